@@ -0,0 +1,225 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009 - 2011
+ *               - Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               						Lucian Blaga University of Sibiu, Romania
+ *               - Systems and Networking, University of Augsburg, Germany
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+// Startup benchmark: measures how long it takes to build 2D meshes of NoC nodes
+// (from 4x4 up to 256x256 nodes, by default) and how much memory every node needs.
+//
+// For every mesh size, the nodes are created, the NocMesh2D topology is installed and
+// (optionally) a NocSyncApplication is installed and started on every node. Only the
+// startup is measured: no flit is simulated.
+//
+// Every mesh is built by its own (forked) process, so the memory of a mesh is not
+// reused from the previous, smaller one. The default build of ns-3 addresses at most
+// 128 nodes per dimension in the NoC headers; 256x256 meshes require ns-3 to be configured
+// with --enable-noc-wide-coordinates (the larger meshes are skipped otherwise).
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ns3/core-module.h"
+#include "ns3/simulator-module.h"
+#include "ns3/node-module.h"
+#include "ns3/topology-module.h"
+#include "ns3/noc-sync-application.h"
+#include "ns3/noc-sync-application-helper.h"
+#include "ns3/noc-node.h"
+#include "ns3/noc-registry.h"
+#include "ns3/noc-value.h"
+#include "ns3/noc-header.h"
+#include "ns3/integer.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+
+using namespace ns3;
+using namespace std;
+
+NS_LOG_COMPONENT_DEFINE ("NocStartupBenchmark");
+
+/**
+ * \return the wall-clock time, in seconds
+ */
+static double
+GetWallClockTime ()
+{
+  struct timeval tv;
+  gettimeofday (&tv, 0);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/**
+ * \return the resident set size of this process, in bytes (0 if it cannot be read)
+ */
+static uint64_t
+GetResidentSetSize ()
+{
+  uint64_t size = 0;
+  uint64_t resident = 0;
+  ifstream statm ("/proc/self/statm");
+  if (statm >> size >> resident)
+    {
+      return resident * sysconf (_SC_PAGESIZE);
+    }
+  return 0;
+}
+
+/**
+ * Builds a mesh and prints one line of results
+ *
+ * \param side the side of the mesh
+ * \param withApplications whether or not NocSyncApplications are installed and started
+ * \param globalClock the global clock
+ * \param flitSize the size of a flit, in bits
+ */
+static void
+BenchmarkMesh (uint32_t side, bool withApplications, Time globalClock, uint32_t flitSize)
+{
+  uint32_t numberOfNodes = side * side;
+  uint64_t memoryBefore = GetResidentSetSize ();
+  double buildStart = GetWallClockTime ();
+
+  NodeContainer nodes;
+  for (uint32_t i = 0; i < numberOfNodes; ++i)
+    {
+      nodes.Add (CreateObject<NocNode> ());
+    }
+
+  Ptr<NocTopology> noc = CreateObject<NocMesh2D> ();
+  noc->SetAttribute ("hSize", UintegerValue (side));
+  noc->SetChannelAttribute ("DataRate", DataRateValue (DataRate ((uint64_t) (1e12 * flitSize
+      / globalClock.GetPicoSeconds ()))));
+  noc->SetChannelAttribute ("Delay", TimeValue (PicoSeconds (0)));
+  noc->SetInQueue ("ns3::DropTailQueue", "Mode", EnumValue (DropTailQueue::PACKETS),
+      "MaxPackets", UintegerValue (1));
+  noc->SetRouter ("ns3::FourWayRouter");
+  noc->SetRoutingProtocol ("ns3::XyRouting");
+  noc->SetSwitchingProtocol ("ns3::WormholeSwitching");
+  NetDeviceContainer devs = noc->Install (nodes);
+  NocRegistry::GetInstance ()->SetAttribute ("NoCTopology", PointerValue (noc));
+
+  double buildTime = GetWallClockTime () - buildStart;
+  uint64_t memoryAfter = GetResidentSetSize ();
+
+  stringstream mesh;
+  mesh << side << "x" << side;
+  cout << " " << setw (10) << mesh.str () << setw (10) << numberOfNodes
+      << setw (14) << fixed << setprecision (3) << buildTime
+      << setw (16) << setprecision (2) << buildTime * 1e6 / numberOfNodes
+      << setw (16) << (memoryAfter > memoryBefore ? (memoryAfter - memoryBefore) / numberOfNodes : 0);
+
+  if (withApplications)
+    {
+      double appsStart = GetWallClockTime ();
+      vector<Ptr<NocValue> > size (2);
+      size.at (0) = CreateObject<NocValue> (side);
+      size.at (1) = CreateObject<NocValue> (side);
+      NocSyncApplicationHelper nocSyncAppHelper (nodes, devs, size);
+      nocSyncAppHelper.SetAttribute ("InjectionProbability", DoubleValue (0.1));
+      nocSyncAppHelper.SetAttribute ("TrafficPattern", EnumValue (NocSyncApplication::UNIFORM_RANDOM));
+      ApplicationContainer apps = nocSyncAppHelper.Install (nodes);
+      apps.Start (Seconds (0.0));
+      apps.Stop (globalClock);
+      double appsTime = GetWallClockTime () - appsStart;
+
+      // only the start events (of the net devices and of the applications) are run
+      double startStart = GetWallClockTime ();
+      Simulator::Stop (Seconds (0.0));
+      Simulator::Run ();
+      double startTime = GetWallClockTime () - startStart;
+
+      cout << setw (14) << setprecision (3) << appsTime << setw (14) << startTime;
+    }
+  cout << endl;
+
+  Simulator::Destroy ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t minSize = 4;
+  uint32_t maxSize = 256;
+  bool withApplications = false;
+  Time globalClock = PicoSeconds (1000); // 1 ns -> NoC @ 1GHz
+
+  CommandLine cmd;
+  cmd.AddValue<uint32_t> ("min-size", "The side of the smallest mesh (default is 4)", minSize);
+  cmd.AddValue<uint32_t> ("max-size", "The side of the largest mesh (default is 256)", maxSize);
+  cmd.AddValue<bool> ("with-applications",
+      "Also install and start a NocSyncApplication on every node (default is false)", withApplications);
+  cmd.Parse (argc, argv);
+
+  NocRegistry::GetInstance ()->SetAttribute ("GlobalClock", TimeValue (globalClock));
+  NocRegistry::GetInstance ()->SetAttribute ("NoCDimensions", IntegerValue (2));
+  uint32_t flitSize = 32; // 4 bytes
+  NocRegistry::GetInstance ()->SetAttribute ("FlitSize", IntegerValue (flitSize));
+
+  cout << "# NoC startup benchmark (2D mesh, FourWayRouter, XY routing, wormhole switching)" << endl;
+  cout << "#" << setw (10) << "mesh" << setw (10) << "nodes" << setw (14) << "build (s)"
+      << setw (16) << "per node (us)" << setw (16) << "bytes / node";
+  if (withApplications)
+    {
+      cout << setw (14) << "apps (s)" << setw (14) << "start (s)";
+    }
+  cout << endl;
+
+  uint32_t largestSize = NocHeader::OFFSET_BIT_MASK + 1;
+  for (uint32_t side = minSize; side <= maxSize; side *= 2)
+    {
+      if (side > largestSize)
+        {
+          stringstream mesh;
+          mesh << side << "x" << side;
+          cout << " " << setw (10) << mesh.str () << "   skipped (the NoC headers address at most " << largestSize
+              << " nodes per dimension; configure ns-3 with --enable-noc-wide-coordinates)" << endl;
+          continue;
+        }
+      cout.flush ();
+      pid_t pid = fork ();
+      if (pid < 0)
+        {
+          NS_FATAL_ERROR ("Could not fork the benchmark of the " << side << "x" << side << " mesh");
+        }
+      if (pid == 0)
+        {
+          BenchmarkMesh (side, withApplications, globalClock, flitSize);
+          cout.flush ();
+          _exit (0);
+        }
+      int status;
+      if (waitpid (pid, &status, 0) != pid || !WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          cout << " " << side << "x" << side << " failed" << endl;
+        }
+    }
+
+  return 0;
+}
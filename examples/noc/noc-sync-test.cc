@@ -78,12 +78,14 @@ main (int argc, char *argv[])
 
   double injectionProbability (1);
   int dataPacketSpeedup (1);
+  bool cycleDriven (false);
   Time globalClock = PicoSeconds (1000); // 1 ns -> NoC @ 1GHz
 
   // Set up command line parameters used to control the experiment.
   CommandLine cmd;
   cmd.AddValue<double> ("injection-probability", "The packet injection probability.", injectionProbability);
   cmd.AddValue<int> ("data-packet-speedup", "The speedup used for data packets (compared to head packets)", dataPacketSpeedup);
+  cmd.AddValue<bool> ("cycle-driven", "Simulate the NoC clock cycle by clock cycle (instead of scheduling an event for every flit)", cycleDriven);
   cmd.Parse (argc, argv);
 
   // set the global parameters
@@ -121,6 +123,7 @@ main (int argc, char *argv[])
   size.at (1) = CreateObject<NocValue> (vSize);
   size.at (2) = CreateObject<NocValue> (numberOfNodes / hSize / vSize);
   Ptr<NocTopology> noc = CreateObject<NocMeshND> (size);
+  noc->SetAttribute ("CycleDriven", BooleanValue (cycleDriven));
 
   uint32_t flitSize = 8 * 6; // 3 bytes
   NocRegistry::GetInstance ()->SetAttribute ("FlitSize", IntegerValue (flitSize));
@@ -0,0 +1,161 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+// Converts a binary NoC trace (see NocBinaryTraceWriter) to the ASCII trace format (see NocTopology::EnableAscii).
+//
+// The binary trace does not keep the content of the flits, so a flit is printed only with its size
+// (the NocHeader of the head flits is not printed). The time of an event is the start of its clock cycle.
+//
+// Usage: noc-trace-converter --input=trace.bin [--output=trace.tr] [--summary]
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/simulator-module.h"
+#include "ns3/noc-binary-trace-reader.h"
+#include "ns3/noc-packet.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("NocTraceConverter");
+
+static void
+PrintRecord (std::ostream &os, const NocTraceRecord &record, int64_t globalClock)
+{
+  std::string traceSource;
+  switch (record.m_event)
+    {
+    case NocTraceRecord::TX:
+      traceSource = "Send";
+      break;
+    case NocTraceRecord::RX:
+      traceSource = "Receive";
+      break;
+    case NocTraceRecord::ENQUEUE:
+      traceSource = "Enqueue";
+      break;
+    case NocTraceRecord::DEQUEUE:
+      traceSource = "Dequeue";
+      break;
+    default:
+      traceSource = "Drop";
+      break;
+    }
+
+  os << (char) record.m_event << " " << PicoSeconds (record.m_cycle * globalClock)
+     << " /NodeList/" << record.m_node << "/DeviceList/" << record.m_port << "/$ns3::NocNetDevice/" << traceSource
+     << " Payload (size=" << record.m_flitSize << ")";
+
+  if (NocPacket::HEAD == record.m_flitType)
+    {
+      os << " (UID: " << record.m_flitUid << ")";
+    }
+  if (NocPacket::TAIL == record.m_flitType)
+    {
+      os << "(tail flit)" << " (head flit UID: " << record.m_headUid << ")";
+    }
+  if (NocPacket::DATA == record.m_flitType)
+    {
+      os << " (head flit UID: " << record.m_headUid << ")";
+    }
+
+  os << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  bool summary = false;
+
+  CommandLine cmd;
+  cmd.AddValue<std::string> ("input", "The binary trace file (mandatory parameter)", input);
+  cmd.AddValue<std::string> ("output", "The ASCII trace file (by default, the trace is printed to the standard output)", output);
+  cmd.AddValue<bool> ("summary", "Print only a summary of the binary trace, instead of converting it (default is false)", summary);
+  cmd.Parse (argc, argv);
+
+  NS_ASSERT_MSG (!input.empty (), "The binary trace file must be specified (--input)");
+
+  NocBinaryTraceReader reader;
+  if (!reader.Open (input))
+    {
+      std::cerr << input << " is not a readable binary NoC trace" << std::endl;
+      return 1;
+    }
+
+  if (summary)
+    {
+      std::vector<uint64_t> events (256, 0);
+      uint64_t lastCycle = 0;
+      for (uint64_t i = 0; i < reader.GetNRecords (); i++)
+        {
+          const NocTraceRecord *record = reader.GetRecord (i);
+          if (record == 0)
+            {
+              std::cerr << input << " is corrupted (record " << i << " cannot be read)" << std::endl;
+              return 1;
+            }
+          events[record->m_event]++;
+          lastCycle = record->m_cycle;
+        }
+      std::cout << "records " << reader.GetNRecords () << std::endl;
+      std::cout << "compressed " << (reader.IsCompressed () ? "yes" : "no") << std::endl;
+      std::cout << "global-clock " << reader.GetGlobalClock () << " ps" << std::endl;
+      std::cout << "last-cycle " << lastCycle << std::endl;
+      std::cout << "sent-flits " << events[NocTraceRecord::TX] << std::endl;
+      std::cout << "received-flits " << events[NocTraceRecord::RX] << std::endl;
+      std::cout << "enqueued-flits " << events[NocTraceRecord::ENQUEUE] << std::endl;
+      std::cout << "dequeued-flits " << events[NocTraceRecord::DEQUEUE] << std::endl;
+      std::cout << "dropped-flits " << events[NocTraceRecord::DROP] << std::endl;
+      return 0;
+    }
+
+  std::ofstream file;
+  if (!output.empty ())
+    {
+      file.open (output.c_str (), std::ios_base::out | std::ios_base::trunc);
+      if (!file.is_open ())
+        {
+          std::cerr << "Could not create " << output << std::endl;
+          return 1;
+        }
+    }
+  std::ostream &os = output.empty () ? std::cout : file;
+
+  for (uint64_t i = 0; i < reader.GetNRecords (); i++)
+    {
+      const NocTraceRecord *record = reader.GetRecord (i);
+      if (record == 0)
+        {
+          std::cerr << input << " is corrupted (record " << i << " cannot be read)" << std::endl;
+          return 1;
+        }
+      PrintRecord (os, *record, reader.GetGlobalClock ());
+    }
+
+  return 0;
+}
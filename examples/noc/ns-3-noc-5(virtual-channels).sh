@@ -0,0 +1,177 @@
+#!/bin/bash
+
+# Each ns-3 NoC script must have a unique SCRIPT_ID (AKA experiment ID)
+# This helps at identifying the simulation results in the database
+#
+# If you run this script with the "co" parameter (chart only), then no simulation is performed,
+# the data is considered to already be in the database. Only the charts are generated.
+#
+# Compares the saturation throughput of the single input queue model (1 virtual channel)
+# with the one of routers having 2 and 4 virtual channels per input port.
+# The buffer size is given per virtual channel.
+
+SCRIPT_ID="5"
+
+# Do not use spaces for the values passed to ns-3 NoC as simulator parameters
+
+EXPERIMENT="Saturation_throughput_evaluation_on_a_2D_4x4_torus_NoC_(virtual_channels)"
+STRATEGY="packet_injection_probability,virtual_channels,arbiter,traffic_pattern"
+DESCRIPTION="2D_torus_size=4x4,global_clock=1GHz,router=FourWay,routing_protocol=DOR,switching_mechanism=wormhole,number_of_flits_per_packet=9,buffer_size=4,no_data_flit_speedup,warmup_cycles=1000,simulation_cycles=10000"
+AUTHOR="Ciprian_Radu"
+
+NODES="16"
+H_SIZE="4"
+WARMUP_CYCLES="1000"
+SIMULATION_CYCLES="10000"
+
+INJECTION_PROBABILITY="0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1"
+DATA_FLIT_SPEEDUP="1"
+BUFFER_SIZE="4"
+VIRTUAL_CHANNELS="1 2 4"
+ARBITER="RoundRobin iSLIP Age"
+TRAFFIC_PATTERN="UniformRandom BitComplement"
+
+if [ "$1" != "co" ]
+then
+	echo "Starting the experiment '${EXPERIMENT}' with the ns-3 NoC simulator"
+
+	pCheck=`which sqlite3`
+	if [ -z "$pCheck" ]
+	then
+	  echo "ERROR: This script requires sqlite3."
+	  exit 255
+	fi
+
+	pCheck=`which gnuplot`
+	if [ -z "$pCheck" ]
+	then
+	  echo "ERROR: This script requires gnuplot."
+	  exit 255
+	fi
+
+	pCheck=`which sed`
+	if [ -z "$pCheck" ]
+	then
+	  echo "ERROR: This script requires sed."
+	  exit 255
+	fi
+
+	export LD_LIBRARY_PATH=$LD_LIBRARY_PATH:bin/
+
+	if [ -e ../../data.db ]
+	then
+	  echo "Kill data.db? (y/N)"
+	  read ANS
+	  if [ "$ANS" = "yes" -o "$ANS" = "y" -o "$ANS" = "Y" ]
+	  then
+	    echo Deleting database
+	    rm ../../data.db
+	  fi
+	fi
+
+	for injection_probability in $INJECTION_PROBABILITY
+	do
+	  for virtual_channels in $VIRTUAL_CHANNELS
+	  do
+		for arbiter in $ARBITER
+		do
+		  # the arbiter is not used by the single queue model
+		  if [ "$virtual_channels" = "1" -a "$arbiter" != "RoundRobin" ]
+		  then
+		    continue
+		  fi
+		  for traffic_pattern in $TRAFFIC_PATTERN
+		  do
+	    	echo Injection probability $injection_probability, virtual channels $virtual_channels, arbiter $arbiter, traffic pattern $traffic_pattern
+		INPUT="${injection_probability},${virtual_channels},${arbiter},${traffic_pattern}"
+		RUN="experiment_id=${SCRIPT_ID},4x4_2D_torus,packet_injection_probability=${injection_probability},virtual_channels=${virtual_channels},arbiter=${arbiter},traffic_pattern=${traffic_pattern}"
+	    	time ../../waf --run "ns-3-noc --experiment=$EXPERIMENT --strategy=$STRATEGY --input=$INPUT --description=$DESCRIPTION, --run=$RUN --author=$AUTHOR --nodes=$NODES --h-size=$H_SIZE --injection-probability=$injection_probability --data-packet-speedup=$DATA_FLIT_SPEEDUP --buffer-size=$BUFFER_SIZE --virtual-channels=$virtual_channels --arbiter=$arbiter --traffic-pattern=$traffic_pattern --warmup-cycles=$WARMUP_CYCLES --simulation-cycles=$SIMULATION_CYCLES"
+		  done
+		done
+	  done
+	done
+fi
+
+echo "Generating charts"
+
+# the accepted throughput is measured in flits / node / cycle
+for virtual_channels in $VIRTUAL_CHANNELS
+do
+	for arbiter in $ARBITER
+	do
+		if [ "$virtual_channels" = "1" -a "$arbiter" != "RoundRobin" ]
+		then
+		  continue
+		fi
+		for traffic_pattern in $TRAFFIC_PATTERN
+		do
+			INPUT_DB="${virtual_channels},${arbiter},${traffic_pattern}"
+			INPUT_FILE="${virtual_channels}-${arbiter}-${traffic_pattern}"
+			for variable in latency-average flits-received
+			do
+				CMD=" \
+				SELECT E.INPUT, S.VALUE \
+				FROM SINGLETONS S, EXPERIMENTS E \
+				WHERE \
+					E.INPUT LIKE '%,${INPUT_DB}' \
+					AND \
+					S.RUN LIKE 'experiment_id=${SCRIPT_ID},4x4_2D_torus,packet_injection_probability=%,virtual_channels=%,arbiter=%,traffic_pattern=%' \
+					AND \
+					S.RUN = E.RUN \
+					AND \
+					S.VARIABLE = '${variable}' \
+				GROUP BY E.INPUT \
+				ORDER BY ABS(E.INPUT) ASC \
+				; \
+				"
+
+				sqlite3 -noheader ../../data.db "$CMD" > ns-3-noc-${SCRIPT_ID}-${variable}-${INPUT_FILE}.data
+				sed -i "s/,[^|]*|/   /" ns-3-noc-${SCRIPT_ID}-${variable}-${INPUT_FILE}.data
+			done
+		done
+	done
+done
+
+for traffic_pattern in $TRAFFIC_PATTERN
+do
+	for variable in latency-average flits-received
+	do
+		echo "set terminal png" > temp.tmp
+		echo "set out \"ns-3-noc-${SCRIPT_ID}-${variable}-${traffic_pattern}.png\"" >> temp.tmp
+		echo "set title \"${traffic_pattern} traffic in a 2D 4x4 torus NoC\"" >> temp.tmp
+		echo "set xlabel \"Packet injection rate (packets/cycle)\"" >> temp.tmp
+		echo "set xrange [0:1]" >> temp.tmp
+		if [ "$variable" = "latency-average" ]
+		then
+			echo "set ylabel \"Average packet latency (cycles)\"" >> temp.tmp
+			SCALE="2"
+		else
+			echo "set ylabel \"Accepted throughput (flits/node/cycle)\"" >> temp.tmp
+			SCALE="(\$2 / ($NODES * ($SIMULATION_CYCLES - $WARMUP_CYCLES)))"
+		fi
+
+		PLOT="plot"
+		for virtual_channels in $VIRTUAL_CHANNELS
+		do
+			for arbiter in $ARBITER
+			do
+				if [ "$virtual_channels" = "1" ]
+				then
+				  if [ "$arbiter" = "RoundRobin" ]
+				  then
+				    PLOT="$PLOT \"ns-3-noc-${SCRIPT_ID}-${variable}-1-RoundRobin-${traffic_pattern}.data\" using 1:$SCALE with lines title \"single input queue\","
+				  fi
+				  continue
+				fi
+				PLOT="$PLOT \"ns-3-noc-${SCRIPT_ID}-${variable}-${virtual_channels}-${arbiter}-${traffic_pattern}.data\" using 1:$SCALE with lines title \"${virtual_channels} VCs, ${arbiter}\","
+			done
+		done
+		echo "${PLOT%,}" >> temp.tmp
+
+		gnuplot temp.tmp
+	done
+done
+
+rm temp.tmp
+
+echo "Done; data in ns-3-noc-${SCRIPT_ID}*.data, plot in ns-3-noc-${SCRIPT_ID}*.png"
@@ -48,6 +48,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/stats-module.h"
 #include "ns3/noc-packet-tag.h"
+#include "ns3/noc-stats-collector.h"
 #include "ns3/nstime.h"
 #include <map>
 #include <list>
@@ -81,112 +82,6 @@ void FlitInjectedCallback (Ptr<CounterCalculator<> > calc, std::string path, Ptr
   calc->Update();
 }
 
-/**
- * Simple data structure for keeping the latency times of a packet
- */
-class LatencyTimes
-{
-public:
-
-  /** the time when the head of the packet is injected into the network */
-  Time m_startTime;
-
-  /** the time when the tail of the packet reaches the destination */
-  Time m_endTime;
-};
-
-/** keeps the latency time of each fully received packet */
-std::map<uint32_t, LatencyTimes> g_latencyOfPackets;
-
-/**
- * Each time a flit is received at a node, this function gets invoked.
- *
- * \param dummy dummy parameter, not actually used (required by MakeBoundCall (...))
- * \param path the path with the receiving net device
- * \param flit the received flit
- */
-void FlitReceivedCallback (int dummy, std::string path, Ptr<const Packet> flit)
-{
-  NS_LOG_LOGIC ("Flit with UID " << flit->GetUid () << " received");
-
-  LatencyTimes latencyTimes;
-
-  uint32_t uid;
-  NocPacketTag tag;
-  flit->PeekPacketTag (tag);
-  NocPacket::Type flitType = tag.GetPacketType ();
-  switch (flitType)
-    {
-  case NocPacket::HEAD:
-    NS_LOG_LOGIC ("Flit type is head");
-    latencyTimes = g_latencyOfPackets[flit->GetUid ()];
-    latencyTimes.m_startTime = tag.GetInjectionTime ();
-    break;
-  case NocPacket::DATA:
-    NS_LOG_LOGIC ("Flit type is data");
-    break;
-  case NocPacket::TAIL:
-    NS_LOG_LOGIC ("Flit type is tail");
-    uid = tag.GetPacketHeadUid ();
-    latencyTimes = g_latencyOfPackets[uid];
-    latencyTimes.m_endTime = tag.GetReceiveTime ();
-    break;
-  case NocPacket::UNKNOWN:
-  default:
-    NS_LOG_ERROR ("Flit type is unknown");
-    break;
-    }
-
-  if (NocPacket::HEAD == flitType)
-    {
-      g_latencyOfPackets[flit->GetUid ()] = latencyTimes;
-    }
-  if (NocPacket::TAIL == flitType)
-    {
-      uid = tag.GetPacketHeadUid ();
-      g_latencyOfPackets[uid] = latencyTimes;
-    }
-
-  NS_LOG_LOGIC ("Flit " << *flit << " has injection time " << tag.GetInjectionTime()
-      << " and receive time " << tag.GetReceiveTime ());
-  NS_ASSERT (tag.GetReceiveTime ().GetPicoSeconds () - tag.GetInjectionTime().GetPicoSeconds () >= 0);
-}
-
-/**
- * Computes the latency of each fully received packet. A packet is fully received when its
- * even its tail was received.
- *
- * The latency of a network is the time required for a packet to traverse the network,
- * from the time the head of the packet arrives at the input port to the time the tail of
- * the packet departs the output port.
- *
- * \param the latency calculator
- */
-void ComputeLatenciesOfPackets (Ptr<TimeMinMaxAvgTotalCalculator > calc)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-
-  std::map<uint32_t, LatencyTimes>::iterator it;
-  for (it = g_latencyOfPackets.begin (); it != g_latencyOfPackets.end (); it++)
-    {
-      LatencyTimes lt = it->second;
-      if (lt.m_endTime.IsZero ())
-        {
-          NS_LOG_LOGIC ("The packet with the head with UID " << it->first << " has zero end time. "
-              "This means the tail was not received and therefore, "
-              "the latency of this packet is not considered.");
-        }
-      else
-        {
-          NS_LOG_LOGIC ("Packet with UID " << it->first << " has latency times "
-              << lt.m_startTime << " " << lt.m_endTime);
-          TimeValue globalClock;
-          NocRegistry::GetInstance ()->GetAttribute ("GlobalClock", globalClock);
-          calc->Update ((lt.m_endTime - lt.m_startTime) / globalClock.Get ());
-        }
-    }
-}
-
 int
 main (int argc, char *argv[])
 {
@@ -210,6 +105,9 @@ main (int argc, char *argv[])
   // the path to the XML file containing the mapping
   string mappingXmlFilePath;
 
+  // the binary cache of the XML inputs ("default" means next to the mapping XML, "none" disables the cache)
+  string ctgCacheFilePath ("default"); // optional
+
   // the number of nodes from the NoC
   int numberOfNodes = 16;
 
@@ -259,6 +157,7 @@ main (int argc, char *argv[])
   cmd.AddValue<string> ("run", "The run is a unique identifier for this trial with which it's information is tagged for identification in later analysis (mandatory parameter when just-save-topology = false).", run);
   cmd.AddValue<string> ("author", "The author of this simulation (optional parameter).", author);
   cmd.AddValue<string> ("mapping-file-path", "The path to the XML file that contains the application mapping (mandatory parameter when just-save-topology = false)", mappingXmlFilePath);
+  cmd.AddValue<string> ("ctg-cache", "The binary cache of the data read from the mapping, APCG, CTG, core and task XMLs (default is the mapping XML file path followed by .cache; none disables the cache)", ctgCacheFilePath);
   cmd.AddValue<uint64_t> ("frequency", "The NoC operating frequency, expressed in Hertz (default is 1000000000 Hz, i.e. 1 GHz)", nocFrequency);
   cmd.AddValue<int> ("nodes", "The number of nodes from the NoC (default is 16)", numberOfNodes);
   cmd.AddValue<int> ("h-size", "How many nodes a 2D mesh has horizontally (default is 4)", hSize);
@@ -417,6 +316,14 @@ main (int argc, char *argv[])
       NS_LOG_INFO ("Create CTG based Applications.");
       NocCtgApplicationHelper ctgApplicationHelper (mappingXmlFilePath, ctgIterations, // the number of CTG iterations
           flitsPerPacket, simulationCycles, nodes, devs, hSize);
+      if (ctgCacheFilePath == "none")
+        {
+          ctgApplicationHelper.SetCacheFilePath ("");
+        }
+      else if (ctgCacheFilePath != "default")
+        {
+          ctgApplicationHelper.SetCacheFilePath (ctgCacheFilePath);
+        }
       ctgApplicationHelper.Initialize ();
 
     // Configure tracing of all enqueue, dequeue, and NetDevice receive events
@@ -472,13 +379,12 @@ main (int argc, char *argv[])
                     MakeBoundCallback (&FlitInjectedCallback, appFlitInjected));
     data.AddDataCalculator (appFlitInjected);
 
-    // Computes the average packet latency
-    Ptr<TimeMinMaxAvgTotalCalculator> latencyStat = CreateObject<TimeMinMaxAvgTotalCalculator>();
+    // Computes the packet latency (average, percentiles), while the simulation runs
+    Ptr<NocStatsCollector> latencyStat = CreateObject<NocStatsCollector> ();
     latencyStat->SetKey ("latency");
     latencyStat->SetContext (context);
-    Config::Connect ("/NodeList/*/ApplicationList/*/$ns3::NocCtgApplication/FlitReceived",
-                    MakeBoundCallback (&FlitReceivedCallback, 0));
-    data.AddDataCalculator(latencyStat);
+    latencyStat->Install (noc);
+    data.AddDataCalculator (latencyStat);
 
     // start the simulation
 
@@ -533,8 +439,6 @@ main (int argc, char *argv[])
     NS_LOG_INFO ("Cores area: " << coresArea << " mm^2");
     NS_LOG_INFO ("Cores energy: " << coresEnergy << " Joule");
 
-    // this must be done after the simulation ended
-    ComputeLatenciesOfPackets (latencyStat);
 
     // Write the simulation results in the output file
     ofstream outputFile (outputFilePath.c_str ());
@@ -639,6 +543,12 @@ main (int argc, char *argv[])
     outputFile << "# The energy consumed by the entire System on Chip (SoC). It is expressed in Joule and it sums noc-energy and cores-energy." << endl;
     outputFile << "soc-energy = " << (nocTotalPower * applicationRuntime + coresEnergy) << endl;
     outputFile << endl;
+    outputFile << "# The average latency of a packet (from the injection of its head flit until its tail flit is received). It is expressed in clock cycles." << endl;
+    outputFile << "packet-latency-average = " << latencyStat->GetLatency ().getMean () << endl;
+    outputFile << endl;
+    outputFile << "# 99% of the packets have a latency smaller than or equal to this one. It is expressed in clock cycles." << endl;
+    outputFile << "packet-latency-p99 = " << latencyStat->GetLatency ().GetPercentile (99) << endl;
+    outputFile << endl;
     outputFile << "# How much time the simulation took. Is is expressed in seconds." << endl;
     outputFile << "simulation-runtime = " << endTime.tv_sec - startTime.tv_sec << endl;
     outputFile << endl;
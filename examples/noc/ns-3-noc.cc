@@ -30,6 +30,10 @@
 #include <fstream>
 #include <string>
 #include <cassert>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
 
 #include "ns3/core-module.h"
 #include "ns3/simulator-module.h"
@@ -45,8 +49,16 @@
 #include "ns3/noc-registry.h"
 #include "ns3/integer.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/stats-module.h"
 #include "ns3/noc-packet-tag.h"
+#include "ns3/noc-stats-collector.h"
+#include "ns3/noc-binary-trace-writer.h"
+#include "ns3/noc-warmup-fork.h"
+#include "ns3/noc-convergence-controller.h"
+#include "ns3/noc-deadlock-detector.h"
+#include "ns3/noc-fault-campaign.h"
+#include "ns3/noc-faulty-node.h"
 #include "ns3/nstime.h"
 #include <map>
 #include "ns3/output-stream-wrapper.h"
@@ -78,109 +90,13 @@ void FlitInjectedCallback (Ptr<CounterCalculator<> > calc, std::string path, Ptr
 }
 
 /**
- * Simple data structure for keeping the latency times of a packet
+ * Counts the flits received by the destination nodes (the accepted throughput)
  */
-class LatencyTimes
+void FlitAcceptedCallback (Ptr<CounterCalculator<> > calc, std::string path, Ptr<const Packet> flit)
 {
-public:
+  NS_LOG_LOGIC ("Flit received counted in the " << calc->GetKey () << " statistic");
 
-  /** the time when the head of the packet is injected into the network */
-  Time m_startTime;
-
-  /** the time when the tail of the packet reaches the destination */
-  Time m_endTime;
-};
-
-/** keeps the latency time of each fully received packet */
-std::map<uint32_t, LatencyTimes> g_latencyOfPackets;
-
-/**
- * Each time a flit is received at a node, this function gets invoked.
- *
- * \param dummy dummy parameter, not actually used (required by MakeBoundCall (...))
- * \param path the path with the receiving net device
- * \param flit the received flit
- */
-void FlitReceivedCallback (int dummy, std::string path, Ptr<const Packet> flit)
-{
-  NS_LOG_LOGIC ("Flit with UID " << flit->GetUid () << " received");
-
-  LatencyTimes latencyTimes;
-
-  uint32_t uid;
-  NocPacketTag tag;
-  flit->PeekPacketTag (tag);
-  NocPacket::Type flitType = tag.GetPacketType ();
-  switch (flitType)
-    {
-  case NocPacket::HEAD:
-    NS_LOG_LOGIC ("Flit type is head");
-    latencyTimes = g_latencyOfPackets[flit->GetUid ()];
-    latencyTimes.m_startTime = tag.GetInjectionTime ();
-    break;
-  case NocPacket::DATA:
-    NS_LOG_LOGIC ("Flit type is data");
-    break;
-  case NocPacket::TAIL:
-    NS_LOG_LOGIC ("Flit type is tail");
-    uid = tag.GetPacketHeadUid ();
-    latencyTimes = g_latencyOfPackets[uid];
-    latencyTimes.m_endTime = tag.GetReceiveTime ();
-    break;
-  case NocPacket::UNKNOWN:
-  default:
-    NS_LOG_ERROR ("Flit type is unknown");
-    break;
-    }
-
-  if (NocPacket::HEAD == flitType)
-    {
-      g_latencyOfPackets[flit->GetUid ()] = latencyTimes;
-    }
-  if (NocPacket::TAIL == flitType)
-    {
-      uid = tag.GetPacketHeadUid ();
-      g_latencyOfPackets[uid] = latencyTimes;
-    }
-
-  NS_LOG_LOGIC ("Flit " << *flit << " has injection time " << tag.GetInjectionTime()
-      << " and receive time " << tag.GetReceiveTime ());
-  NS_ASSERT (tag.GetReceiveTime ().GetPicoSeconds () - tag.GetInjectionTime().GetPicoSeconds () >= 0);
-}
-
-/**
- * Computes the latency of each fully received packet. A packet is fully received when its
- * even its tail was received.
- *
- * The latency of a network is the time required for a packet to traverse the network,
- * from the time the head of the packet arrives at the input port to the time the tail of
- * the packet departs the output port.
- *
- * \param the latency calculator
- */
-void ComputeLatenciesOfPackets (Ptr<TimeMinMaxAvgTotalCalculator > calc)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-
-  std::map<uint32_t, LatencyTimes>::iterator it;
-  for (it = g_latencyOfPackets.begin (); it != g_latencyOfPackets.end (); it++)
-    {
-      LatencyTimes lt = it->second;
-      if (lt.m_endTime.IsZero ())
-        {
-          NS_LOG_LOGIC ("The packet with the head with UID " << it->first << " has zero end time. "
-              "This means the tail was not received and therefore, "
-              "the latency of this packet is not considered.");
-        }
-      else
-        {
-          NS_LOG_LOGIC ("Packet with UID " << it->first << " has latency times "
-              << lt.m_startTime << " " << lt.m_endTime);
-          TimeValue globalClock;
-          NocRegistry::GetInstance ()->GetAttribute ("GlobalClock", globalClock);
-          calc->Update ((lt.m_endTime - lt.m_startTime) / globalClock.Get ());
-        }
-    }
+  calc->Update();
 }
 
 int
@@ -219,6 +135,16 @@ main (int argc, char *argv[])
 
   uint64_t bufferSize (9);
 
+  // 1 means a single input queue per port (no virtual channels)
+  uint32_t virtualChannels (1);
+
+  std::string arbiter = "RoundRobin";
+
+  // how many clock cycles a credit needs to get back to the upstream router
+  uint64_t creditDelay (0);
+  uint32_t loadSideBandPeriod (0);
+  uint32_t loadSideBandLatency (1);
+
   std::string trafficPattern = "UniformRandom";
 
   uint64_t warmupCycles = 1000;
@@ -226,6 +152,33 @@ main (int argc, char *argv[])
   // the number of simulation cycles includes the warmup cycles
   uint64_t simulationCycles = 10000;
 
+  // no binary trace is written if no file is specified
+  std::string binaryTrace = "";
+
+  bool binaryTraceCompression = false;
+
+  // if set, the end of the warmup is detected and the simulation stops as soon as the latency is known precisely enough
+  bool convergence = false;
+
+  double convergenceTarget (0.05);
+
+  // if set, the simulation stops as soon as the input buffers (virtual channels or input queues) are deadlocked
+  bool deadlockDetection = true;
+
+  // 0 means that the warmup and the measurement are done by a single run (process)
+  uint32_t replications (0);
+
+  // 0 means as many as the processors
+  uint32_t parallelReplications (0);
+
+  // CSV; if it is empty, the measurement runs use the injection probability of the warmup
+  std::string measurementInjectionProbabilities = "";
+
+  // the fault scenarios of a reliability campaign are read from this file and / or generated
+  std::string faultSchedule = "";
+
+  uint32_t faultScenarios (0);
+
   // Set up command line parameters used to control the experiment.
   CommandLine cmd;
   cmd.AddValue<std::string> ("experiment", "The experiment is the study of which this trial (AKA simulation) is a member (mandatory parameter).", experiment);
@@ -241,11 +194,45 @@ main (int argc, char *argv[])
   cmd.AddValue<double> ("injection-probability", "The packet injection probability (default is 1 (maximum), minimum is zero).", injectionProbability);
   cmd.AddValue<int> ("data-packet-speedup", "The speedup used for data packets (compared to head packets) (default is 1 (minimum value) - no speedup)", dataFlitSpeedup);
   cmd.AddValue<uint64_t> ("buffer-size", "The size of the input channel buffers (measured in multiples of packet size) (default is 9)", bufferSize);
+  cmd.AddValue<uint32_t> ("virtual-channels", "The number of virtual channels of each input port "
+      "(default is 1 - a single input queue, the buffer size is per virtual channel)", virtualChannels);
+  cmd.AddValue<std::string> ("arbiter", "The arbiter used by the VC and switch allocators "
+      "(possible values: RoundRobin - default value, iSLIP, Age). It is used only with more than 1 virtual channel.", arbiter);
+  cmd.AddValue<uint64_t> ("credit-delay", "The number of clock cycles needed by a credit to get back to the upstream router "
+      "(default is 0 - a buffer slot can be reused as soon as the flit leaves it)", creditDelay);
+  cmd.AddValue<uint32_t> ("load-side-band-period", "After how many clock cycles the routers publish their load to their neighbors "
+      "(SO and SLB routing only; default is 0 - the load travels with the head flits)", loadSideBandPeriod);
+  cmd.AddValue<uint32_t> ("load-side-band-latency", "After how many clock cycles a load published through the side-band "
+      "becomes visible (default is 1)", loadSideBandLatency);
   cmd.AddValue<std::string> ("traffic-pattern", "The traffic pattern "
       "(possible values: UniformRandom - default value, BitMatrixTranspose, BitComplement, BitReverse, DestinationSpecified). "
       "The default one is UniformRandom and is used when nothing or an invalid value is specified.", trafficPattern);
   cmd.AddValue<uint64_t> ("warmup-cycles", "The number of simulation warm-up cycles (default is 1000)", warmupCycles);
   cmd.AddValue<uint64_t> ("simulation-cycles", "The number of simulation cycles (includes the warm-up cycles, default is 10000)", simulationCycles);
+  cmd.AddValue<std::string> ("binary-trace", "The file where the flit events are traced, in binary format "
+      "(optional parameter; see noc-trace-converter)", binaryTrace);
+  cmd.AddValue<bool> ("binary-trace-compression", "Whether or not the binary trace is compressed (default is false)", binaryTraceCompression);
+  cmd.AddValue<bool> ("convergence", "Whether or not the end of the warmup is detected automatically and the simulation is stopped "
+      "when the average packet latency converged, or when the network is saturated or deadlocked (default is false). "
+      "The warm-up and simulation cycles are then only upper bounds.", convergence);
+  cmd.AddValue<double> ("convergence-target", "The relative half width of the 95% confidence interval of the average packet latency, "
+      "needed for convergence (default is 0.05)", convergenceTarget);
+  cmd.AddValue<bool> ("deadlock-detection", "Whether or not the simulation is stopped as soon as the virtual channels "
+      "(or the input queues, without virtual channels) are deadlocked (default is true)", deadlockDetection);
+  cmd.AddValue<uint32_t> ("replications", "How many measurement runs are forked after the warmup is simulated once "
+      "(default is 0 - no run is forked). Each replication uses other random streams. "
+      "The statistics of the replication R are saved with the run identifier RUN-R.", replications);
+  cmd.AddValue<uint32_t> ("parallel-replications", "How many replications are run at the same time "
+      "(default is 0 - as many as the processors)", parallelReplications);
+  cmd.AddValue<std::string> ("measurement-injection-probabilities", "The injection probabilities used after the warmup, as CSV "
+      "(optional parameter; it requires replications). Every probability is measured by all the replications.",
+      measurementInjectionProbabilities);
+  cmd.AddValue<std::string> ("fault-schedule", "The file with the fault scenarios of a reliability campaign "
+      "(optional parameter; see NocFaultCampaign). Every scenario is simulated by a run forked after the warmup. "
+      "The statistics of the scenario S are saved with the run identifier RUN-S.", faultSchedule);
+  cmd.AddValue<uint32_t> ("fault-scenarios", "How many fault scenarios are generated for a reliability campaign, "
+      "from the mean times to failure of the components (see the attributes of ns3::NocFaultCampaign; default is 0)",
+      faultScenarios);
   cmd.Parse (argc, argv);
 
   NS_LOG_INFO ("ns-3 NoC simulator");
@@ -259,7 +246,10 @@ main (int argc, char *argv[])
   NS_ASSERT_MSG (injectionProbability >= 0 && injectionProbability <= 1, "Injection probability must be in [0,1]!");
   NS_ASSERT_MSG (dataFlitSpeedup >= 1, "Data packet speedup must be >= 1!");
   // the buffer size is allowed to be any number >= 0
+  NS_ASSERT_MSG (virtualChannels >= 1, "At least one virtual channel is required!");
   NS_ASSERT_MSG (simulationCycles > warmupCycles, "The number of simulation cycles is not greater than the number of warm-up cycles!");
+  bool faults = !faultSchedule.empty () || faultScenarios > 0;
+  NS_ASSERT_MSG (!faults || replications == 0, "A fault campaign can not be used with replications");
 
   // set the global parameters
   NocRegistry::GetInstance ()->SetAttribute ("DataPacketSpeedup", IntegerValue (dataFlitSpeedup));
@@ -270,8 +260,15 @@ main (int argc, char *argv[])
   NodeContainer nodes;
   for (unsigned int i = 0; i < numberOfNodes; ++i)
     {
-      Ptr<NocNode> nocNode = CreateObject<NocNode> ();
-      nodes.Add (nocNode);
+      if (faults)
+        {
+          nodes.Add (CreateObject<NocFaultyNode> ());
+        }
+      else
+        {
+          Ptr<NocNode> nocNode = CreateObject<NocNode> ();
+          nodes.Add (nocNode);
+        }
     }
 //  nodes.Create (numberOfNodes);
 
@@ -292,6 +289,8 @@ main (int argc, char *argv[])
       / globalClock.GetPicoSeconds ()))));
   // the channel has no propagation delay
   noc->SetChannelAttribute ("Delay", TimeValue (PicoSeconds (0)));
+  // credits travel back to the upstream routers over the same channels
+  noc->SetChannelAttribute ("CreditDelay", TimeValue (PicoSeconds (creditDelay * globalClock.GetPicoSeconds ())));
 
 // By default, we use full-duplex communication
   //  noc->SetChannelAttribute ("FullDuplex", BooleanValue (false));
@@ -330,6 +329,27 @@ main (int argc, char *argv[])
 
   noc->SetRoutingProtocol ("ns3::DorRouting");
 
+  // virtual channels (the torus wrap-around links need two VC classes in order to avoid deadlock)
+  noc->SetAttribute ("VirtualChannels", UintegerValue (virtualChannels));
+  noc->SetAttribute ("LoadSideBandPeriod", UintegerValue (loadSideBandPeriod));
+  noc->SetAttribute ("LoadSideBandLatency", UintegerValue (loadSideBandLatency));
+  if (virtualChannels >= 2)
+    {
+      noc->SetRoutingProtocolAttribute ("DatelineVirtualChannels", BooleanValue (true));
+    }
+  if (arbiter == "iSLIP")
+    {
+      noc->SetArbiter ("ns3::IslipArbiter");
+    }
+  else if (arbiter == "Age")
+    {
+      noc->SetArbiter ("ns3::AgeArbiter");
+    }
+  else
+    {
+      noc->SetArbiter ("ns3::RoundRobinArbiter");
+    }
+
   // setting the switching mechanism
 //  noc->SetSwitchingProtocol ("ns3::SafSwitching");
 //  noc->SetSwitchingProtocol ("ns3::VctSwitching");
@@ -413,13 +433,140 @@ main (int argc, char *argv[])
                   MakeBoundCallback (&FlitInjectedCallback, appFlitInjected));
   data.AddDataCalculator (appFlitInjected);
 
-  // Computes the average packet latency
-  Ptr<TimeMinMaxAvgTotalCalculator> latencyStat = CreateObject<TimeMinMaxAvgTotalCalculator>();
+  // This counter tracks how many flits are received (the accepted throughput)
+  Ptr<CounterCalculator<> > appFlitAccepted = CreateObject<CounterCalculator<> > ();
+  appFlitAccepted->SetKey ("flits-received");
+  appFlitAccepted->SetContext (context);
+  Config::Connect ("/NodeList/*/ApplicationList/*/$ns3::NocSyncApplication/FlitReceived",
+                  MakeBoundCallback (&FlitAcceptedCallback, appFlitAccepted));
+  data.AddDataCalculator (appFlitAccepted);
+
+  // Computes the packet latency (average, percentiles), while the simulation runs
+  Ptr<NocStatsCollector> latencyStat = CreateObject<NocStatsCollector> ();
   latencyStat->SetKey ("latency");
   latencyStat->SetContext (context);
-  Config::Connect ("/NodeList/*/ApplicationList/*/$ns3::NocSyncApplication/FlitReceived",
-                  MakeBoundCallback (&FlitReceivedCallback, 0));
-  data.AddDataCalculator(latencyStat);
+  latencyStat->SetAttribute ("WarmupCycles", UintegerValue (convergence ? 0 : warmupCycles));
+  latencyStat->Install (noc);
+  data.AddDataCalculator (latencyStat);
+
+  // Detects the end of the warmup and stops the simulation when the average packet latency converged
+  Ptr<NocConvergenceController> convergenceController;
+  if (convergence)
+    {
+      NS_ASSERT_MSG (replications == 0 && !faults,
+          "The convergence control can not be used with replications or with a fault campaign");
+      convergenceController = CreateObject<NocConvergenceController> ();
+      convergenceController->SetKey ("convergence");
+      convergenceController->SetContext (context);
+      convergenceController->SetAttribute ("TargetRelativeWidth", DoubleValue (convergenceTarget));
+      convergenceController->Install (latencyStat);
+      data.AddDataCalculator (convergenceController);
+    }
+
+  // Stops the simulation as soon as a set of input buffers wait for each other forever
+  Ptr<NocDeadlockDetector> deadlockDetector;
+  if (deadlockDetection)
+    {
+      deadlockDetector = CreateObject<NocDeadlockDetector> ();
+      deadlockDetector->SetKey ("deadlock");
+      deadlockDetector->SetContext (context);
+      deadlockDetector->Install (noc, nodes);
+      data.AddDataCalculator (deadlockDetector);
+    }
+
+  // Simulates every fault scenario of a reliability campaign in its own run, forked after the warmup
+  Ptr<NocFaultCampaign> faultCampaign;
+  if (faults)
+    {
+      faultCampaign = CreateObject<NocFaultCampaign> ();
+      faultCampaign->SetKey ("faults");
+      faultCampaign->SetContext (context);
+      faultCampaign->Install (nodes, latencyStat);
+      if (!faultSchedule.empty () && !faultCampaign->LoadScenarios (faultSchedule))
+        {
+          NS_FATAL_ERROR ("Could not read the fault schedule " << faultSchedule);
+        }
+      faultCampaign->GenerateScenarios (faultScenarios, simulationCycles - warmupCycles);
+      NS_ASSERT_MSG (faultCampaign->GetNScenarios () > 0, "The fault campaign has no scenarios");
+      data.AddDataCalculator (faultCampaign);
+    }
+
+  // the injection probabilities of the measurement runs
+  std::vector<double> measurementProbabilities;
+  std::istringstream probabilities (measurementInjectionProbabilities);
+  std::string probability;
+  while (std::getline (probabilities, probability, ','))
+    {
+      measurementProbabilities.push_back (atof (probability.c_str ()));
+      NS_ASSERT_MSG (measurementProbabilities.back () >= 0 && measurementProbabilities.back () <= 1,
+          "Injection probability must be in [0,1]!");
+    }
+  NS_ASSERT_MSG (measurementProbabilities.empty () || replications > 0,
+      "The measurement injection probabilities can be used only with replications");
+
+  // the warmup is simulated once, the measurement runs are forked from the warmed up simulation
+  // (or the fault scenarios are forked)
+  NocWarmupFork warmupFork (faultCampaign != 0 ? faultCampaign->GetNScenarios ()
+      : replications * std::max<uint32_t> (1, measurementProbabilities.size ()), parallelReplications);
+  std::string binaryTraceFile = binaryTrace;
+  if (replications > 0 || faultCampaign != 0)
+    {
+      NS_LOG_INFO ("Simulate the warmup.");
+      if (!warmupFork.Fork (PicoSeconds (warmupCycles * globalClock.GetPicoSeconds ())))
+        {
+          Simulator::Destroy ();
+          return warmupFork.GetFailedRuns () == 0 ? 0 : 1;
+        }
+
+      if (faultCampaign != 0)
+        {
+          faultCampaign->StartScenario (warmupFork.GetRun ());
+          data.AddMetadata ("fault-scenario", warmupFork.GetRun ());
+        }
+      else
+        {
+          uint32_t replication = warmupFork.GetRun () % replications;
+          // the replications with the same index use the same random streams, for every injection probability
+          NocWarmupFork::Reseed (SeedManager::GetSeed () + replication + 1);
+          for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); ++node)
+            {
+              for (uint32_t j = 0; j < (*node)->GetNApplications (); ++j)
+                {
+                  Ptr<NocSyncApplication> application = (*node)->GetApplication (j)->GetObject<NocSyncApplication> ();
+                  if (application != 0)
+                    {
+                      application->ResetRandomStream ();
+                    }
+                }
+            }
+          data.AddMetadata ("replication", replication);
+          if (!measurementProbabilities.empty ())
+            {
+              double measurementProbability = measurementProbabilities[warmupFork.GetRun () / replications];
+              Config::Set ("/NodeList/*/ApplicationList/*/$ns3::NocSyncApplication/InjectionProbability",
+                  DoubleValue (measurementProbability));
+              data.AddMetadata ("measurement-injection-probability", measurementProbability);
+            }
+        }
+
+      std::ostringstream runIndex;
+      runIndex << warmupFork.GetRun ();
+      data.DescribeRun (experiment, strategy, input, run + "-" + runIndex.str (), description);
+      binaryTraceFile = binaryTrace + "." + runIndex.str ();
+    }
+
+  // the binary trace is compact enough to be used for big simulations too
+  // (a replication traces only its measurement phase)
+  Ptr<NocBinaryTraceWriter> binaryTraceWriter;
+  if (!binaryTrace.empty ())
+    {
+      binaryTraceWriter = CreateObject<NocBinaryTraceWriter> ();
+      binaryTraceWriter->SetAttribute ("Compression", BooleanValue (binaryTraceCompression));
+      if (binaryTraceWriter->Open (binaryTraceFile, globalClock.GetPicoSeconds ()))
+        {
+          noc->EnableBinaryAll (binaryTraceWriter);
+        }
+    }
 
   // start the simulation
 
@@ -427,10 +574,22 @@ main (int argc, char *argv[])
   Simulator::Run ();
   NS_LOG_INFO ("Done.");
   NS_LOG_INFO ("Simulation time is " << Simulator::Now ());
+  if (convergenceController != 0)
+    {
+      NS_LOG_INFO ("The simulation " << NocConvergenceController::StatusToString (convergenceController->GetStatus ())
+          << " after " << convergenceController->GetCycles () << " cycles (the warmup ended at cycle "
+          << convergenceController->GetWarmupCycles () << ")");
+    }
+  if (deadlockDetector != 0 && deadlockDetector->GetStatus () == NocDeadlockDetector::DEADLOCKED)
+    {
+      NS_LOG_INFO ("The input buffers deadlocked:" << std::endl << deadlockDetector->GetReport ());
+    }
+  if (binaryTraceWriter != 0)
+    {
+      binaryTraceWriter->Close ();
+    }
   Simulator::Destroy ();
 
-  // this must be done after the simulation ended
-  ComputeLatenciesOfPackets (latencyStat);
 
   // Generate statistics output
 
@@ -441,7 +600,10 @@ main (int argc, char *argv[])
   // Pick an output writer based in the requested format.
   NS_LOG_INFO ("Creating sqlite formatted data output.");
   Ptr<DataOutputInterface> output = CreateObject<SqliteDataOutput> ();
+  // the replications write into the same database, one at a time
+  warmupFork.LockOutput (output->GetFilePrefix () + ".db");
   output->Output (data);
+  warmupFork.UnlockOutput ();
 
   return 0;
 }
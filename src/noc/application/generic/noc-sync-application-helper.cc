@@ -74,8 +74,6 @@ namespace ns3
   {
     Ptr<NocSyncApplication> app = m_factory.Create<NocSyncApplication> ();
     app->SetDimensionSize (m_size);
-    app->SetNetDeviceContainer (m_devices);
-    app->SetNodeContainer (m_nodes);
     node->AddApplication (app);
 
     return app;
@@ -39,6 +39,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/enum.h"
 #include <cstdlib>
+#include <math.h>
 #include <bitset>
 #include "stdio.h"
 #include "ns3/config.h"
@@ -46,6 +47,8 @@
 #include "ns3/pointer.h"
 #include "ns3/noc-value.h"
 #include "ns3/object-vector.h"
+#include "ns3/noc-cycle-engine.h"
+#include "ns3/noc-profiler.h"
 
 NS_LOG_COMPONENT_DEFINE ("NocSyncApplication");
 
@@ -175,6 +178,8 @@ namespace ns3
     m_totFlits = 0;
     m_trafficPatternEnum = BIT_COMPLEMENT;
     m_currentFlitIndex = 0;
+    m_injection = 0;
+    m_firstTx = false;
   }
 
   NocSyncApplication::~NocSyncApplication()
@@ -189,6 +194,7 @@ namespace ns3
     if (Simulator::Now () >= GetGlobalClock () * Scalar (m_warmupCycles))
       {
         NS_LOG_DEBUG ("Tracing the flit");
+        NOC_PROFILE (TRACE_CALLBACKS, GetInstanceTypeId ());
         m_flitReceivedTrace (packet);
       }
     else
@@ -210,16 +216,11 @@ namespace ns3
     m_maxBytes = maxBytes;
   }
 
-  void NocSyncApplication::SetNetDeviceContainer (NetDeviceContainer devices)
+  void NocSyncApplication::ResetRandomStream ()
   {
     NS_LOG_FUNCTION_NOARGS ();
-    m_devices = devices;
-  }
-
-  void NocSyncApplication::SetNodeContainer (NodeContainer nodes)
-  {
-    NS_LOG_FUNCTION_NOARGS ();
-    m_nodes = nodes;
+    m_trafficPattern.ResetRandomStream ();
+    m_injectionStream = RngStream ();
   }
 
   void
@@ -227,6 +228,7 @@ namespace ns3
   {
     NS_LOG_FUNCTION_NOARGS ();
 
+    m_context = 0;
     Application::DoDispose();
   }
 
@@ -236,13 +238,43 @@ namespace ns3
   {
     NS_LOG_LOGIC ("Starting the application at time " << Simulator::Now ());
 
+    // the simulation context is retrieved only once, from the NoC topology
+    PointerValue nocPointer;
+    NocRegistry::GetInstance ()->GetAttribute ("NoCTopology", nocPointer);
+    Ptr<NocTopology> nocTopology = nocPointer.Get<NocTopology> ();
+    NS_ASSERT_MSG (nocTopology != 0, "The NoC topology was not registered in NocRegistry!");
+    m_context = nocTopology->GetContext ();
+
+    // the bit permutation traffic patterns work with floor (log2 (size)) bits of every coordinate
+    m_sizeBits.clear ();
+    double log = 0;
+    for (unsigned int k = 0; k < m_size.size (); k++)
+      {
+        if (m_size.at (k)->GetValue () > 0)
+          {
+            log = log2 (m_size.at (k)->GetValue ());
+          }
+        m_sizeBits.push_back ((uint8_t) floor (log));
+        NS_LOG_DEBUG ("dimension " << (k+1) << " size " << (int) m_sizeBits.at (k));
+      }
+
     uint32_t nodeId = GetNode ()->GetId ();
     NS_LOG_DEBUG ("Tracing the flits received at node " << (int) nodeId);
     // we configure this trace here and not in the constructor, because
     // the node is not initialized yet at constructor time
-    std::stringstream ss;
-    ss << "/NodeList/" << nodeId << "/DeviceList/*/$ns3::NocNetDevice/Receive";
-    Config::Connect (ss.str (), MakeCallback (&NocSyncApplication::FlitReceivedCallback, this));
+    // the trace sources of the node's own net devices are connected directly, with the same context
+    // Config::Connect would give; resolving a /NodeList/ path copies and scans the whole node list,
+    // which makes the startup quadratic in the number of nodes
+    for (uint32_t j = 0; j < GetNode ()->GetNDevices (); j++)
+      {
+        Ptr<NocNetDevice> device = GetNode ()->GetDevice (j)->GetObject<NocNetDevice> ();
+        if (device != 0)
+          {
+            std::stringstream ss;
+            ss << "/NodeList/" << nodeId << "/DeviceList/" << j << "/$ns3::NocNetDevice/Receive";
+            device->TraceConnect ("Receive", ss.str (), MakeCallback (&NocSyncApplication::FlitReceivedCallback, this));
+          }
+      }
 
     NS_LOG_DEBUG ("Using the " << TrafficPatternToString(m_trafficPatternEnum) << " traffic pattern");
 
@@ -267,6 +299,8 @@ namespace ns3
 
     Simulator::Cancel (m_sendEvent);
     Simulator::Cancel (m_startEvent);
+    // a pending injection made through the cycle engine is ignored when it occurs
+    m_injection++;
   }
 
   // Event handlers
@@ -274,6 +308,7 @@ namespace ns3
   NocSyncApplication::StartSending ()
   {
     NS_LOG_FUNCTION_NOARGS ();
+    m_firstTx = true;
     ScheduleNextTx (); // Schedule the send flit event
   }
 
@@ -289,9 +324,8 @@ namespace ns3
   Time
   NocSyncApplication::GetGlobalClock () const
   {
-    TimeValue timeValue;
-    NocRegistry::GetInstance ()->GetAttribute ("GlobalClock", timeValue);
-    Time globalClock = timeValue.Get ();
+    NS_ASSERT_MSG (m_context != 0, "The application was not started yet (no simulation context)!");
+    Time globalClock = m_context->GetGlobalClock ();
     NS_ASSERT_MSG (!globalClock.IsZero (), "A global clock must be set!");
 
     return globalClock;
@@ -316,10 +350,11 @@ namespace ns3
           {
             Time globalClock = GetGlobalClock ();
             Time sendAtTime;
-            if (m_totBytes == 0)
+            if (m_firstTx)
               {
                 // the first flit injection event must occur with no delay
                 sendAtTime = PicoSeconds (0);
+                m_firstTx = false;
               }
             else
               {
@@ -336,12 +371,28 @@ namespace ns3
                     << "; Simulator::Now () = Simulator::Now () "
                     << "(sendAtTime = globalClock * Scalar (clockMultiplier) - Simulator::Now ())");
               }
+            if (m_currentFlitIndex == 0)
+              {
+                // the cycles without a packet injection are skipped (the data flits are injected in consecutive cycles)
+                uint64_t gap = GetInjectionGap ();
+                NS_LOG_DEBUG ("The next packet is injected after " << gap << " idle cycles");
+                sendAtTime += globalClock * Scalar (gap);
+              }
             NS_ASSERT_MSG (sendAtTime >= Scalar (0),
                "The next flit injection is scheduled to run at a time less than the current simulation time!");
             NS_LOG_DEBUG ("Schedule event (flit injection) to occur at time "
                 << Simulator::Now () + sendAtTime);
-            // Simulator::Schedule (...) receives a relative time
-            m_sendEvent = Simulator::Schedule (sendAtTime, &NocSyncApplication::SendFlit, this);
+            NocCycleEngine *engine = m_context->GetCycleEngine ();
+            if (engine != 0)
+              {
+                engine->ScheduleInjection (sendAtTime,
+                    MakeCallback (&NocSyncApplication::InjectFlit, this), m_injection);
+              }
+            else
+              {
+                // Simulator::Schedule (...) receives a relative time
+                m_sendEvent = Simulator::Schedule (sendAtTime, &NocSyncApplication::SendFlit, this);
+              }
           }
         else
           { // All done, cancel any pending events
@@ -353,6 +404,20 @@ namespace ns3
       }
   }
 
+  uint64_t
+  NocSyncApplication::GetInjectionGap ()
+  {
+    if (m_injectionProbability >= 1)
+      {
+        return 0;
+      }
+    // the number of failed Bernoulli trials before the first success, by inversion (RandU01 is in (0, 1))
+    double gap = floor (log (m_injectionStream.RandU01 ()) / log (1 - m_injectionProbability));
+    // a (practically) infinite gap must still be a valid simulation time
+    const double maxGap = 1e12;
+    return gap < maxGap ? (uint64_t) gap : (uint64_t) maxGap;
+  }
+
   void
   NocSyncApplication::ScheduleStartEvent ()
   {
@@ -361,6 +426,22 @@ namespace ns3
     m_startEvent = Simulator::ScheduleNow (&NocSyncApplication::StartSending, this);
   }
 
+  void
+  NocSyncApplication::InjectFlit (uint64_t injection)
+  {
+    NS_LOG_FUNCTION (injection);
+
+    if (injection == m_injection)
+      {
+        m_injection++;
+        SendFlit ();
+      }
+    else
+      {
+        NS_LOG_DEBUG ("The flit injection " << injection << " was cancelled");
+      }
+  }
+
   void
   NocSyncApplication::SendFlit ()
   {
@@ -371,73 +452,27 @@ namespace ns3
     Ptr<NocNode> sourceNode = GetNode ()->GetObject<NocNode> ();
     uint32_t sourceNodeId = sourceNode->GetId ();
 
-    std::vector <uint8_t> source=vector<uint8_t> ();
-    uint32_t numberOfNodes=1;
-
-    for (unsigned int k = 0; k < m_size.size (); k++)
-      {
-        if (m_size.at (k)->GetValue () != 0)
-          {
-            if (k != 0)
-              {
-                numberOfNodes *= m_size.at (k - 1)->GetValue();
-              }
-            else
-              {
-                numberOfNodes = 1;
-              }
-            source.insert(source.end(), sourceNodeId / numberOfNodes % m_size.at (k)->GetValue());
-          }
-        else
-          {
-            source.at (k) = 0;
-          }
-        NS_LOG_DEBUG ("dimension " << (k+1) << " source " << (int) source.at (k));
-      }
-
-    std::vector <uint32_t> destination=vector<uint32_t> ();
-
-    double log = 0;
-    std::vector<uint8_t> size = vector<uint8_t> ();
-    for (unsigned int k = 0; k < m_size.size (); k++)
-      {
-        if (m_size.at (k)->GetValue() > 0)
-          {
-            log = log2 (m_size.at (k)->GetValue());
-          }
-        size.insert (size.end (), (uint8_t) floor (log));
-        NS_LOG_DEBUG ("dimension " << (k+1) << " size " << (int) size.at (k));
-      }
-
-    numberOfNodes=1;
+    // the coordinates are taken from the topology tables, so no memory is allocated for injecting a flit
+    Ptr<NocTopology> nocTopology = m_context->GetTopology ();
+    uint32_t dimensions = m_size.size ();
+    NS_ASSERT_MSG (dimensions == nocTopology->GetNumberOfDimensions (), "The application has " << dimensions
+        << " dimensions but the topology has " << nocTopology->GetNumberOfDimensions ());
+    const uint32_t *source = nocTopology->GetNodeCoordinates (sourceNodeId);
+    uint32_t destination[NocHeader::MAX_DIMENSIONS];
 
     switch (m_trafficPatternEnum)
       {
         case DESTINATION_SPECIFIED:
-          for (unsigned int k = 0; k < m_size.size (); k++)
+          for (unsigned int k = 0; k < dimensions; k++)
             {
-              if (m_size.at (k)->GetValue () != 0)
-                {
-                  if (k != 0)
-                    {
-                      numberOfNodes *= m_size.at (k - 1)->GetValue();
-                    }
-                  else
-                    {
-                      numberOfNodes = 1;
-                    }
-                  destination.insert (destination.end(), m_destinationNodeId / numberOfNodes % m_size.at (k)->GetValue());
-                }
-              else
-                {
-                  source.at (k) = 0;
-                }NS_LOG_DEBUG ("dimension "<<(k+1)<<" specified destination " <<(int) destination.at(k)); NS_ASSERT (destination.at(k) < m_size.at(k)->GetValue());
+              destination[k] = m_destinationNodeId / nocTopology->GetDimensionStride (k) % m_size.at (k)->GetValue ();
+              NS_LOG_DEBUG ("dimension "<<(k+1)<<" specified destination " <<(int) destination[k]);
             }
       break;
         case UNIFORM_RANDOM:
           if (m_currentFlitIndex == 0)
             {
-              for (unsigned int k = 0; k < m_size.size (); k++)
+              for (unsigned int k = 0; k < dimensions; k++)
                 {
                   if (m_uniformDestination.size () <= k)
                     {
@@ -451,73 +486,51 @@ namespace ns3
                     }
                 }
             }
-          for (unsigned int k = 0; k < m_size.size (); k++)
+          for (unsigned int k = 0; k < dimensions; k++)
             {
-              destination.insert (destination.end (), m_uniformDestination.at (k));
-              NS_LOG_DEBUG("dimension "<<(k+1)<<" random destination = "<<(int) destination.at(k));
-              NS_ASSERT (destination.at(k) < m_size.at(k)->GetValue());
+              destination[k] = m_uniformDestination.at (k);
+              NS_LOG_DEBUG("dimension "<<(k+1)<<" random destination = "<<(int) destination[k]);
             }
           break;
 
         case BIT_MATRIX_TRANSPOSE:
-          for (unsigned int k = 0; k < m_size.size (); k++)
+          for (unsigned int k = 0; k < dimensions; k++)
             {
-              destination.insert(destination.end(), ns3::TrafficPattern::MatrixTransposeBits(source.at(k), size.at(k)));
-              NS_ASSERT (destination.at(k) < m_size.at(k)->GetValue());
+              destination[k] = ns3::TrafficPattern::MatrixTransposeBits (source[k], m_sizeBits[k]);
             }
           break;
 
         case BIT_COMPLEMENT:
-          for (unsigned int k = 0; k < m_size.size (); k++)
+          for (unsigned int k = 0; k < dimensions; k++)
             {
-              destination.insert (destination.end (), ns3::TrafficPattern::ComplementBits(source.at (k), size.at (k)));
-              NS_ASSERT (destination.at(k) < m_size.at(k)->GetValue());
+              destination[k] = ns3::TrafficPattern::ComplementBits (source[k], m_sizeBits[k]);
             }
           break;
 
         case BIT_REVERSE:
-          for (unsigned int k = 0; k < m_size.size (); k++)
+          for (unsigned int k = 0; k < dimensions; k++)
            {
-             destination.insert(destination.end(), ns3::TrafficPattern::ReverseBits(source.at(k), size.at(k)));
-             NS_ASSERT (destination.at(k) < m_size.at(k)->GetValue());
+             destination[k] = ns3::TrafficPattern::ReverseBits (source[k], m_sizeBits[k]);
            };
           break;
 
         default:
+          for (unsigned int k = 0; k < dimensions; k++)
+            {
+              destination[k] = source[k];
+            }
           break;
       }
-
-    uint32_t destinationNodeId=0;
-    numberOfNodes=1;
-    for (unsigned int k = 0; k < m_size.size (); k++)
+    for (unsigned int k = 0; k < dimensions; k++)
       {
-        if (m_size.at (k)->GetValue () != 0)
-          {
-            if (k != 0)
-              {
-                numberOfNodes *= m_size.at (k - 1)->GetValue ();
-              }
-            else
-              {
-                numberOfNodes = 1;
-              }
-            destinationNodeId += destination.at (k) * numberOfNodes;
-          }
+        NS_ASSERT (destination[k] < m_size.at (k)->GetValue ());
       }
 
+    uint32_t destinationNodeId = nocTopology->GetNodeId (destination);
+
     NS_LOG_DEBUG ("destinationNodeId = " << destinationNodeId);
 
-    Ptr<NocNode> destinationNode;
-    for (NetDeviceContainer::Iterator i = m_devices.Begin(); i
-        != m_devices.End(); ++i)
-      {
-        Ptr<Node> tmpNode = (*i)->GetNode();
-        if (destinationNodeId == tmpNode->GetId())
-          {
-            destinationNode = tmpNode->GetObject<NocNode> ();
-            break;
-          }
-      }
+    Ptr<NocNode> destinationNode = m_context->GetTopology ()->GetNocNode (destinationNodeId);
     if (sourceNodeId == destinationNodeId)
       {
         NS_LOG_LOGIC ("Trying to send a packet from node " << sourceNodeId << " to node "
@@ -531,51 +544,38 @@ namespace ns3
       {
         NS_LOG_LOGIC ("A flit is sent from node " << sourceNodeId << " to node " << destinationNodeId);
 
-        PointerValue nocPointer;
-        NocRegistry::GetInstance ()->GetAttribute ("NoCTopology", nocPointer);
-        Ptr<NocTopology> nocTopology = nocPointer.Get<NocTopology> ();
-        NS_ASSERT_MSG (nocTopology != 0, "The NoC topology was not registered in NocRegistry!");
-        std::vector<uint8_t> relativePositions = nocTopology->GetDestinationRelativeDimensionalPosition (sourceNodeId,
-            destinationNodeId);
-        std::vector <uint8_t> relative=vector<uint8_t>();
-
-        for (unsigned int k = 0; k < relativePositions.size (); k++)
+        NocCoordinate relative[NocHeader::MAX_DIMENSIONS];
+        nocTopology->GetDestinationRelativePosition (sourceNodeId, destinationNodeId, relative);
+        NocCoordinate sourceCoordinates[NocHeader::MAX_DIMENSIONS];
+        for (unsigned int k = 0; k < dimensions; k++)
           {
-            relative.insert(relative.end(), relativePositions.at(k));
-            NS_LOG_DEBUG ("dimension "<<(k+1)<<" relative = " << (int) relative.at(k));
+            sourceCoordinates[k] = source[k];
+            NS_LOG_DEBUG ("dimension "<<(k+1)<<" relative = " << (int) relative[k]);
           }
 
         NS_ASSERT_MSG (m_numberOfFlits >= 1,
             "The number of flits must be at least 1 (the head flit) but it is " << m_numberOfFlits);
         if (m_currentFlitIndex == 0)
           {
-            int randomValue = rand ();
-            randomValue = randomValue % 100 + 1; // 1 .. 100
-            if (randomValue <= m_injectionProbability * 100)
-              {
-                NS_LOG_LOGIC ("A new packet is injected into the network (injection probability is "
-                    << m_injectionProbability << ")");
-
-                NS_ASSERT_MSG (m_flitSize >= (uint64_t) NocHeader::GetHeaderSize(),
-                    "The flit size must be at least " << NocHeader::GetHeaderSize()
-                    << " bytes (the packet header size), but it is " << m_flitSize << "!");
-                m_currentHeadFlit = Create<NocPacket> (relative, source, m_numberOfFlits - 1, (m_flitSize
-                    - NocHeader::GetHeaderSize ()));
-                NS_LOG_LOGIC ("Preparing to inject packet " << *m_currentHeadFlit);
-                if (Simulator::Now () >= GetGlobalClock () * Scalar (m_warmupCycles))
-                  {
-                    m_flitInjectedTrace (m_currentHeadFlit);
-                  }
-                sourceNode->InjectPacket (m_currentHeadFlit, destinationNode);
-                m_currentFlitIndex++;
-                m_totBytes += m_flitSize - NocHeader::GetHeaderSize();
-                NS_LOG_DEBUG ("m_totBytes " << m_totBytes);
-              }
-            else
+            // this clock cycle was chosen by GetInjectionGap
+            NS_LOG_LOGIC ("A new packet is injected into the network (injection probability is "
+                << m_injectionProbability << ")");
+
+            NS_ASSERT_MSG (m_flitSize >= (uint64_t) NocHeader::GetHeaderSize(),
+                "The flit size must be at least " << NocHeader::GetHeaderSize()
+                << " bytes (the packet header size), but it is " << m_flitSize << "!");
+            m_currentHeadFlit = Create<NocPacket> (relative, sourceCoordinates, dimensions, m_numberOfFlits - 1,
+                (m_flitSize - NocHeader::GetHeaderSize ()));
+            NS_LOG_LOGIC ("Preparing to inject packet " << *m_currentHeadFlit);
+            if (Simulator::Now () >= GetGlobalClock () * Scalar (m_warmupCycles))
               {
-                NS_LOG_LOGIC ("A new packet is not injected into the network (injection probability is "
-                    << m_injectionProbability << ")");
+                NOC_PROFILE (TRACE_CALLBACKS, GetInstanceTypeId ());
+                m_flitInjectedTrace (m_currentHeadFlit);
               }
+            sourceNode->InjectPacket (m_currentHeadFlit, destinationNode);
+            m_currentFlitIndex++;
+            m_totBytes += m_flitSize - NocHeader::GetHeaderSize();
+            NS_LOG_DEBUG ("m_totBytes " << m_totBytes);
           }
         else
           {
@@ -592,6 +592,7 @@ namespace ns3
             Ptr<NocPacket> dataFlit = Create<NocPacket> (m_currentHeadFlit->GetUid (), m_flitSize, isTail);
             if (Simulator::Now () >= GetGlobalClock () * Scalar (m_warmupCycles))
               {
+                NOC_PROFILE (TRACE_CALLBACKS, GetInstanceTypeId ());
                 m_flitInjectedTrace (dataFlit);
               }
             sourceNode->InjectPacket (dataFlit, destinationNode);
@@ -604,6 +605,7 @@ namespace ns3
             if (Simulator::Now () >= GetGlobalClock () * Scalar (m_warmupCycles))
               {
                 NS_LOG_DEBUG ("An entire packet was injected into the network");              
+                NOC_PROFILE (TRACE_CALLBACKS, GetInstanceTypeId ());
                 m_packetInjectedTrace (m_currentHeadFlit);
               }
               m_currentFlitIndex = 0;
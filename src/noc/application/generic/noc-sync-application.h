@@ -30,7 +30,9 @@
 #include "ns3/node-container.h"
 #include "ns3/net-device-container.h"
 #include "ns3/noc-packet.h"
+#include "ns3/noc-simulation-context.h"
 #include "ns3/traffic-pattern.h"
+#include "ns3/rng-stream.h"
 #include "ns3/noc-value.h"
 
 namespace ns3 {
@@ -105,11 +107,12 @@ public:
   void
   SetMaxBytes (uint32_t maxBytes);
 
+  /**
+   * Replaces the random streams used to pick the injection cycles and the destinations with new ones
+   * (created from the current seed of the package).
+   */
   void
-  SetNetDeviceContainer (NetDeviceContainer devices);
-
-  void
-  SetNodeContainer (NodeContainer nodes);
+  ResetRandomStream ();
 
 protected:
 
@@ -138,9 +141,25 @@ private:
   void
   SendFlit ();
 
+  /**
+   * Flit injection event, used when the NoC is cycle driven.
+   *
+   * \param injection identifies the injection (it is ignored if it was cancelled meanwhile)
+   */
+  void
+  InjectFlit (uint64_t injection);
+
+  /**
+   * A packet is injected in a clock cycle with the injection probability, independently of the other cycles
+   * (Bernoulli trials). Instead of a trial for every cycle, the number of cycles until the next injection
+   * is sampled directly, from the geometric distribution.
+   *
+   * \return how many clock cycles are skipped until the next packet injection (0 means the current one)
+   */
+  uint64_t
+  GetInjectionGap ();
+
   std::vector<Ptr<NocValue> > m_size;           // The dimensions size of a nD mesh (how many nodes can be put on each dimension).
-  NetDeviceContainer m_devices;                 // the net devices from the NoC network
-  NodeContainer      m_nodes;                   // the nodes from the NoC network
   double             m_injectionProbability;    // The injection probability
   uint32_t           m_flitSize;                // The flit size, in bytes
   uint16_t           m_numberOfFlits;           // How many flits a message will have
@@ -153,8 +172,12 @@ private:
   uint32_t           m_warmupCycles;            // During warmup cycles, no statistics are collected
   EventId            m_startEvent;              // Event id for next start event
   EventId            m_sendEvent;               // Event id of pending send packet event
+  uint64_t           m_injection;               // Identifies the pending flit injection (cycle driven NoC)
+  RngStream          m_injectionStream;         // decides the clock cycles when packets are injected
+  bool               m_firstTx;                 // whether or not the next injection is the first one since the start
   ns3::TrafficPattern    m_trafficPattern;
   std::vector<uint32_t> m_uniformDestination;   // the coordinates of the last destination node (generated in an uniform random manner)
+  std::vector<uint8_t> m_sizeBits;              // how many bits the bit permutation traffic patterns use, for each dimension
   
   /**
    * Allows tracing injected packets into the network.
@@ -185,6 +208,11 @@ private:
 
 private:
 
+  /**
+   * the simulation context of the NoC topology (retrieved when the application starts)
+   */
+  Ptr<NocSimulationContext> m_context;
+
   Time
   GetGlobalClock () const;
 
@@ -29,6 +29,11 @@
 #include "ns3/string.h"
 #include "ns3/uinteger.h"
 #include "ns3/names.h"
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
 
 NS_LOG_COMPONENT_DEFINE ("NocCtgApplicationHelper");
 
@@ -39,6 +44,7 @@ namespace ns3
       uint64_t simulationCycles, NodeContainer nodes, NetDeviceContainer devices, uint32_t hSize)
   {
     m_mappingXmlFilePath = mappingXmlFilePath;
+    m_cacheFilePath = mappingXmlFilePath + ".cache";
     m_iterations = iterations;
     m_numberOfFlits = numberOfFlits;
     m_simulationCycles = simulationCycles;
@@ -77,36 +83,73 @@ namespace ns3
     return theApcgCoreType;
   }
 
-  string
-  NocCtgApplicationHelper::FindNodeIdForTask (apcgType theApcgType, mappingType theMappingType, string taskId)
+  void
+  NocCtgApplicationHelper::CompileCtg (const apcgType &theApcgType, const mappingType &theMappingType,
+      const ctgType &theCtgType)
   {
     NS_LOG_FUNCTION_NOARGS ();
 
-    string nodeId = "";
+    if (m_compiledApcgId == theApcgType.id ())
+      {
+        NS_LOG_LOGIC ("The CTG of APCG " << m_compiledApcgId << " is already compiled");
+        return;
+      }
 
-    for (apcgType::core_iterator i (theApcgType.core ().begin ()); i != theApcgType.core ().end (); i++)
+    m_taskNodeIds.clear ();
+    m_taskCommunications.clear ();
+
+    // the first mapping of an APCG core decides its node
+    map<string, string> coreNodeIds;
+    for (mappingType::map_const_iterator k (theMappingType.map ().begin ()); k != theMappingType.map ().end (); k++)
       {
-        apcgType::core_type theCoreType = *i;
+        if (k->apcg () == theApcgType.id () && k->core ().present ())
+          {
+            coreNodeIds.insert (make_pair (string (k->core ().get ()), string (k->node ())));
+          }
+      }
+
+    // the first (mapped) core of a task decides its node
+    for (apcgType::core_const_iterator i (theApcgType.core ().begin ()); i != theApcgType.core ().end (); i++)
+      {
+        map<string, string>::iterator it = coreNodeIds.find (i->uid ());
+        if (it == coreNodeIds.end ())
+          {
+            continue;
+          }
         for (apcgType::core_type::task_const_iterator j (i->task ().begin ()); j != i->task ().end (); j++)
           {
-            apcgType::core_type::task_type theApcgTaskType = *j;
-            if (taskId == theApcgTaskType.id ())
-              {
-                for (mappingType::map_const_iterator k (theMappingType.map ().begin ()); k != theMappingType.map ().end (); k++)
-                  {
-                    mapType theMapType = *k;
+            m_taskNodeIds.insert (make_pair (string (j->id ()), it->second));
+          }
+      }
 
-                    if (theMapType.apcg () == theApcgType.id() && theMapType.core ().get () == theCoreType.uid ())
-                      {
-                        nodeId = theMapType.node ();
-                        goto done;
-                      }
-                  }
-              }
+    for (uint32_t c = 0; c < theCtgType.communication ().size (); c++)
+      {
+        string sourceTaskId = theCtgType.communication ()[c].source ().id ();
+        string destinationTaskId = theCtgType.communication ()[c].destination ().id ();
+        m_taskCommunications[sourceTaskId].push_back (c);
+        if (destinationTaskId != sourceTaskId)
+          {
+            m_taskCommunications[destinationTaskId].push_back (c);
           }
       }
 
-    done:
+    m_compiledApcgId = theApcgType.id ();
+    NS_LOG_LOGIC ("Compiled the CTG of APCG " << m_compiledApcgId << ": " << m_taskNodeIds.size ()
+        << " mapped tasks, " << theCtgType.communication ().size () << " communications");
+  }
+
+  string
+  NocCtgApplicationHelper::FindNodeIdForTask (string taskId)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    string nodeId = "";
+
+    map<string, string>::iterator it = m_taskNodeIds.find (taskId);
+    if (it != m_taskNodeIds.end ())
+      {
+        nodeId = it->second;
+      }
 
     if ("" == nodeId)
       {
@@ -131,11 +174,37 @@ namespace ns3
   void
   NocCtgApplicationHelper::Initialize()
   {
-    try
+    NS_LOG_INFO ("Initializing a CTG application for XML mapping " << m_mappingXmlFilePath);
+
+    list<CtgInstallation> installations;
+    if (!LoadCache (installations))
       {
-        NS_LOG_INFO ("Initializing a CTG application for XML mapping " << m_mappingXmlFilePath);
+        set<string> inputFiles;
+        if (ReadXml (installations, inputFiles))
+          {
+            SaveCache (installations, inputFiles);
+          }
+      }
+
+    for (list<CtgInstallation>::iterator it = installations.begin (); it != installations.end (); it++)
+      {
+        InstallCtg (*it);
+      }
+  }
+
+  void
+  NocCtgApplicationHelper::SetCacheFilePath (string cacheFilePath)
+  {
+    m_cacheFilePath = cacheFilePath;
+  }
 
+  bool
+  NocCtgApplicationHelper::ReadXml (list<CtgInstallation> &installations, set<string> &inputFiles)
+  {
+    try
+      {
         // parse the mapping XML
+        inputFiles.insert (m_mappingXmlFilePath);
         auto_ptr<mappingType> theMappingType (research::noc::application_mapping::unified_framework::schema::mapping::mapping (
             m_mappingXmlFilePath, flags::dont_validate));
 
@@ -152,6 +221,7 @@ namespace ns3
             NS_LOG_LOGIC ("APCG XML file path is " << apcgXmlFilePath);
 
             // parse the APCG XML
+            inputFiles.insert (apcgXmlFilePath);
             auto_ptr<apcgType> theApcgType (research::noc::application_mapping::unified_framework::schema::apcg::apcg (
                 apcgXmlFilePath, flags::dont_validate));
 
@@ -161,6 +231,7 @@ namespace ns3
 
             string ctgXmlFilePath = ctgFilePath + FILE_SEPARATOR + "ctg-" + theApcgType->ctg () + ".xml";
             NS_LOG_LOGIC ("CTG XML file path is " << ctgXmlFilePath);
+            inputFiles.insert (ctgXmlFilePath);
 
             // parse the CTG XML
             auto_ptr<ctgType> theCtgType (research::noc::application_mapping::unified_framework::schema::ctg::ctg (ctgXmlFilePath,
@@ -170,6 +241,8 @@ namespace ns3
                 "APCG XML says the CTG ID is " << theApcgType->ctg ()
                 << " but, CTG XML says the CTG ID is " << theCtgType->id () << "!");
 
+            CompileCtg (*theApcgType, *theMappingType, *theCtgType);
+
             // extract all required information from all XMLs
             string coresFilePath = ctgFilePath.substr (0, ctgFilePath.find_last_of (FILE_SEPARATOR) + 1) + "cores";
 
@@ -183,6 +256,7 @@ namespace ns3
 
             string coreXmlFilePath = coresFilePath + FILE_SEPARATOR + "core-" + theApcgCoreType.id () + ".xml";
             NS_LOG_LOGIC ("IP core XML file path is " << coreXmlFilePath);
+            inputFiles.insert (coreXmlFilePath);
 
             auto_ptr<research::noc::application_mapping::unified_framework::schema::core::coreType> theCoreType (
                 research::noc::application_mapping::unified_framework::schema::core::core (coreXmlFilePath,
@@ -217,6 +291,7 @@ namespace ns3
 
                 string taskXmlFilePath = tasksFilePath + FILE_SEPARATOR + "task-" + theApcgTaskType.id () + ".xml";
                 NS_LOG_LOGIC ("Task XML file path is " << taskXmlFilePath);
+                inputFiles.insert (taskXmlFilePath);
 
                 auto_ptr<research::noc::application_mapping::unified_framework::schema::task::taskType> theTaskType (
                     research::noc::application_mapping::unified_framework::schema::task::task (taskXmlFilePath,
@@ -252,107 +327,441 @@ namespace ns3
                 taskList.insert (taskList.end (), *taskData);
 
                 // build the task source and destination lists
-                for (ctgType::communication_const_iterator i (theCtgType->communication ().begin ()); i
-                    != theCtgType->communication ().end (); i++)
+                vector<uint32_t> &taskCommunications = m_taskCommunications[taskData->GetId ()];
+                for (uint32_t c = 0; c < taskCommunications.size (); c++)
                   {
-                    ctgType::communication_type theCommunicationType = *i;
+                    const ctgType::communication_type &theCommunicationType = theCtgType->communication ()[taskCommunications[c]];
 
-                    if (theCommunicationType.source ().id () == taskData->GetId () || theCommunicationType.destination ().id ()
-                        == taskData->GetId ())
+                    NS_LOG_INFO ("\tsource task: " << theCommunicationType.source ().id ());
+                    for (research::noc::application_mapping::unified_framework::schema::ctg::communicatingTaskType::deadline_const_iterator
+                        i (theCommunicationType.source ().deadline ().begin ()); i
+                        != theCommunicationType.source ().deadline ().end (); i++)
                       {
-                        NS_LOG_INFO ("\tsource task: " << theCommunicationType.source ().id ());
-                        for (research::noc::application_mapping::unified_framework::schema::ctg::communicatingTaskType::deadline_const_iterator
-                            i (theCommunicationType.source ().deadline ().begin ()); i
-                            != theCommunicationType.source ().deadline ().end (); i++)
-                          {
-                            research::noc::application_mapping::unified_framework::schema::ctg::communicatingTaskType::deadline_type
-                                deadline = *i;
-                            NS_LOG_INFO ("\t\tdeadline: " << deadline.type () << " at " << deadline << " (ms)");
-                          }NS_LOG_INFO ("\tdestination task: " << theCommunicationType.destination ().id ());
-
-                        for (research::noc::application_mapping::unified_framework::schema::ctg::communicatingTaskType::deadline_const_iterator
-                            i (theCommunicationType.destination ().deadline ().begin ()); i
-                            != theCommunicationType.destination ().deadline ().end (); i++)
-                          {
-                            research::noc::application_mapping::unified_framework::schema::ctg::communicatingTaskType::deadline_type
-                                deadline = *i;
-                            NS_LOG_INFO ("\t\tdeadline: " << deadline.type () << " at " << deadline << " (ms)");
-                          }
-
-                        NS_LOG_INFO ("\tcommunication volume: " << theCommunicationType.volume () << " (bits)");
-
-                        uint32_t sourceNodeId;
-                        if (!FromString<uint32_t> (sourceNodeId, FindNodeIdForTask (*theApcgType, *theMappingType,
-                            theCommunicationType.source ().id ()), std::dec))
-                          {
-                            NS_LOG_ERROR ("The source node ID is not a number");
-                          }
-
-                        uint32_t destinationNodeId;
-                        if (!FromString<uint32_t> (destinationNodeId, FindNodeIdForTask (*theApcgType, *theMappingType,
-                            theCommunicationType.destination ().id ()), std::dec))
-                          {
-                            NS_LOG_ERROR ("The destination node ID is not a number");
-                          }
-
-                        NocCtgApplication::DependentTaskData dependentTaskData = NocCtgApplication::DependentTaskData (
-                            theCommunicationType.source ().id (), sourceNodeId, theCommunicationType.volume (),
-                            theCommunicationType.destination ().id (), destinationNodeId);
-
-                        if (theCommunicationType.destination ().id () == taskData->GetId ())
-                          {
-                            NS_LOG_DEBUG ("Inserting in the remote task list");
-
-                            remoteTaskList.insert (remoteTaskList.end (), dependentTaskData);
-                          }
-                        if (theCommunicationType.source ().id () == taskData->GetId ())
-                          {
-                            NS_LOG_DEBUG ("Inserting in the local task list");
-
-                            localTakList.insert (localTakList.end (), dependentTaskData);
-                          }
+                        research::noc::application_mapping::unified_framework::schema::ctg::communicatingTaskType::deadline_type
+                            deadline = *i;
+                        NS_LOG_INFO ("\t\tdeadline: " << deadline.type () << " at " << deadline << " (ms)");
+                      }NS_LOG_INFO ("\tdestination task: " << theCommunicationType.destination ().id ());
+
+                    for (research::noc::application_mapping::unified_framework::schema::ctg::communicatingTaskType::deadline_const_iterator
+                        i (theCommunicationType.destination ().deadline ().begin ()); i
+                        != theCommunicationType.destination ().deadline ().end (); i++)
+                      {
+                        research::noc::application_mapping::unified_framework::schema::ctg::communicatingTaskType::deadline_type
+                            deadline = *i;
+                        NS_LOG_INFO ("\t\tdeadline: " << deadline.type () << " at " << deadline << " (ms)");
                       }
-                  }
-              }
 
-            m_coreDataList.insert (m_coreDataList.end (), coreData);
+                    NS_LOG_INFO ("\tcommunication volume: " << theCommunicationType.volume () << " (bits)");
 
-            SetAttribute ("Period", TimeValue (Seconds (theCtgType->period ().get ())));
-            //          SetAttribute ("MaxFlits", UintegerValue (100));
-            m_taskList = taskList;
-            m_remoteTaskList = remoteTaskList;
-            m_localTaskList = localTakList;
+                    uint32_t sourceNodeId;
+                    if (!FromString<uint32_t> (sourceNodeId, FindNodeIdForTask (
+                        theCommunicationType.source ().id ()), std::dec))
+                      {
+                        NS_LOG_ERROR ("The source node ID is not a number");
+                      }
+
+                    uint32_t destinationNodeId;
+                    if (!FromString<uint32_t> (destinationNodeId, FindNodeIdForTask (
+                        theCommunicationType.destination ().id ()), std::dec))
+                      {
+                        NS_LOG_ERROR ("The destination node ID is not a number");
+                      }
+
+                    NocCtgApplication::DependentTaskData dependentTaskData = NocCtgApplication::DependentTaskData (
+                        theCommunicationType.source ().id (), sourceNodeId, theCommunicationType.volume (),
+                        theCommunicationType.destination ().id (), destinationNodeId);
+
+                    if (theCommunicationType.destination ().id () == taskData->GetId ())
+                      {
+                        NS_LOG_DEBUG ("Inserting in the remote task list");
 
-            uint32_t nodeId;
-            if (!FromString<uint32_t> (nodeId, theMapType.node (), std::dec))
+                        remoteTaskList.insert (remoteTaskList.end (), dependentTaskData);
+                      }
+                    if (theCommunicationType.source ().id () == taskData->GetId ())
+                      {
+                        NS_LOG_DEBUG ("Inserting in the local task list");
+
+                        localTakList.insert (localTakList.end (), dependentTaskData);
+                      }
+                  }
+              }
+
+            CtgInstallation installation;
+            if (!FromString<uint32_t> (installation.m_nodeId, theMapType.node (), std::dec))
               {
                 NS_LOG_ERROR ("The node ID " << theMapType.node () << " is not a number");
               }
+            installation.m_period = Seconds (theCtgType->period ().get ());
+            installation.m_coreData = coreData;
+            installation.m_taskList = taskList;
+            installation.m_remoteTaskList = remoteTaskList;
+            installation.m_localTaskList = localTakList;
+            installations.push_back (installation);
+          }
+      }
+    catch (const xml_schema::exception& e)
+      {
+        NS_LOG_ERROR (e);
+        return false;
+      }
+    return true;
+  }
+
+  void
+  NocCtgApplicationHelper::InstallCtg (const CtgInstallation &installation)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    m_coreDataList.insert (m_coreDataList.end (), installation.m_coreData);
 
-            NS_ASSERT_MSG (m_nodes.GetN () > nodeId, "Cannot find NoC node "
-                << nodeId << " because the NoC has only " << m_nodes.GetN () << " nodes. Check to see if this mapping is for this NoC topology!");
+    SetAttribute ("Period", TimeValue (installation.m_period));
+    //          SetAttribute ("MaxFlits", UintegerValue (100));
+    m_taskList = installation.m_taskList;
+    m_remoteTaskList = installation.m_remoteTaskList;
+    m_localTaskList = installation.m_localTaskList;
 
-            ApplicationContainer apps = Install (m_nodes.Get (nodeId)); // source
-            uint64_t startTime = 0;
-            apps.Start (PicoSeconds (startTime));
-            //          apps.Stop (PicoSeconds (10.0));
-            //          // the application can also be limited by MaxPackets (the two ways of ending the application are equivalent)
-            //          apps.Stop (PicoSeconds ((uint64_t) (m_simulationCycles * globalClock + startTime))); // stop = simulationCycles * globalClock + start
+    uint32_t nodeId = installation.m_nodeId;
+    NS_ASSERT_MSG (m_nodes.GetN () > nodeId, "Cannot find NoC node "
+        << nodeId << " because the NoC has only " << m_nodes.GetN () << " nodes. Check to see if this mapping is for this NoC topology!");
 
+    ApplicationContainer apps = Install (m_nodes.Get (nodeId)); // source
+    uint64_t startTime = 0;
+    apps.Start (PicoSeconds (startTime));
+    //          apps.Stop (PicoSeconds (10.0));
+    //          // the application can also be limited by MaxPackets (the two ways of ending the application are equivalent)
+    //          apps.Stop (PicoSeconds ((uint64_t) (m_simulationCycles * globalClock + startTime))); // stop = simulationCycles * globalClock + start
+  }
+
+  /** identifies the binary cache files */
+  static const char CACHE_MAGIC[8] = { 'N', 'O', 'C', 'C', 'T', 'G', 'C', '\0' };
+
+  /** the version of the binary cache format (to be increased when the format changes) */
+  static const uint32_t CACHE_VERSION = 1;
+
+  /** the cache is written in host byte order: this marker rejects caches written on a different machine */
+  static const uint32_t CACHE_BYTE_ORDER = 0x01020304;
+
+  /**
+   * Computes the size and the FNV-1a hash of the content of a file
+   *
+   * \return false if the file cannot be read
+   */
+  static bool
+  HashFile (string filePath, uint64_t &size, uint64_t &hash)
+  {
+    ifstream file (filePath.c_str (), ios::in | ios::binary);
+    if (!file)
+      {
+        return false;
+      }
+    size = 0;
+    hash = 14695981039346656037ULL;
+    char buffer[65536];
+    while (file)
+      {
+        file.read (buffer, sizeof (buffer));
+        streamsize n = file.gcount ();
+        for (streamsize i = 0; i < n; i++)
+          {
+            hash = (hash ^ (uint8_t) buffer[i]) * 1099511628211ULL;
           }
+        size += n;
       }
-    catch (const xml_schema::exception& e)
+    return file.eof ();
+  }
+
+  template<class T>
+  static void
+  WriteCacheValue (ostream &os, T value)
+  {
+    os.write ((const char *) &value, sizeof (T));
+  }
+
+  template<class T>
+  static bool
+  ReadCacheValue (istream &is, T &value)
+  {
+    is.read ((char *) &value, sizeof (T));
+    return is.good ();
+  }
+
+  static void
+  WriteCacheString (ostream &os, const string &value)
+  {
+    WriteCacheValue<uint32_t> (os, value.size ());
+    os.write (value.data (), value.size ());
+  }
+
+  static bool
+  ReadCacheString (istream &is, string &value)
+  {
+    uint32_t size;
+    if (!ReadCacheValue (is, size))
       {
-        NS_LOG_ERROR (e);
+        return false;
+      }
+    value.resize (size);
+    if (size > 0)
+      {
+        is.read (&value[0], size);
+      }
+    return is.good ();
+  }
+
+  static void
+  WriteCacheMap (ostream &os, const map<string, double> &values)
+  {
+    WriteCacheValue<uint32_t> (os, values.size ());
+    for (map<string, double>::const_iterator it = values.begin (); it != values.end (); it++)
+      {
+        WriteCacheString (os, it->first);
+        WriteCacheValue (os, it->second);
+      }
+  }
+
+  static bool
+  ReadCacheMap (istream &is, map<string, double> &values)
+  {
+    uint32_t n;
+    if (!ReadCacheValue (is, n))
+      {
+        return false;
+      }
+    for (uint32_t i = 0; i < n; i++)
+      {
+        string key;
+        double value;
+        if (!ReadCacheString (is, key) || !ReadCacheValue (is, value))
+          {
+            return false;
+          }
+        values[key] = value;
+      }
+    return true;
+  }
+
+  static void
+  WriteCacheDependencies (ostream &os, const list<NocCtgApplication::DependentTaskData> &dependencies)
+  {
+    WriteCacheValue<uint32_t> (os, dependencies.size ());
+    for (list<NocCtgApplication::DependentTaskData>::const_iterator it = dependencies.begin (); it != dependencies.end (); it++)
+      {
+        // the DependentTaskData getters are not const
+        NocCtgApplication::DependentTaskData dtd = *it;
+        WriteCacheString (os, dtd.GetSenderTaskId ());
+        WriteCacheValue (os, dtd.GetSenderNodeId ());
+        WriteCacheValue (os, dtd.GetData ());
+        WriteCacheString (os, dtd.GetReceivingTaskId ());
+        WriteCacheValue (os, dtd.GetReceivingNodeId ());
+      }
+  }
+
+  static bool
+  ReadCacheDependencies (istream &is, list<NocCtgApplication::DependentTaskData> &dependencies)
+  {
+    uint32_t n;
+    if (!ReadCacheValue (is, n))
+      {
+        return false;
+      }
+    for (uint32_t i = 0; i < n; i++)
+      {
+        string senderTaskId;
+        uint32_t senderNodeId;
+        double data;
+        string receivingTaskId;
+        uint32_t receivingNodeId;
+        if (!ReadCacheString (is, senderTaskId) || !ReadCacheValue (is, senderNodeId) || !ReadCacheValue (is, data)
+            || !ReadCacheString (is, receivingTaskId) || !ReadCacheValue (is, receivingNodeId))
+          {
+            return false;
+          }
+        dependencies.push_back (NocCtgApplication::DependentTaskData (senderTaskId, senderNodeId, data,
+            receivingTaskId, receivingNodeId));
       }
+    return true;
+  }
+
+  bool
+  NocCtgApplicationHelper::LoadCache (list<CtgInstallation> &installations)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    if (m_cacheFilePath.empty ())
+      {
+        return false;
+      }
+
+    ifstream is (m_cacheFilePath.c_str (), ios::in | ios::binary);
+    if (!is)
+      {
+        NS_LOG_INFO ("No cache file " << m_cacheFilePath << " (the XMLs will be parsed)");
+        return false;
+      }
+
+    char magic[sizeof (CACHE_MAGIC)];
+    uint32_t version;
+    uint32_t byteOrder;
+    is.read (magic, sizeof (magic));
+    if (!is || memcmp (magic, CACHE_MAGIC, sizeof (magic)) != 0 || !ReadCacheValue (is, version)
+        || version != CACHE_VERSION || !ReadCacheValue (is, byteOrder) || byteOrder != CACHE_BYTE_ORDER)
+      {
+        NS_LOG_WARN ("Ignoring the cache file " << m_cacheFilePath << " (unknown format)");
+        return false;
+      }
+
+    uint32_t nInputFiles;
+    if (!ReadCacheValue (is, nInputFiles))
+      {
+        return false;
+      }
+    for (uint32_t i = 0; i < nInputFiles; i++)
+      {
+        string filePath;
+        uint64_t cachedSize;
+        uint64_t cachedHash;
+        if (!ReadCacheString (is, filePath) || !ReadCacheValue (is, cachedSize) || !ReadCacheValue (is, cachedHash))
+          {
+            NS_LOG_WARN ("Ignoring the cache file " << m_cacheFilePath << " (truncated)");
+            return false;
+          }
+        uint64_t size;
+        uint64_t hash;
+        if (!HashFile (filePath, size, hash) || size != cachedSize || hash != cachedHash)
+          {
+            NS_LOG_INFO ("The cache file " << m_cacheFilePath << " is stale (" << filePath << " changed)");
+            return false;
+          }
+      }
+
+    list<CtgInstallation> cached;
+    uint32_t nInstallations;
+    bool ok = ReadCacheValue (is, nInstallations);
+    for (uint32_t i = 0; ok && i < nInstallations; i++)
+      {
+        CtgInstallation installation;
+        int64_t period;
+        ok = ReadCacheValue (is, installation.m_nodeId) && ReadCacheValue (is, period)
+            && ReadCacheString (is, installation.m_coreData.m_uid) && ReadCacheString (is, installation.m_coreData.m_id)
+            && ReadCacheString (is, installation.m_coreData.m_apcgId)
+            && ReadCacheValue (is, installation.m_coreData.m_idlePower)
+            && ReadCacheValue (is, installation.m_coreData.m_area)
+            && ReadCacheMap (is, installation.m_coreData.m_power)
+            && ReadCacheMap (is, installation.m_coreData.m_execTime);
+        installation.m_period = TimeStep (period);
+
+        uint32_t nTasks = 0;
+        ok = ok && ReadCacheValue (is, nTasks);
+        for (uint32_t j = 0; ok && j < nTasks; j++)
+          {
+            string id;
+            int64_t execTime;
+            ok = ReadCacheString (is, id) && ReadCacheValue (is, execTime);
+            installation.m_taskList.push_back (NocCtgApplication::TaskData (id, TimeStep (execTime)));
+          }
+
+        ok = ok && ReadCacheDependencies (is, installation.m_remoteTaskList)
+            && ReadCacheDependencies (is, installation.m_localTaskList);
+        cached.push_back (installation);
+      }
+    if (!ok)
+      {
+        NS_LOG_WARN ("Ignoring the cache file " << m_cacheFilePath << " (truncated)");
+        return false;
+      }
+
+    NS_LOG_INFO ("Read the data of " << nInstallations << " mapped cores from the cache file " << m_cacheFilePath);
+    installations.splice (installations.end (), cached);
+    return true;
+  }
+
+  void
+  NocCtgApplicationHelper::SaveCache (const list<CtgInstallation> &installations, const set<string> &inputFiles)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    if (m_cacheFilePath.empty ())
+      {
+        return;
+      }
+
+    // the cache is written in a temporary file, which is then renamed,
+    // so that simulations running in parallel never read a partially written cache
+    stringstream tmpFilePath;
+    tmpFilePath << m_cacheFilePath << "." << getpid ();
+    ofstream os (tmpFilePath.str ().c_str (), ios::out | ios::binary | ios::trunc);
+    if (!os)
+      {
+        NS_LOG_WARN ("Cannot write the cache file " << m_cacheFilePath);
+        return;
+      }
+
+    os.write (CACHE_MAGIC, sizeof (CACHE_MAGIC));
+    WriteCacheValue (os, CACHE_VERSION);
+    WriteCacheValue (os, CACHE_BYTE_ORDER);
+
+    WriteCacheValue<uint32_t> (os, inputFiles.size ());
+    for (set<string>::const_iterator it = inputFiles.begin (); it != inputFiles.end (); it++)
+      {
+        uint64_t size;
+        uint64_t hash;
+        if (!HashFile (*it, size, hash))
+          {
+            NS_LOG_WARN ("Cannot read " << *it << ". The cache file " << m_cacheFilePath << " is not written.");
+            os.close ();
+            remove (tmpFilePath.str ().c_str ());
+            return;
+          }
+        WriteCacheString (os, *it);
+        WriteCacheValue (os, size);
+        WriteCacheValue (os, hash);
+      }
+
+    WriteCacheValue<uint32_t> (os, installations.size ());
+    for (list<CtgInstallation>::const_iterator it = installations.begin (); it != installations.end (); it++)
+      {
+        WriteCacheValue (os, it->m_nodeId);
+        WriteCacheValue (os, it->m_period.GetTimeStep ());
+        WriteCacheString (os, it->m_coreData.m_uid);
+        WriteCacheString (os, it->m_coreData.m_id);
+        WriteCacheString (os, it->m_coreData.m_apcgId);
+        WriteCacheValue (os, it->m_coreData.m_idlePower);
+        WriteCacheValue (os, it->m_coreData.m_area);
+        WriteCacheMap (os, it->m_coreData.m_power);
+        WriteCacheMap (os, it->m_coreData.m_execTime);
+
+        WriteCacheValue<uint32_t> (os, it->m_taskList.size ());
+        for (list<NocCtgApplication::TaskData>::const_iterator task = it->m_taskList.begin (); task != it->m_taskList.end (); task++)
+          {
+            // the TaskData getters are not const
+            NocCtgApplication::TaskData taskData = *task;
+            WriteCacheString (os, taskData.GetId ());
+            WriteCacheValue (os, taskData.GetExecTime ().GetTimeStep ());
+          }
+
+        WriteCacheDependencies (os, it->m_remoteTaskList);
+        WriteCacheDependencies (os, it->m_localTaskList);
+      }
+
+    os.close ();
+    if (!os || rename (tmpFilePath.str ().c_str (), m_cacheFilePath.c_str ()) != 0)
+      {
+        NS_LOG_WARN ("Cannot write the cache file " << m_cacheFilePath);
+        remove (tmpFilePath.str ().c_str ());
+        return;
+      }
+    NS_LOG_INFO ("Wrote the data of " << installations.size () << " mapped cores in the cache file " << m_cacheFilePath);
+  }
+
+  NocCtgApplicationHelper::CtgInstallation::CtgInstallation ()
+    : m_nodeId (0)
+  {
   }
 
   Ptr<Application>
   NocCtgApplicationHelper::Install (Ptr<Node> node) const
   {
     Ptr<NocCtgApplication> app = m_factory.Create<NocCtgApplication> ();
-    app->SetNetDeviceContainer (m_devices);
-    app->SetNodeContainer (m_nodes);
 
     NS_LOG_DEBUG ("Installing an application on NoC node " << node->GetId ());
 
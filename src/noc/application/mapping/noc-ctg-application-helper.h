@@ -25,6 +25,9 @@
 
 #include <stdint.h>
 #include <string>
+#include <map>
+#include <set>
+#include <vector>
 #include "ns3/object-factory.h"
 #include "ns3/address.h"
 #include "ns3/attribute.h"
@@ -119,11 +122,26 @@ namespace ns3
         uint64_t simulationCycles, NodeContainer nodes, NetDeviceContainer devices, uint32_t hSize);
 
     /**
-     * Reads the data from each mapping XML and installs the NoC CTG applications
+     * Reads the data from each mapping XML and installs the NoC CTG applications.
+     * The data is read from the binary cache file, if the cache is still valid.
+     * Otherwise, the XMLs are parsed and the cache file is (re)written.
+     *
+     * \see SetCacheFilePath
      */
     void
     Initialize ();
 
+    /**
+     * Sets the file which caches, in a binary form, the data read from the XMLs
+     * (the mapping, APCG, CTG, core and task XMLs). The cache is used only if the content hash of
+     * every XML it was built from is unchanged. By default, the cache file is the mapping
+     * XML file path followed by ".cache".
+     *
+     * \param cacheFilePath the cache file path (an empty path disables the cache)
+     */
+    void
+    SetCacheFilePath (string cacheFilePath);
+
     /**
      * Helper function used to set the underlying application attributes.
      *
@@ -138,11 +156,96 @@ namespace ns3
 
   private:
 
+    /**
+     * Everything that is required for installing the NoC CTG application of one mapped core.
+     * This is what the binary cache stores.
+     */
+    class CtgInstallation
+    {
+    public:
+
+      CtgInstallation ();
+
+      /** the NoC node to which the core is mapped */
+      uint32_t m_nodeId;
+
+      /** the period of the CTG */
+      Time m_period;
+
+      /** power and area information about the core */
+      CoreData m_coreData;
+
+      /** the tasks that are assigned to the core */
+      list<NocCtgApplication::TaskData> m_taskList;
+
+      /** the remote tasks that send data to the core */
+      list<NocCtgApplication::DependentTaskData> m_remoteTaskList;
+
+      /** the local tasks that send data to tasks from remote NoC nodes */
+      list<NocCtgApplication::DependentTaskData> m_localTaskList;
+    };
+
+    /**
+     * Parses the XMLs
+     *
+     * \param installations where the data of each mapped core is added
+     * \param inputFiles where the paths of all the parsed XMLs are added
+     *
+     * \return false if an XML could not be parsed
+     */
+    bool
+    ReadXml (list<CtgInstallation> &installations, set<string> &inputFiles);
+
+    /**
+     * Reads the binary cache file
+     *
+     * \param installations where the data of each mapped core is added
+     *
+     * \return false if there is no cache file or if it is stale (nothing is added to installations in this case)
+     */
+    bool
+    LoadCache (list<CtgInstallation> &installations);
+
+    /**
+     * Writes the binary cache file
+     *
+     * \param installations the data of each mapped core
+     * \param inputFiles the paths of the XMLs from which the data was read
+     */
+    void
+    SaveCache (const list<CtgInstallation> &installations, const set<string> &inputFiles);
+
+    /**
+     * Installs the NoC CTG application of a mapped core
+     *
+     * \param installation the data of the mapped core
+     */
+    void
+    InstallCtg (const CtgInstallation &installation);
+
     apcgType::core_type
     FindCoreInApcg (apcgType theApcgType, string coreId);
 
+    /**
+     * Compiles the CTG of an APCG into indexes: the NoC node of every task and the communications
+     * of every task. This is done only once per APCG (not for every communication of every task).
+     *
+     * \param theApcgType the APCG
+     * \param theMappingType the mapping of the APCG cores onto the NoC nodes
+     * \param theCtgType the CTG of the APCG
+     */
+    void
+    CompileCtg (const apcgType &theApcgType, const mappingType &theMappingType, const ctgType &theCtgType);
+
+    /**
+     * \param taskId the ID of a task from the compiled CTG
+     *
+     * \return the ID of the NoC node to which the task is mapped, or an empty string if the task is not mapped
+     *
+     * \see CompileCtg
+     */
     string
-    FindNodeIdForTask (apcgType theApcgType, mappingType theMappingType, string taskId);
+    FindNodeIdForTask (string taskId);
 
     template<class T>
     bool
@@ -168,6 +271,9 @@ namespace ns3
     /** the mapping XML file path */
     string m_mappingXmlFilePath;
 
+    /** the binary cache file path (empty if the cache is disabled) */
+    string m_cacheFilePath;
+
     /** how many times the CTGs will be iterated */
     uint64_t m_iterations;
 
@@ -200,6 +306,15 @@ namespace ns3
      */
     list<CoreData> m_coreDataList;
 
+    /** the ID of the APCG compiled by CompileCtg (an empty string means that nothing is compiled yet) */
+    string m_compiledApcgId;
+
+    /** the NoC node of each task of the compiled CTG (task ID, node ID) */
+    map<string, string> m_taskNodeIds;
+
+    /** the communications of each task of the compiled CTG (task ID, indexes in the CTG communication sequence) */
+    map<string, vector<uint32_t> > m_taskCommunications;
+
   };
 
 } // namespace ns3
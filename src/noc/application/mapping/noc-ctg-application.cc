@@ -39,6 +39,7 @@
 #include "ns3/enum.h"
 #include <cstdlib>
 #include <bitset>
+#include <set>
 #include "stdio.h"
 #include "ns3/config.h"
 #include "ns3/noc-packet-tag.h"
@@ -89,6 +90,17 @@ namespace ns3
                 "How many warmup cycles are considered. During warmup cycles, no statistics are collected",
                 UintegerValue (0), MakeUintegerAccessor (&NocCtgApplication::m_warmupCycles),
                 MakeUintegerChecker<uint32_t> ())
+            .AddAttribute ("IterationWindow",
+                "For how many CTG iterations state is initially kept (rounded up to a power of two). "
+                "Only the iterations in progress at a node keep state; the window grows automatically "
+                "when more iterations are in progress at the same time.",
+                UintegerValue (16), MakeUintegerAccessor (&NocCtgApplication::m_iterationWindow),
+                MakeUintegerChecker<uint32_t> (1))
+            .AddAttribute ("MaxIterationWindow",
+                "For how many CTG iterations state is kept at most (rounded up to a power of two). "
+                "A traffic source defers the start of a CTG iteration while the window is full.",
+                UintegerValue (1024), MakeUintegerAccessor (&NocCtgApplication::m_maxIterationWindow),
+                MakeUintegerChecker<uint32_t> (1))
             .AddTraceSource ("FlitInjected", "A new flit is created and sent",
                 MakeTraceSourceAccessor (&NocCtgApplication::m_flitInjectedTrace))
             .AddTraceSource ("PacketInjected", "A new packet was injected into the network",
@@ -111,6 +123,9 @@ namespace ns3
     m_totalExecTime = Seconds (0);
     m_executionAvailabilityTime = Seconds (0);
     m_totalData = 0;
+    m_containsNotDependentTask = false;
+    m_deferredStart = false;
+    m_deferredStartIteration = 0;
   }
 
   NocCtgApplication::~NocCtgApplication ()
@@ -149,20 +164,39 @@ namespace ns3
 
 	NS_ASSERT_MSG (packetIteration < m_iterations, "This packet's CTG iteration exceeds the number of CTG iterations set: " << m_iterations);
 
-    m_receivedData[packetIteration] += dataSize * 8;
-
-    NS_LOG_DEBUG ("For packet CTG iteration, current received data is " << m_receivedData[packetIteration] << ". Total data to be received is " << m_totalData);
+    if (m_totalData > 0)
+      {
+        if (packetIteration < m_currentIteration && FindIterationState (packetIteration) == 0)
+          {
+            // the state of an iteration is released only after all its data was received
+            NS_LOG_LOGIC ("CTG iteration " << packetIteration << " was already completed by this node. Ignoring the received data.");
+          }
+        else
+          {
+            IterationState &state = GetIterationState (packetIteration);
+            state.m_receivedData += dataSize * 8;
+            ReceiveData (state, tag, dataSize * 8);
+            NS_LOG_DEBUG ("For packet CTG iteration, current received data is " << state.m_receivedData << ". Total data to be received is " << m_totalData
+                << " (" << state.m_readyTasks.size () << " of the " << m_taskList.size () << " tasks are ready)");
+            if (m_localTaskList.size () > 0)
+              {
+                // the tasks inject their data as soon as they are ready, not after this node received all its data
+                ResumeInjection (packetIteration);
+              }
+          }
+      }
 
     if (m_currentIteration < m_iterations)
       {
-        NS_LOG_DEBUG ("For this core's current CTG iteration, current received data is " << m_receivedData[m_currentIteration] << ". Total data to be received is " << m_totalData);
+        // the state of the current iteration is only looked up: an iteration without state did not receive any data yet
+        IterationState *currentState = FindIterationState (m_currentIteration);
+        double receivedData = currentState != 0 ? currentState->m_receivedData : 0;
+        NS_LOG_DEBUG ("For this core's current CTG iteration, current received data is " << receivedData << ". Total data to be received is " << m_totalData);
 
-        if (m_receivedData[m_currentIteration] >= m_totalData)
+        if (m_totalData == 0 || (currentState != 0 && IsIterationReady (*currentState)))
           {
-            m_receivedData[m_currentIteration] = m_totalData;
-
             NS_LOG_INFO ("Node " << GetNode ()->GetId () << " received " << m_totalData << " bits of data for CTG iteration " << m_currentIteration
-                << ". Since this is the amount of data expected, node " << GetNode ()->GetId () << " can start injecting flits.");
+                << ". Since this is the amount of data expected, all the tasks of node " << GetNode ()->GetId () << " are ready.");
 
             if (m_localTaskList.size() == 0)
               {
@@ -180,20 +214,8 @@ namespace ns3
                   Simulator::Schedule (m_totalExecTime + startTime - Simulator::Now (), &NocCtgApplication::ProcessFlit, this);
                   m_executionAvailabilityTime = m_totalExecTime + startTime;
               }
-            else
-              {
-                // a core with non dependent tasks will be scheduled for injection, for all its tasks, by StartApplication ()
-                // thus ScheduleStartEvent (...) must be called here (at receive time) only for cores with non dependent tasks
-                if (!ContainsNotDependentTask () && m_currentDestinationIndex[m_currentIteration] < m_localTaskList.size())
-                  {
-                    ScheduleStartEvent(m_currentIteration);
-                  }
-                else
-                  {
-                    NS_LOG_LOGIC ("Node " << GetNode ()->GetId () << " already injected all data. No more injections are scheduled.");
-                  }
-              }
             m_currentIteration++;
+            ReleaseIterationState (m_currentIteration - 1);
           }
     }
     else
@@ -217,37 +239,22 @@ namespace ns3
     m_maxBytes = maxBytes;
   }
 
-  void
-  NocCtgApplication::SetNetDeviceContainer (NetDeviceContainer devices)
-  {
-    NS_LOG_FUNCTION_NOARGS ();
-
-    m_devices = devices;
-  }
-
-  void
-  NocCtgApplication::SetNodeContainer (NodeContainer nodes)
-  {
-    NS_LOG_FUNCTION_NOARGS ();
-
-    m_nodes = nodes;
-  }
-
   void
   NocCtgApplication::SetTaskList (list<TaskData> taskList)
   {
     NS_LOG_FUNCTION_NOARGS ();
 
-    m_taskList = taskList;
+    m_taskList.assign (taskList.begin (), taskList.end ());
+    m_taskIndexes.clear ();
 
     m_totalExecTime = Seconds (0);
 
     NS_LOG_DEBUG ("Computing the total execution time for NoC node " << GetNode ()->GetId ());
-    list<TaskData>::iterator it;
-    for (it = m_taskList.begin (); it != m_taskList.end (); it++)
+    for (uint32_t i = 0; i < m_taskList.size (); i++)
       {
-        NS_LOG_DEBUG ("Task " << it->GetId () << " has execution time " << it->GetExecTime ());
-        m_totalExecTime += it->GetExecTime ();
+        NS_LOG_DEBUG ("Task " << m_taskList[i].GetId () << " has execution time " << m_taskList[i].GetExecTime ());
+        m_totalExecTime += m_taskList[i].GetExecTime ();
+        m_taskIndexes.insert (make_pair (m_taskList[i].GetId (), i));
       }
 
     NS_LOG_LOGIC ("Computed a total execution time of " << m_totalExecTime
@@ -259,76 +266,272 @@ namespace ns3
   {
     NS_LOG_FUNCTION_NOARGS ();
 
-    bool found = false;
+    return m_taskIndexes.find (taskId) != m_taskIndexes.end ();
+  }
+
+  NocCtgApplication::DependentTaskData &
+  NocCtgApplication::GetLocalDependentTaskData (uint32_t index)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    NS_ASSERT_MSG (index < m_localTaskList.size (), "index = " << index << ", m_localTaskList.size () = " << m_localTaskList.size () << ", node = " << GetNode ()->GetId ());
 
-    list<TaskData>::iterator it;
-    for (it = m_taskList.begin (); it != m_taskList.end (); it++)
+    return m_localTaskList[index];
+  }
+
+  bool
+  NocCtgApplication::ContainsNotDependentTask ()
+  {
+    return m_containsNotDependentTask;
+  }
+
+  void
+  NocCtgApplication::UpdateDependencies ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    set<string> receivingTasks;
+    for (uint32_t i = 0; i < m_remoteTaskList.size (); i++)
       {
-        if (taskId == it->GetId ())
+        receivingTasks.insert (m_remoteTaskList[i].GetReceivingTaskId ());
+      }
+
+    m_containsNotDependentTask = false;
+    for (uint32_t i = 0; i < m_localTaskList.size (); i++)
+      {
+        if (receivingTasks.find (m_localTaskList[i].GetSenderTaskId ()) == receivingTasks.end ())
           {
-            found = true;
+            m_containsNotDependentTask = true;
+            NS_LOG_LOGIC ("Found that task " << m_localTaskList[i].GetSenderTaskId () << " is a non dependent task");
             break;
           }
       }
 
-    return found;
-  }
+    if (!m_containsNotDependentTask)
+      {
+        NS_LOG_LOGIC ("All tasks are dependent");
+      }
 
-  NocCtgApplication::DependentTaskData
-  NocCtgApplication::GetLocalDependentTaskData (uint32_t index)
-  {
-    NS_LOG_FUNCTION_NOARGS ();
+    // the dependencies are compiled into integer indexes, so that a received flit updates them in constant time
+    uint32_t nodeId = GetNode ()->GetId ();
+    m_dependencyTasks.assign (m_remoteTaskList.size (), m_taskList.size ());
+    m_taskDependencyCounts.assign (m_taskList.size (), 0);
+    m_dependencyData.resize (m_remoteTaskList.size ());
+    m_taskLocalDependencies.assign (m_taskList.size (), vector<uint32_t> ());
+    m_dependencyIndexes.clear ();
+    for (uint32_t i = 0; i < m_remoteTaskList.size (); i++)
+      {
+        map<string, uint32_t>::iterator task = m_taskIndexes.find (m_remoteTaskList[i].GetReceivingTaskId ());
+        if (task != m_taskIndexes.end ())
+          {
+            m_dependencyTasks[i] = task->second;
+            m_taskDependencyCounts[task->second]++;
+          }
+        m_dependencyData[i] = m_remoteTaskList[i].GetData ();
 
-    NS_ASSERT_MSG (index < m_localTaskList.size (), "index = " << index << ", m_localTaskList.size () = " << m_localTaskList.size () << ", node = " << GetNode ()->GetId ());
+        uint32_t senderNodeId = m_remoteTaskList[i].GetSenderNodeId ();
+        if (senderNodeId == nodeId)
+          {
+            map<string, uint32_t>::iterator senderTask = m_taskIndexes.find (m_remoteTaskList[i].GetSenderTaskId ());
+            if (senderTask != m_taskIndexes.end ())
+              {
+                m_taskLocalDependencies[senderTask->second].push_back (i);
+              }
+            else
+              {
+                NS_LOG_ERROR ("Task " << m_remoteTaskList[i].GetSenderTaskId () << " sends data from node " << nodeId
+                    << ". However, this task is not in the task list!");
+                // this data is never sent, so the receiving task does not wait for it
+                if (m_dependencyTasks[i] < m_taskList.size ())
+                  {
+                    m_taskDependencyCounts[m_dependencyTasks[i]]--;
+                    m_dependencyTasks[i] = m_taskList.size ();
+                  }
+              }
+            continue;
+          }
+        // the dependencies whose receiving task is not assigned to this node are indexed too, because their data is still sent
+        pair<map<pair<string, string>, uint32_t>::iterator, bool> inserted = m_dependencyIndexes.insert (make_pair (
+            make_pair (m_remoteTaskList[i].GetSenderTaskId (), m_remoteTaskList[i].GetReceivingTaskId ()), i));
+        if (!inserted.second)
+          {
+            NS_LOG_WARN ("Task " << m_remoteTaskList[i].GetSenderTaskId () << " sends data to task "
+                << m_remoteTaskList[i].GetReceivingTaskId () << " more than once. The data is received as a single dependency.");
+            m_dependencyData[inserted.first->second] += m_dependencyData[i];
+            m_dependencyData[i] = 0;
+          }
+      }
+    // a dependency without any data to receive is satisfied from the start
+    // (the dependencies between the tasks of this node are satisfied when their sender task becomes ready)
+    for (uint32_t i = 0; i < m_remoteTaskList.size (); i++)
+      {
+        if (m_remoteTaskList[i].GetSenderNodeId () != nodeId && m_dependencyData[i] <= 0 && m_dependencyTasks[i] < m_taskList.size ())
+          {
+            m_taskDependencyCounts[m_dependencyTasks[i]]--;
+            m_dependencyTasks[i] = m_taskList.size ();
+          }
+      }
 
-    uint32_t idx = 0;
-    DependentTaskData dtd = *(m_localTaskList.begin ());
-    list<DependentTaskData>::iterator it;
-    for (it = m_localTaskList.begin (); it != m_localTaskList.end (); it++)
+    m_taskOutgoingDependencies.assign (m_taskList.size (), vector<uint32_t> ());
+    for (uint32_t i = 0; i < m_localTaskList.size (); i++)
       {
-        if (index == idx)
+        map<string, uint32_t>::iterator senderTask = m_taskIndexes.find (m_localTaskList[i].GetSenderTaskId ());
+        if (senderTask != m_taskIndexes.end ())
           {
-            dtd = *it;
+            m_taskOutgoingDependencies[senderTask->second].push_back (i);
           }
-        idx++;
       }
+    NS_LOG_LOGIC ("Node " << nodeId << " receives " << m_dependencyIndexes.size () << " dependencies from remote nodes");
+  }
 
-    return dtd;
+  void
+  NocCtgApplication::InitDependencies (IterationState &state)
+  {
+    state.m_remainingData = m_dependencyData;
+    state.m_pendingDependencies = m_taskDependencyCounts;
+    state.m_readyTasks.clear ();
+    state.m_readyTasks.reserve (m_taskList.size ());
+    for (uint32_t t = 0; t < m_taskList.size (); t++)
+      {
+        if (m_taskDependencyCounts[t] == 0)
+          {
+            PushReadyTask (state, t);
+          }
+      }
   }
 
-  bool
-  NocCtgApplication::ContainsNotDependentTask ()
+  void
+  NocCtgApplication::ReceiveData (IterationState &state, const NocPacketTag &tag, double data)
   {
-    NS_LOG_FUNCTION_NOARGS ();
+    uint32_t dependency = tag.GetCtgDependency ();
+    if (dependency >= m_remoteTaskList.size ())
+      {
+        NS_LOG_WARN ("Node " << GetNode ()->GetId () << " received a flit with data for an unknown dependency (" << dependency << ")");
+        return;
+      }
 
-    bool contains = false;
+    double &remainingData = state.m_remainingData[dependency];
+    if (remainingData <= 0)
+      {
+        // the last packet of a dependency may carry more data than needed
+        NS_LOG_LOGIC ("The data from task " << m_remoteTaskList[dependency].GetSenderTaskId () << " was already received");
+        return;
+      }
+    remainingData -= data;
+    if (remainingData <= 0)
+      {
+        SatisfyDependency (state, dependency);
+      }
+  }
 
-    for (list<DependentTaskData>::iterator localIt = m_localTaskList.begin(); localIt != m_localTaskList.end(); localIt++)
+  void
+  NocCtgApplication::SatisfyDependency (IterationState &state, uint32_t dependency)
+  {
+    NS_LOG_LOGIC ("Task " << m_remoteTaskList[dependency].GetReceivingTaskId () << " received all the data from task "
+        << m_remoteTaskList[dependency].GetSenderTaskId () << " (CTG iteration " << state.m_iteration << ")");
+
+    uint32_t task = m_dependencyTasks[dependency];
+    if (task < m_taskList.size ())
       {
-        string localTaskId = localIt->GetSenderTaskId ();
-        bool found = true;
-        for (list<DependentTaskData>::iterator remoteIt = m_remoteTaskList.begin(); remoteIt != m_remoteTaskList.end(); remoteIt++)
+        NS_ASSERT (state.m_pendingDependencies[task] > 0);
+        state.m_pendingDependencies[task]--;
+        if (state.m_pendingDependencies[task] == 0)
           {
-            if (localIt->GetSenderTaskId () == remoteIt->GetReceivingTaskId ())
+            PushReadyTask (state, task);
+          }
+      }
+  }
+
+  void
+  NocCtgApplication::PushReadyTask (IterationState &state, uint32_t task)
+  {
+    uint32_t first = state.m_readyTasks.size ();
+    state.m_readyTasks.push_back (task);
+    for (uint32_t i = first; i < state.m_readyTasks.size (); i++)
+      {
+        NS_LOG_LOGIC ("Task " << m_taskList[state.m_readyTasks[i]].GetId () << " is ready (CTG iteration " << state.m_iteration << ")");
+        vector<uint32_t> &localDependencies = m_taskLocalDependencies[state.m_readyTasks[i]];
+        for (uint32_t j = 0; j < localDependencies.size (); j++)
+          {
+            uint32_t next = m_dependencyTasks[localDependencies[j]];
+            if (next < m_taskList.size ())
               {
-                found = false;
-                break;
+                NS_ASSERT (state.m_pendingDependencies[next] > 0);
+                state.m_pendingDependencies[next]--;
+                if (state.m_pendingDependencies[next] == 0)
+                  {
+                    state.m_readyTasks.push_back (next);
+                  }
               }
           }
-        if (found)
+      }
+  }
+
+  bool
+  NocCtgApplication::IsIterationReady (const IterationState &state) const
+  {
+    return state.m_readyTasks.size () == m_taskList.size ();
+  }
+
+  bool
+  NocCtgApplication::HasReadyDestination (IterationState &state)
+  {
+    while (state.m_currentReadyTask < state.m_readyTasks.size ())
+      {
+        if (state.m_currentTaskDependency < m_taskOutgoingDependencies[state.m_readyTasks[state.m_currentReadyTask]].size ())
           {
-            contains = true;
-            NS_LOG_LOGIC ("Found that task " << localTaskId << " is a non dependent task");
-            break;
+            return true;
           }
+        state.m_currentReadyTask++;
+        state.m_currentTaskDependency = 0;
       }
+    return false;
+  }
 
-    if (!contains)
+  uint32_t
+  NocCtgApplication::GetCurrentDestination (const IterationState &state) const
+  {
+    NS_ASSERT (state.m_currentReadyTask < state.m_readyTasks.size ());
+    const vector<uint32_t> &outgoingDependencies = m_taskOutgoingDependencies[state.m_readyTasks[state.m_currentReadyTask]];
+    NS_ASSERT (state.m_currentTaskDependency < outgoingDependencies.size ());
+
+    return outgoingDependencies[state.m_currentTaskDependency];
+  }
+
+  void
+  NocCtgApplication::ResumeInjection (uint64_t iteration)
+  {
+    NS_LOG_FUNCTION (iteration);
+
+    IterationState &state = GetIterationState (iteration);
+    if (!HasReadyDestination (state))
       {
-        NS_LOG_LOGIC ("All tasks are dependent");
+        NS_LOG_LOGIC ("Node " << GetNode ()->GetId () << " has no ready task with data to inject (CTG iteration " << iteration << ")");
+      }
+    else if (!state.m_injectionStarted)
+      {
+        // the iterations of the traffic sources are started one after another, by StartSending (...)
+        if (!ContainsNotDependentTask ())
+          {
+            ScheduleStartEvent (iteration);
+          }
+      }
+    else if (!state.m_startEvent.IsRunning () && !state.m_sendEvent.IsRunning ())
+      {
+        NS_LOG_LOGIC ("Node " << GetNode ()->GetId () << " resumes injecting flits from CTG iteration " << iteration);
+        ScheduleNextTx (iteration);
       }
+  }
 
-    return contains;
+  uint32_t
+  NocCtgApplication::GetRemoteDependencyIndex (string senderTaskId, string receivingTaskId) const
+  {
+    map<pair<string, string>, uint32_t>::const_iterator it = m_dependencyIndexes.find (make_pair (senderTaskId, receivingTaskId));
+    if (it == m_dependencyIndexes.end ())
+      {
+        return m_remoteTaskList.size ();
+      }
+    return it->second;
   }
 
   void
@@ -336,9 +539,10 @@ namespace ns3
   {
     NS_LOG_FUNCTION_NOARGS ();
 
-    m_remoteTaskList = remoteTaskList;
+    m_remoteTaskList.assign (remoteTaskList.begin (), remoteTaskList.end ());
+    m_totalData = 0;
 
-    list<DependentTaskData>::iterator it;
+    vector<DependentTaskData>::iterator it;
     for (it = m_remoteTaskList.begin (); it != m_remoteTaskList.end (); it++)
       {
         if (!TaskListContainsTask (it->GetReceivingTaskId ()))
@@ -354,6 +558,8 @@ namespace ns3
       }
 
     NS_LOG_INFO ("The total amount of data to be received by node " << GetNode ()->GetId () << " is " << m_totalData << " bits.");
+
+    UpdateDependencies ();
   }
 
   void
@@ -361,9 +567,9 @@ namespace ns3
   {
     NS_LOG_FUNCTION_NOARGS ();
 
-    m_localTaskList = localTaskList;
+    m_localTaskList.assign (localTaskList.begin (), localTaskList.end ());
 
-    list<DependentTaskData>::iterator it;
+    vector<DependentTaskData>::iterator it;
     for (it = m_localTaskList.begin (); it != m_localTaskList.end (); it++)
       {
         if (!TaskListContainsTask (it->GetSenderTaskId ()))
@@ -373,6 +579,8 @@ namespace ns3
                 << ". However, this task is not in the task list!");
           }
       }
+
+    UpdateDependencies ();
   }
 
   void
@@ -380,6 +588,9 @@ namespace ns3
   {
     NS_LOG_FUNCTION_NOARGS ();
 
+    m_context = 0;
+    m_localTaskDestinations.clear ();
+    m_localTaskRemoteDependencies.clear ();
     Application::DoDispose();
   }
 
@@ -390,32 +601,71 @@ namespace ns3
     NS_LOG_LOGIC ("Trying to start injecting flits by checking CTG dependencies (node " << GetNode ()->GetId () << ")");
     NS_LOG_LOGIC ("The CTG will be iterated " << m_iterations << " times, with a period of " << m_period);
 
+    // the simulation context is retrieved only once, from the NoC topology
+    PointerValue nocPointer;
+    NocRegistry::GetInstance ()->GetAttribute ("NoCTopology", nocPointer);
+    Ptr<NocTopology> nocTopology = nocPointer.Get<NocTopology> ();
+    NS_ASSERT_MSG (nocTopology != 0, "The NoC topology was not registered in NocRegistry!");
+    m_context = nocTopology->GetContext ();
+
     uint32_t nodeId = GetNode ()->GetId ();
     NS_LOG_DEBUG ("Tracing the flits received at node " << (int) nodeId);
     // we configure this trace here and not in the constructor, because
     // the node is not initialized yet at constructor time
-    std::stringstream ss;
-    ss << "/NodeList/" << nodeId << "/DeviceList/*/$ns3::NocNetDevice/Receive";
-    Config::Connect (ss.str (), MakeCallback (&NocCtgApplication::FlitReceivedCallback, this));
+    // the trace sources of the node's own net devices are connected directly, with the same context
+    // Config::Connect would give; resolving a /NodeList/ path copies and scans the whole node list,
+    // which makes the startup quadratic in the number of nodes
+    for (uint32_t j = 0; j < GetNode ()->GetNDevices (); j++)
+      {
+        Ptr<NocNetDevice> device = GetNode ()->GetDevice (j)->GetObject<NocNetDevice> ();
+        if (device != 0)
+          {
+            std::stringstream ss;
+            ss << "/NodeList/" << nodeId << "/DeviceList/" << j << "/$ns3::NocNetDevice/Receive";
+            device->TraceConnect ("Receive", ss.str (), MakeCallback (&NocCtgApplication::FlitReceivedCallback, this));
+          }
+      }
 
-    for (uint64_t i = 0; i < m_iterations; ++i)
+    // the destination nodes are looked up only once, not for every injected flit
+    // the destination nodes, and the dependency indexes used by their applications, are looked up only once,
+    // not for every injected flit
+    m_localTaskDestinations.clear ();
+    m_localTaskRemoteDependencies.clear ();
+    for (uint32_t t = 0; t < m_localTaskList.size (); t++)
       {
-        m_injectionStarted.insert (m_injectionStarted.end (), false);
-        m_totBytes.insert (m_totBytes.end (), 0);
-        m_totFlits.insert (m_totFlits.end (), 0);
-        m_currentFlitIndex.insert (m_currentFlitIndex.end (), 0);
-        m_currentHeadFlit.insert (m_currentHeadFlit.end (), 0);
-        m_receivedData.insert (m_receivedData.end (), 0);
-        m_currentDestinationIndex.insert (m_currentDestinationIndex.end (), 0);
-        m_totalTaskBytes.insert (m_totalTaskBytes.end (), 0);
-        m_startEvent.insert (m_startEvent.end (), EventId ());
-        m_sendEvent.insert (m_sendEvent.end (), EventId ());
+        Ptr<NocNode> destinationNode = nocTopology->GetNocNode (m_localTaskList[t].GetReceivingNodeId ());
+        m_localTaskDestinations.push_back (destinationNode);
 
-        // Ensure no pending event
-        CancelEvents (i);
+        uint32_t remoteDependency = ~0U;
+        for (uint32_t j = 0; destinationNode != 0 && j < destinationNode->GetNApplications (); j++)
+          {
+            Ptr<NocCtgApplication> application = DynamicCast<NocCtgApplication> (destinationNode->GetApplication (j));
+            if (application != 0)
+              {
+                remoteDependency = application->GetRemoteDependencyIndex (m_localTaskList[t].GetSenderTaskId (),
+                    m_localTaskList[t].GetReceivingTaskId ());
+                break;
+              }
+          }
+        if (remoteDependency == ~0U)
+          {
+            NS_LOG_WARN ("Node " << m_localTaskList[t].GetReceivingNodeId () << " has no CTG application to receive the data of task "
+                << m_localTaskList[t].GetSenderTaskId ());
+          }
+        m_localTaskRemoteDependencies.push_back (remoteDependency);
+      }
 
-        ScheduleStartEvent (i);
+    uint32_t window = 1;
+    while (window < m_iterationWindow && window < m_maxIterationWindow)
+      {
+        window <<= 1;
       }
+    m_iterationStates.clear ();
+    m_iterationStates.resize (window);
+    m_deferredStart = false;
+
+    // the start of the next CTG iteration is scheduled only when an iteration starts (see StartSending)
+    ScheduleStartEvent (0);
   }
 
   void
@@ -423,9 +673,15 @@ namespace ns3
   {
     NS_LOG_FUNCTION_NOARGS ();
 
-    for (uint64_t i = 0; i < m_iterations; ++i) {
-        CancelEvents (i);
-    }
+    m_deferredStart = false;
+
+    for (uint32_t i = 0; i < m_iterationStates.size (); ++i)
+      {
+        if (m_iterationStates[i].m_used)
+          {
+            CancelEvents (m_iterationStates[i].m_iteration);
+          }
+      }
   }
 
   void
@@ -433,8 +689,130 @@ namespace ns3
   {
     NS_LOG_FUNCTION (iteration);
 
-    Simulator::Cancel (m_sendEvent[iteration]);
-    Simulator::Cancel (m_startEvent[iteration]);
+    IterationState *state = FindIterationState (iteration);
+    if (state != 0)
+      {
+        Simulator::Cancel (state->m_sendEvent);
+        Simulator::Cancel (state->m_startEvent);
+      }
+  }
+
+  NocCtgApplication::IterationState &
+  NocCtgApplication::GetIterationState (uint64_t iteration)
+  {
+    NS_ASSERT_MSG (!m_iterationStates.empty (), "The application was not started yet!");
+
+    IterationState *state = FindIterationState (iteration);
+    if (state == 0)
+      {
+        state = CreateIterationState (iteration);
+        if (state == 0)
+          {
+            NS_FATAL_ERROR ("Node " << GetNode ()->GetId () << " cannot keep state for CTG iteration " << iteration
+                << " because " << m_iterationStates.size () << " CTG iterations are already in progress"
+                << " (increase the MaxIterationWindow attribute)");
+          }
+      }
+    return *state;
+  }
+
+  NocCtgApplication::IterationState *
+  NocCtgApplication::CreateIterationState (uint64_t iteration)
+  {
+    NS_ASSERT_MSG (!m_iterationStates.empty (), "The application was not started yet!");
+
+    IterationState *state = &m_iterationStates[iteration & (m_iterationStates.size () - 1)];
+    while (state->m_used)
+      {
+        NS_ASSERT (state->m_iteration != iteration);
+        if (m_iterationStates.size () >= m_maxIterationWindow)
+          {
+            NS_LOG_LOGIC ("Node " << GetNode ()->GetId () << " has no free state for CTG iteration " << iteration);
+            return 0;
+          }
+        GrowIterationStates ();
+        state = &m_iterationStates[iteration & (m_iterationStates.size () - 1)];
+      }
+    *state = IterationState ();
+    state->m_used = true;
+    state->m_iteration = iteration;
+    InitDependencies (*state);
+    return state;
+  }
+
+  NocCtgApplication::IterationState *
+  NocCtgApplication::FindIterationState (uint64_t iteration)
+  {
+    if (m_iterationStates.empty ())
+      {
+        return 0;
+      }
+    IterationState *state = &m_iterationStates[iteration & (m_iterationStates.size () - 1)];
+    if (!state->m_used || state->m_iteration != iteration)
+      {
+        return 0;
+      }
+    return state;
+  }
+
+  void
+  NocCtgApplication::GrowIterationStates ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    vector<IterationState> states (2 * m_iterationStates.size ());
+    for (uint32_t i = 0; i < m_iterationStates.size (); ++i)
+      {
+        if (m_iterationStates[i].m_used)
+          {
+            states[m_iterationStates[i].m_iteration & (states.size () - 1)] = m_iterationStates[i];
+          }
+      }
+    m_iterationStates.swap (states);
+    NS_LOG_LOGIC ("Node " << GetNode ()->GetId () << " now keeps state for up to "
+        << m_iterationStates.size () << " CTG iterations in progress");
+  }
+
+  void
+  NocCtgApplication::ReleaseIterationState (uint64_t iteration)
+  {
+    NS_LOG_FUNCTION (iteration);
+
+    IterationState *state = FindIterationState (iteration);
+    if (state == 0)
+      {
+        return;
+      }
+    // the data of an iteration is completely received when this node moved to a following iteration
+    bool received = m_totalData == 0 || iteration < m_currentIteration;
+    // the data of an iteration is completely sent when all the tasks are ready and none has data left to inject
+    bool sent = m_localTaskList.empty () || (IsIterationReady (*state) && !HasReadyDestination (*state)
+        && !state->m_startEvent.IsRunning () && !state->m_sendEvent.IsRunning ());
+    if (received && sent)
+      {
+        NS_LOG_LOGIC ("Node " << GetNode ()->GetId () << " completed CTG iteration " << iteration);
+        *state = IterationState ();
+        if (m_deferredStart)
+          {
+            m_deferredStart = false;
+            ScheduleStartEvent (m_deferredStartIteration);
+          }
+      }
+  }
+
+  NocCtgApplication::IterationState::IterationState ()
+    : m_used (false),
+      m_iteration (0),
+      m_currentFlitIndex (0),
+      m_currentHeadFlit (0),
+      m_totBytes (0),
+      m_totFlits (0),
+      m_injectionStarted (false),
+      m_receivedData (0),
+      m_currentReadyTask (0),
+      m_currentTaskDependency (0),
+      m_totalTaskBytes (0)
+  {
   }
 
   // Event handlers
@@ -443,7 +821,21 @@ namespace ns3
   {
     NS_LOG_FUNCTION (iteration);
 
-    ScheduleNextTx (iteration); // Schedule the send flit event
+    if ((ContainsNotDependentTask () || m_totalData == 0) && iteration + 1 < m_iterations)
+      {
+        // nodes which do not wait for data (i.e. traffic sources) start their iterations one after another:
+        // the next iteration is scheduled now, exactly when it would have been scheduled from StartApplication
+        ScheduleStartEvent (iteration + 1);
+      }
+    if (HasReadyDestination (GetIterationState (iteration)))
+      {
+        ScheduleNextTx (iteration); // Schedule the send flit event
+      }
+    else
+      {
+        NS_LOG_LOGIC ("Node " << GetNode ()->GetId () << " waits for its tasks to become ready (CTG iteration " << iteration << ")");
+        ReleaseIterationState (iteration);
+      }
   }
 
   void
@@ -456,9 +848,8 @@ namespace ns3
   Time
   NocCtgApplication::GetGlobalClock () const
   {
-    TimeValue timeValue;
-    NocRegistry::GetInstance ()->GetAttribute ("GlobalClock", timeValue);
-    Time globalClock = timeValue.Get ();
+    NS_ASSERT_MSG (m_context != 0, "The application was not started yet (no simulation context)!");
+    Time globalClock = m_context->GetGlobalClock ();
     NS_ASSERT_MSG (!globalClock.IsZero (), "A global clock must be set!");
 
     return globalClock;
@@ -470,12 +861,13 @@ namespace ns3
   {
     NS_LOG_FUNCTION (iteration);
 
-    if ((m_maxBytes == 0 || (m_maxBytes > 0 && m_totBytes[iteration] < m_maxBytes))
-        && (m_maxFlits == 0 || (m_maxFlits > 0 && m_totFlits[iteration] < m_maxFlits)))
+    IterationState &state = GetIterationState (iteration);
+    if ((m_maxBytes == 0 || (m_maxBytes > 0 && state.m_totBytes < m_maxBytes))
+        && (m_maxFlits == 0 || (m_maxFlits > 0 && state.m_totFlits < m_maxFlits)))
       {
         Time globalClock = GetGlobalClock ();
         Time sendAtTime;
-        if (m_totBytes[iteration] == 0)
+        if (state.m_totBytes == 0)
           {
             // the first flit injection event must occur with no delay
             sendAtTime = PicoSeconds (0);
@@ -497,13 +889,13 @@ namespace ns3
         NS_LOG_DEBUG ("Schedule event (flit injection) to occur at time "
             << Simulator::Now () + sendAtTime);
         // Simulator::Schedule (...) receives a relative time
-        m_sendEvent[iteration] = Simulator::Schedule (sendAtTime, &NocCtgApplication::SendFlit, this, iteration);
+        state.m_sendEvent = Simulator::Schedule (sendAtTime, &NocCtgApplication::SendFlit, this, iteration);
       }
     else
       { // All done, cancel any pending events
         NS_LOG_DEBUG ("Stopping the application");
-        NS_LOG_DEBUG ("maxBytes = " << m_maxBytes << " totBytes = " << m_totBytes[iteration]);
-        NS_LOG_DEBUG ("maxFlits = " << m_maxFlits << " totFlits = " << m_totFlits[iteration]);
+        NS_LOG_DEBUG ("maxBytes = " << m_maxBytes << " totBytes = " << state.m_totBytes);
+        NS_LOG_DEBUG ("maxFlits = " << m_maxFlits << " totFlits = " << state.m_totFlits);
 
         StopApplication();
       }
@@ -514,14 +906,23 @@ namespace ns3
   {
     NS_LOG_FUNCTION (iteration);
 
-    if ((ContainsNotDependentTask () || m_receivedData[iteration] == m_totalData) && m_localTaskList.size() > 0)
+    if (FindIterationState (iteration) == 0 && CreateIterationState (iteration) == 0)
+      {
+        NS_LOG_LOGIC ("Node " << GetNode ()->GetId () << " defers the start of CTG iteration " << iteration
+            << " until the state of an iteration in progress is released");
+        m_deferredStart = true;
+        m_deferredStartIteration = iteration;
+        return;
+      }
+    IterationState &state = GetIterationState (iteration);
+    if ((ContainsNotDependentTask () || HasReadyDestination (state)) && m_localTaskList.size() > 0)
     {
         NS_LOG_LOGIC ("Execution time is " << m_totalExecTime);
         NS_LOG_LOGIC ("CTG period is " << m_period);
         NS_LOG_LOGIC ("Current CTG iteration is " << iteration << " (iteration 0 is the first one).");
 
         Time delay;
-        if (!m_injectionStarted[iteration])
+        if (!state.m_injectionStarted)
           {
             NS_LOG_LOGIC ("This is the first time when node " << GetNode ()->GetId () << " injects flits from CTG iteration " << iteration);
             // the execution of an IP core is simulated by introducing a delay
@@ -562,10 +963,10 @@ namespace ns3
         NS_LOG_LOGIC ("The clock cycle when node " << GetNode ()->GetId () << " will start injecting flits is "
             << globalClock * Scalar (clockMultiplier));
 
-        m_injectionStarted[iteration] = true;
+        state.m_injectionStarted = true;
 
         // Simulator::Schedule (...) receives a relative time
-        m_startEvent[iteration] = Simulator::Schedule (nextClock, &NocCtgApplication::StartSending, this, iteration);
+        state.m_startEvent = Simulator::Schedule (nextClock, &NocCtgApplication::StartSending, this, iteration);
 
         m_executionAvailabilityTime = Simulator::Now () + nextClock;
     }
@@ -575,9 +976,9 @@ namespace ns3
           {
             NS_LOG_LOGIC ("Node " << GetNode ()->GetId () << " doesn't have any data to receive!");
           }
-        if (!ContainsNotDependentTask () && m_receivedData[iteration] < m_totalData)
+        if (!ContainsNotDependentTask () && !HasReadyDestination (state))
           {
-            NS_LOG_LOGIC ("Node " << GetNode ()->GetId () << " still has to receive data before being able to inject its data into the NoC!");
+            NS_LOG_LOGIC ("Node " << GetNode ()->GetId () << " still has to receive data before any of its tasks can inject data into the NoC!");
           }
         if (m_localTaskList.size() == 0)
           {
@@ -591,7 +992,7 @@ namespace ns3
   {
     NS_LOG_FUNCTION (iteration);
     NS_LOG_LOGIC ("sending flit at " << Simulator::Now ());
-//    NS_ASSERT (m_sendEvent[iteration].IsExpired ());
+//    NS_ASSERT (GetIterationState (iteration).m_sendEvent.IsExpired ());
 
     Ptr<NocNode> sourceNode = GetNode ()->GetObject<NocNode> ();
     uint32_t sourceNodeId = sourceNode->GetId ();
@@ -600,7 +1001,9 @@ namespace ns3
     NS_LOG_DEBUG ("source X = " << sourceX);
     NS_LOG_DEBUG ("source Y = " << sourceY);
 
-    DependentTaskData dtd = GetLocalDependentTaskData (m_currentDestinationIndex[iteration]);
+    IterationState &state = GetIterationState (iteration);
+    uint32_t destinationIndex = GetCurrentDestination (state);
+    DependentTaskData &dtd = GetLocalDependentTaskData (destinationIndex);
     uint32_t destinationNodeId = dtd.GetReceivingNodeId ();
     uint32_t destinationX = destinationNodeId % m_hSize;
     uint32_t destinationY = destinationNodeId / m_hSize;
@@ -624,25 +1027,15 @@ namespace ns3
       }
     NS_ASSERT_MSG (m_numberOfFlits >= 1, "The number of flits must be at least 1 (the head flit) but it is " << m_numberOfFlits);
 
-    Ptr<NocNode> destinationNode;
-    for (NetDeviceContainer::Iterator i = m_devices.Begin(); i
-        != m_devices.End(); ++i)
-      {
-        Ptr<Node> tmpNode = (*i)->GetNode();
-        if (destinationNodeId == tmpNode->GetId())
-          {
-            destinationNode = tmpNode->GetObject<NocNode> ();
-            break;
-          }
-      }
+    Ptr<NocNode> destinationNode = m_localTaskDestinations[destinationIndex];
     if (sourceNodeId == destinationNodeId)
       {
         NS_LOG_LOGIC ("Trying to send a packet from node " << sourceNodeId << " to node "
             << destinationNodeId << ". Aborting because source and destination nodes are the same.");
 
-        if (m_currentDestinationIndex[iteration] < m_localTaskList.size () - 1)
+        state.m_currentTaskDependency++;
+        if (HasReadyDestination (state))
         {
-            m_currentDestinationIndex[iteration]++;
             ScheduleNextTx (iteration);
         }
       }
@@ -650,44 +1043,42 @@ namespace ns3
       {
         NS_LOG_LOGIC ("A flit is sent from node " << sourceNodeId << " to node " << destinationNodeId);
 
-        PointerValue nocPointer;
-        NocRegistry::GetInstance ()->GetAttribute ("NoCTopology", nocPointer);
-        Ptr<NocTopology> nocTopology = nocPointer.Get<NocTopology> ();
-        NS_ASSERT_MSG (nocTopology != 0, "The NoC topology was not registered in NocRegistry!");
-        vector<uint8_t> relativePositions = nocTopology->GetDestinationRelativeDimensionalPosition (sourceNodeId,
-            destinationNodeId);
-        uint8_t relativeX = relativePositions[0];
-        uint8_t relativeY = relativePositions[1];
+        Ptr<NocTopology> nocTopology = m_context->GetTopology ();
+        NocCoordinate relativePositions[NocHeader::MAX_DIMENSIONS];
+        nocTopology->GetDestinationRelativePosition (sourceNodeId, destinationNodeId, relativePositions);
+        NocCoordinate relativeX = relativePositions[0];
+        NocCoordinate relativeY = relativePositions[1];
         // end traffic pattern
 
         NS_ASSERT_MSG (m_numberOfFlits >= 1,
             "The number of flits must be at least 1 (the head flit) but it is " << m_numberOfFlits);
-        if (m_currentFlitIndex[iteration] == 0)
+        if (state.m_currentFlitIndex == 0)
           {
             NS_ASSERT_MSG (m_flitSize >= (uint64_t) NocHeader::GetHeaderSize(),
                 "The flit size must be at least " << NocHeader::GetHeaderSize()
                 << " bytes (the packet header size), but it is " << m_flitSize << "!");
-            m_currentHeadFlit[iteration] = Create<NocPacket> (relativeX, relativeY, sourceX,
+            state.m_currentHeadFlit = Create<NocPacket> (relativeX, relativeY, sourceX,
                 sourceY, m_numberOfFlits - 1, m_flitSize - NocHeader::GetHeaderSize());
             NocPacketTag packetTag;
-            m_currentHeadFlit[iteration]->RemovePacketTag (packetTag);
+            state.m_currentHeadFlit->RemovePacketTag (packetTag);
             packetTag.SetCtgIteration (iteration);
-            m_currentHeadFlit[iteration]->AddPacketTag (packetTag);
-            NS_LOG_LOGIC ("Preparing to inject flit " << *m_currentHeadFlit[iteration]);
+            packetTag.SetCtgDependency (m_localTaskRemoteDependencies[destinationIndex]);
+            state.m_currentHeadFlit->AddPacketTag (packetTag);
+            NS_LOG_LOGIC ("Preparing to inject flit " << *state.m_currentHeadFlit);
             if (Simulator::Now () >= GetGlobalClock () * Scalar (m_warmupCycles))
               {
-                m_flitInjectedTrace (m_currentHeadFlit[iteration]);
+                m_flitInjectedTrace (state.m_currentHeadFlit);
               }
-            sourceNode->InjectPacket (m_currentHeadFlit[iteration], destinationNode);
-            m_currentFlitIndex[iteration]++;
-            m_totBytes[iteration] += m_flitSize - NocHeader::GetHeaderSize();
-            m_totalTaskBytes[iteration] += m_flitSize - NocHeader::GetHeaderSize();
+            sourceNode->InjectPacket (state.m_currentHeadFlit, destinationNode);
+            state.m_currentFlitIndex++;
+            state.m_totBytes += m_flitSize - NocHeader::GetHeaderSize();
+            state.m_totalTaskBytes += m_flitSize - NocHeader::GetHeaderSize();
           }
         else
           {
             bool isTail = false;
             // the last packet sent might be smaller (i.e. its number of flits is < m_numberOfFlits)
-            if (m_currentFlitIndex[iteration] + 1 == m_numberOfFlits || (m_totalTaskBytes[iteration] + m_flitSize) * 8 >= dtd.GetData())
+            if (state.m_currentFlitIndex + 1 == m_numberOfFlits || (state.m_totalTaskBytes + m_flitSize) * 8 >= dtd.GetData())
               {
                 isTail = true;
                 NS_LOG_DEBUG ("About to inject a tail flit");
@@ -696,56 +1087,58 @@ namespace ns3
               {
                 NS_LOG_DEBUG ("About to inject a data flit");
               }
-            Ptr<NocPacket> dataFlit = Create<NocPacket> (m_currentHeadFlit[iteration]->GetUid (), m_flitSize, isTail);
+            Ptr<NocPacket> dataFlit = Create<NocPacket> (state.m_currentHeadFlit->GetUid (), m_flitSize, isTail);
             NocPacketTag packetTag;
             dataFlit->RemovePacketTag (packetTag);
             packetTag.SetCtgIteration (iteration);
+            packetTag.SetCtgDependency (m_localTaskRemoteDependencies[destinationIndex]);
             dataFlit->AddPacketTag (packetTag);
             if (Simulator::Now () >= GetGlobalClock () * Scalar (m_warmupCycles))
               {
                 m_flitInjectedTrace (dataFlit);
               }
             sourceNode->InjectPacket (dataFlit, destinationNode);
-            m_currentFlitIndex[iteration]++;
-            m_totBytes[iteration] += m_flitSize;
-            m_totalTaskBytes[iteration] += m_flitSize;
+            state.m_currentFlitIndex++;
+            state.m_totBytes += m_flitSize;
+            state.m_totalTaskBytes += m_flitSize;
           }
-        if (m_currentFlitIndex[iteration] == m_numberOfFlits)
+        if (state.m_currentFlitIndex == m_numberOfFlits)
           {
             if (Simulator::Now () >= GetGlobalClock () * Scalar (m_warmupCycles))
               {
                 NS_LOG_DEBUG ("An entire packet was injected into the network");
-                m_packetInjectedTrace (m_currentHeadFlit[iteration]);
+                m_packetInjectedTrace (state.m_currentHeadFlit);
               }
-            m_currentFlitIndex[iteration] = 0;
+            state.m_currentFlitIndex = 0;
           }
 
-        m_totFlits[iteration] ++;
+        state.m_totFlits ++;
 
-        NS_LOG_LOGIC ("Node " << GetNode ()->GetId () << " sent " << m_totalTaskBytes[iteration] << " bytes (in total), at CTG iteration " << iteration);
+        NS_LOG_LOGIC ("Node " << GetNode ()->GetId () << " sent " << state.m_totalTaskBytes << " bytes (in total), at CTG iteration " << iteration);
 
-        if (m_totalTaskBytes[iteration] * 8 >= dtd.GetData())
+        if (state.m_totalTaskBytes * 8 >= dtd.GetData())
         {
             NS_LOG_LOGIC ("All data was sent to the current destination node");
             // the last packet sent might be smaller (i.e. its number of flits is < m_numberOfFlits)
             // this means that it must be traced (m_packetTrace) here because the above tracing will most likely not apply
-            if (m_currentFlitIndex[iteration] > 0 && m_currentFlitIndex[iteration] < m_numberOfFlits && Simulator::Now () >= GetGlobalClock ()
+            if (state.m_currentFlitIndex > 0 && state.m_currentFlitIndex < m_numberOfFlits && Simulator::Now () >= GetGlobalClock ()
                 * Scalar (m_warmupCycles))
               {
                 NS_LOG_DEBUG ("An entire packet was injected into the network (this is the last packet injected and it has a smaller number of flits)");
-                m_packetInjectedTrace (m_currentHeadFlit[iteration]);
+                m_packetInjectedTrace (state.m_currentHeadFlit);
               }
-            m_currentFlitIndex[iteration] = 0;
-            // when m_currentDestinationIndex[iteration] = m_localTaskList.size () no further injection will be done
-            // (this core injected all the data in the NoC, from all its tasks)
-            m_currentDestinationIndex[iteration]++;
-            m_totalTaskBytes[iteration] = 0;
+            state.m_currentFlitIndex = 0;
+            // the next injection is for the next dependency of the current ready task, or of the next ready task;
+            // when no ready task has data left, the injection is resumed by FlitReceivedCallback (...)
+            state.m_currentTaskDependency++;
+            state.m_totalTaskBytes = 0;
         }
-        if (m_currentDestinationIndex[iteration] < m_localTaskList.size ())
+        if (HasReadyDestination (state))
         {
             ScheduleNextTx (iteration);
         }
       }
+    ReleaseIterationState (iteration);
   }
 
   NocCtgApplication::TaskData::TaskData (string id, Time execTime)
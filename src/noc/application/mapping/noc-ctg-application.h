@@ -33,8 +33,13 @@
 #include "ns3/node-container.h"
 #include "ns3/net-device-container.h"
 #include "ns3/noc-packet.h"
+#include "ns3/noc-packet-tag.h"
+#include "ns3/noc-simulation-context.h"
 #include "ns3/nstime.h"
+#include "ns3/noc-node.h"
 #include <vector>
+#include <list>
+#include <map>
 
 using namespace std;
 
@@ -170,12 +175,6 @@ public:
   void
   SetMaxBytes (uint32_t maxBytes);
 
-  void
-  SetNetDeviceContainer (NetDeviceContainer devices);
-
-  void
-  SetNodeContainer (NodeContainer nodes);
-
   /**
    * Sets the task list and computes the total execution time of these tasks (as the sum of the execution times of each task).
    * This method should be called right after instantiating this NocCtgApplication.
@@ -204,6 +203,16 @@ public:
   void
   SetLocalTaskList (list<DependentTaskData> taskDestinationList);
 
+  /**
+   * \param senderTaskId the ID of the task which sends the data
+   * \param receivingTaskId the ID of the task which receives the data
+   *
+   * \return the index of the specified dependency in the remote task list of this application,
+   *         or the size of the remote task list if this application does not receive such data
+   */
+  uint32_t
+  GetRemoteDependencyIndex (string senderTaskId, string receivingTaskId) const;
+
 protected:
 
   virtual void
@@ -244,23 +253,111 @@ private:
   uint64_t m_currentIteration;
 
   uint32_t           m_hSize;                   // The horizontal size of a 2D mesh (how many nodes can be put on a line). The vertical size of the 2D mesh is given by number of nodes
-  NetDeviceContainer m_devices;                 // the net devices from the NoC network
-  NodeContainer      m_nodes;                   // the nodes from the NoC network
   uint32_t           m_flitSize;                // The flit size (the head flit will use part of this size for the flit header)
   uint64_t           m_numberOfFlits;           // How many flits a packet will have
-  vector<uint64_t>   m_currentFlitIndex;        // the index of the flit to be injected ( [0, m_numberOfFlits - 1] )
-  vector<Ptr<NocPacket> > m_currentHeadFlit;    // the current head flit
   uint32_t           m_maxBytes;                // Limit total number of bytes sent
-  vector<uint32_t>   m_totBytes;                // Total bytes sent so far
   uint32_t           m_maxFlits;                // the maximum number of flits which may be injected (zero means no limit)
-  vector<uint32_t>   m_totFlits;                // Total flits injected so far
   uint32_t           m_warmupCycles;            // During warmup cycles, no statistics are collected
-  vector<EventId>    m_startEvent;              // Event id for next start event
-  vector<EventId>    m_sendEvent;               // Event id of pending send flit event
-  vector<bool>       m_injectionStarted;        // marks if this is the first time a flit is scheduled to be injected
-  
+
+  /**
+   * The state kept by this application for a CTG iteration which is in progress
+   */
+  struct IterationState
+  {
+    IterationState ();
+
+    bool               m_used;                    // whether or not this state belongs to an iteration in progress
+    uint64_t           m_iteration;               // the CTG iteration which owns this state
+    uint64_t           m_currentFlitIndex;        // the index of the flit to be injected ( [0, m_numberOfFlits - 1] )
+    Ptr<NocPacket>     m_currentHeadFlit;         // the current head flit
+    uint32_t           m_totBytes;                // Total bytes sent so far
+    uint32_t           m_totFlits;                // Total flits injected so far
+    EventId            m_startEvent;              // Event id for next start event
+    EventId            m_sendEvent;               // Event id of pending send flit event
+    bool               m_injectionStarted;        // marks if this is the first time a flit is scheduled to be injected
+    double             m_receivedData;            // the amount of data received for this iteration (in bits)
+    vector<double>     m_remainingData;           // for each dependency from m_remoteTaskList, the data which is still to be received (in bits; at most 0 once it is satisfied)
+    vector<uint32_t>   m_pendingDependencies;     // for each task from m_taskList, how many of its dependencies are not satisfied yet
+    vector<uint32_t>   m_readyTasks;              // the ready queue: the tasks from m_taskList with all dependencies satisfied, in topological order
+    uint32_t           m_currentReadyTask;        // the element from m_readyTasks whose data is currently injected
+    uint32_t           m_currentTaskDependency;   // the element from m_taskOutgoingDependencies (of the current ready task) that is currently active for flit injection
+    uint32_t           m_totalTaskBytes;          // the total number of bytes sent to the current destination task
+  };
+
+  /**
+   * the states of the CTG iterations in progress, kept in a ring which is indexed with
+   * the iteration number, modulo the ring size (always a power of two). Only the iterations
+   * in progress use memory, so the number of CTG iterations is not limited by this ring.
+   * The ring grows up to m_maxIterationWindow states.
+   */
+  vector<IterationState> m_iterationStates;
+
+  /** the initial size of the m_iterationStates ring */
+  uint32_t m_iterationWindow;
+
+  /** the maximum size of the m_iterationStates ring */
+  uint32_t m_maxIterationWindow;
+
+  /** whether or not the start of a CTG iteration waits for a free slot of the m_iterationStates ring */
+  bool m_deferredStart;
+
+  /** the CTG iteration whose start waits for a free slot of the m_iterationStates ring */
+  uint64_t m_deferredStartIteration;
+
+  /**
+   * Retrieves the state of a CTG iteration. If the iteration has no state yet, a new one is
+   * created with CreateIterationState (...). The simulation is aborted if the ring is full,
+   * because the data received for an iteration cannot be deferred.
+   * Note that the returned reference is invalidated when the ring grows, so it must not be kept
+   * while the state of another iteration is created.
+   *
+   * \param iteration the CTG iteration
+   *
+   * \return the state of the iteration
+   */
+  IterationState &
+  GetIterationState (uint64_t iteration);
+
+  /**
+   * Creates the state of a CTG iteration which has no state yet. The ring grows when the slot of
+   * the iteration is used by another iteration in progress, up to m_maxIterationWindow states.
+   * The dependency counters of the new state are initialized with InitDependencies (...).
+   *
+   * \param iteration the CTG iteration
+   *
+   * \return the new state of the iteration, or 0 if the ring is full
+   */
+  IterationState *
+  CreateIterationState (uint64_t iteration);
+
+  /**
+   * \param iteration the CTG iteration
+   *
+   * \return the state of the iteration, or 0 if the iteration has no state
+   */
+  IterationState *
+  FindIterationState (uint64_t iteration);
+
+  /**
+   * Doubles the size of the m_iterationStates ring
+   */
+  void
+  GrowIterationStates ();
+
+  /**
+   * Frees the state of the specified CTG iteration, if this node finished both receiving and sending
+   * the data of that iteration. A deferred iteration start is retried afterwards.
+   *
+   * \param iteration the CTG iteration
+   */
+  void
+  ReleaseIterationState (uint64_t iteration);
+
   /** keeps all the tasks that are assigned to the IP core associated with this ns-3 application */
-  list<TaskData> m_taskList;
+  vector<TaskData> m_taskList;
+
+  /** the index of each task from m_taskList (task ID, index) */
+  map<string, uint32_t> m_taskIndexes;
 
   /**
    * Checks if the task list contains the specified task
@@ -279,19 +376,51 @@ private:
   Time m_executionAvailabilityTime;
 
   /** keeps all the remote tasks that send data to this NoC node */
-  list<DependentTaskData> m_remoteTaskList;
+  vector<DependentTaskData> m_remoteTaskList;
 
   /** the total amount of data to be received at this node (in bits) */
   double m_totalData;
 
-  /** keeps the amount of data currently received by this node (in bits). It obviously cannot exceed m_totalData */
-  vector<double> m_receivedData;
+  /**
+   * the receiving task (an index from m_taskList) of each dependency from m_remoteTaskList,
+   * or m_taskList.size () if the receiving task is not assigned to this node
+   */
+  vector<uint32_t> m_dependencyTasks;
+
+  /** for each task from m_taskList, how many dependencies from m_remoteTaskList it waits for */
+  vector<uint32_t> m_taskDependencyCounts;
+
+  /**
+   * the data (in bits) which is received for each dependency from m_remoteTaskList
+   * (the data of a duplicate dependency is received by its first occurrence)
+   */
+  vector<double> m_dependencyData;
+
+  /**
+   * for each task from m_taskList, the dependencies from m_remoteTaskList which it sends to other tasks
+   * of this node (this data does not go through the network)
+   */
+  vector<vector<uint32_t> > m_taskLocalDependencies;
+
+  /** the index of each dependency from m_remoteTaskList ((sender task ID, receiving task ID), index) */
+  map<pair<string, string>, uint32_t> m_dependencyIndexes;
 
   /** keeps all the local tasks that send data to tasks from remote NoC nodes */
-  list<DependentTaskData> m_localTaskList;
+  vector<DependentTaskData> m_localTaskList;
+
+  /**
+   * the destination node of each task from m_localTaskList (looked up when the application starts)
+   */
+  vector<Ptr<NocNode> > m_localTaskDestinations;
 
-  /** marks the element from the m_localTaskList list that is currently active for flit injection */
-  vector<uint32_t> m_currentDestinationIndex;
+  /**
+   * for each dependency from m_localTaskList, its index in the remote task list of the receiving application
+   * (looked up when the application starts). The injected flits carry it in their NocPacketTag.
+   */
+  vector<uint32_t> m_localTaskRemoteDependencies;
+
+  /** for each task from m_taskList, the dependencies from m_localTaskList which it sends */
+  vector<vector<uint32_t> > m_taskOutgoingDependencies;
 
   /**
    * Retrieves the item from the local task list, located at the specified index
@@ -300,7 +429,8 @@ private:
    *
    * \return the DependentTaskData from the list
    */
-  DependentTaskData GetLocalDependentTaskData (uint32_t index);
+  DependentTaskData &
+  GetLocalDependentTaskData (uint32_t index);
 
   /**
    *
@@ -309,8 +439,98 @@ private:
   bool
   ContainsNotDependentTask ();
 
-  /** the total number of bytes sent to the current destination task */
-  vector<uint32_t> m_totalTaskBytes;
+  /**
+   * whether or not this application has a task that does not receive data from any other remote task.
+   * This is computed by UpdateDependencies (), every time the remote or the local task list is set.
+   */
+  bool m_containsNotDependentTask;
+
+  /**
+   * Computes m_containsNotDependentTask from the remote and local task lists and compiles
+   * the dependencies into the integer indexed arrays used when flits are received and injected
+   * (m_dependencyIndexes, m_dependencyTasks, m_taskDependencyCounts, m_dependencyData,
+   * m_taskLocalDependencies and m_taskOutgoingDependencies)
+   */
+  void
+  UpdateDependencies ();
+
+  /**
+   * Initializes the dependency counters of a new CTG iteration and puts the tasks
+   * which wait for no data into its ready queue
+   *
+   * \param state the state of the CTG iteration
+   */
+  void
+  InitDependencies (IterationState &state);
+
+  /**
+   * Credits the data carried by a received flit to the dependency from its packet tag
+   *
+   * \param state the state of the CTG iteration of the flit
+   * \param tag the packet tag of the flit
+   * \param data the amount of data carried by the flit (in bits)
+   */
+  void
+  ReceiveData (IterationState &state, const NocPacketTag &tag, double data);
+
+  /**
+   * Marks a dependency as satisfied. When its receiving task does not wait for other
+   * dependencies, the task is put into the ready queue.
+   *
+   * \param state the state of the CTG iteration
+   * \param dependency the dependency (an index from m_remoteTaskList)
+   */
+  void
+  SatisfyDependency (IterationState &state, uint32_t dependency);
+
+  /**
+   * Puts a task into the ready queue of a CTG iteration. The dependencies sent by this task
+   * to the other tasks of this node are satisfied too (Kahn's algorithm), because the core
+   * executes all its tasks in a single run, so the ready queue keeps a topological order.
+   *
+   * \param state the state of the CTG iteration
+   * \param task the task (an index from m_taskList)
+   */
+  void
+  PushReadyTask (IterationState &state, uint32_t task);
+
+  /**
+   * \param state the state of a CTG iteration
+   *
+   * \return whether or not all the tasks of this node are ready in the specified CTG iteration
+   *          (i.e. this node received all its data)
+   */
+  bool
+  IsIterationReady (const IterationState &state) const;
+
+  /**
+   * Moves the injection of a CTG iteration past the ready tasks which have no more data to send.
+   * The tasks send their data in the order of the ready queue.
+   *
+   * \param state the state of a CTG iteration
+   *
+   * \return whether or not a ready task still has data to send (the dependency from
+   *          m_localTaskList which is injected is then given by GetCurrentDestination (...))
+   */
+  bool
+  HasReadyDestination (IterationState &state);
+
+  /**
+   * \param state the state of a CTG iteration, for which HasReadyDestination (...) is true
+   *
+   * \return the dependency from m_localTaskList which is currently injected
+   */
+  uint32_t
+  GetCurrentDestination (const IterationState &state) const;
+
+  /**
+   * Continues the flit injection of a CTG iteration, after some of its tasks became ready.
+   * The injection is started, if it did not start yet, or resumed, if it waits for tasks to become ready.
+   *
+   * \param iteration the CTG iteration
+   */
+  void
+  ResumeInjection (uint64_t iteration);
 
   /**
    * Allows tracing injected packets into the network.
@@ -328,6 +548,11 @@ private:
    */
   TracedCallback<Ptr<const Packet> > m_flitReceivedTrace;
 
+  /**
+   * the simulation context of the NoC topology (retrieved when the application starts)
+   */
+  Ptr<NocSimulationContext> m_context;
+
   Time
   GetGlobalClock () const;
 
@@ -344,6 +569,7 @@ private:
   /**
    * For each IP core from the CTG, the flit injection is just started with this method.
    * ScheduleNextTx (...) is used to continue the flit injection.
+   * The nodes which do not wait for data schedule the start of an iteration when the previous one starts.
    *
    * \param iteration the CTG iteration number (0 is the first iteration)
    */
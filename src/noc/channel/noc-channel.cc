@@ -29,7 +29,11 @@
 #include "ns3/integer.h"
 #include "ns3/boolean.h"
 #include "ns3/double.h"
+#include "ns3/trace-source-accessor.h"
 #include "ns3/noc-registry.h"
+#include "ns3/noc-cycle-engine.h"
+#include "ns3/noc-load-side-band.h"
+#include "ns3/noc-profiler.h"
 #include "src/noc/orion/SIM_link.h"
 #include <math.h>
 
@@ -60,10 +64,17 @@ namespace ns3
                        TimeValue (PicoSeconds (0)), // no channel delay by default
                        MakeTimeAccessor (&NocChannel::m_delay),
                        MakeTimeChecker ())
+        .AddAttribute ("CreditDelay", "The time needed by a credit to travel back to the upstream net device "
+                       "(no credit delay by default)",
+                       TimeValue (PicoSeconds (0)),
+                       MakeTimeAccessor (&NocChannel::m_creditDelay),
+                       MakeTimeChecker ())
         .AddAttribute ("Length", "The length of this wire, in um (micro meters); 50 um by default",
                        DoubleValue (50),
                        MakeDoubleAccessor (&NocChannel::m_length),
                        MakeDoubleChecker<double> (1e-3))
+        .AddTraceSource ("FlitLost", "A flit was lost, because the channel or one of its net devices is faulty",
+                         MakeTraceSourceAccessor (&NocChannel::m_flitLostTrace))
         ;
     return tid;
   }
@@ -73,6 +84,7 @@ namespace ns3
     NS_LOG_FUNCTION_NOARGS ();
     m_fullDuplex = true;
     m_trasmittedFlits = 0;
+    m_losingFlits = 0;
     m_state.insert(m_state.end(), IDLE); // the state of the Tx line
     if (m_fullDuplex) {
         m_state.insert(m_state.end(), IDLE); // the state of the Rx line
@@ -89,18 +101,30 @@ namespace ns3
     if (m_fullDuplex) {
         m_currentDestDevice.insert(m_currentDestDevice.end(), 0);
     }
+    m_currentVirtualChannel.insert(m_currentVirtualChannel.end(), -1);
+    if (m_fullDuplex) {
+        m_currentVirtualChannel.insert(m_currentVirtualChannel.end(), -1);
+    }
     NS_LOG_LOGIC ("switched to IDLE");
     m_devices.clear();
 
     m_powerCounter = 0;
+    m_lastClock = 0;
+    m_trasmittedFlits = 0;
+    m_transmittedBits = 0;
     m_dynamicPower = 0;
     m_leakagePower = 0;
+    m_dynamicPowerPerBit = 0;
+    m_leakagePowerPerBit = 0;
+    m_powerTableFrequency = 0;
+    m_powerTableLength = -1;
   }
 
   bool
-  NocChannel::TransmitStart (Ptr<NocNetDevice> originalNetDevice, Ptr<Packet> p, uint32_t srcId)
+  NocChannel::TransmitStart (Ptr<NocNetDevice> originalNetDevice, Ptr<Packet> p, uint32_t srcId, int virtualChannel)
   {
     NS_LOG_FUNCTION ("original net device" << originalNetDevice->GetAddress () << "packet" << *p << "node" << (int) srcId);
+    NOC_PROFILE (CHANNEL_TRANSMIT, GetInstanceTypeId ());
     NS_LOG_DEBUG ("Packet UID " << p->GetUid ());
     NS_LOG_DEBUG ("Channel ID " << GetId ());
     NS_LOG_DEBUG ("Original net device " << originalNetDevice->GetAddress ());
@@ -137,12 +161,13 @@ namespace ns3
       }
     NS_ASSERT (m_currentDestDevice[link] != 0);
     NS_LOG_DEBUG ("The receiving net device is " << m_currentDestDevice[link]->GetAddress ());
-    if (m_currentDestDevice[link]->GetInQueueNPacktes () == m_currentDestDevice[link]->GetInQueueSize ())
+    if (virtualChannel >= 0 && !sender->HasCredit (virtualChannel))
       {
         NS_LOG_WARN ("The receiving net device " << m_currentDestDevice[link]->GetAddress ()
-            << " will have no place to buffer the packet");
+            << " will have no place to buffer the packet (no credit for virtual channel " << virtualChannel << ")");
         return false;
       }
+    m_currentVirtualChannel[link] = virtualChannel;
 
     m_state[link] = TRANSMITTING;
     if (!m_fullDuplex) {
@@ -181,18 +206,22 @@ namespace ns3
     NS_LOG_DEBUG("number of devices for node " << sender->GetNode()->GetId() << " is " << m_devices.size());
     NS_LOG_DEBUG ("The packet " << (*m_currentPkt[link]) << " has size " << (int) m_currentPkt[link]->GetSize ());
 
+    // a flit which reaches its destination at the next router is not buffered there, so it needs no credit
+    if (m_currentVirtualChannel[link] >= 0 && to != m_currentDestDevice[link]->GetAddress ())
+      {
+        sender->ConsumeCredit (m_currentVirtualChannel[link]);
+      }
+
     int speedup = 1;
     if (m_currentPkt[link] != 0)
       {
+        NS_ASSERT_MSG (m_context != 0, "The channel has no simulation context (was the topology installed?)");
         NocPacketTag tag;
         m_currentPkt[link]->PeekPacketTag (tag);
         if (NocPacket::HEAD == tag.GetPacketType ())
           {
             // a data packet will be sent
-            IntegerValue dataFlitSpeedup;
-            Ptr<NocRegistry> nocRegistry = NocRegistry::GetInstance ();
-            nocRegistry->GetAttribute ("DataPacketSpeedup", dataFlitSpeedup);
-            speedup = dataFlitSpeedup.Get ();
+            speedup = m_context->GetDataFlitSpeedup ();
           }
       }
     NS_LOG_LOGIC ("The channel has a delay of " << m_delay);
@@ -227,8 +256,17 @@ namespace ns3
     NS_LOG_DEBUG ("Schedule event (channel transmission) to occur at time "
         << Simulator::Now() + (m_delay + tEvent) / Scalar (speedup));
     // if default values for delay and data rate are used (0 and respectively infinite), then the channel transports the data instantly
-    Simulator::Schedule ((m_delay + tEvent) / Scalar (speedup), &NocChannel::TransmitEnd, this, sender, to,
-        m_currentDestDevice[link], from);
+    NocCycleEngine *engine = m_context != 0 ? m_context->GetCycleEngine () : 0;
+    if (engine != 0)
+      {
+        engine->ScheduleTransmitEnd ((m_delay + tEvent) / Scalar (speedup), this, PeekPointer (sender), to,
+            PeekPointer (m_currentDestDevice[link]), from);
+      }
+    else
+      {
+        Simulator::Schedule ((m_delay + tEvent) / Scalar (speedup), &NocChannel::TransmitEnd, this, sender, to,
+            m_currentDestDevice[link], from);
+      }
 
     result = true;
 
@@ -238,6 +276,7 @@ namespace ns3
   void
   NocChannel::TransmitEnd (Ptr<NocNetDevice> srcNocNetDevice, Mac48Address to, Ptr<NocNetDevice> destNocNetDevice, Mac48Address from)
   {
+    NOC_PROFILE (CHANNEL_PROPAGATE, GetInstanceTypeId ());
     uint32_t srcId;
     bool found = false;
     for (uint32_t i = 0; i < m_devices.size (); ++i) {
@@ -268,16 +307,25 @@ namespace ns3
         NS_LOG_DEBUG ("Load component found");
 
         loadComponent->IncreaseLoad ();
-        NocPacketTag tag;
-        m_currentPkt[link]->PeekPacketTag (tag);
-        if (NocPacket::HEAD == tag.GetPacketType ())
+        NocLoadSideBand *sideBand = m_context != 0 ? m_context->GetLoadSideBand () : 0;
+        if (sideBand != 0)
           {
-            NocHeader nocHeader;
-            m_currentPkt[link]->PeekHeader (nocHeader);
-            if (!nocHeader.IsEmpty ())
+            // the neighbors learn the load of this router through the side-band
+            sideBand->NotifyActivity ();
+          }
+        else
+          {
+            NocPacketTag tag;
+            m_currentPkt[link]->PeekPacketTag (tag);
+            if (NocPacket::HEAD == tag.GetPacketType ())
               {
-                uint8_t load = tag.GetLoad ();
-                router->AddNeighborLoad ((int) load, srcNocNetDevice);
+                NocHeader nocHeader;
+                m_currentPkt[link]->PeekHeader (nocHeader);
+                if (!nocHeader.IsEmpty ())
+                  {
+                    uint8_t load = tag.GetLoad ();
+                    router->AddNeighborLoad ((int) load, srcNocNetDevice);
+                  }
               }
           }
       }
@@ -290,15 +338,28 @@ namespace ns3
     NS_ASSERT (originalNetDevice != 0);
     NS_LOG_LOGIC ("Dequeuing the transmitted packet from the queue of net device "
         << originalNetDevice->GetAddress ());
-    Ptr<const Packet> dequeuedPacket = originalNetDevice->DequeuePacketFromInQueue ();
+    Ptr<const Packet> dequeuedPacket = originalNetDevice->DequeueTransmittedPacket (m_currentPkt[link]->GetUid ());
     NS_ASSERT (dequeuedPacket != 0);
     NS_ASSERT_MSG(m_currentPkt[link]->GetUid () == dequeuedPacket->GetUid (),
         "The transmitted packet (UID " << m_currentPkt[link]->GetUid ()
         << ") should have been dequeued, not packet with UID " << dequeuedPacket->GetUid ());
     m_packetOriginalDevice[link].erase (m_currentPkt[link]->GetUid ());
 
-    NS_LOG_LOGIC ("The channel is calling the Receive method of the net device");
-    destNocNetDevice->Receive (m_currentPkt[link]->Copy (), to, from);
+    if (m_losingFlits > 0 || srcNocNetDevice->IsLosingFlits () || destNocNetDevice->IsLosingFlits ())
+      {
+        NS_LOG_LOGIC ("The packet with UID " << m_currentPkt[link]->GetUid () << " is lost by the faulty link");
+        if (m_currentVirtualChannel[link] >= 0 && to != destNocNetDevice->GetAddress ())
+          {
+            // the flit consumed a credit of the receiving net device (see Send)
+            destNocNetDevice->LoseFlit (m_currentPkt[link]);
+          }
+        m_flitLostTrace (m_currentPkt[link]);
+      }
+    else
+      {
+        NS_LOG_LOGIC ("The channel is calling the Receive method of the net device");
+        destNocNetDevice->Receive (m_currentPkt[link]->Copy (), to, from);
+      }
 
     m_state[link] = IDLE;
     if (!m_fullDuplex) {
@@ -308,33 +369,42 @@ namespace ns3
     }
 
     m_powerCounter++;
-    TimeValue timeValue;
-    NocRegistry::GetInstance ()->GetAttribute ("GlobalClock", timeValue);
-    Time globalClock = timeValue.Get ();
-    uint64_t clockNumber = Simulator::Now ().GetPicoSeconds () / globalClock.GetPicoSeconds () + 1;
+    uint64_t clockNumber = m_context->GetClockNumber (Simulator::Now ());
     NS_LOG_DEBUG ("clock number " << clockNumber);
     NS_LOG_DEBUG ("last clock " << m_lastClock);
     if (clockNumber > m_lastClock)
       {
-        // the following loop measures the power consumed by the flits from the previous clock cycle (m_lastClock)
-        for (unsigned int i = 0; i < m_flitsFromLastClock.size (); ++i)
-          {
-            m_dynamicPower += GetDynamicPower (m_flitsFromLastClock[i]);
-            m_leakagePower += GetLeakagePower (m_flitsFromLastClock[i]);
-          }
-
-        m_flitsFromLastClock.clear ();
+        // the flits from the previous clock cycle (m_lastClock) are accounted for, by their number and size
+        RecordTransmittedFlits ();
         m_trasmittedFlits = 1;
+        m_transmittedBits = m_currentPkt[link]->GetSize () * 8;
         m_lastClock = clockNumber;
       }
     else
       {
         m_trasmittedFlits++;
+        m_transmittedBits += m_currentPkt[link]->GetSize () * 8;
       }
-    m_flitsFromLastClock.insert (m_flitsFromLastClock.end (), m_currentPkt[link]);
 
   }
 
+  void
+  NocChannel::SendCredit (Ptr<NocNetDevice> device, uint32_t virtualChannel)
+  {
+    NS_ASSERT_MSG (m_devices.size () == 2, "A NoCchannel must be connected to two net devices!");
+    Ptr<NocNetDevice> upstream = (device == m_devices[0] ? m_devices[1] : m_devices[0]);
+    NS_LOG_DEBUG ("The net device " << device->GetAddress () << " sends a credit for virtual channel "
+        << virtualChannel << " to the net device " << upstream->GetAddress ());
+    if (m_creditDelay.IsZero ())
+      {
+        upstream->ReturnCredit (virtualChannel);
+      }
+    else
+      {
+        Simulator::Schedule (m_creditDelay, &NocNetDevice::ReturnCredit, upstream, virtualChannel);
+      }
+  }
+
   uint32_t
   NocChannel::Add (Ptr<NocNetDevice> device)
   {
@@ -356,6 +426,18 @@ namespace ns3
     return m_devices[i];
   }
 
+  void
+  NocChannel::SetContext (Ptr<NocSimulationContext> context)
+  {
+    m_context = context;
+  }
+
+  Ptr<NocSimulationContext>
+  NocChannel::GetContext () const
+  {
+    return m_context;
+  }
+
   bool
   NocChannel::IsBusy (Ptr<NocNetDevice> device)
   {
@@ -387,6 +469,36 @@ namespace ns3
       }
   }
 
+  void
+  NocChannel::SetLosingFlits (bool losing)
+  {
+    NS_LOG_FUNCTION (losing);
+    if (losing)
+      {
+        m_losingFlits++;
+      }
+    else
+      {
+        NS_ASSERT_MSG (m_losingFlits > 0, "The channel " << GetId () << " does not lose flits");
+        m_losingFlits--;
+      }
+  }
+
+  Ptr<NocNetDevice>
+  NocChannel::GetTransmittingNetDevice (uint32_t srcId) const
+  {
+    NS_ASSERT (srcId < m_devices.size ());
+    uint32_t link = m_fullDuplex ? srcId : 0;
+    if (m_state[link] == IDLE)
+      {
+        return 0;
+      }
+    map<uint32_t, Ptr<NocNetDevice> >::const_iterator it = m_packetOriginalDevice[link].find (
+        m_currentPkt[link]->GetUid ());
+    NS_ASSERT (it != m_packetOriginalDevice[link].end ());
+    return it->second;
+  }
+
   DataRate
   NocChannel::GetDataRate ()
   {
@@ -423,79 +535,67 @@ namespace ns3
     return m_state[link];
   }
 
-  double
-  NocChannel::GetDynamicPower (Ptr<Packet> flit)
+  void
+  NocChannel::BuildPowerTable ()
   {
-    NS_LOG_FUNCTION (*flit);
-    double power = 0;
-
-    TimeValue timeValue;
-    NocRegistry::GetInstance ()->GetAttribute ("GlobalClock", timeValue);
-    Time globalClock = timeValue.Get ();
+    NS_LOG_FUNCTION_NOARGS ();
 
-    double freq = 1 / globalClock.GetSeconds ();
+    double freq = m_context->GetFrequency ();
     NS_LOG_DEBUG ("NoC clock frequency is " << freq << " Hz");
-    double dataWidth = flit->GetSize () * 8; // in bits
-    NS_LOG_DEBUG ("Transmitted flit has size " << dataWidth);
-    NS_LOG_DEBUG ("transmitted flits " << m_trasmittedFlits);
-    double load = m_trasmittedFlits * 1.0 / m_currentPkt.size ();
-    NS_LOG_DEBUG ("Channel load is " << load);
-    NS_ASSERT_MSG (load >= 0 && load <= 1, "Channel load in [0,1] interval");
-
     double linkLength = m_length * 1e-6; //unit meter
     NS_LOG_DEBUG ("Channel length is " << m_length << " micrometers");
-    power = 0.5 * load * LinkDynamicEnergyPerBitPerMeter(linkLength, Vdd) * freq * linkLength * dataWidth;
-    NS_LOG_LOGIC ("Flit " << *flit << " required " << power << " W of dynamic power to be sent through this link");
 
-    return power;
+    // power consumed by one bit, at full channel load
+    m_dynamicPowerPerBit = 0.5 * LinkDynamicEnergyPerBitPerMeter(linkLength, Vdd) * freq * linkLength;
+    m_leakagePowerPerBit = 0.5 * LinkLeakagePowerPerMeter(linkLength, Vdd) * linkLength;
+    NS_LOG_DEBUG ("Dynamic power per bit " << m_dynamicPowerPerBit
+        << ", leakage power per bit " << m_leakagePowerPerBit);
+
+    m_powerTableFrequency = freq;
+    m_powerTableLength = m_length;
   }
 
-  double
-  NocChannel::GetLeakagePower (Ptr<Packet> flit)
+  void
+  NocChannel::RecordTransmittedFlits ()
   {
-    NS_LOG_FUNCTION (*flit);
-    double power = 0;
-
-    TimeValue timeValue;
-    NocRegistry::GetInstance ()->GetAttribute ("GlobalClock", timeValue);
-    Time globalClock = timeValue.Get ();
-
-    double freq = 1 / globalClock.GetSeconds ();
-    NS_LOG_DEBUG ("NoC clock frequency is " << freq << " Hz");
-    double dataWidth = flit->GetSize () * 8; // in bits
-    NS_LOG_DEBUG ("Transmitted flit has size " << dataWidth);
-    NS_LOG_DEBUG ("transmitted flits " << m_trasmittedFlits);
-    double load = m_trasmittedFlits * 1.0 / m_currentPkt.size ();
-    NS_LOG_DEBUG ("Channel load is " << load);
-    NS_ASSERT_MSG (load >= 0 && load <= 1, "Channel load in [0,1] interval");
-
-    double linkLength = m_length * 1e-6; //unit meter
-    NS_LOG_DEBUG ("Channel length is " << m_length << " micrometers");
-    power = 0.5 * load * LinkLeakagePowerPerMeter(linkLength, Vdd) * linkLength * dataWidth;
-    NS_LOG_LOGIC ("Flit " << *flit << " required " << power << " W of leakage power to be sent through this link");
-
-    return power;
+    if (m_trasmittedFlits > 0)
+      {
+        if (m_bitsPerTransmitCount.size () <= m_trasmittedFlits)
+          {
+            m_bitsPerTransmitCount.resize (m_trasmittedFlits + 1, 0);
+          }
+        m_bitsPerTransmitCount[m_trasmittedFlits] += m_transmittedBits;
+      }
   }
 
   void
   NocChannel::MeasurePowerForLastClock ()
   {
     NS_LOG_FUNCTION_NOARGS ();
+    NOC_PROFILE (POWER_MEASUREMENT, GetInstanceTypeId ());
+
+    uint64_t clockNumber = m_context->GetClockNumber (Simulator::Now ());
+    RecordTransmittedFlits ();
+    m_trasmittedFlits = 0;
+    m_transmittedBits = 0;
+    m_lastClock = clockNumber;
 
-    TimeValue timeValue;
-    NocRegistry::GetInstance ()->GetAttribute ("GlobalClock", timeValue);
-    Time globalClock = timeValue.Get ();
-    uint64_t clockNumber = Simulator::Now ().GetPicoSeconds () / globalClock.GetPicoSeconds () + 1;
-    // the following loop measures the power consumed by the flits from the previous clock cycle (m_lastClock)
-    for (unsigned int i = 0; i < m_flitsFromLastClock.size (); ++i)
+    if (m_powerTableFrequency != m_context->GetFrequency () || m_powerTableLength != m_length)
       {
-        m_dynamicPower += GetDynamicPower (m_flitsFromLastClock[i]);
-        m_leakagePower += GetLeakagePower (m_flitsFromLastClock[i]);
+        BuildPowerTable ();
       }
+    NS_ASSERT_MSG (m_bitsPerTransmitCount.size () <= m_currentPkt.size () + 1,
+        "Channel load in [0,1] interval");
 
-    m_flitsFromLastClock.clear ();
-    m_trasmittedFlits = 0;
-    m_lastClock = clockNumber;
+    m_dynamicPower = 0;
+    m_leakagePower = 0;
+    for (uint32_t k = 1; k < m_bitsPerTransmitCount.size (); ++k)
+      {
+        double load = k * 1.0 / m_currentPkt.size ();
+        NS_LOG_DEBUG ("Channel load " << load << ": " << m_bitsPerTransmitCount[k] << " bits transmitted");
+        m_dynamicPower += load * m_bitsPerTransmitCount[k] * m_dynamicPowerPerBit;
+        m_leakagePower += load * m_bitsPerTransmitCount[k] * m_leakagePowerPerBit;
+      }
   }
 
   double
@@ -552,10 +652,7 @@ namespace ns3
     double linkLength = m_length * 1e-6; //unit meter
     NS_LOG_DEBUG ("Channel length is " << m_length << " micrometers");
 
-    IntegerValue flitSize;
-    NocRegistry::GetInstance ()->GetAttribute ("FlitSize", flitSize);
-
-    area = LinkArea(linkLength, flitSize.Get ());
+    area = LinkArea(linkLength, m_context->GetFlitSize ());
 
     NS_LOG_LOGIC ("Channel area is " << area << " um^2");
     return area;
@@ -28,6 +28,8 @@
 #include <vector>
 #include "ns3/noc-packet.h"
 #include "ns3/noc-net-device.h"
+#include "ns3/noc-simulation-context.h"
+#include "ns3/traced-callback.h"
 #include <map>
 
 using namespace std;
@@ -74,6 +76,20 @@ namespace ns3
     virtual Ptr<NetDevice>
     GetDevice (uint32_t i) const;
 
+    /**
+     * Sets the simulation context (this is done by the NoC topology, at install time)
+     *
+     * \param context the simulation context
+     */
+    void
+    SetContext (Ptr<NocSimulationContext> context);
+
+    /**
+     * \return the simulation context
+     */
+    Ptr<NocSimulationContext>
+    GetContext () const;
+
     /**
      * Get the assigned data rate of the channel
      *
@@ -111,6 +127,17 @@ namespace ns3
     virtual bool
     IsBusy (Ptr<NocNetDevice> device);
 
+    /**
+     * \param srcId the device Id of a net device connected to the channel
+     *
+     * \return the net device which generated the packet that occupies the link used by the given net device
+     *          (0 if the link is idle)
+     *
+     * \see TransmitStart
+     */
+    Ptr<NocNetDevice>
+    GetTransmittingNetDevice (uint32_t srcId) const;
+
     /**
      * \brief Start transmitting a packet over the channel
      *
@@ -126,10 +153,13 @@ namespace ns3
      * \param srcId The device Id of the net device that wants to
      * transmit on the channel
      *
-     * \return True if the channel is not busy
+     * \param virtualChannel the virtual channel of the receiving net device which will buffer the packet
+     * (0 if virtual channels are not used, -1 if the packet is not buffered there)
+     *
+     * \return True if the channel is not busy and the sending net device has a credit for the virtual channel
      */
     virtual bool
-    TransmitStart (Ptr<NocNetDevice> originalNetDevice, Ptr<Packet> p, uint32_t srcId);
+    TransmitStart (Ptr<NocNetDevice> originalNetDevice, Ptr<Packet> p, uint32_t srcId, int virtualChannel = 0);
 
     /**
      * \brief Transmits the packet. Please note that prior to calling this method, TransmitStart method must be called.
@@ -162,31 +192,56 @@ namespace ns3
     TransmitEnd (Ptr<NocNetDevice> srcNocNetDevice, Mac48Address to,
         Ptr<NocNetDevice> destNocNetDevice, Mac48Address from);
 
-private:
-
     /**
-     * Uses ORION to measure this channel's dynamic power, consumed for sending the specified flit.
+     * \brief Sends a credit back over the channel, to the net device from the other end of the channel.
+     * The credit arrives after the credit delay of the channel.
      *
-     * \param flit the flit
+     * \param device the net device which has room for one more flit
      *
-     * \return the dynamic power, in Watt
+     * \param virtualChannel the virtual channel with room for one more flit (0 if virtual channels are not used)
      */
-    virtual double
-    GetDynamicPower (Ptr<Packet> flit);
+    virtual void
+    SendCredit (Ptr<NocNetDevice> device, uint32_t virtualChannel);
 
     /**
-     * Uses ORION to measure this channel's leakage power.
+     * Makes the channel lose the flits which it transmits, or makes it work again. The calls are counted,
+     * like for NocNetDevice::SetLosingFlits.
      *
-     * \return the dynamic power, in Watt
+     * \param losing whether or not the flits are lost
      */
-    virtual double
-    GetLeakagePower (Ptr<Packet> flit);
+    void
+    SetLosingFlits (bool losing);
+
+    /**
+     * \return whether or not the channel loses the flits which it transmits
+     */
+    bool
+    IsLosingFlits () const
+    {
+      return m_losingFlits > 0;
+    }
+
+private:
+
+    /**
+     * Uses ORION to compute the dynamic and the leakage power consumed by one bit
+     * sent through this channel, at full load. The channel's length and the NoC clock
+     * do not change during a simulation, so this is done only once.
+     */
+    virtual void
+    BuildPowerTable ();
+
+    /**
+     * Adds the flits which were transmitted during the last clock cycle to the channel's activity counters.
+     */
+    void
+    RecordTransmittedFlits ();
 
     /**
      * Power is measured for the previous clock cycle.
      * This method is invoked when methods GetDynamicPower () and GetLeakagePower () are called,
      * with the purpose to measure power for the last clock too.
-     * The method has effect only if there are flits for which power wasn't measured.
+     * The channel's power is computed from its activity counters and its power table.
      */
     void
     MeasurePowerForLastClock ();
@@ -248,6 +303,11 @@ public:
      */
     Time m_delay;
 
+    /**
+     * The time needed by a credit to travel back to the upstream net device
+     */
+    Time m_creditDelay;
+
     /**
      * The length of this wire, in um (micro meters)
      */
@@ -277,14 +337,40 @@ public:
     uint64_t m_lastClock;
 
     /**
-     * the flits from the previous clock cycle, for which power will have to be measured
+     * the number of transmitted flits (during the last clock cycle)
      */
-    vector<Ptr<Packet> > m_flitsFromLastClock;
+    uint64_t m_trasmittedFlits;
 
     /**
-     * the number of transmitted flits
+     * the number of bits transmitted during the last clock cycle
      */
-    uint64_t m_trasmittedFlits;
+    uint64_t m_transmittedBits;
+
+    /**
+     * the channel's activity counters: element k holds how many bits were transmitted during
+     * clock cycles in which exactly k flits were transmitted through the channel
+     */
+    vector<uint64_t> m_bitsPerTransmitCount;
+
+    /**
+     * the dynamic power consumed by one bit, at full channel load
+     */
+    double m_dynamicPowerPerBit;
+
+    /**
+     * the leakage power consumed by one bit, at full channel load
+     */
+    double m_leakagePowerPerBit;
+
+    /**
+     * the NoC clock frequency used for computing the power per bit
+     */
+    double m_powerTableFrequency;
+
+    /**
+     * the channel length used for computing the power per bit
+     */
+    double m_powerTableLength;
 
     double m_dynamicPower;
 
@@ -299,11 +385,32 @@ public:
      */
     vector<map<uint32_t, Ptr<NocNetDevice> > > m_packetOriginalDevice;
 
+    /**
+     * the simulation context (global clock, speedup, flit size, topology)
+     */
+    Ptr<NocSimulationContext> m_context;
+
+    /**
+     * how many faults make the channel lose flits (see SetLosingFlits)
+     */
+    uint32_t m_losingFlits;
+
+    /**
+     * a flit was lost, because the channel or one of its net devices is faulty
+     */
+    TracedCallback<Ptr<const Packet> > m_flitLostTrace;
+
     /**
      * The current destination net device (one for each physical channel)
      */
     vector<Ptr<NocNetDevice> > m_currentDestDevice;
 
+    /**
+     * The virtual channel of the destination net device which buffers the current packet
+     * (one for each physical channel; -1 if the packet is not buffered by the destination net device)
+     */
+    vector<int> m_currentVirtualChannel;
+
   };
 
 } // namespace ns3
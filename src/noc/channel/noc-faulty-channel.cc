@@ -46,6 +46,13 @@ namespace ns3
             BooleanValue (false),
             MakeBooleanAccessor (&NocFaultyChannel::m_faulty),
             MakeBooleanChecker ())
+        .AddAttribute (
+            "LoseFlits",
+            "Whether or not a faulty channel loses the flits which cross it, instead of stopping the simulation "
+            "when it is used (default is false)",
+            BooleanValue (false),
+            MakeBooleanAccessor (&NocFaultyChannel::m_loseFlits),
+            MakeBooleanChecker ())
         ;
     return tid;
   }
@@ -53,10 +60,14 @@ namespace ns3
   NocFaultyChannel::NocFaultyChannel () : NocChannel ()
   {
     NS_LOG_FUNCTION_NOARGS ();
+    m_faulty = false;
+    m_loseFlits = false;
+    m_losing = false;
   }
 
   bool
-  NocFaultyChannel::TransmitStart (Ptr<NocNetDevice> originalNetDevice, Ptr<Packet> p, uint32_t srcId)
+  NocFaultyChannel::TransmitStart (Ptr<NocNetDevice> originalNetDevice, Ptr<Packet> p, uint32_t srcId,
+      int virtualChannel)
   {
     NS_LOG_FUNCTION_NOARGS ();
 
@@ -64,7 +75,7 @@ namespace ns3
 
     if (!m_faulty)
       {
-        start = NocChannel::TransmitStart (originalNetDevice, p, srcId);
+        start = NocChannel::TransmitStart (originalNetDevice, p, srcId, virtualChannel);
       }
     else
       {
@@ -227,4 +238,29 @@ namespace ns3
     return wireState;
   }
 
+  void
+  NocFaultyChannel::SetFaulty (bool faulty)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+    if (m_loseFlits)
+      {
+        if (faulty != m_losing)
+          {
+            SetLosingFlits (faulty);
+            m_losing = faulty;
+          }
+      }
+    else
+      {
+        m_faulty = faulty;
+      }
+    NS_LOG_LOGIC ("The channel " << GetId () << " has the faulty state set to " << faulty);
+  }
+
+  bool
+  NocFaultyChannel::IsFaulty () const
+  {
+    return m_faulty || m_losing;
+  }
+
 } // namespace ns3
@@ -38,6 +38,9 @@ namespace ns3
    * A NocChannel which can be faulty.
    * The faulty property is an ns-3 attribute.
    *
+   * By default, a faulty channel stops the simulation when it is used. When the LoseFlits attribute is set,
+   * a faulty channel keeps working, but it and its net devices lose the flits which cross them (see NocChannel::TransmitEnd).
+   *
    * \see NocChannel
    */
   class NocFaultyChannel : public NocChannel
@@ -90,10 +93,13 @@ namespace ns3
      * \param srcId The device Id of the net device that wants to
      * transmit on the channel
      *
+     * \param virtualChannel the virtual channel of the receiving net device which will buffer the packet
+     * (0 if virtual channels are not used, -1 if the packet is not buffered there)
+     *
      * \return True if the channel is not busy
      */
     virtual bool
-    TransmitStart (Ptr<NocNetDevice> originalNetDevice, Ptr<Packet> p, uint32_t srcId);
+    TransmitStart (Ptr<NocNetDevice> originalNetDevice, Ptr<Packet> p, uint32_t srcId, int virtualChannel = 0);
 
     /**
      * \brief Transmits the packet. Please note that prior to calling this method, TransmitStart method must be called.
@@ -126,6 +132,21 @@ namespace ns3
     TransmitEnd (Ptr<NocNetDevice> srcNocNetDevice, Mac48Address to,
         Ptr<NocNetDevice> destNocNetDevice, Mac48Address from);
 
+    /**
+     * Marks the channel as faulty or as working. This is the same as setting the Faulty attribute,
+     * without looking up the attribute.
+     *
+     * \param faulty whether or not the channel is faulty
+     */
+    void
+    SetFaulty (bool faulty);
+
+    /**
+     * \return whether or not the channel is faulty
+     */
+    bool
+    IsFaulty () const;
+
   private:
 
     /**
@@ -133,6 +154,16 @@ namespace ns3
      */
     bool m_faulty;
 
+    /**
+     * whether or not a fault makes the channel lose flits, instead of stopping the simulation
+     */
+    bool m_loseFlits;
+
+    /**
+     * whether or not the channel is faulty and loses flits
+     */
+    bool m_losing;
+
   };
 
 } // namespace ns3
@@ -0,0 +1,730 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-fault-campaign.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/data-output-interface.h"
+#include "ns3/noc-faulty-node.h"
+#include "ns3/noc-faulty-router.h"
+#include "ns3/noc-faulty-net-device.h"
+#include "ns3/noc-faulty-channel.h"
+#include "ns3/noc-stats-collector.h"
+#include "ns3/noc-packet-tag.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <limits>
+
+NS_LOG_COMPONENT_DEFINE ("NocFaultCampaign");
+
+namespace ns3
+{
+
+  NS_OBJECT_ENSURE_REGISTERED (NocFaultCampaign);
+
+  /**
+   * orders the faults of a scenario by clock cycle (the faults from the same clock cycle keep their order)
+   */
+  static bool
+  FaultHappensBefore (const NocFaultCampaign::Fault &first, const NocFaultCampaign::Fault &second)
+  {
+    return first.m_cycle < second.m_cycle;
+  }
+
+  std::string
+  NocFaultCampaign::ComponentTypeToString (ComponentType type)
+  {
+    switch (type)
+      {
+      case NODE:
+        return "node";
+      case ROUTER:
+        return "router";
+      case NET_DEVICE:
+        return "device";
+      case CHANNEL:
+        return "channel";
+      default:
+        return "unknown";
+      }
+  }
+
+  NocFaultCampaign::ComponentType
+  NocFaultCampaign::ComponentTypeFromString (std::string type)
+  {
+    for (int i = 0; i < COMPONENT_TYPES; i++)
+      {
+        if (type == ComponentTypeToString ((ComponentType) i))
+          {
+            return (ComponentType) i;
+          }
+      }
+    return COMPONENT_TYPES;
+  }
+
+  TypeId
+  NocFaultCampaign::GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::NocFaultCampaign")
+        .SetParent<DataCalculator> ()
+        .AddConstructor<NocFaultCampaign> ()
+        .AddAttribute ("NodeMeanTimeToFailure",
+            "The mean time to failure of a node, in clock cycles, used to generate scenarios "
+            "(default is 0 - the nodes do not fail)",
+            DoubleValue (0),
+            MakeDoubleAccessor (&NocFaultCampaign::m_nodeMeanTimeToFailure),
+            MakeDoubleChecker<double> (0))
+        .AddAttribute ("RouterMeanTimeToFailure",
+            "The mean time to failure of a router, in clock cycles, used to generate scenarios "
+            "(default is 0 - the routers do not fail)",
+            DoubleValue (0),
+            MakeDoubleAccessor (&NocFaultCampaign::m_routerMeanTimeToFailure),
+            MakeDoubleChecker<double> (0))
+        .AddAttribute ("NetDeviceMeanTimeToFailure",
+            "The mean time to failure of a net device, in clock cycles, used to generate scenarios "
+            "(default is 0 - the net devices do not fail)",
+            DoubleValue (0),
+            MakeDoubleAccessor (&NocFaultCampaign::m_netDeviceMeanTimeToFailure),
+            MakeDoubleChecker<double> (0))
+        .AddAttribute ("ChannelMeanTimeToFailure",
+            "The mean time to failure of a channel, in clock cycles, used to generate scenarios "
+            "(default is 0 - the channels do not fail)",
+            DoubleValue (0),
+            MakeDoubleAccessor (&NocFaultCampaign::m_channelMeanTimeToFailure),
+            MakeDoubleChecker<double> (0))
+        .AddAttribute ("MeanTimeToRepair",
+            "The mean time after which a failed component works again, in clock cycles, used to generate scenarios "
+            "(default is 0 - the faults are permanent)",
+            DoubleValue (0),
+            MakeDoubleAccessor (&NocFaultCampaign::m_meanTimeToRepair),
+            MakeDoubleChecker<double> (0))
+        .AddAttribute ("ClusterRadius",
+            "How many hops away from a failed node (router) the other nodes (routers) may fail at the same time "
+            "(default is 0 - the faults are independent)",
+            UintegerValue (0),
+            MakeUintegerAccessor (&NocFaultCampaign::m_clusterRadius),
+            MakeUintegerChecker<uint32_t> ())
+        .AddAttribute ("ClusterProbability",
+            "The probability that a node (router) from the cluster of a failed node (router) fails too "
+            "(default is 0.5)",
+            DoubleValue (0.5),
+            MakeDoubleAccessor (&NocFaultCampaign::m_clusterProbability),
+            MakeDoubleChecker<double> (0, 1))
+        ;
+    return tid;
+  }
+
+  NocFaultCampaign::NocFaultCampaign ()
+  {
+    m_nodeMeanTimeToFailure = 0;
+    m_routerMeanTimeToFailure = 0;
+    m_netDeviceMeanTimeToFailure = 0;
+    m_channelMeanTimeToFailure = 0;
+    m_meanTimeToRepair = 0;
+    m_clusterRadius = 0;
+    m_clusterProbability = 0.5;
+    m_clock = 0;
+    m_scenario = -1;
+    for (int i = 0; i < COMPONENT_TYPES; i++)
+      {
+        m_components[i] = 0;
+        m_appliedFaults[i] = 0;
+      }
+    m_appliedRepairs = 0;
+    m_injectedFlits = 0;
+    m_receivedFlits = 0;
+    m_lostFlits = 0;
+    m_injectedPackets = 0;
+    m_deliveredPackets = 0;
+    m_measuredPackets = 0;
+    m_latencySum = 0;
+    m_firstFlitUid = std::numeric_limits<uint32_t>::max ();
+  }
+
+  NocFaultCampaign::~NocFaultCampaign ()
+  {
+    ;
+  }
+
+  void
+  NocFaultCampaign::DoDispose ()
+  {
+    m_nodes.clear ();
+    m_routers.clear ();
+    m_netDevices.clear ();
+    m_channels.clear ();
+    DataCalculator::DoDispose ();
+  }
+
+  void
+  NocFaultCampaign::Install (NodeContainer nodes, Ptr<NocStatsCollector> collector)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+    NS_ASSERT (collector != 0);
+    NS_ASSERT_MSG (collector->GetGlobalClock () > 0, "The statistics collector must be installed first");
+
+    m_clock = collector->GetGlobalClock ();
+    uint32_t maxNodeId = 0;
+    for (uint32_t i = 0; i < nodes.GetN (); ++i)
+      {
+        maxNodeId = std::max (maxNodeId, nodes.Get (i)->GetId ());
+      }
+    m_nodes.assign (maxNodeId + 1, 0);
+    m_routers.assign (maxNodeId + 1, 0);
+    m_firstNetDevices.assign (maxNodeId + 1, 0);
+    m_neighbors.assign (maxNodeId + 1, std::vector<uint32_t> ());
+    m_netDevices.clear ();
+    m_channels.clear ();
+    // every channel loses the flits which cross a faulty component (not only the channels which can be faulty)
+    std::vector<bool> connectedChannels;
+
+    for (uint32_t i = 0; i < nodes.GetN (); ++i)
+      {
+        Ptr<Node> node = nodes.Get (i);
+        uint32_t nodeId = node->GetId ();
+        m_nodes[nodeId] = node->GetObject<NocFaultyNode> ();
+        Ptr<NocNode> nocNode = node->GetObject<NocNode> ();
+        if (nocNode != 0 && nocNode->GetRouter () != 0)
+          {
+            m_routers[nodeId] = nocNode->GetRouter ()->GetObject<NocFaultyRouter> ();
+          }
+        m_firstNetDevices[nodeId] = m_netDevices.size ();
+        for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+          {
+            Ptr<NetDevice> device = node->GetDevice (j);
+            m_netDevices.push_back (device->GetObject<NocFaultyNetDevice> ());
+            Ptr<Channel> channel = device->GetChannel ();
+            if (channel == 0)
+              {
+                continue;
+              }
+            if (channel->GetId () >= m_channels.size ())
+              {
+                m_channels.resize (channel->GetId () + 1, 0);
+              }
+            m_channels[channel->GetId ()] = channel->GetObject<NocFaultyChannel> ();
+            if (channel->GetId () >= connectedChannels.size ())
+              {
+                connectedChannels.resize (channel->GetId () + 1, false);
+              }
+            if (!connectedChannels[channel->GetId ()])
+              {
+                channel->TraceConnectWithoutContext ("FlitLost", MakeCallback (&NocFaultCampaign::FlitLost, this));
+                connectedChannels[channel->GetId ()] = true;
+              }
+            for (uint32_t k = 0; k < channel->GetNDevices (); ++k)
+              {
+                uint32_t neighborId = channel->GetDevice (k)->GetNode ()->GetId ();
+                if (neighborId != nodeId && neighborId <= maxNodeId && std::find (m_neighbors[nodeId].begin (),
+                    m_neighbors[nodeId].end (), neighborId) == m_neighbors[nodeId].end ())
+                  {
+                    m_neighbors[nodeId].push_back (neighborId);
+                  }
+              }
+          }
+      }
+
+    m_components[NODE] = m_nodes.size () - std::count (m_nodes.begin (), m_nodes.end (), Ptr<NocFaultyNode> (0));
+    m_components[ROUTER] = m_routers.size ()
+        - std::count (m_routers.begin (), m_routers.end (), Ptr<NocFaultyRouter> (0));
+    m_components[NET_DEVICE] = m_netDevices.size ()
+        - std::count (m_netDevices.begin (), m_netDevices.end (), Ptr<NocFaultyNetDevice> (0));
+    m_components[CHANNEL] = m_channels.size ()
+        - std::count (m_channels.begin (), m_channels.end (), Ptr<NocFaultyChannel> (0));
+    for (int i = 0; i < COMPONENT_TYPES; i++)
+      {
+        NS_LOG_INFO (m_components[i] << " components of type " << ComponentTypeToString ((ComponentType) i)
+            << " can be faulty");
+      }
+
+    // the faulty components lose flits, instead of stopping the simulation
+    BooleanValue loseFlits (true);
+    for (uint32_t i = 0; i < m_nodes.size (); ++i)
+      {
+        if (m_nodes[i] != 0)
+          {
+            m_nodes[i]->SetAttribute ("LoseFlits", loseFlits);
+          }
+        if (m_routers[i] != 0)
+          {
+            m_routers[i]->SetAttribute ("LoseFlits", loseFlits);
+          }
+      }
+    for (uint32_t i = 0; i < m_netDevices.size (); ++i)
+      {
+        if (m_netDevices[i] != 0)
+          {
+            m_netDevices[i]->SetAttribute ("LoseFlits", loseFlits);
+          }
+      }
+    for (uint32_t i = 0; i < m_channels.size (); ++i)
+      {
+        if (m_channels[i] != 0)
+          {
+            m_channels[i]->SetAttribute ("LoseFlits", loseFlits);
+          }
+      }
+
+    collector->TraceConnectWithoutContext ("PacketLatency", MakeCallback (&NocFaultCampaign::PacketLatency, this));
+    Config::ConnectWithoutContext ("/NodeList/*/ApplicationList/*/$ns3::NocSyncApplication/FlitInjected",
+        MakeCallback (&NocFaultCampaign::FlitInjected, this));
+    Config::ConnectWithoutContext ("/NodeList/*/ApplicationList/*/$ns3::NocSyncApplication/FlitReceived",
+        MakeCallback (&NocFaultCampaign::FlitReceived, this));
+  }
+
+  uint32_t
+  NocFaultCampaign::GetNComponents (ComponentType type) const
+  {
+    NS_ASSERT (type < COMPONENT_TYPES);
+    return m_components[type];
+  }
+
+  uint32_t
+  NocFaultCampaign::GetNetDeviceIndex (uint32_t nodeId, uint32_t device) const
+  {
+    NS_ASSERT (nodeId < m_firstNetDevices.size ());
+    return m_firstNetDevices[nodeId] + device;
+  }
+
+  bool
+  NocFaultCampaign::IsValid (const Fault &fault) const
+  {
+    switch (fault.m_type)
+      {
+      case NODE:
+        return fault.m_id < m_nodes.size () && m_nodes[fault.m_id] != 0;
+      case ROUTER:
+        return fault.m_id < m_routers.size () && m_routers[fault.m_id] != 0;
+      case NET_DEVICE:
+        return fault.m_id < m_netDevices.size () && m_netDevices[fault.m_id] != 0;
+      case CHANNEL:
+        return fault.m_id < m_channels.size () && m_channels[fault.m_id] != 0;
+      default:
+        return false;
+      }
+  }
+
+  bool
+  NocFaultCampaign::LoadScenarios (std::string fileName)
+  {
+    NS_LOG_FUNCTION (fileName);
+
+    std::ifstream file (fileName.c_str ());
+    if (!file.is_open ())
+      {
+        NS_LOG_ERROR ("Could not open the fault schedule " << fileName);
+        return false;
+      }
+    std::vector<Scenario> scenarios;
+    std::string line;
+    uint32_t lineNumber = 0;
+    while (std::getline (file, line))
+      {
+        lineNumber++;
+        std::istringstream fields (line);
+        std::string first;
+        if (!(fields >> first) || first[0] == '#')
+          {
+            continue;
+          }
+        std::istringstream scenarioField (first);
+        uint32_t scenario;
+        std::string type;
+        Fault fault;
+        int faulty = 1;
+        if (!(scenarioField >> scenario) || !(fields >> fault.m_cycle >> type >> fault.m_id))
+          {
+            NS_LOG_ERROR ("Line " << lineNumber << " of the fault schedule " << fileName << " is not valid");
+            return false;
+          }
+        fields >> faulty;
+        fault.m_type = ComponentTypeFromString (type);
+        fault.m_faulty = (faulty != 0);
+        if (!IsValid (fault))
+          {
+            NS_LOG_ERROR ("Line " << lineNumber << " of the fault schedule " << fileName
+                << " refers to a component which can not be faulty");
+            return false;
+          }
+        if (scenario >= scenarios.size ())
+          {
+            scenarios.resize (scenario + 1);
+          }
+        scenarios[scenario].push_back (fault);
+      }
+    m_scenarios.insert (m_scenarios.end (), scenarios.begin (), scenarios.end ());
+    NS_LOG_INFO ("Read " << scenarios.size () << " fault scenarios from " << fileName);
+    return true;
+  }
+
+  bool
+  NocFaultCampaign::SaveScenarios (std::string fileName) const
+  {
+    NS_LOG_FUNCTION (fileName);
+
+    std::ofstream file (fileName.c_str ());
+    if (!file.is_open ())
+      {
+        NS_LOG_ERROR ("Could not create the fault schedule " << fileName);
+        return false;
+      }
+    file << "# scenario cycle type id faulty" << std::endl;
+    for (uint32_t i = 0; i < m_scenarios.size (); i++)
+      {
+        for (uint32_t j = 0; j < m_scenarios[i].size (); j++)
+          {
+            const Fault &fault = m_scenarios[i][j];
+            file << i << " " << fault.m_cycle << " " << ComponentTypeToString (fault.m_type) << " " << fault.m_id
+                << " " << (fault.m_faulty ? 1 : 0) << std::endl;
+          }
+      }
+    return file.good ();
+  }
+
+  double
+  NocFaultCampaign::GetMeanTimeToFailure (ComponentType type) const
+  {
+    switch (type)
+      {
+      case NODE:
+        return m_nodeMeanTimeToFailure;
+      case ROUTER:
+        return m_routerMeanTimeToFailure;
+      case NET_DEVICE:
+        return m_netDeviceMeanTimeToFailure;
+      case CHANNEL:
+        return m_channelMeanTimeToFailure;
+      default:
+        return 0;
+      }
+  }
+
+  void
+  NocFaultCampaign::GenerateScenarios (uint32_t scenarios, uint64_t cycles)
+  {
+    NS_LOG_FUNCTION (scenarios << cycles);
+    NS_ASSERT_MSG (m_clock > 0, "The fault campaign must be installed first");
+
+    uint32_t sizes[COMPONENT_TYPES];
+    sizes[NODE] = m_nodes.size ();
+    sizes[ROUTER] = m_routers.size ();
+    sizes[NET_DEVICE] = m_netDevices.size ();
+    sizes[CHANNEL] = m_channels.size ();
+    std::vector<ExponentialVariable> timesToFailure;
+    for (int i = 0; i < COMPONENT_TYPES; i++)
+      {
+        double meanTimeToFailure = GetMeanTimeToFailure ((ComponentType) i);
+        timesToFailure.push_back (ExponentialVariable (meanTimeToFailure > 0 ? meanTimeToFailure : 1));
+      }
+    if (m_meanTimeToRepair > 0)
+      {
+        m_timeToRepair = ExponentialVariable (m_meanTimeToRepair);
+      }
+
+    for (uint32_t i = 0; i < scenarios; i++)
+      {
+        Scenario scenario;
+        std::vector<std::vector<bool> > failed (COMPONENT_TYPES);
+        for (int type = 0; type < COMPONENT_TYPES; type++)
+          {
+            failed[type].assign (sizes[type], false);
+            if (GetMeanTimeToFailure ((ComponentType) type) <= 0)
+              {
+                continue;
+              }
+            for (uint32_t id = 0; id < sizes[type]; id++)
+              {
+                Fault fault;
+                fault.m_type = (ComponentType) type;
+                fault.m_id = id;
+                if (!IsValid (fault))
+                  {
+                    continue;
+                  }
+                // the time to failure is drawn even for the components which already failed (as part of a cluster),
+                // so that the other components get the same failure times no matter how the clusters are formed
+                uint64_t cycle = (uint64_t) timesToFailure[type].GetValue ();
+                if (cycle < cycles && !failed[type][id])
+                  {
+                    GenerateFault (scenario, failed[type], (ComponentType) type, id, cycle, cycles);
+                  }
+              }
+          }
+        std::stable_sort (scenario.begin (), scenario.end (), FaultHappensBefore);
+        NS_LOG_LOGIC ("Generated fault scenario " << m_scenarios.size () << " has " << scenario.size ()
+            << " faults and repairs");
+        m_scenarios.push_back (scenario);
+      }
+  }
+
+  void
+  NocFaultCampaign::GenerateFault (Scenario &scenario, std::vector<bool> &failed, ComponentType type, uint32_t id,
+      uint64_t cycle, uint64_t cycles)
+  {
+    std::vector<uint32_t> components;
+    components.push_back (id);
+    failed[id] = true;
+    if ((type == NODE || type == ROUTER) && m_clusterRadius > 0)
+      {
+        // breadth first search of the nodes which are at most ClusterRadius hops away
+        std::vector<uint32_t> hops (m_neighbors.size (), m_clusterRadius + 1);
+        std::vector<uint32_t> queue;
+        queue.push_back (id);
+        hops[id] = 0;
+        for (uint32_t i = 0; i < queue.size (); i++)
+          {
+            uint32_t current = queue[i];
+            if (hops[current] == m_clusterRadius)
+              {
+                continue;
+              }
+            for (uint32_t j = 0; j < m_neighbors[current].size (); j++)
+              {
+                uint32_t neighbor = m_neighbors[current][j];
+                if (hops[neighbor] > hops[current] + 1)
+                  {
+                    hops[neighbor] = hops[current] + 1;
+                    queue.push_back (neighbor);
+                  }
+              }
+          }
+        for (uint32_t i = 1; i < queue.size (); i++)
+          {
+            Fault neighbor;
+            neighbor.m_type = type;
+            neighbor.m_id = queue[i];
+            if (IsValid (neighbor) && !failed[queue[i]] && m_clusterVariable.GetValue () < m_clusterProbability)
+              {
+                components.push_back (queue[i]);
+                failed[queue[i]] = true;
+              }
+          }
+      }
+
+    for (uint32_t i = 0; i < components.size (); i++)
+      {
+        Fault fault;
+        fault.m_cycle = cycle;
+        fault.m_type = type;
+        fault.m_id = components[i];
+        fault.m_faulty = true;
+        scenario.push_back (fault);
+        if (m_meanTimeToRepair > 0)
+          {
+            fault.m_cycle = cycle + 1 + (uint64_t) m_timeToRepair.GetValue ();
+            fault.m_faulty = false;
+            if (fault.m_cycle < cycles)
+              {
+                scenario.push_back (fault);
+              }
+          }
+      }
+  }
+
+  void
+  NocFaultCampaign::AddScenario (const Scenario &scenario)
+  {
+    m_scenarios.push_back (scenario);
+  }
+
+  uint32_t
+  NocFaultCampaign::GetNScenarios () const
+  {
+    return m_scenarios.size ();
+  }
+
+  const NocFaultCampaign::Scenario &
+  NocFaultCampaign::GetScenario (uint32_t scenario) const
+  {
+    NS_ASSERT (scenario < m_scenarios.size ());
+    return m_scenarios[scenario];
+  }
+
+  void
+  NocFaultCampaign::StartScenario (uint32_t scenario)
+  {
+    NS_LOG_FUNCTION (scenario);
+    NS_ASSERT_MSG (m_clock > 0, "The fault campaign must be installed first");
+    NS_ASSERT_MSG (m_scenario < 0, "A fault scenario was already started");
+    NS_ASSERT (scenario < m_scenarios.size ());
+
+    m_scenario = scenario;
+    m_faults = m_scenarios[scenario];
+    std::stable_sort (m_faults.begin (), m_faults.end (), FaultHappensBefore);
+    m_injectedFlits = 0;
+    m_receivedFlits = 0;
+    m_lostFlits = 0;
+    m_injectedPackets = 0;
+    m_deliveredPackets = 0;
+    m_measuredPackets = 0;
+    m_latencySum = 0;
+    m_firstFlitUid = std::numeric_limits<uint32_t>::max ();
+
+    // one event for all the faults of a clock cycle
+    uint32_t first = 0;
+    while (first < m_faults.size ())
+      {
+        uint32_t last = first + 1;
+        while (last < m_faults.size () && m_faults[last].m_cycle == m_faults[first].m_cycle)
+          {
+            last++;
+          }
+        Simulator::Schedule (PicoSeconds (m_faults[first].m_cycle * m_clock), &NocFaultCampaign::ApplyFaults, this,
+            first, last);
+        first = last;
+      }
+    NS_LOG_INFO ("Fault scenario " << scenario << " started, with " << m_faults.size () << " faults and repairs");
+  }
+
+  void
+  NocFaultCampaign::ApplyFaults (uint32_t first, uint32_t last)
+  {
+    NS_LOG_FUNCTION (first << last);
+
+    for (uint32_t i = first; i < last; i++)
+      {
+        const Fault &fault = m_faults[i];
+        switch (fault.m_type)
+          {
+          case NODE:
+            m_nodes[fault.m_id]->SetFaulty (fault.m_faulty);
+            break;
+          case ROUTER:
+            m_routers[fault.m_id]->SetFaulty (fault.m_faulty);
+            break;
+          case NET_DEVICE:
+            m_netDevices[fault.m_id]->SetFaulty (fault.m_faulty);
+            break;
+          case CHANNEL:
+            m_channels[fault.m_id]->SetFaulty (fault.m_faulty);
+            break;
+          default:
+            NS_ASSERT_MSG (false, "Unknown component type " << fault.m_type);
+            break;
+          }
+        if (fault.m_faulty)
+          {
+            m_appliedFaults[fault.m_type]++;
+          }
+        else
+          {
+            m_appliedRepairs++;
+          }
+        NS_LOG_LOGIC ((fault.m_faulty ? "Fault" : "Repair") << " of the " << ComponentTypeToString (fault.m_type)
+            << " " << fault.m_id);
+      }
+  }
+
+  void
+  NocFaultCampaign::FlitInjected (Ptr<const Packet> flit)
+  {
+    if (m_injectedFlits == 0)
+      {
+        // the flits are created when they are injected, so the flits injected from now on have bigger UIDs
+        m_firstFlitUid = flit->GetUid ();
+      }
+    m_injectedFlits++;
+    NocPacketTag tag;
+    flit->PeekPacketTag (tag);
+    if (NocPacket::HEAD == tag.GetPacketType ())
+      {
+        m_injectedPackets++;
+      }
+  }
+
+  void
+  NocFaultCampaign::FlitReceived (Ptr<const Packet> flit)
+  {
+    // the flits which were in the network when the scenario started are not counted
+    if (flit->GetUid () < m_firstFlitUid)
+      {
+        return;
+      }
+    m_receivedFlits++;
+    NocPacketTag tag;
+    flit->PeekPacketTag (tag);
+    if (NocPacket::TAIL == tag.GetPacketType () && tag.GetPacketHeadUid () >= m_firstFlitUid)
+      {
+        m_deliveredPackets++;
+      }
+    if (NocPacket::HEAD == tag.GetPacketType () && tag.GetDataFlitCount () == 0)
+      {
+        m_deliveredPackets++;
+      }
+  }
+
+  void
+  NocFaultCampaign::FlitLost (Ptr<const Packet> flit)
+  {
+    if (flit->GetUid () >= m_firstFlitUid)
+      {
+        m_lostFlits++;
+      }
+  }
+
+  void
+  NocFaultCampaign::PacketLatency (double latency)
+  {
+    m_measuredPackets++;
+    m_latencySum += latency;
+  }
+
+  double
+  NocFaultCampaign::GetDeliveredFraction () const
+  {
+    return m_injectedFlits > 0 ? (double) m_receivedFlits / m_injectedFlits : 1;
+  }
+
+  void
+  NocFaultCampaign::Output (DataOutputCallback &callback) const
+  {
+    if (m_scenario < 0)
+      {
+        return;
+      }
+    callback.OutputSingleton (m_context, m_key + "-scenario", (uint32_t) m_scenario);
+    for (int i = 0; i < COMPONENT_TYPES; i++)
+      {
+        callback.OutputSingleton (m_context, m_key + "-" + ComponentTypeToString ((ComponentType) i) + "-faults",
+            m_appliedFaults[i]);
+      }
+    callback.OutputSingleton (m_context, m_key + "-repairs", m_appliedRepairs);
+    callback.OutputSingleton (m_context, m_key + "-injected-flits", (double) m_injectedFlits);
+    callback.OutputSingleton (m_context, m_key + "-received-flits", (double) m_receivedFlits);
+    callback.OutputSingleton (m_context, m_key + "-delivered-fraction", GetDeliveredFraction ());
+    callback.OutputSingleton (m_context, m_key + "-lost-flits", (double) m_lostFlits);
+    callback.OutputSingleton (m_context, m_key + "-injected-packets", (double) m_injectedPackets);
+    callback.OutputSingleton (m_context, m_key + "-delivered-packets", (double) m_deliveredPackets);
+    callback.OutputSingleton (m_context, m_key + "-undelivered-packets",
+        (double) (m_injectedPackets > m_deliveredPackets ? m_injectedPackets - m_deliveredPackets : 0));
+    callback.OutputSingleton (m_context, m_key + "-measured-packets", (double) m_measuredPackets);
+    callback.OutputSingleton (m_context, m_key + "-average-latency",
+        m_measuredPackets > 0 ? m_latencySum / m_measuredPackets : 0.0);
+  }
+
+} // namespace ns3
@@ -0,0 +1,405 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCFAULTCAMPAIGN_H_
+#define NOCFAULTCAMPAIGN_H_
+
+#include "ns3/data-calculator.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+  class NocFaultyNode;
+  class NocFaultyRouter;
+  class NocFaultyNetDevice;
+  class NocFaultyChannel;
+  class NocStatsCollector;
+
+  /**
+   * \brief Runs Monte-Carlo reliability sweeps: many fault scenarios, simulated on the same NoC
+   *
+   * \detail A fault scenario is a list of faults (and repairs) of nodes, routers, net devices and channels,
+   *         each one happening at a given clock cycle after the scenario starts. The scenarios are either
+   *         read from a schedule file (see LoadScenarios) or generated from the mean time to failure of
+   *         every type of component (exponentially distributed failure times). Generated faults may be
+   *         spatially correlated: when a node or a router fails, every node (router) at most ClusterRadius
+   *         hops away fails at the same time with probability ClusterProbability.
+   *
+   *         The components are indexed when the campaign is installed, so a fault is applied without searching
+   *         the node container and without the attribute system. All the faults of a scenario which happen at
+   *         the same clock cycle are applied by a single event.
+   *
+   *         The scenarios are meant to be run by forked processes which share the already built (and warmed up)
+   *         NoC (see NocWarmupFork): each process schedules one scenario. The campaign is a DataCalculator which
+   *         outputs, for its scenario, the applied faults, the fraction of the injected flits which were delivered,
+   *         the lost flits, the undelivered packets and the average packet latency (all measured from the start
+   *         of the scenario: the flits which were already in the network are ignored). A packet is undelivered
+   *         if its last flit did not reach the destination by the end of the simulation (it was lost or it is
+   *         still in the network).
+   *
+   *         Only the components which can be faulty (NocFaultyNode, NocFaultyRouter, NocFaultyNetDevice and
+   *         NocFaultyChannel) are part of a campaign. The campaign sets their LoseFlits attribute, so a faulty
+   *         component does not stop the simulation: the links of a faulty node, router or net device and a faulty
+   *         channel lose the flits which cross them (see the FlitLost trace source of NocChannel). The routing
+   *         protocols do not route around faults, so rerouted packets are not reported.
+   */
+  class NocFaultCampaign : public DataCalculator
+  {
+  public:
+
+    enum ComponentType
+      {
+        NODE,
+        ROUTER,
+        NET_DEVICE,
+        CHANNEL,
+        COMPONENT_TYPES
+      };
+
+    /**
+     * \param type a type of component
+     *
+     * \return the name of the component type, as used by the schedule files
+     */
+    static std::string
+    ComponentTypeToString (ComponentType type);
+
+    /**
+     * \param type the name of a component type, as used by the schedule files
+     *
+     * \return the component type (COMPONENT_TYPES if the name is not known)
+     */
+    static ComponentType
+    ComponentTypeFromString (std::string type);
+
+    /**
+     * a fault (or a repair) of a component
+     */
+    struct Fault
+    {
+      /**
+       * the clock cycle when the fault happens, counted from the start of the scenario
+       */
+      uint64_t m_cycle;
+
+      ComponentType m_type;
+
+      /**
+       * the component: the node ID (for nodes and routers), the index of the net device
+       * (see GetNetDeviceIndex) or the channel ID
+       */
+      uint32_t m_id;
+
+      /**
+       * true for a fault, false for a repair
+       */
+      bool m_faulty;
+    };
+
+    typedef std::vector<Fault> Scenario;
+
+    static TypeId
+    GetTypeId ();
+
+    NocFaultCampaign ();
+
+    virtual
+    ~NocFaultCampaign ();
+
+    /**
+     * Indexes the components of the NoC which can be faulty and starts listening to the measured packets.
+     * The topology and the statistics collector must be installed.
+     *
+     * \param nodes the nodes of the NoC
+     * \param collector the statistics collector of the NoC
+     */
+    void
+    Install (NodeContainer nodes, Ptr<NocStatsCollector> collector);
+
+    /**
+     * \param type a type of component
+     *
+     * \return how many components of this type can be faulty
+     */
+    uint32_t
+    GetNComponents (ComponentType type) const;
+
+    /**
+     * The net devices are numbered in the order of the nodes (of the node container given at install)
+     * and, for every node, in the order of its devices.
+     *
+     * \param nodeId the ID of a node
+     * \param device the index of the device, in the node
+     *
+     * \return the index of the net device, in the campaign
+     */
+    uint32_t
+    GetNetDeviceIndex (uint32_t nodeId, uint32_t device) const;
+
+    /**
+     * Reads fault scenarios from a schedule file and adds them to the campaign. Every line of the file
+     * (except the empty ones and the ones starting with #) is a fault:
+     *
+     *   scenario cycle type id [faulty]
+     *
+     * where type is node, router, device or channel and faulty is 1 for a fault (default) or 0 for a repair.
+     * The scenario indices are relative to the scenarios which already exist.
+     *
+     * \param fileName the schedule file
+     *
+     * \return whether or not the file was read successfully (nothing is added otherwise)
+     */
+    bool
+    LoadScenarios (std::string fileName);
+
+    /**
+     * Writes all the scenarios of the campaign into a schedule file (see LoadScenarios).
+     *
+     * \param fileName the schedule file
+     *
+     * \return whether or not the file was written successfully
+     */
+    bool
+    SaveScenarios (std::string fileName) const;
+
+    /**
+     * Generates fault scenarios from the mean times to failure (and to repair) of the components.
+     *
+     * \param scenarios how many scenarios are generated
+     * \param cycles how many clock cycles a scenario lasts (the faults which would happen later are dropped)
+     */
+    void
+    GenerateScenarios (uint32_t scenarios, uint64_t cycles);
+
+    /**
+     * \param scenario the fault scenario which is added
+     */
+    void
+    AddScenario (const Scenario &scenario);
+
+    /**
+     * \return how many fault scenarios the campaign has
+     */
+    uint32_t
+    GetNScenarios () const;
+
+    /**
+     * \param scenario the index of a scenario
+     *
+     * \return the faults of the scenario
+     */
+    const Scenario &
+    GetScenario (uint32_t scenario) const;
+
+    /**
+     * Starts a scenario now: its faults are scheduled (batched by clock cycle) and the measurement starts.
+     * At most one scenario may be started (by every forked process).
+     *
+     * \param scenario the index of the scenario
+     */
+    void
+    StartScenario (uint32_t scenario);
+
+    /**
+     * \return the fraction of the flits injected since the start of the scenario which were delivered
+     */
+    double
+    GetDeliveredFraction () const;
+
+    virtual void
+    Output (DataOutputCallback &callback) const;
+
+  protected:
+
+    virtual void
+    DoDispose ();
+
+  private:
+
+    /**
+     * Applies the faults of the started scenario from the given range (they all happen at the same clock cycle).
+     *
+     * \param first the index of the first fault
+     * \param last the index after the last fault
+     */
+    void
+    ApplyFaults (uint32_t first, uint32_t last);
+
+    /**
+     * \param fault a fault
+     *
+     * \return whether or not the faulty component is part of the campaign
+     */
+    bool
+    IsValid (const Fault &fault) const;
+
+    /**
+     * Adds a fault to a generated scenario. For a node or a router, the neighboring components of the same type
+     * may fail too (clusters). A repair is added too, if the components are repaired.
+     *
+     * \param scenario the generated scenario
+     * \param failed which components already failed in this scenario
+     * \param type the type of the component
+     * \param id the component
+     * \param cycle when the component fails
+     * \param cycles how many clock cycles the scenario lasts
+     */
+    void
+    GenerateFault (Scenario &scenario, std::vector<bool> &failed, ComponentType type, uint32_t id, uint64_t cycle,
+        uint64_t cycles);
+
+    void
+    FlitInjected (Ptr<const Packet> flit);
+
+    void
+    FlitReceived (Ptr<const Packet> flit);
+
+    void
+    PacketLatency (double latency);
+
+    void
+    FlitLost (Ptr<const Packet> flit);
+
+    /**
+     * \param type a type of component
+     *
+     * \return the mean time to failure of the components of this type, in clock cycles
+     */
+    double
+    GetMeanTimeToFailure (ComponentType type) const;
+
+    /**
+     * the mean times to failure, in clock cycles (0 means that the components never fail)
+     */
+    double m_nodeMeanTimeToFailure;
+
+    double m_routerMeanTimeToFailure;
+
+    double m_netDeviceMeanTimeToFailure;
+
+    double m_channelMeanTimeToFailure;
+
+    /**
+     * used to decide which neighbors are part of a cluster of faults
+     */
+    UniformVariable m_clusterVariable;
+
+    /**
+     * the times to repair (valid only while scenarios are generated)
+     */
+    ExponentialVariable m_timeToRepair;
+
+    /**
+     * the mean time to repair, in clock cycles (0 means that the faults are permanent)
+     */
+    double m_meanTimeToRepair;
+
+    uint32_t m_clusterRadius;
+
+    double m_clusterProbability;
+
+    /**
+     * the global clock, in picoseconds
+     */
+    int64_t m_clock;
+
+    /**
+     * the components which can be faulty, indexed by node ID (nodes and routers), by net device index or by
+     * channel ID (null for the components which can not be faulty)
+     */
+    std::vector<Ptr<NocFaultyNode> > m_nodes;
+
+    std::vector<Ptr<NocFaultyRouter> > m_routers;
+
+    std::vector<Ptr<NocFaultyNetDevice> > m_netDevices;
+
+    std::vector<Ptr<NocFaultyChannel> > m_channels;
+
+    /**
+     * how many components of every type can be faulty
+     */
+    uint32_t m_components[COMPONENT_TYPES];
+
+    /**
+     * the index of the first net device of every node (by node ID)
+     */
+    std::vector<uint32_t> m_firstNetDevices;
+
+    /**
+     * the IDs of the neighbors of every node (by node ID)
+     */
+    std::vector<std::vector<uint32_t> > m_neighbors;
+
+    std::vector<Scenario> m_scenarios;
+
+    /**
+     * the index of the started scenario (-1 if no scenario was started)
+     */
+    int32_t m_scenario;
+
+    /**
+     * the faults of the started scenario, sorted by clock cycle
+     */
+    Scenario m_faults;
+
+    /**
+     * how many faults (and repairs) of every type of component were applied
+     */
+    uint32_t m_appliedFaults[COMPONENT_TYPES];
+
+    uint32_t m_appliedRepairs;
+
+    uint64_t m_injectedFlits;
+
+    uint64_t m_receivedFlits;
+
+    uint64_t m_lostFlits;
+
+    uint64_t m_injectedPackets;
+
+    /**
+     * how many packets had their last flit received
+     */
+    uint64_t m_deliveredPackets;
+
+    uint64_t m_measuredPackets;
+
+    double m_latencySum;
+
+    /**
+     * the UID of the first flit injected after the scenario started (the flits with smaller UIDs
+     * were injected before the scenario started, so they are not counted)
+     */
+    uint32_t m_firstFlitUid;
+
+  };
+
+} // namespace ns3
+
+#endif /* NOCFAULTCAMPAIGN_H_ */
@@ -53,6 +53,13 @@ namespace ns3
             BooleanValue (false),
             MakeBooleanAccessor (&NocFaultyNetDevice::m_faulty),
             MakeBooleanChecker ())
+        .AddAttribute (
+            "LoseFlits",
+            "Whether or not a faulty net device loses the flits which cross it, instead of stopping the simulation "
+            "when it is used (default is false)",
+            BooleanValue (false),
+            MakeBooleanAccessor (&NocFaultyNetDevice::m_loseFlits),
+            MakeBooleanChecker ())
         ;
     return tid;
   }
@@ -60,6 +67,9 @@ namespace ns3
   NocFaultyNetDevice::NocFaultyNetDevice () : NocNetDevice ()
   {
     NS_LOG_FUNCTION_NOARGS ();
+    m_faulty = false;
+    m_loseFlits = false;
+    m_losing = false;
   }
 
   NocFaultyNetDevice::~NocFaultyNetDevice ()
@@ -291,4 +301,29 @@ namespace ns3
     return routingDimension;
   }
 
+  void
+  NocFaultyNetDevice::SetFaulty (bool faulty)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+    if (m_loseFlits)
+      {
+        if (faulty != m_losing)
+          {
+            SetLosingFlits (faulty);
+            m_losing = faulty;
+          }
+      }
+    else
+      {
+        m_faulty = faulty;
+      }
+    NS_LOG_LOGIC ("The net device " << GetAddress () << " has the faulty state set to " << faulty);
+  }
+
+  bool
+  NocFaultyNetDevice::IsFaulty () const
+  {
+    return m_faulty || m_losing;
+  }
+
 } // namespace ns3
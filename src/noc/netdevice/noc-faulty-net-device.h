@@ -42,6 +42,9 @@ namespace ns3
    * A NocNetDevice which can be faulty.
    * The faulty property is an ns-3 attribute.
    *
+   * By default, a faulty net device stops the simulation when it is used. When the LoseFlits attribute is set,
+   * a faulty net device keeps working, but its links lose the flits which cross them (see NocChannel::TransmitEnd).
+   *
    * \see NocNetDevice
    */
   class NocFaultyNetDevice : public NocNetDevice
@@ -120,6 +123,21 @@ namespace ns3
     virtual void
     SetNode (Ptr<Node> node);
 
+    /**
+     * Marks the net device as faulty or as working. This is the same as setting the Faulty attribute,
+     * without looking up the attribute.
+     *
+     * \param faulty whether or not the net device is faulty
+     */
+    void
+    SetFaulty (bool faulty);
+
+    /**
+     * \return whether or not the net device is faulty
+     */
+    bool
+    IsFaulty () const;
+
   protected:
 
   private:
@@ -129,6 +147,16 @@ namespace ns3
      */
     bool m_faulty;
 
+    /**
+     * whether or not a fault makes the net device lose flits, instead of stopping the simulation
+     */
+    bool m_loseFlits;
+
+    /**
+     * whether or not the net device is faulty and loses flits
+     */
+    bool m_losing;
+
   };
 
 } // namespace ns3
@@ -32,6 +32,9 @@
 #include "ns3/noc-packet-tag.h"
 #include "ns3/integer.h"
 #include "ns3/noc-registry.h"
+#include "ns3/noc-cycle-engine.h"
+#include "ns3/noc-profiler.h"
+#include "ns3/noc-deadlock-detector.h"
 #include "ns3/pointer.h"
 
 NS_LOG_COMPONENT_DEFINE ("NocNetDevice");
@@ -53,6 +56,9 @@ namespace ns3
         .AddTraceSource ("Receive",
                  "Trace source indicating a packet has been received by this device",
                  MakeTraceSourceAccessor (&NocNetDevice::m_receiveTrace))
+        .AddTraceSource ("Drop",
+                 "Trace source indicating a packet has been dropped by this device",
+                 MakeTraceSourceAccessor (&NocNetDevice::m_dropTrace))
         .AddAttribute ("InQueue",
                  "A queue to use as the input channel buffer of this net device.",
                  PointerValue (),
@@ -68,7 +74,8 @@ namespace ns3
   }
 
   NocNetDevice::NocNetDevice() :
-    m_channel (0), m_node (0), m_mtu (0xffff), m_ifIndex (0), m_routingDirection (0), m_routingDimension (-1)
+    m_channel (0), m_inQueueCapacity (0), m_node (0), m_mtu (0xffff), m_ifIndex (0), m_losingFlits (0),
+    m_routingDirection (0), m_routingDimension (-1)
   {
     m_lastScheduledEvent = PicoSeconds (0);
   }
@@ -122,7 +129,7 @@ namespace ns3
                 packetTag.SetReceiveTime (Simulator::Now ());
                 packet->AddPacketTag (packetTag);
                 NS_LOG_DEBUG ("Packet receive time is " << Simulator::Now ());
-                m_receiveTrace (packet);
+                TraceReceivedPacket (packet);
               }
             else
               {
@@ -133,7 +140,7 @@ namespace ns3
         else
           {
             NS_LOG_DEBUG ("The packet reached its destination.");
-            m_receiveTrace (packet);
+            TraceReceivedPacket (packet);
           }
       }
     else
@@ -142,10 +149,9 @@ namespace ns3
         // ask the node to deal with this (the node talks to the router)
         NS_LOG_DEBUG ("The packet is intended for another net device.");
         Ptr<NocNode> nocNode = GetNode ()->GetObject<NocNode> ();
-        PointerValue nocPointer;
-        NocRegistry::GetInstance ()->GetAttribute ("NoCTopology", nocPointer);
-        Ptr<NocTopology> nocTopology = nocPointer.Get<NocTopology> ();
-        NS_ASSERT_MSG (nocTopology != 0, "NoC topology was not set in the NocRegistry!");
+        NS_ASSERT_MSG (m_context != 0, "The net device has no simulation context (was the topology installed?)");
+        Ptr<NocTopology> nocTopology = m_context->GetTopology ();
+        NS_ASSERT_MSG (nocTopology != 0, "The simulation context does not belong to a NoC topology!");
         Ptr<NocNetDevice> destinationNetDevice = nocTopology->FindNetDeviceByAddress (to);
         nocNode->Send (this, packet, destinationNetDevice->GetNode ()->GetObject<NocNode> ());
 //        Simulator::ScheduleNow (&NocNode::Send, nocNode, this, packet, destinationNetDevice->GetNode ()->GetObject<NocNode> ());
@@ -159,11 +165,30 @@ namespace ns3
     m_deviceId = m_channel->Add(this);
   }
 
+  void
+  NocNetDevice::SetContext (Ptr<NocSimulationContext> context)
+  {
+    m_context = context;
+  }
+
+  Ptr<NocSimulationContext>
+  NocNetDevice::GetContext () const
+  {
+    return m_context;
+  }
+
   void
   NocNetDevice::SetInQueue(Ptr<Queue> inQueue)
   {
     NS_LOG_FUNCTION (inQueue);
     m_inQueue = inQueue;
+    m_inQueueCapacity = 0;
+    if (m_inQueue != 0)
+      {
+        UintegerValue size;
+        m_inQueue->GetAttribute ("MaxPackets", size);
+        m_inQueueCapacity = size.Get ();
+      }
   }
 
   void
@@ -255,7 +280,14 @@ namespace ns3
   {
     uint32_t n = 0;
 
-    if (m_inQueue != 0)
+    if (!m_virtualChannels.empty ())
+      {
+        for (uint32_t i = 0; i < m_virtualChannels.size (); i++)
+          {
+            n += m_virtualChannels[i].m_queue->GetNPackets ();
+          }
+      }
+    else if (m_inQueue != 0)
       {
         n = m_inQueue->GetNPackets ();
       }
@@ -269,11 +301,16 @@ namespace ns3
   {
     uint64_t n = 0;
 
-    if (m_inQueue != 0)
+    if (!m_virtualChannels.empty ())
       {
-        UintegerValue size;
-        m_inQueue->GetAttribute ("MaxPackets", size);
-        n = size.Get ();
+        for (uint32_t i = 0; i < m_virtualChannels.size (); i++)
+          {
+            n += m_virtualChannels[i].m_capacity;
+          }
+      }
+    else
+      {
+        n = m_inQueueCapacity;
       }
     NS_LOG_DEBUG ("In queue has size " << n);
 
@@ -438,6 +475,26 @@ namespace ns3
         from = Mac48Address::ConvertFrom (source);
       }
 
+    if (!m_virtualChannels.empty ())
+      {
+        // the flit waits in the virtual channel of its message, until the router lets it traverse the switch
+        uint32_t vc = GetMessageVirtualChannel (packet);
+        if (!m_virtualChannels[vc].m_queue->Enqueue (packet))
+          {
+            NS_LOG_LOGIC ("Cannot buffer packet " << packet << " (UID " << packet->GetUid () << ")"
+                << " in the virtual channel " << vc << " of the NoC net device with address " << GetAddress ());
+            Drop (packet);
+            return false;
+          }
+        NS_LOG_DEBUG ("Enqueued packet " << *packet << " (UID " << packet->GetUid () << ") "
+            << " in the virtual channel " << vc << " of NoC net device with address " << GetAddress ()
+            << " (virtual channel now has " << m_virtualChannels[vc].m_queue->GetNPackets () << " packets)");
+        m_pktSrcDestMap.insert (std::pair<Ptr<const Packet>,SrcDest> (packet,
+            SrcDest (from, to, m_viaNetDevice, originalHeader)));
+        GetNode ()->GetObject<NocNode> ()->GetRouter ()->ScheduleSwitchAllocation ();
+        return true;
+      }
+
     Ptr<Packet> packetToSend;
     if (m_inQueue != 0)
       {
@@ -466,22 +523,15 @@ namespace ns3
     else
       {
         packetToSend = packet;
-        Ptr<Packet> tracedPacket = packetToSend->Copy ();
-        NocHeader removedHeader;
-        NocPacketTag tag;
-        tracedPacket->PeekPacketTag (tag);
-        if (NocPacket::HEAD == tag.GetPacketType ())
-          {
-            tracedPacket->RemoveHeader (removedHeader);
-          }
-        if (!removedHeader.IsEmpty() && !originalHeader.IsEmpty ())
-          {
-            tracedPacket->AddHeader (originalHeader);
-          }
-        m_sendTrace (tracedPacket);
-
-        bool canDoRouting = GetNode ()->GetObject<NocNode> ()->GetRouter ()->
-            GetSwitchingProtocol ()->ApplyFlowControl (packetToSend, m_inQueue);
+        TraceSentPacket (packetToSend, originalHeader);
+
+        Ptr<NocSwitchingProtocol> switchingProtocol = GetNode ()->GetObject<NocNode> ()->GetRouter ()->
+            GetSwitchingProtocol ();
+        bool canDoRouting;
+        {
+          NOC_PROFILE (SWITCHING, switchingProtocol->GetInstanceTypeId ());
+          canDoRouting = switchingProtocol->ApplyFlowControl (packetToSend, m_inQueue);
+        }
         if (canDoRouting)
           {
             Ptr<NocChannel> channel = m_channel;
@@ -566,8 +616,10 @@ namespace ns3
                   {
                     MarkHeadPacketAsBlocked (packet);
                   }
-                canDoRouting = GetNode ()->GetObject<NocNode> ()->GetRouter ()->
-                    GetSwitchingProtocol ()->ApplyFlowControl (packet, m_inQueue);
+                Ptr<NocSwitchingProtocol> switchingProtocol = GetNode ()->GetObject<NocNode> ()->GetRouter ()->
+                    GetSwitchingProtocol ();
+                NOC_PROFILE (SWITCHING, switchingProtocol->GetInstanceTypeId ());
+                canDoRouting = switchingProtocol->ApplyFlowControl (packet, m_inQueue);
               }
             if (canDoRouting)
               {
@@ -577,26 +629,28 @@ namespace ns3
                     deviceId = m_viaNetDevice->m_deviceId;
                   }
                 bool canSend = channel->TransmitStart (this, packetToSend, deviceId);
+                NocDeadlockDetector *detector = m_context->GetDeadlockDetector ();
+                if (detector != 0)
+                  {
+                    Ptr<NocNetDevice> holder = canSend ? 0 : channel->GetTransmittingNetDevice (deviceId);
+                    if (holder == 0 || holder == this)
+                      {
+                        // the link is free or it already carries the flit from the head of this queue
+                        detector->NotifyQueueNotWaiting (this);
+                      }
+                    else
+                      {
+                        detector->NotifyQueueWaiting (this, PeekPointer (holder));
+                      }
+                  }
                 if (canSend)
                   {
                     result = channel->Send (to, from);
                     if (result)
                       {
-                        Ptr<Packet> tracedPacket = packetToSend->Copy ();
-                        NocHeader removedHeader;
-                        NocPacketTag tag;
-                        tracedPacket->PeekPacketTag (tag);
-                        if (NocPacket::HEAD == tag.GetPacketType ())
-                          {
-                            tracedPacket->RemoveHeader (removedHeader);
-                          }
-                        if (!removedHeader.IsEmpty() && !originalHeader.IsEmpty ())
-                          {
-                            tracedPacket->AddHeader (originalHeader);
-                          }
-                        NS_LOG_DEBUG ("Tracing packet with UID " << tracedPacket->GetUid ()
+                        NS_LOG_DEBUG ("Tracing packet with UID " << packetToSend->GetUid ()
                             << " as being sent at time " << Simulator::Now ());
-                        m_sendTrace (tracedPacket);
+                        TraceSentPacket (packetToSend, originalHeader);
 
                         NS_LOG_LOGIC ("Packet " << *packetToSend << " (UID " << packetToSend->GetUid () << ")"
                             << " was sent to the NoC net device with address " << to);
@@ -631,9 +685,7 @@ namespace ns3
               }
             if (!m_inQueue->IsEmpty ())
               {
-                TimeValue timeValue;
-                NocRegistry::GetInstance ()->GetAttribute ("GlobalClock", timeValue);
-                Time globalClock = timeValue.Get ();
+                Time globalClock = m_context->GetGlobalClock ();
                 if (globalClock.IsZero ())
                   {
                     // the channel's bandwidth is obviously expressed in bits / s
@@ -657,6 +709,19 @@ namespace ns3
                             << m_lastScheduledEvent << ")");
                       }
                   }
+                else if (m_context->GetCycleEngine () != 0)
+                  {
+                    // the cycle engine lets every net device process its buffered flits once per clock cycle
+                    if (m_lastScheduledEvent <= Simulator::Now ())
+                      {
+                        m_lastScheduledEvent = m_context->GetCycleEngine ()->ScheduleBufferedPackets (this, originalHeader);
+                      }
+                    else
+                      {
+                        NS_LOG_DEBUG ("The net device " << GetAddress () << " will already process its buffered packets at time "
+                            << m_lastScheduledEvent);
+                      }
+                  }
                 else
                   {
                     int speedup = 1;
@@ -665,10 +730,7 @@ namespace ns3
                     if (NocPacket::HEAD == tag.GetPacketType ())
                       {
                         // a data packet will be sent
-                        IntegerValue dataFlitSpeedup;
-                        Ptr<NocRegistry> nocRegistry = NocRegistry::GetInstance ();
-                        nocRegistry->GetAttribute ("DataPacketSpeedup", dataFlitSpeedup);
-                        speedup = dataFlitSpeedup.Get ();
+                        speedup = m_context->GetDataFlitSpeedup ();
                       }
                     NS_LOG_DEBUG ("Data flit speedup is " << speedup);
                     NS_LOG_DEBUG ("Packet has UID " << packetToSend->GetUid ());
@@ -708,12 +770,376 @@ namespace ns3
       }
   }
 
+  void
+  NocNetDevice::EnableVirtualChannels (uint32_t virtualChannels, ObjectFactory queueFactory)
+  {
+    NS_LOG_FUNCTION (virtualChannels);
+    NS_ASSERT_MSG (virtualChannels > 0, "A net device must have at least one virtual channel");
+    NS_ASSERT_MSG (m_inQueue != 0, "The net device " << GetAddress () << " has no in queue");
+    NS_ASSERT_MSG (m_inQueue->IsEmpty (), "Virtual channels must be enabled before any flit is sent");
+
+    m_virtualChannels.clear ();
+    m_messageVirtualChannels.clear ();
+    for (uint32_t i = 0; i < virtualChannels; i++)
+      {
+        VirtualChannel virtualChannel;
+        virtualChannel.m_capacity = m_inQueueCapacity;
+        if (i == 0)
+          {
+            virtualChannel.m_queue = m_inQueue;
+          }
+        else
+          {
+            virtualChannel.m_queue = queueFactory.Create<Queue> ();
+            UintegerValue size;
+            virtualChannel.m_queue->GetAttribute ("MaxPackets", size);
+            virtualChannel.m_capacity = size.Get ();
+          }
+        virtualChannel.m_reserved = false;
+        virtualChannel.m_headUid = 0;
+        virtualChannel.m_outputVirtualChannel = -1;
+        m_virtualChannels.push_back (virtualChannel);
+      }
+  }
+
+  uint32_t
+  NocNetDevice::GetNumberOfVirtualChannels () const
+  {
+    return m_virtualChannels.size ();
+  }
+
+  Ptr<const Packet>
+  NocNetDevice::PeekVirtualChannel (uint32_t vc) const
+  {
+    NS_ASSERT (vc < m_virtualChannels.size ());
+    return m_virtualChannels[vc].m_queue->Peek ();
+  }
+
+  Ptr<NocNetDevice>
+  NocNetDevice::GetOutputNetDevice (uint32_t vc) const
+  {
+    Ptr<const Packet> packet = PeekVirtualChannel (vc);
+    NS_ASSERT_MSG (packet != 0, "The virtual channel " << vc << " of the net device " << GetAddress () << " is empty");
+    std::map<Ptr<const Packet>,SrcDest>::const_iterator it = m_pktSrcDestMap.find (packet);
+    NS_ASSERT (it != m_pktSrcDestMap.end ());
+    Ptr<NocNetDevice> viaNetDevice = it->second.GetViaNetDevice ();
+    if (viaNetDevice == 0)
+      {
+        return Ptr<NocNetDevice> (const_cast<NocNetDevice *> (this));
+      }
+    return viaNetDevice;
+  }
+
+  Ptr<NocNetDevice>
+  NocNetDevice::GetNextNetDevice (uint32_t vc) const
+  {
+    Ptr<NocNetDevice> output = GetOutputNetDevice (vc);
+    NS_ASSERT_MSG (output->m_channel != 0, "The output net device " << output->GetAddress () << " has no channel");
+    return DynamicCast<NocNetDevice> (output->m_channel->GetDevice (1 - output->m_deviceId));
+  }
+
+  bool
+  NocNetDevice::IsEjectedAtNextNetDevice (uint32_t vc) const
+  {
+    Ptr<const Packet> packet = PeekVirtualChannel (vc);
+    std::map<Ptr<const Packet>,SrcDest>::const_iterator it = m_pktSrcDestMap.find (packet);
+    NS_ASSERT (it != m_pktSrcDestMap.end ());
+    return it->second.GetDest () == GetNextNetDevice (vc)->m_address;
+  }
+
+  bool
+  NocNetDevice::IsVirtualChannelReserved (uint32_t vc) const
+  {
+    NS_ASSERT (vc < m_virtualChannels.size ());
+    return m_virtualChannels[vc].m_reserved;
+  }
+
+  void
+  NocNetDevice::ReserveVirtualChannel (uint32_t vc, uint32_t headUid)
+  {
+    NS_LOG_FUNCTION (vc << headUid);
+    NS_ASSERT (vc < m_virtualChannels.size ());
+    NS_ASSERT_MSG (!m_virtualChannels[vc].m_reserved, "The virtual channel " << vc << " of the net device "
+        << GetAddress () << " is already allocated to the message with head UID " << m_virtualChannels[vc].m_headUid);
+    m_virtualChannels[vc].m_reserved = true;
+    m_virtualChannels[vc].m_headUid = headUid;
+    m_messageVirtualChannels[headUid] = vc;
+  }
+
+  int
+  NocNetDevice::GetOutputVirtualChannel (uint32_t vc) const
+  {
+    NS_ASSERT (vc < m_virtualChannels.size ());
+    return m_virtualChannels[vc].m_outputVirtualChannel;
+  }
+
+  void
+  NocNetDevice::SetOutputVirtualChannel (uint32_t vc, int outputVc)
+  {
+    NS_ASSERT (vc < m_virtualChannels.size ());
+    m_virtualChannels[vc].m_outputVirtualChannel = outputVc;
+  }
+
+  bool
+  NocNetDevice::IsReadyToSend (uint32_t vc) const
+  {
+    Ptr<NocNetDevice> output = GetOutputNetDevice (vc);
+    if (!IsEjectedAtNextNetDevice (vc))
+      {
+        int outputVc = m_virtualChannels[vc].m_outputVirtualChannel;
+        if (outputVc < 0 || !output->HasCredit (outputVc))
+          {
+            return false;
+          }
+      }
+    return !output->m_channel->IsBusy (output);
+  }
+
+  bool
+  NocNetDevice::SendFromVirtualChannel (uint32_t vc)
+  {
+    NS_LOG_FUNCTION (vc);
+
+    Ptr<const Packet> packet = PeekVirtualChannel (vc);
+    NS_ASSERT_MSG (packet != 0, "The virtual channel " << vc << " of the net device " << GetAddress () << " is empty");
+    SrcDest srcDest = m_pktSrcDestMap[packet];
+    Ptr<NocNetDevice> output = GetOutputNetDevice (vc);
+
+    // the flit stays in the virtual channel until the channel delivers it, so a copy is sent
+    Ptr<Packet> packetToSend = packet->Copy ();
+    int outputVc = IsEjectedAtNextNetDevice (vc) ? -1 : m_virtualChannels[vc].m_outputVirtualChannel;
+    if (!output->m_channel->TransmitStart (this, packetToSend, output->m_deviceId, outputVc))
+      {
+        NS_LOG_LOGIC ("Cannot send packet " << *packetToSend << " (UID " << packetToSend->GetUid () << ")"
+            << " because the channel is busy");
+        return false;
+      }
+    output->m_channel->Send (srcDest.GetDest (), srcDest.GetSrc ());
+    TraceSentPacket (packetToSend, srcDest.GetOriginalHeader ());
+    NS_LOG_LOGIC ("Packet " << *packetToSend << " (UID " << packetToSend->GetUid () << ")"
+        << " was sent from the virtual channel " << vc << " to the NoC net device with address " << srcDest.GetDest ());
+    return true;
+  }
+
+  void
+  NocNetDevice::InitializeCredits ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    m_credits.clear ();
+    if (m_channel == 0)
+      {
+        return;
+      }
+    Ptr<NocNetDevice> peer = DynamicCast<NocNetDevice> (m_channel->GetDevice (1 - m_deviceId));
+    NS_ASSERT_MSG (peer != 0, "The channel of the net device " << GetAddress () << " has a single net device");
+    if (peer->m_virtualChannels.empty ())
+      {
+        m_credits.push_back (peer->m_inQueueCapacity);
+      }
+    else
+      {
+        for (uint32_t i = 0; i < peer->m_virtualChannels.size (); i++)
+          {
+            m_credits.push_back (peer->m_virtualChannels[i].m_capacity);
+          }
+      }
+    NS_LOG_DEBUG ("The net device " << GetAddress () << " has " << m_credits.size ()
+        << " credit counter(s), for the net device " << peer->GetAddress ());
+  }
+
+  uint32_t
+  NocNetDevice::GetCredits (uint32_t vc) const
+  {
+    NS_ASSERT_MSG (vc < m_credits.size (), "The net device " << GetAddress () << " has no credits for virtual channel " << vc
+        << " (were the credits initialized?)");
+    return m_credits[vc];
+  }
+
+  bool
+  NocNetDevice::HasCredit (uint32_t vc) const
+  {
+    return GetCredits (vc) > 0;
+  }
+
+  void
+  NocNetDevice::ConsumeCredit (uint32_t vc)
+  {
+    NS_ASSERT_MSG (HasCredit (vc), "The net device " << GetAddress () << " has no credit for virtual channel " << vc);
+    m_credits[vc]--;
+    NS_LOG_DEBUG ("The net device " << GetAddress () << " consumed a credit for virtual channel " << vc
+        << " (" << m_credits[vc] << " credits left)");
+  }
+
+  void
+  NocNetDevice::ReturnCredit (uint32_t vc)
+  {
+    NS_ASSERT (vc < m_credits.size ());
+    m_credits[vc]++;
+    NS_LOG_DEBUG ("The net device " << GetAddress () << " got back a credit for virtual channel " << vc
+        << " (" << m_credits[vc] << " credits)");
+  }
+
+  Ptr<const Packet>
+  NocNetDevice::DequeueTransmittedPacket (uint32_t uid)
+  {
+    NS_LOG_FUNCTION (uid);
+
+    if (m_virtualChannels.empty ())
+      {
+        Ptr<const Packet> dequeuedPacket = DequeuePacketFromInQueue ();
+        if (dequeuedPacket != 0 && m_channel != 0)
+          {
+            m_channel->SendCredit (this, 0);
+          }
+        return dequeuedPacket;
+      }
+
+    for (uint32_t vc = 0; vc < m_virtualChannels.size (); vc++)
+      {
+        VirtualChannel &virtualChannel = m_virtualChannels[vc];
+        if (virtualChannel.m_queue->IsEmpty () || virtualChannel.m_queue->Peek ()->GetUid () != uid)
+          {
+            continue;
+          }
+        Ptr<const Packet> dequeuedPacket = virtualChannel.m_queue->Dequeue ();
+        m_pktSrcDestMap.erase (dequeuedPacket);
+        NS_LOG_LOGIC ("Dequeued packet " << *dequeuedPacket << " (UID " << uid << ")"
+            << " from the virtual channel " << vc << " of NoC net device with address " << GetAddress ());
+        if (m_channel != 0)
+          {
+            m_channel->SendCredit (this, vc);
+          }
+
+        NocPacketTag tag;
+        dequeuedPacket->PeekPacketTag (tag);
+        if (NocPacket::TAIL == tag.GetPacketType ()
+            || (NocPacket::HEAD == tag.GetPacketType () && tag.GetDataFlitCount () == 0))
+          {
+            // the last flit of the message left, so the virtual channel is released
+            uint32_t headUid = GetHeadUid (dequeuedPacket, tag);
+            m_messageVirtualChannels.erase (headUid);
+            if (virtualChannel.m_reserved && virtualChannel.m_headUid == headUid)
+              {
+                virtualChannel.m_reserved = false;
+              }
+            virtualChannel.m_outputVirtualChannel = -1;
+            NS_LOG_DEBUG ("The message with head UID " << headUid << " left the virtual channel " << vc);
+          }
+        return dequeuedPacket;
+      }
+    NS_LOG_WARN ("No virtual channel of the net device " << GetAddress () << " starts with the packet with UID " << uid);
+    return 0;
+  }
+
+  void
+  NocNetDevice::SetLosingFlits (bool losing)
+  {
+    NS_LOG_FUNCTION (losing);
+    if (losing)
+      {
+        m_losingFlits++;
+      }
+    else
+      {
+        NS_ASSERT_MSG (m_losingFlits > 0, "The net device " << GetAddress () << " does not lose flits");
+        m_losingFlits--;
+      }
+  }
+
+  void
+  NocNetDevice::LoseFlit (Ptr<const Packet> flit)
+  {
+    NS_LOG_FUNCTION (flit->GetUid ());
+
+    uint32_t vc = 0;
+    if (!m_virtualChannels.empty ())
+      {
+        vc = GetMessageVirtualChannel (flit);
+        NocPacketTag tag;
+        flit->PeekPacketTag (tag);
+        if (NocPacket::TAIL == tag.GetPacketType ()
+            || (NocPacket::HEAD == tag.GetPacketType () && tag.GetDataFlitCount () == 0))
+          {
+            // the message will not use its virtual channel anymore
+            uint32_t headUid = GetHeadUid (flit, tag);
+            m_messageVirtualChannels.erase (headUid);
+            if (m_virtualChannels[vc].m_reserved && m_virtualChannels[vc].m_headUid == headUid)
+              {
+                m_virtualChannels[vc].m_reserved = false;
+              }
+          }
+      }
+    if (m_channel != 0)
+      {
+        m_channel->SendCredit (this, vc);
+      }
+  }
+
+  uint32_t
+  NocNetDevice::GetMessageVirtualChannel (Ptr<const Packet> packet) const
+  {
+    NocPacketTag tag;
+    packet->PeekPacketTag (tag);
+    std::map<uint32_t, uint32_t>::const_iterator it = m_messageVirtualChannels.find (GetHeadUid (packet, tag));
+    if (it == m_messageVirtualChannels.end ())
+      {
+        return 0;
+      }
+    return it->second;
+  }
+
+  uint32_t
+  NocNetDevice::GetHeadUid (Ptr<const Packet> packet, const NocPacketTag &tag)
+  {
+    if (NocPacket::HEAD == tag.GetPacketType ())
+      {
+        return packet->GetUid ();
+      }
+    return tag.GetPacketHeadUid ();
+  }
+
+  void
+  NocNetDevice::TraceSentPacket (Ptr<Packet> packet, const NocHeader &originalHeader)
+  {
+    if (m_sendTrace.IsEmpty ())
+      {
+        return;
+      }
+
+    Ptr<Packet> tracedPacket = packet->Copy ();
+    NocHeader removedHeader;
+    NocPacketTag tag;
+    tracedPacket->PeekPacketTag (tag);
+    if (NocPacket::HEAD == tag.GetPacketType ())
+      {
+        tracedPacket->RemoveHeader (removedHeader);
+      }
+    if (!removedHeader.IsEmpty() && !originalHeader.IsEmpty ())
+      {
+        tracedPacket->AddHeader (originalHeader);
+      }
+    NOC_PROFILE (TRACE_CALLBACKS, GetInstanceTypeId ());
+    m_sendTrace (tracedPacket);
+  }
+
+  void
+  NocNetDevice::TraceReceivedPacket (Ptr<Packet> packet)
+  {
+    if (!m_receiveTrace.IsEmpty ())
+      {
+        NOC_PROFILE (TRACE_CALLBACKS, GetInstanceTypeId ());
+        m_receiveTrace (packet);
+      }
+  }
+
   void
   NocNetDevice::Drop (Ptr<Packet> packet)
   {
     NS_LOG_FUNCTION (packet);
     NS_LOG_LOGIC ("Dropping packet with UID " << packet->GetUid () << " " << *packet);
     // For now we just use this method to trace dropped packets
+    m_dropTrace (packet);
   }
 
   void
@@ -823,8 +1249,13 @@ namespace ns3
   void
   NocNetDevice::DoDispose ()
   {
+    m_virtualChannels.clear ();
+    m_messageVirtualChannels.clear ();
+    m_credits.clear ();
+    m_pktSrcDestMap.clear ();
     m_channel = 0;
     m_node = 0;
+    m_context = 0;
     NetDevice::DoDispose();
   }
 
@@ -33,8 +33,11 @@
 #include "ns3/noc-routing-protocol.h"
 #include "ns3/noc-topology.h"
 #include "ns3/queue.h"
+#include "ns3/object-factory.h"
 #include <map>
 #include "ns3/noc-header.h"
+#include "ns3/noc-packet-tag.h"
+#include "ns3/noc-simulation-context.h"
 #include <vector>
 
 namespace ns3
@@ -67,6 +70,20 @@ namespace ns3
     virtual void
     SetChannel(Ptr<NocChannel> channel);
 
+    /**
+     * Sets the simulation context (this is done by the NoC topology, at install time)
+     *
+     * \param context the simulation context
+     */
+    void
+    SetContext (Ptr<NocSimulationContext> context);
+
+    /**
+     * \return the simulation context
+     */
+    Ptr<NocSimulationContext>
+    GetContext () const;
+
     /**
      * Attach an input queue to this NoC net device.
      *
@@ -113,6 +130,7 @@ namespace ns3
 
     /**
      * \return the maximum number of packets the in queue might contain
+     *         (the capacity is read when the in queue is set, so this is a cheap call)
      */
     uint64_t
     GetInQueueSize ();
@@ -258,6 +276,196 @@ namespace ns3
     Ptr<NocNetDevice>
     GetViaNetDevice () const;
 
+    /**
+     * Splits the input buffer of this net device into virtual channels. Virtual channel 0 is the in queue
+     * of the net device; the other virtual channels get new queues. Once virtual channels are enabled,
+     * the buffered flits are no longer sent by the net device: the router allocates the virtual channels
+     * and the switch (see NocRouter::EnableVirtualChannels).
+     *
+     * \param virtualChannels how many virtual channels this net device has
+     * \param queueFactory the factory used for creating the queues of the virtual channels 1, 2, ...
+     */
+    void
+    EnableVirtualChannels (uint32_t virtualChannels, ObjectFactory queueFactory);
+
+    /**
+     * \return how many virtual channels this net device has (zero if virtual channels are not enabled)
+     */
+    uint32_t
+    GetNumberOfVirtualChannels () const;
+
+    /**
+     * \param vc a virtual channel
+     *
+     * \return the flit from the head of the virtual channel (NULL if the virtual channel is empty)
+     */
+    Ptr<const Packet>
+    PeekVirtualChannel (uint32_t vc) const;
+
+    /**
+     * \param vc a non empty virtual channel
+     *
+     * \return the net device (of the same router) through which the flit from the head of the virtual channel leaves
+     */
+    Ptr<NocNetDevice>
+    GetOutputNetDevice (uint32_t vc) const;
+
+    /**
+     * \param vc a non empty virtual channel
+     *
+     * \return the net device (of the next router) which receives the flit from the head of the virtual channel
+     */
+    Ptr<NocNetDevice>
+    GetNextNetDevice (uint32_t vc) const;
+
+    /**
+     * \param vc a non empty virtual channel
+     *
+     * \return whether the flit from the head of the virtual channel reaches its destination at the next router
+     *         (the flit is not buffered there, so it needs no downstream virtual channel)
+     */
+    bool
+    IsEjectedAtNextNetDevice (uint32_t vc) const;
+
+    /**
+     * \param vc a virtual channel
+     *
+     * \return whether the virtual channel is allocated to a message (by the upstream router)
+     */
+    bool
+    IsVirtualChannelReserved (uint32_t vc) const;
+
+    /**
+     * Allocates a free virtual channel to a message. The virtual channel is released when the last flit
+     * of the message leaves it.
+     *
+     * \param vc the virtual channel
+     * \param headUid the UID of the head flit of the message
+     */
+    void
+    ReserveVirtualChannel (uint32_t vc, uint32_t headUid);
+
+    /**
+     * \param vc a virtual channel
+     *
+     * \return the virtual channel of the next router allocated to the message from the head of
+     *         the virtual channel, or -1 if none was allocated yet
+     */
+    int
+    GetOutputVirtualChannel (uint32_t vc) const;
+
+    /**
+     * \param vc a virtual channel
+     * \param outputVc the virtual channel of the next router allocated to the message from the head of the virtual channel
+     */
+    void
+    SetOutputVirtualChannel (uint32_t vc, int outputVc);
+
+    /**
+     * Checks if the flit from the head of a virtual channel can traverse the switch: its message has a virtual channel
+     * in the next router (unless it is ejected there), the output net device has a credit for that virtual channel and
+     * the output link is not busy.
+     *
+     * \param vc a non empty virtual channel
+     *
+     * \return whether the flit can be sent
+     */
+    bool
+    IsReadyToSend (uint32_t vc) const;
+
+    /**
+     * Sends the flit from the head of a virtual channel. The flit stays in the virtual channel until the channel
+     * delivers it (see DequeueTransmittedPacket).
+     *
+     * \param vc a non empty virtual channel
+     *
+     * \return whether the flit was sent
+     */
+    bool
+    SendFromVirtualChannel (uint32_t vc);
+
+    /**
+     * Sets up the credits of this net device, used as an output port: one credit counter for each
+     * virtual channel of the net device from the other end of the channel (a single counter if that net device
+     * has no virtual channels). Each counter starts with the capacity of the buffer it accounts for.
+     * This must be done after the virtual channels of all the net devices are enabled.
+     */
+    void
+    InitializeCredits ();
+
+    /**
+     * \param vc a virtual channel of the net device from the other end of the channel (0 if virtual channels are not used)
+     *
+     * \return how many more flits can be sent to that virtual channel
+     */
+    uint32_t
+    GetCredits (uint32_t vc) const;
+
+    /**
+     * \param vc a virtual channel of the net device from the other end of the channel (0 if virtual channels are not used)
+     *
+     * \return whether one more flit can be sent to that virtual channel
+     */
+    bool
+    HasCredit (uint32_t vc) const;
+
+    /**
+     * Consumes a credit, for a flit sent to a virtual channel of the net device from the other end of the channel.
+     *
+     * \param vc the virtual channel (0 if virtual channels are not used)
+     */
+    void
+    ConsumeCredit (uint32_t vc);
+
+    /**
+     * Gets back a credit from the net device from the other end of the channel, after a flit left its buffer
+     * (see NocChannel::SendCredit).
+     *
+     * \param vc the virtual channel which has room for one more flit (0 if virtual channels are not used)
+     */
+    void
+    ReturnCredit (uint32_t vc);
+
+    /**
+     * Dequeues a flit which was transmitted by the channel, from the in queue or from its virtual channel.
+     * A credit is sent back to the upstream net device, because the buffer has room for one more flit.
+     *
+     * \param uid the UID of the transmitted flit
+     *
+     * \return the dequeued flit
+     */
+    Ptr<const Packet>
+    DequeueTransmittedPacket (uint32_t uid);
+
+    /**
+     * Makes the links of this net device lose the flits which cross them (see NocChannel::TransmitEnd),
+     * or makes them work again. The calls are counted: the links work again only after every call with true
+     * was followed by a call with false (the node, the router and the net device itself may fail independently).
+     *
+     * \param losing whether or not the flits are lost
+     */
+    void
+    SetLosingFlits (bool losing);
+
+    /**
+     * \return whether or not the links of this net device lose the flits which cross them
+     */
+    bool
+    IsLosingFlits () const
+    {
+      return m_losingFlits > 0;
+    }
+
+    /**
+     * Accounts for a flit which was sent to this net device and lost on the link: the credit consumed for it
+     * is sent back and, if it was the last flit of its message, the virtual channel allocated to the message
+     * is released.
+     *
+     * \param flit the lost flit
+     */
+    void
+    LoseFlit (Ptr<const Packet> flit);
+
   protected:
 
     virtual void
@@ -284,6 +492,8 @@ namespace ns3
     virtual void
     ProcessBufferedPackets (NocHeader originalHeader, Ptr<Packet> packet);
 
+    friend class NocCycleEngine;
+
   private:
 
     /**
@@ -301,6 +511,17 @@ namespace ns3
      */
     Ptr<Queue> m_inQueue;
 
+    /**
+     * how many flits the in queue can buffer (read once, from the queue's MaxPackets attribute)
+     */
+    uint32_t m_inQueueCapacity;
+
+    /**
+     * the credits of this net device, used as an output port: how many more flits can be sent
+     * to each virtual channel of the net device from the other end of the channel
+     */
+    std::vector<uint32_t> m_credits;
+
     class SrcDest
     {
     private:
@@ -310,6 +531,11 @@ namespace ns3
 
       Ptr<NocNetDevice> m_viaNetDevice;
 
+      /**
+       * the header of the packet before routing (kept only in virtual channel mode, for tracing)
+       */
+      NocHeader m_originalHeader;
+
     public:
 
       SrcDest ()
@@ -326,6 +552,14 @@ namespace ns3
         m_viaNetDevice = viaNetDevice;
       }
 
+      SrcDest (Mac48Address src, Mac48Address dest, Ptr<NocNetDevice> viaNetDevice, const NocHeader &originalHeader)
+      {
+        m_src = src;
+        m_dest = dest;
+        m_viaNetDevice = viaNetDevice;
+        m_originalHeader = originalHeader;
+      }
+
       Mac48Address
       GetSrc () const
       {
@@ -344,10 +578,75 @@ namespace ns3
         return m_viaNetDevice;
       }
 
+      const NocHeader &
+      GetOriginalHeader () const
+      {
+        return m_originalHeader;
+      }
+
     };
 
     std::map<Ptr<const Packet>,SrcDest> m_pktSrcDestMap;
 
+    /**
+     * The state of a virtual channel
+     */
+    struct VirtualChannel
+    {
+      /**
+       * the flits buffered by the virtual channel
+       */
+      Ptr<Queue> m_queue;
+
+      /**
+       * how many flits the virtual channel can buffer (read once, from the queue's MaxPackets attribute)
+       */
+      uint32_t m_capacity;
+
+      /**
+       * whether the virtual channel is allocated to a message
+       */
+      bool m_reserved;
+
+      /**
+       * the UID of the head flit of the message which reserved the virtual channel
+       */
+      uint32_t m_headUid;
+
+      /**
+       * the virtual channel of the next router allocated to the message from the head of this virtual channel (or -1)
+       */
+      int m_outputVirtualChannel;
+    };
+
+    /**
+     * the virtual channels of this net device (empty if virtual channels are not used)
+     */
+    std::vector<VirtualChannel> m_virtualChannels;
+
+    /**
+     * the virtual channel allocated to each message, by the UID of its head flit
+     */
+    std::map<uint32_t, uint32_t> m_messageVirtualChannels;
+
+    /**
+     * \param packet a flit
+     *
+     * \return the virtual channel which buffers the message of the flit
+     *         (virtual channel 0, if no virtual channel was allocated to the message)
+     */
+    uint32_t
+    GetMessageVirtualChannel (Ptr<const Packet> packet) const;
+
+    /**
+     * \param packet a flit
+     * \param tag the tag of the flit
+     *
+     * \return the UID of the head flit of the flit's message
+     */
+    static uint32_t
+    GetHeadUid (Ptr<const Packet> packet, const NocPacketTag &tag);
+
     /**
      * The Queue which this NoC net device uses as a packet source (channel output buffering).
      *
@@ -374,6 +673,24 @@ namespace ns3
     void
     MarkHeadPacketAsUnblocked (Ptr<Packet> packet);
 
+    /**
+     * Fires the Send trace source, for a packet which has the specified original header (before routing).
+     * The traced packet is built only if the trace source has sinks.
+     *
+     * \param packet the sent packet
+     * \param originalHeader the header of the packet, before it was routed
+     */
+    void
+    TraceSentPacket (Ptr<Packet> packet, const NocHeader &originalHeader);
+
+    /**
+     * Fires the Receive trace source for a packet which reached its destination.
+     *
+     * \param packet the received packet
+     */
+    void
+    TraceReceivedPacket (Ptr<Packet> packet);
+
     NetDevice::ReceiveCallback m_rxCallback;
 
     NetDevice::PromiscReceiveCallback m_promiscCallback;
@@ -386,6 +703,11 @@ namespace ns3
 
     Mac48Address m_address;
 
+    /**
+     * how many faults make the links of this net device lose flits (see SetLosingFlits)
+     */
+    uint32_t m_losingFlits;
+
     /**
      * Marks to what direction this NoC net device can route packets to.
      * This field should take the value from an enum (enumeration) taken
@@ -414,6 +736,13 @@ namespace ns3
      */
     TracedCallback<Ptr<const Packet> > m_receiveTrace;
 
+    /**
+     * The trace source fired when packets are dropped.
+     *
+     * \see class CallBackTraceSource
+     */
+    TracedCallback<Ptr<const Packet> > m_dropTrace;
+
     /**
      * The net device used as an output port for sending a message from this
      * net device. If a via net device is set, its channel will be used for
@@ -427,6 +756,11 @@ namespace ns3
      * an event more than once, at the same time)
      */
     Time m_lastScheduledEvent;
+
+    /**
+     * the simulation context (global clock, speedup, flit size, topology)
+     */
+    Ptr<NocSimulationContext> m_context;
   };
 
 } // namespace ns3
@@ -42,6 +42,13 @@ namespace ns3
             BooleanValue (false),
             MakeBooleanAccessor (&NocFaultyNode::m_faulty),
             MakeBooleanChecker ())
+        .AddAttribute (
+            "LoseFlits",
+            "Whether or not a faulty node loses the flits which cross it, instead of stopping the simulation "
+            "when it is used (default is false)",
+            BooleanValue (false),
+            MakeBooleanAccessor (&NocFaultyNode::m_loseFlits),
+            MakeBooleanChecker ())
         ;
     return tid;
   }
@@ -51,6 +58,8 @@ namespace ns3
     NS_LOG_FUNCTION_NOARGS ();
 
     m_faulty = false;
+    m_loseFlits = false;
+    m_losing = false;
   }
 
   NocFaultyNode::~NocFaultyNode ()
@@ -90,21 +99,37 @@ namespace ns3
     return router;
   }
 
-//  void
-//  NocFaultyNode::SetFaulty (bool faulty)
-//  {
-//    NS_LOG_FUNCTION_NOARGS ();
-//    m_faulty = faulty;
-//    NS_LOG_LOGIC ("The node " << (int) GetId () << " has the faulty state set to " << faulty);
-//  }
-//
-//  bool
-//  NocFaultyNode::IsFaulty ()
-//  {
-//    NS_LOG_FUNCTION_NOARGS ();
-//    NS_LOG_LOGIC ("The node " << (int) GetId () << " has the faulty state " << m_faulty);
-//    return m_faulty;
-//  }
+  void
+  NocFaultyNode::SetFaulty (bool faulty)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+    if (m_loseFlits)
+      {
+        if (faulty != m_losing)
+          {
+            for (uint32_t i = 0; i < GetNDevices (); ++i)
+              {
+                Ptr<NocNetDevice> device = DynamicCast<NocNetDevice> (GetDevice (i));
+                if (device != 0)
+                  {
+                    device->SetLosingFlits (faulty);
+                  }
+              }
+            m_losing = faulty;
+          }
+      }
+    else
+      {
+        m_faulty = faulty;
+      }
+    NS_LOG_LOGIC ("The node " << GetId () << " has the faulty state set to " << faulty);
+  }
+
+  bool
+  NocFaultyNode::IsFaulty () const
+  {
+    return m_faulty || m_losing;
+  }
 
   void
   NocFaultyNode::InjectPacket (Ptr<NocPacket> packet, Ptr<NocNode> destination)
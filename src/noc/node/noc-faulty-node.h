@@ -33,6 +33,9 @@ namespace ns3
    * A NocNode which can be faulty.
    * The faulty property is an ns-3 attribute.
    *
+   * By default, a faulty node stops the simulation when it is used. When the LoseFlits attribute is set,
+   * a faulty node keeps working, but the links of its net devices lose the flits which cross them (see NocChannel::TransmitEnd).
+   *
    * \see NocNode
    */
   class NocFaultyNode : public NocNode
@@ -58,11 +61,20 @@ namespace ns3
     GetRouter ();
     //\}
 
-//    void
-//    SetFaulty (bool faulty);
-//
-//    bool
-//    IsFaulty ();
+    /**
+     * Marks the node as faulty or as working. This is the same as setting the Faulty attribute,
+     * without looking up the attribute.
+     *
+     * \param faulty whether or not the node is faulty
+     */
+    void
+    SetFaulty (bool faulty);
+
+    /**
+     * \return whether or not the node is faulty
+     */
+    bool
+    IsFaulty () const;
 
     /**
      * Injects a specified packet into the NoC. The packet will be sent to the specified destination node.
@@ -90,6 +102,16 @@ namespace ns3
      */
     bool m_faulty;
 
+    /**
+     * whether or not a fault makes the node lose flits, instead of stopping the simulation
+     */
+    bool m_loseFlits;
+
+    /**
+     * whether or not the node is faulty and loses flits
+     */
+    bool m_losing;
+
   };
 
 } // namespace ns3
@@ -24,6 +24,7 @@
 #include "ns3/simulator.h"
 #include "ns3/noc-registry.h"
 #include "ns3/integer.h"
+#include "ns3/noc-profiler.h"
 
 NS_LOG_COMPONENT_DEFINE ("NocNode");
 
@@ -77,6 +78,7 @@ namespace ns3
   void
   NocNode::InjectPacket (Ptr<NocPacket> packet, Ptr<NocNode> destination)
   {
+    NOC_PROFILE (INJECTION, GetInstanceTypeId ());
     NS_LOG_LOGIC ("Node " << GetId () << " is injecting the packet " << *packet
         << " (packet UID " << packet->GetUid () << " ; destination is "
         << destination->GetId () << ")");
@@ -93,6 +95,7 @@ namespace ns3
   void
   NocNode::Send (Ptr<NocNetDevice> source, Ptr<Packet> packet, Ptr<NocNode> destination)
   {
+    NOC_PROFILE (NODE_SEND, GetInstanceTypeId ());
     NS_LOG_DEBUG ("source " << source->GetAddress () << ", packet UID " << packet->GetUid () << ", destination " << destination->GetId ());
 
     NocHeader header;
@@ -102,19 +105,20 @@ namespace ns3
       {
         packet->PeekHeader (header);
       }
-    Ptr<Route> route = GetRouter ()->ManageFlit (source, destination, packet);
+    Route route = GetRouter ()->ManageFlit (source, destination, packet);
+    NS_ASSERT_MSG (route.IsValid (), "No route was found for the packet with UID " << packet->GetUid ());
     NS_LOG_DEBUG ("The route for packet with UID " << packet->GetUid ()
-        << " is from " << route->GetSourceDevice ()->GetAddress ()
-        << " to " << route->GetDestinationDevice ()->GetAddress ());
+        << " is from " << route.GetSourceDevice ()->GetAddress ()
+        << " to " << route.GetDestinationDevice ()->GetAddress ());
     // note the packet returned by the route has its header updated!
-    // => packet->PeekHeader (...) <> route->GetPacket ()->PeekHeader (...)
-    Ptr<Packet> routedPacket = route->GetRoutedPacket ();
+    // => packet->PeekHeader (...) <> route.GetPacket ()->PeekHeader (...)
+    Ptr<Packet> routedPacket = route.GetRoutedPacket ();
     // add the original header as well
     if (NocPacket::HEAD == tag.GetPacketType () && !header.IsEmpty ())
       {
         routedPacket->AddHeader (header);
       }
-    DoSend (routedPacket, source, route->GetSourceDevice (), route->GetDestinationDevice ());
+    DoSend (routedPacket, source, route.GetSourceDevice (), route.GetDestinationDevice ());
   }
 
   void
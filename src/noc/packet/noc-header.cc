@@ -35,443 +35,450 @@ NS_LOG_COMPONENT_DEFINE ("NocHeader");
 namespace ns3
 {
 
-  NS_OBJECT_ENSURE_REGISTERED ( NocHeader);
+  // the serialized coordinates are big-endian, with the width of the coordinate type
 
-  NocHeader::NocHeader ()
+  static void
+  WriteCoordinate (Buffer::Iterator &i, uint8_t coordinate)
   {
-    IntegerValue integerValue;
-    NocRegistry::GetInstance ()->GetAttribute ("NoCDimensions", integerValue);
-    uint32_t topologyDimension = integerValue.Get ();
-    NocHeader::m_source = vector<uint8_t> ();
-    NocHeader::m_distance = vector<uint8_t> ();
-    for (unsigned int i = 0; i < topologyDimension; i ++)
-      {
-        NocHeader::m_source.insert(m_source.end(), 0);
-        NocHeader::m_distance.insert(m_distance.end(), 0);
-      }
-
-    //    NocHeader::m_subdataId = 0;
-    //    NocHeader::m_peGroupAddress = 0;
+    i.WriteU8 (coordinate);
   }
-  NocHeader::NocHeader (uint8_t xDistance, uint8_t yDistance, uint8_t sourceX, uint8_t sourceY, uint16_t dataFlitCount)
-    {
-      IntegerValue integerValue;
-      NocRegistry::GetInstance ()->GetAttribute ("NoCDimensions", integerValue);
-      uint32_t topologyDimension = integerValue.Get ();
-      NocHeader::m_source = vector<uint8_t> ();
-      NocHeader::m_distance = vector<uint8_t> ();
-      for (unsigned int i = 0; i < topologyDimension; i ++)
-        {
-          NocHeader::m_source.insert(m_source.end(), 0);
-          NocHeader::m_distance.insert(m_distance.end(), 0);
-        }
-      NocHeader::m_distance.at(0) = xDistance;
-      NocHeader::m_distance.at(1) = yDistance;
-      NocHeader::m_source.at(0) = sourceX;
-      NocHeader::m_source.at(1) = sourceY;
-  //    NocHeader::m_subdataId = 0;
-  //    NocHeader::m_peGroupAddress = 0;
-    }
 
-  NocHeader::NocHeader (uint8_t xDistance, uint8_t yDistance, uint8_t zDistance, uint8_t sourceX, uint8_t sourceY, uint8_t sourceZ, uint16_t dataFlitCount)
+  static void
+  WriteCoordinate (Buffer::Iterator &i, uint16_t coordinate)
   {
-    IntegerValue integerValue;
-    NocRegistry::GetInstance ()->GetAttribute ("NoCDimensions", integerValue);
-    uint32_t topologyDimension = integerValue.Get ();
-    NocHeader::m_source = vector<uint8_t> ();
-    NocHeader::m_distance = vector<uint8_t> ();
-    for (unsigned int i = 0; i < topologyDimension; i ++)
-      {
-        NocHeader::m_source.insert(m_source.end(), 0);
-        NocHeader::m_distance.insert(m_distance.end(), 0);
-      }
-    NocHeader::m_distance.at (0) = xDistance;
-    NocHeader::m_distance.at (1) = yDistance;
-    NocHeader::m_distance.at (2) = zDistance;
-    NocHeader::m_source.at (0) = sourceX;
-    NocHeader::m_source.at (1) = sourceY;
-    NocHeader::m_source.at (2) = sourceZ;
-    //    NocHeader::m_subdataId = 0;
-    //    NocHeader::m_peGroupAddress = 0;
-  }
-  NocHeader::NocHeader (std::vector<uint8_t> distance, std::vector<uint8_t> source, uint16_t dataFlitCount)
-  {
-    NocHeader::m_distance = distance;
-    NocHeader::m_source = source;
+    i.WriteHtonU16 (coordinate);
   }
 
-  NocHeader::~NocHeader ()
+  static void
+  ReadCoordinate (Buffer::Iterator &i, uint8_t &coordinate)
   {
-    ;
+    coordinate = i.ReadU8 ();
   }
 
-  TypeId
-  NocHeader::GetTypeId ()
+  static void
+  ReadCoordinate (Buffer::Iterator &i, uint16_t &coordinate)
   {
-        static TypeId tid = TypeId ("NocHeader")
-          .SetParent<Header> ()
-          .AddConstructor<NocHeader> ()
-        ;
-    return tid;
+    coordinate = i.ReadNtohU16 ();
   }
 
-  TypeId
-  NocHeader::GetInstanceTypeId () const
-  {
-    return GetTypeId ();
-  }
+  template <uint32_t N, typename C>
+    const uint32_t NocHeaderT<N, C>::MAX_DIMENSIONS;
 
-  uint32_t
-  NocHeader::GetSerializedSize () const
-  {
-    return GetHeaderSize (); // bytes
-  }
+  template <uint32_t N, typename C>
+    const uint32_t NocHeaderT<N, C>::COORDINATE_SIZE;
 
-  void
-  NocHeader::Serialize (Buffer::Iterator start) const
-  {
-    // The 1 byte-constant (the first 2 bits are 1 and the rest are 0;
-    // the 6 zeroes represent the packet type)
-    //    start.WriteU8 (HEADER_ID);
+  template <uint32_t N, typename C>
+    const uint32_t NocHeaderT<N, C>::MAX_SERIALIZED_SIZE;
 
-    for (unsigned int i = 0; i < m_distance.size (); i++)
-      {
-        start.WriteU8 (m_distance.at (i));
-      }
-    for (unsigned int i = 0; i < m_source.size (); i++)
-      {
-        start.WriteU8 (m_source.at (i));
-      }
+  template <uint32_t N, typename C>
+    const C NocHeaderT<N, C>::DIRECTION_BIT_MASK;
 
-    //    start.WriteU8 (m_subdataId);
+  template <uint32_t N, typename C>
+    const C NocHeaderT<N, C>::OFFSET_BIT_MASK;
 
-    //    start.WriteHtonU16 (m_peGroupAddress);
+  template <uint32_t N, typename C>
+    const C NocHeaderT<N, C>::MAX_COORDINATE;
 
-  }
+  template <uint32_t N, typename C>
+    NocHeaderT<N, C>::NocHeaderT ()
+    {
+      Initialize ();
+    }
 
-  uint32_t
-  NocHeader::Deserialize (Buffer::Iterator start)
-  {
-    //    uint8_t tmp;
-    //    tmp = start.ReadU8 ();
-    //    // if tmp == 0 then we have a data packet
-    //    if (tmp != 0)
-    //      {
-    //        NS_ASSERT (tmp == HEADER_ID);
-    for (unsigned int i = 0; i < m_distance.size (); i++)
-      {
-        m_distance.at (i) = start.ReadU8 ();
-      }
+  template <uint32_t N, typename C>
+    NocHeaderT<N, C>::NocHeaderT (C xDistance, C yDistance, C sourceX, C sourceY, uint16_t dataFlitCount)
+    {
+      Initialize ();
+      NS_ASSERT (m_dimensions >= 2);
+      m_distance[0] = xDistance;
+      m_distance[1] = yDistance;
+      m_source[0] = sourceX;
+      m_source[1] = sourceY;
+    }
 
-    for (unsigned int i = 0; i < m_source.size (); i++)
-      {
-        m_source.at (i) = start.ReadU8 ();
-      }
+  template <uint32_t N, typename C>
+    NocHeaderT<N, C>::NocHeaderT (C xDistance, C yDistance, C zDistance, C sourceX, C sourceY, C sourceZ,
+        uint16_t dataFlitCount)
+    {
+      Initialize ();
+      NS_ASSERT (m_dimensions >= 3);
+      m_distance[0] = xDistance;
+      m_distance[1] = yDistance;
+      m_distance[2] = zDistance;
+      m_source[0] = sourceX;
+      m_source[1] = sourceY;
+      m_source[2] = sourceZ;
+    }
 
+  template <uint32_t N, typename C>
+    NocHeaderT<N, C>::NocHeaderT (const std::vector<C> &distance, const std::vector<C> &source, uint16_t dataFlitCount)
+    {
+      NS_ASSERT (distance.size () == source.size ());
+      NS_ASSERT_MSG (distance.size () <= N, "A NoC header can have at most " << N << " dimensions");
+      m_dimensions = distance.size ();
+      for (uint32_t i = 0; i < N; i++)
+        {
+          m_distance[i] = i < m_dimensions ? distance[i] : 0;
+          m_source[i] = i < m_dimensions ? source[i] : 0;
+        }
+    }
 
-    //        m_subdataId = start.ReadU8 ();
+  template <uint32_t N, typename C>
+    NocHeaderT<N, C>::NocHeaderT (const C *distance, const C *source, uint32_t dimensions, uint16_t dataFlitCount)
+    {
+      NS_ASSERT_MSG (dimensions <= N, "A NoC header can have at most " << N << " dimensions");
+      m_dimensions = dimensions;
+      for (uint32_t i = 0; i < N; i++)
+        {
+          m_distance[i] = i < m_dimensions ? distance[i] : 0;
+          m_source[i] = i < m_dimensions ? source[i] : 0;
+        }
+    }
 
-    //        m_peGroupAddress = start.ReadNtohU16 ();
+  template <uint32_t N, typename C>
+    NocHeaderT<N, C>::~NocHeaderT ()
+    {
+      ;
+    }
 
-    //      }
+  template <uint32_t N, typename C>
+    void
+    NocHeaderT<N, C>::Initialize ()
+    {
+      uint32_t topologyDimension = NocRegistry::GetInstance ()->GetNocDimensions ();
+      NS_ASSERT_MSG (topologyDimension <= N, "A NoC header can have at most " << N << " dimensions");
+      m_dimensions = topologyDimension;
+      for (uint32_t i = 0; i < N; i++)
+        {
+          m_distance[i] = 0;
+          m_source[i] = 0;
+        }
+    }
 
-    return GetHeaderSize (); // the number of bytes consumed.
-  }
+  template <uint32_t N, typename C>
+    TypeId
+    NocHeaderT<N, C>::GetTypeId ()
+    {
+      // every instantiation has its own name (only the one used by the NoC, NocHeader, is registered)
+      static TypeId tid = TypeId (COORDINATE_SIZE == 1 ? "NocHeader" : "NocHeader16")
+        .SetParent<Header> ()
+        .AddConstructor<NocHeaderT<N, C> > ()
+      ;
+      return tid;
+    }
 
-  void
-  NocHeader::Print (std::ostream &os) const
-  {
-    std::vector<string> dir(m_distance.size());
-    for (unsigned int i = 0; i < m_distance.size (); i++)
-      {
-        if ((m_distance.at (i) & DIRECTION_BIT_MASK) == DIRECTION_BIT_MASK && (m_distance.at (i) != DIRECTION_BIT_MASK))
-          {
-            dir.at(i)= "B";
-          }
-        else
-          {
-            if ((m_distance.at (i) != 0) && (m_distance.at (i) != DIRECTION_BIT_MASK))
-              {
-                dir.at(i)= "F";
-              }
-          }
-        os << "dimension " << (i+1) << "=<" << (int) (m_distance.at (i) & OFFSET_BIT_MASK) << ", " << dir.at (i) << "> ";
-      }
-    for (unsigned int i = 0; i < m_source.size (); i++)
-      {
-        os <<" dimension " << (i+1) << " source=" << (int) m_source.at (i);
-      }
-  }
+  template <uint32_t N, typename C>
+    TypeId
+    NocHeaderT<N, C>::GetInstanceTypeId () const
+    {
+      return GetTypeId ();
+    }
 
-  bool
-  NocHeader::IsEmpty () const
-  {
-    bool empty = true;
-
-    for (unsigned int i = 0; i < m_distance.size (); i++)
-      {
-        if (m_distance.at (i) != 0)
-          {
-            empty = false;
-            break;
-          }
-      }
-
-    for (unsigned int i = 0; i < m_source.size (); i++)
-      {
-        if (m_source.at (i) != 0)
-          {
-            empty = false;
-            break;
-          }
-      }
-
-    return empty;
-  }
+  template <uint32_t N, typename C>
+    uint32_t
+    NocHeaderT<N, C>::GetSerializedSize () const
+    {
+      return 2 * m_dimensions * COORDINATE_SIZE; // bytes
+    }
 
-  //  void
-  //  NocHeader::SetXDistance(uint32_t xDistance)
-  //  {
-  //    m_xDistance = xDistance;
-  //  }
-  //
-  //  uint32_t
-  //  const NocHeader::GetXDistance()
-  //  {
-  //    return m_xDistance;
-  //  }
-  //
-  //  void
-  //  NocHeader::SetYDistance(uint32_t yDistance)
-  //  {
-  //    m_yDistance = yDistance;
-  //  }
-  //
-  //  uint32_t
-  //  const NocHeader::GetYDistance()
-  //  {
-  //    return m_yDistance;
-  //  }
-
-  bool
-  NocHeader::HasEastDirection ()
-  {
-    return (m_distance.at(0) & DIRECTION_BIT_MASK) != DIRECTION_BIT_MASK;
-  }
+  template <uint32_t N, typename C>
+    void
+    NocHeaderT<N, C>::Serialize (Buffer::Iterator start) const
+    {
+      for (uint32_t i = 0; i < m_dimensions; i++)
+        {
+          WriteCoordinate (start, m_distance[i]);
+        }
+      for (uint32_t i = 0; i < m_dimensions; i++)
+        {
+          WriteCoordinate (start, m_source[i]);
+        }
+    }
 
-  bool
-  NocHeader::HasWestDirection ()
-  {
-    return !HasEastDirection ();
-  }
+  template <uint32_t N, typename C>
+    uint32_t
+    NocHeaderT<N, C>::Deserialize (Buffer::Iterator start)
+    {
+      for (uint32_t i = 0; i < m_dimensions; i++)
+        {
+          ReadCoordinate (start, m_distance[i]);
+        }
+      for (uint32_t i = 0; i < m_dimensions; i++)
+        {
+          ReadCoordinate (start, m_source[i]);
+        }
 
-  bool
-  NocHeader::HasNorthDirection ()
-  {
-    return (m_distance.at(1) & DIRECTION_BIT_MASK) != DIRECTION_BIT_MASK;
-  }
+      return GetSerializedSize (); // the number of bytes consumed.
+    }
 
-  bool
-  NocHeader::HasSouthDirection ()
-  {
-    return !HasNorthDirection();
-  }
+  template <uint32_t N, typename C>
+    void
+    NocHeaderT<N, C>::Print (std::ostream &os) const
+    {
+      for (uint32_t i = 0; i < m_dimensions; i++)
+        {
+          std::string dir;
+          if ((m_distance[i] & OFFSET_BIT_MASK) != 0)
+            {
+              dir = (m_distance[i] & DIRECTION_BIT_MASK) == DIRECTION_BIT_MASK ? "B" : "F";
+            }
+          os << "dimension " << (i + 1) << "=<" << (int) (m_distance[i] & OFFSET_BIT_MASK) << ", " << dir << "> ";
+        }
+      for (uint32_t i = 0; i < m_dimensions; i++)
+        {
+          os << " dimension " << (i + 1) << " source=" << (int) m_source[i];
+        }
+    }
 
-  bool
-  NocHeader::HasUpDirection ()
-  {
-    return (m_distance.at(2) & DIRECTION_BIT_MASK) != DIRECTION_BIT_MASK;
-  }
+  template <uint32_t N, typename C>
+    bool
+    NocHeaderT<N, C>::IsEmpty () const
+    {
+      for (uint32_t i = 0; i < m_dimensions; i++)
+        {
+          if (m_distance[i] != 0 || m_source[i] != 0)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
 
-  bool
-  NocHeader::HasDownDirection ()
-  {
-    return !HasUpDirection ();
-  }
+  template <uint32_t N, typename C>
+    uint32_t
+    NocHeaderT<N, C>::GetDimensions () const
+    {
+      return m_dimensions;
+    }
 
-  bool
-  NocHeader::HasForwardDirection (int index)
-  {
-    return (m_distance.at (index) & DIRECTION_BIT_MASK) != DIRECTION_BIT_MASK;
-  }
+  template <uint32_t N, typename C>
+    bool
+    NocHeaderT<N, C>::HasEastDirection () const
+    {
+      return HasForwardDirection (0);
+    }
 
-  bool
-  NocHeader::HasBackDirection (int index)
-  {
-    return !HasForwardDirection (index);
-  }
+  template <uint32_t N, typename C>
+    bool
+    NocHeaderT<N, C>::HasWestDirection () const
+    {
+      return !HasEastDirection ();
+    }
 
-  void
-  NocHeader::SetXOffset (uint8_t xOffset)
-  {
-    if (HasEastDirection ())
-      {
-        m_distance.at(0) = xOffset;
-      }
-    else
-      {
-        m_distance.at(0) = xOffset | DIRECTION_BIT_MASK;
-      }
-  }
+  template <uint32_t N, typename C>
+    bool
+    NocHeaderT<N, C>::HasNorthDirection () const
+    {
+      return HasForwardDirection (1);
+    }
 
-  void
-  NocHeader::SetYOffset (uint8_t yOffset)
-  {
-    if (HasNorthDirection ())
-      {
-        m_distance.at(1) = yOffset;
-      }
-    else
-      {
-        m_distance.at(1) = yOffset | DIRECTION_BIT_MASK;
-      }
-  }
+  template <uint32_t N, typename C>
+    bool
+    NocHeaderT<N, C>::HasSouthDirection () const
+    {
+      return !HasNorthDirection ();
+    }
 
-  void
-  NocHeader::SetZOffset (uint8_t zOffset)
-  {
-    if (HasUpDirection ())
-      {
-        m_distance.at(2) = zOffset;
-      }
-    else
-      {
-        m_distance.at(2) = zOffset | DIRECTION_BIT_MASK;
-      }
-  }
+  template <uint32_t N, typename C>
+    bool
+    NocHeaderT<N, C>::HasUpDirection () const
+    {
+      return HasForwardDirection (2);
+    }
 
-  void
-  NocHeader::SetOffset (vector<uint8_t> offset)
-  {
-    for (unsigned int i = 0; i < m_distance.size (); i++)
-      {
-        if (HasForwardDirection (i))
-          {
-            m_distance.at (i) = offset.at (i);
-          }
-        else
-          {
-            m_distance.at (i) = offset.at (i) | DIRECTION_BIT_MASK;
-          }
-      }
-  }
+  template <uint32_t N, typename C>
+    bool
+    NocHeaderT<N, C>::HasDownDirection () const
+    {
+      return !HasUpDirection ();
+    }
 
-  uint8_t
-  NocHeader::GetXOffset ()
-  {
-    return m_distance.at(0) & OFFSET_BIT_MASK;
-  }
+  template <uint32_t N, typename C>
+    bool
+    NocHeaderT<N, C>::HasForwardDirection (int index) const
+    {
+      NS_ASSERT (index >= 0 && (uint32_t) index < m_dimensions);
+      return (m_distance[index] & DIRECTION_BIT_MASK) != DIRECTION_BIT_MASK;
+    }
 
-  uint8_t
-  NocHeader::GetYOffset ()
-  {
-    return m_distance.at(1) & OFFSET_BIT_MASK;
-  }
+  template <uint32_t N, typename C>
+    bool
+    NocHeaderT<N, C>::HasBackDirection (int index) const
+    {
+      return !HasForwardDirection (index);
+    }
 
-  uint8_t
-  NocHeader::GetZOffset ()
-  {
-    return m_distance.at(2) & OFFSET_BIT_MASK;
-  }
+  template <uint32_t N, typename C>
+    void
+    NocHeaderT<N, C>::SetXOffset (C xOffset)
+    {
+      SetOffset (0, xOffset);
+    }
 
-  vector<uint8_t>
-  NocHeader::GetOffset ()
-  {
-    std::vector<uint8_t> distance;
+  template <uint32_t N, typename C>
+    void
+    NocHeaderT<N, C>::SetYOffset (C yOffset)
+    {
+      SetOffset (1, yOffset);
+    }
 
-    for (unsigned int i = 0; i < m_distance.size (); i++)
-      {
-        distance.insert (distance.end (), m_distance.at (i) & OFFSET_BIT_MASK);
-      }
-    return distance;
-  }
+  template <uint32_t N, typename C>
+    void
+    NocHeaderT<N, C>::SetZOffset (C zOffset)
+    {
+      SetOffset (2, zOffset);
+    }
 
-  void
-  NocHeader::SetSourceX (uint8_t sourceX)
-  {
-    m_source.at(0) = sourceX;
-  }
+  template <uint32_t N, typename C>
+    void
+    NocHeaderT<N, C>::SetOffset (const std::vector<C> &offset)
+    {
+      NS_ASSERT (offset.size () >= m_dimensions);
+      for (uint32_t i = 0; i < m_dimensions; i++)
+        {
+          SetOffset (i, offset[i]);
+        }
+    }
 
-  uint8_t
-  const
-  NocHeader::GetSourceX ()
-  {
-    return m_source.at(0);
-  }
+  template <uint32_t N, typename C>
+    void
+    NocHeaderT<N, C>::SetOffset (int index, C offset)
+    {
+      NS_ASSERT (index >= 0 && (uint32_t) index < m_dimensions);
+      NS_ASSERT_MSG ((offset & DIRECTION_BIT_MASK) == 0, "The offset " << (int) offset << " is too large");
+      m_distance[index] = (m_distance[index] & DIRECTION_BIT_MASK) | offset;
+    }
 
-  void
-  NocHeader::SetSourceY (uint8_t sourceY)
-  {
-    m_source.at(1) = sourceY;
-  }
+  template <uint32_t N, typename C>
+    void
+    NocHeaderT<N, C>::DecrementOffset (int index)
+    {
+      NS_ASSERT_MSG ((m_distance[index] & OFFSET_BIT_MASK) > 0,
+          "The offset from dimension " << index << " is already zero");
+      m_distance[index] = (m_distance[index] & DIRECTION_BIT_MASK) | ((m_distance[index] & OFFSET_BIT_MASK) - 1);
+    }
 
-  uint8_t
-  const
-  NocHeader::GetSourceY ()
-  {
-    return m_source.at(1);
-  }
+  template <uint32_t N, typename C>
+    C
+    NocHeaderT<N, C>::GetXOffset () const
+    {
+      return GetOffset (0);
+    }
 
-  void
-  NocHeader::SetSourceZ (uint8_t sourceZ)
-  {
-    m_source.at(2) = sourceZ;
-  }
+  template <uint32_t N, typename C>
+    C
+    NocHeaderT<N, C>::GetYOffset () const
+    {
+      return GetOffset (1);
+    }
 
-  uint8_t
-  const
-  NocHeader::GetSourceZ ()
-  {
-    return m_source.at(2);
-  }
+  template <uint32_t N, typename C>
+    C
+    NocHeaderT<N, C>::GetZOffset () const
+    {
+      return GetOffset (2);
+    }
 
-  void
-  NocHeader::SetSource (vector<uint8_t> source)
-  {
-    m_source = source;
-  }
+  template <uint32_t N, typename C>
+    std::vector<C>
+    NocHeaderT<N, C>::GetOffset () const
+    {
+      std::vector<C> distance (m_dimensions);
+      for (uint32_t i = 0; i < m_dimensions; i++)
+        {
+          distance[i] = m_distance[i] & OFFSET_BIT_MASK;
+        }
+      return distance;
+    }
 
-  vector<uint8_t>
-  const
-  NocHeader::GetSource ()
-  {
-    return m_source;
-  }
+  template <uint32_t N, typename C>
+    C
+    NocHeaderT<N, C>::GetOffset (int index) const
+    {
+      NS_ASSERT (index >= 0 && (uint32_t) index < m_dimensions);
+      return m_distance[index] & OFFSET_BIT_MASK;
+    }
 
-  uint32_t
-  const
-  NocHeader::GetHeaderSize ()
-  {
-    IntegerValue integerValue;
-    NocRegistry::GetInstance ()->GetAttribute ("NoCDimensions", integerValue);
-    uint32_t topologyDimension = integerValue.Get ();
-    return (2 * topologyDimension);
-  }
+  template <uint32_t N, typename C>
+    void
+    NocHeaderT<N, C>::SetSourceX (C sourceX)
+    {
+      m_source[0] = sourceX;
+    }
+
+  template <uint32_t N, typename C>
+    C
+    NocHeaderT<N, C>::GetSourceX () const
+    {
+      return GetSource (0);
+    }
+
+  template <uint32_t N, typename C>
+    void
+    NocHeaderT<N, C>::SetSourceY (C sourceY)
+    {
+      m_source[1] = sourceY;
+    }
+
+  template <uint32_t N, typename C>
+    C
+    NocHeaderT<N, C>::GetSourceY () const
+    {
+      return GetSource (1);
+    }
+
+  template <uint32_t N, typename C>
+    void
+    NocHeaderT<N, C>::SetSourceZ (C sourceZ)
+    {
+      m_source[2] = sourceZ;
+    }
+
+  template <uint32_t N, typename C>
+    C
+    NocHeaderT<N, C>::GetSourceZ () const
+    {
+      return GetSource (2);
+    }
+
+  template <uint32_t N, typename C>
+    void
+    NocHeaderT<N, C>::SetSource (const std::vector<C> &source)
+    {
+      NS_ASSERT (source.size () >= m_dimensions);
+      for (uint32_t i = 0; i < m_dimensions; i++)
+        {
+          m_source[i] = source[i];
+        }
+    }
+
+  template <uint32_t N, typename C>
+    std::vector<C>
+    NocHeaderT<N, C>::GetSource () const
+    {
+      return std::vector<C> (m_source, m_source + m_dimensions);
+    }
+
+  template <uint32_t N, typename C>
+    C
+    NocHeaderT<N, C>::GetSource (int index) const
+    {
+      NS_ASSERT (index >= 0 && (uint32_t) index < m_dimensions);
+      return m_source[index];
+    }
+
+  template <uint32_t N, typename C>
+    uint32_t
+    NocHeaderT<N, C>::GetHeaderSize ()
+    {
+      uint32_t topologyDimension = NocRegistry::GetInstance ()->GetNocDimensions ();
+      return 2 * topologyDimension * COORDINATE_SIZE;
+    }
+
+  // both coordinate widths are built, the NoC uses the one selected by NocCoordinate
+  template class NocHeaderT<8, uint8_t>;
+  template class NocHeaderT<8, uint16_t>;
 
-//  void
-//  NocHeader::SetSubdataId (uint8_t subdataId)
-//  {
-//    m_subdataId = subdataId;
-//  }
-//
-//  uint8_t
-//  const
-//  NocHeader::GetSubdataId ()
-//  {
-//    return m_subdataId;
-//  }
-
-//  void
-//  NocHeader::SetPeGroupAddress (uint16_t peGroupAddress)
-//  {
-//    m_peGroupAddress = peGroupAddress;
-//  }
-//
-//  uint16_t
-//  const
-//  NocHeader::GetPeGroupAddress ()
-//  {
-//    return m_peGroupAddress;
-//  }
+  NS_OBJECT_ENSURE_REGISTERED (NocHeader);
 
 } // namespace ns3
@@ -23,25 +23,63 @@
 
 #include "ns3/header.h"
 #include "ns3/buffer.h"
+#include <stdint.h>
+#include <vector>
 
 namespace ns3
 {
 
   /**
-   * \brief Header for messages routed in 2D mesh and torus NoCs (based on the Irvine NoC architecture)
+   * \brief Header for messages routed in n-dimensional mesh and torus NoCs (based on the Irvine NoC architecture)
    *
    * This class has fields corresponding to those in a Network on Chip (NoC) header
    * (destination address, source address, etc).
+   *
+   * \detail The header keeps, for every topology dimension, the offset to the destination and the
+   *         coordinate of the source node. The fields are stored in fixed-size arrays (no memory is allocated
+   *         when a header is created, peeked or copied) and they are serialized as fixed-width big-endian
+   *         values. The most significant bit of an offset gives the routing direction (0 = forward, 1 = back).
+   *
+   *         The template parameters give the maximum number of topology dimensions and the type of a
+   *         coordinate. The number of dimensions which are actually used is the one from NocRegistry
+   *         (NoCDimensions) and it cannot be larger than MaxDimensions. The NoC uses the NocHeader
+   *         instantiation, which is chosen at build time (see NocCoordinate).
    */
-  class NocHeader : public Header
+  template <uint32_t MaxDimensions, typename CoordinateType>
+  class NocHeaderT : public Header
   {
   public:
 
-    static const uint8_t DIRECTION_BIT_MASK = 0x80;
+    /**
+     * the type of an offset and of a coordinate
+     */
+    typedef CoordinateType Coordinate;
+
+    /**
+     * the maximum number of topology dimensions a header can have
+     */
+    static const uint32_t MAX_DIMENSIONS = MaxDimensions;
+
+    /**
+     * the size of a serialized offset or coordinate, in bytes
+     */
+    static const uint32_t COORDINATE_SIZE = sizeof (CoordinateType);
+
+    /**
+     * the serialized size of a header with MAX_DIMENSIONS dimensions, in bytes
+     */
+    static const uint32_t MAX_SERIALIZED_SIZE = 2 * MaxDimensions * sizeof (CoordinateType);
+
+    static const CoordinateType DIRECTION_BIT_MASK = (CoordinateType) (1u << (8 * sizeof (CoordinateType) - 1));
+
+    static const CoordinateType OFFSET_BIT_MASK = (CoordinateType) ((1u << (8 * sizeof (CoordinateType) - 1)) - 1);
 
-    static const uint8_t OFFSET_BIT_MASK = 0x7F;
+    /**
+     * the largest coordinate a node can have
+     */
+    static const CoordinateType MAX_COORDINATE = (CoordinateType) ~0u;
 
-    NocHeader ();
+    NocHeaderT ();
 
     /**
      * Constructor - creates a header
@@ -52,21 +90,22 @@ namespace ns3
      * \param sourceY the Y coordinate of the source node
      * \param dataFlitCount the number of data flits (packets) that the message having this header will have
      */
-    NocHeader (uint8_t xDistance, uint8_t yDistance, uint8_t sourceX, uint8_t sourceY, uint16_t dataFlitCount);
+    NocHeaderT (CoordinateType xDistance, CoordinateType yDistance, CoordinateType sourceX, CoordinateType sourceY,
+        uint16_t dataFlitCount);
 
     /**
      * Constructor - creates a header
      *
      * \param xDistance the X (horizontal) offset to the destination
      * \param yDistance the Y (vertical) offset to the destination
-     * \param yDistance the Z offset to the destination
+     * \param zDistance the Z offset to the destination
      * \param sourceX the X coordinate of the source node
      * \param sourceY the Y coordinate of the source node
-     * \param sourceY the Z coordinate of the source node
+     * \param sourceZ the Z coordinate of the source node
      * \param dataFlitCount the number of data flits (packets) that the message having this header will have
      */
-    NocHeader (uint8_t xDistance, uint8_t yDistance, uint8_t zDistance,
-        uint8_t sourceX, uint8_t sourceY, uint8_t sourceZ,  uint16_t dataFlitCount);
+    NocHeaderT (CoordinateType xDistance, CoordinateType yDistance, CoordinateType zDistance,
+        CoordinateType sourceX, CoordinateType sourceY, CoordinateType sourceZ, uint16_t dataFlitCount);
 
     /**
      * Constructor - creates a header
@@ -75,11 +114,22 @@ namespace ns3
      * \param source the coordinate of the source node
      * \param dataFlitCount the number of data flits (packets) that the message having this header will have
      */
+    NocHeaderT (const std::vector<CoordinateType> &distance, const std::vector<CoordinateType> &source,
+        uint16_t dataFlitCount);
 
-    NocHeader (std::vector <uint8_t> distance, std::vector <uint8_t> source, uint16_t dataFlitCount);
+    /**
+     * Constructor - creates a header
+     *
+     * \param distance the offsets to the destination
+     * \param source the coordinates of the source node
+     * \param dimensions how many offsets and coordinates are given
+     * \param dataFlitCount the number of data flits (packets) that the message having this header will have
+     */
+    NocHeaderT (const CoordinateType *distance, const CoordinateType *source, uint32_t dimensions,
+        uint16_t dataFlitCount);
 
     virtual
-    ~NocHeader ();
+    ~NocHeaderT ();
 
     static TypeId
     GetTypeId ();
@@ -105,158 +155,178 @@ namespace ns3
     bool
     IsEmpty () const;
 
-    // allow protocol-specific access to the header data.
+    /**
+     * \return how many topology dimensions this header has
+     */
+    uint32_t
+    GetDimensions () const;
 
-//    void
-//    SetXDistance (uint8_t xDistance);
-//
-//    uint8_t
-//    const GetXDistance ();
-//
-//    void
-//    SetYDistance (uint8_t yDistance);
-//
-//    uint8_t
-//    const GetYDistance ();
+    // allow protocol-specific access to the header data.
 
     bool
-    HasEastDirection ();
+    HasEastDirection () const;
 
     bool
-    HasWestDirection ();
+    HasWestDirection () const;
 
     bool
-    HasNorthDirection ();
+    HasNorthDirection () const;
 
     bool
-    HasSouthDirection ();
+    HasSouthDirection () const;
 
     bool
-    HasUpDirection ();
+    HasUpDirection () const;
 
     bool
-    HasDownDirection ();
+    HasDownDirection () const;
 
     bool
-    HasForwardDirection (int index);
+    HasForwardDirection (int index) const;
 
     bool
-    HasBackDirection (int index);
+    HasBackDirection (int index) const;
 
     void
-    SetXOffset (uint8_t xOffset);
+    SetXOffset (CoordinateType xOffset);
 
-    uint8_t
-    GetXOffset ();
+    CoordinateType
+    GetXOffset () const;
 
     void
-    SetYOffset (uint8_t yOffset);
+    SetYOffset (CoordinateType yOffset);
 
-    uint8_t
-    GetYOffset ();
+    CoordinateType
+    GetYOffset () const;
 
     void
-    SetZOffset (uint8_t zOffset);
+    SetZOffset (CoordinateType zOffset);
 
-    uint8_t
-    GetZOffset ();
+    CoordinateType
+    GetZOffset () const;
 
+    /**
+     * Sets the offsets to the destination, for all the dimensions (the routing directions are not changed)
+     *
+     * \param offset the offsets
+     */
     void
-    SetOffset (std::vector <uint8_t> offset);
+    SetOffset (const std::vector<CoordinateType> &offset);
 
-    std::vector<uint8_t>
-    GetOffset ();
+    /**
+     * Sets the offset to the destination, for one dimension (the routing direction is not changed)
+     *
+     * \param index the dimension
+     * \param offset the offset
+     */
+    void
+    SetOffset (int index, CoordinateType offset);
+
+    /**
+     * \return the offsets to the destination (without the routing directions), for all the dimensions
+     */
+    std::vector<CoordinateType>
+    GetOffset () const;
+
+    /**
+     * \param index the dimension
+     *
+     * \return the offset to the destination (without the routing direction), for the specified dimension
+     */
+    CoordinateType
+    GetOffset (int index) const;
+
+    /**
+     * Decrements the offset from the specified dimension (the routing direction is not changed).
+     * This is what a router does after it forwards a head packet one hop further, in that dimension.
+     *
+     * \param index the dimension
+     */
+    void
+    DecrementOffset (int index);
 
     void
-    SetSourceX (uint8_t sourceX);
+    SetSourceX (CoordinateType sourceX);
 
-    uint8_t
-    const GetSourceX ();
+    CoordinateType
+    GetSourceX () const;
 
     void
-    SetSourceY (uint8_t sourceY);
+    SetSourceY (CoordinateType sourceY);
 
-    uint8_t
-    const GetSourceY ();
+    CoordinateType
+    GetSourceY () const;
 
     void
-    SetSourceZ (uint8_t sourceZ);
+    SetSourceZ (CoordinateType sourceZ);
 
-    uint8_t
-    const GetSourceZ ();
+    CoordinateType
+    GetSourceZ () const;
 
     void
-    SetSource (std::vector<uint8_t> source);
+    SetSource (const std::vector<CoordinateType> &source);
 
-    std::vector<uint8_t>
-    const GetSource ();
+    std::vector<CoordinateType>
+    GetSource () const;
 
     /**
-     * the size of this type of header, in bytes
+     * \param index the dimension
+     *
+     * \return the coordinate of the source node, from the specified dimension
      */
-    static uint32_t
-    const GetHeaderSize ();
-
-//    void
-//    SetSubdataId (uint8_t subdataId);
-//
-//    uint8_t
-//    const GetSubdataId ();
-
-//    void
-//    SetPeGroupAddress (uint16_t peGroupAddress);
-//
-//    uint16_t
-//    const GetPeGroupAddress ();
-
-  public:
+    CoordinateType
+    GetSource (int index) const;
 
     /**
      * the size of this type of header, in bytes
      */
-    // Make sure to update this field whenever you modify the structure of the header
-//    static const uint32_t HEADER_SIZE = 6;
+    static uint32_t
+    GetHeaderSize ();
 
   private:
 
-//    /**
-//     * the identifier of this kind of header
-//     */
-//    static const uint8_t HEADER_ID = 0x0C;
-
-    // m_Distance determine the destination address
-
-    std::vector <uint8_t> m_distance;
-
-    // m_xDistance, m_yDistance and m_zDistance determine the destination address
-
-//    uint8_t m_xDistance;
-
-//    uint8_t m_yDistance;
-
-    // m_sourceX, m_sourceY and m_sourceZ for the source address
-
-    std::vector <uint8_t> m_source;
+    /**
+     * Sets the number of dimensions from NocRegistry and clears all the fields
+     */
+    void
+    Initialize ();
 
-    // m_sourceX, m_sourceY and m_sourceZ for the source address
+    /**
+     * how many dimensions are used
+     */
+    uint8_t m_dimensions;
 
-//    uint8_t m_sourceX;
+    /**
+     * the offsets to the destination (each one with its routing direction bit)
+     */
+    CoordinateType m_distance[MaxDimensions];
 
-//    uint8_t m_sourceY;
+    /**
+     * the coordinates of the source node
+     */
+    CoordinateType m_source[MaxDimensions];
 
-//    /**
-//     * allows package indexing; this is useful when data has to be split
-//     * into multiple packets (a package order is required is such a case)
-//     */
-//    uint8_t m_subdataId;
+  };
 
-//    /**
-//     * allows to specify a group of processing elements to which the packet is sent
-//     * (this allows multicasting)
-//     */
-//    uint16_t m_peGroupAddress;
+#ifdef NS3_NOC_WIDE_COORDINATES
+  /**
+   * the type of the coordinates and offsets carried by the NoC headers
+   * (16 bits: at most 65536 nodes and 32767 hops in a dimension)
+   */
+  typedef uint16_t NocCoordinate;
+#else
+  /**
+   * the type of the coordinates and offsets carried by the NoC headers
+   * (8 bits: at most 256 nodes and 127 hops in a dimension; configure with --enable-noc-wide-coordinates
+   * for larger networks)
+   */
+  typedef uint8_t NocCoordinate;
+#endif
 
-  };
+  /**
+   * the header used by the NoC
+   */
+  typedef NocHeaderT<8, NocCoordinate> NocHeader;
 
 } // namespace ns3
 
@@ -32,6 +32,7 @@ namespace ns3 {
       m_load = 0;
       m_packetBlocked = false;
       m_ctgIteration = 0;
+      m_ctgDependency = 0;
     }
 
   TypeId
@@ -80,6 +81,11 @@ namespace ns3 {
     		  	     EmptyAttributeValue (),
     		  	     MakeUintegerAccessor (&NocPacketTag::m_ctgIteration),
     		  	     MakeUintegerChecker<uint64_t> ())
+      .AddAttribute ("CtgDependency",
+                     "the CTG dependency to which the data of this packet belongs (useful for NoC Communication Task Graph based traffic generator)",
+                     EmptyAttributeValue (),
+                     MakeUintegerAccessor (&NocPacketTag::m_ctgDependency),
+                     MakeUintegerChecker<uint32_t> ())
       ;
     return tid;
   }
@@ -93,7 +99,7 @@ namespace ns3 {
   uint32_t
   NocPacketTag::GetSerializedSize () const
   {
-    return 33; // 1 + 4 + 2 + 1 + 1 + 8 + 8 + 8
+    return 37; // 1 + 4 + 2 + 1 + 1 + 8 + 8 + 8 + 4
   }
 
   void
@@ -107,6 +113,7 @@ namespace ns3 {
     i.WriteU64 (m_injectionTime.GetPicoSeconds ());
     i.WriteU64 (m_receiveTime.GetPicoSeconds ());
     i.WriteU64 (m_ctgIteration);
+    i.WriteU32 (m_ctgDependency);
   }
 
   void
@@ -136,6 +143,7 @@ namespace ns3 {
     m_injectionTime = PicoSeconds (i.ReadU64 ());
     m_receiveTime = PicoSeconds (i.ReadU64 ());
     m_ctgIteration = i.ReadU64 ();
+    m_ctgDependency = i.ReadU32 ();
   }
 
   void
@@ -246,4 +254,16 @@ namespace ns3 {
 	  m_ctgIteration = ctgIteration;
   }
 
+  uint32_t
+  NocPacketTag::GetCtgDependency () const
+  {
+    return m_ctgDependency;
+  }
+
+  void
+  NocPacketTag::SetCtgDependency (uint32_t ctgDependency)
+  {
+    m_ctgDependency = ctgDependency;
+  }
+
 }  // namespace ns3
@@ -133,6 +133,20 @@ namespace ns3
     void
     SetCtgIteration (uint64_t ctgIteration);
 
+    /**
+     * \return the CTG dependency to which the data of this packet belongs
+     *         (an index from the remote task list of the receiving NocCtgApplication)
+     */
+    uint32_t
+    GetCtgDependency () const;
+
+    /**
+     * \param ctgDependency the CTG dependency to which the data of this packet belongs
+     *        (an index from the remote task list of the receiving NocCtgApplication)
+     */
+    void
+    SetCtgDependency (uint32_t ctgDependency);
+
   private:
 
     /**
@@ -178,6 +192,11 @@ namespace ns3
      * the CTG iteration for which this packet was created (useful for NoC Communication Task Graph based traffic generator)
      */
     uint64_t m_ctgIteration;
+
+    /**
+     * the CTG dependency to which the data of this packet belongs (useful for NoC Communication Task Graph based traffic generator)
+     */
+    uint32_t m_ctgDependency;
   };
 
 } // namespace ns3
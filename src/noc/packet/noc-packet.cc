@@ -28,38 +28,48 @@ NS_LOG_COMPONENT_DEFINE ("NocPacket");
 
 namespace ns3
 {
-  NocPacket::NocPacket (uint8_t xDistance, uint8_t yDistance, uint8_t sourceX,
-      uint8_t sourceY,  uint16_t dataFlitCount,uint32_t dataPacketSize)
+  NocPacket::NocPacket (NocCoordinate xDistance, NocCoordinate yDistance, NocCoordinate sourceX,
+      NocCoordinate sourceY,  uint16_t dataFlitCount,uint32_t dataPacketSize)
   : Packet (dataPacketSize)
    {
      NocHeader nocHeader (xDistance, yDistance, sourceX, sourceY, dataFlitCount);
-     AddHeader (nocHeader);
      NocPacketTag tag;
      tag.SetPacketType (HEAD);
-     AddPacketTag (tag);
+     tag.SetDataFlitCount (dataFlitCount);
+     AddNocHeaderAndTag (&nocHeader, tag);
    }
 
-  NocPacket::NocPacket (uint8_t xDistance, uint8_t yDistance, uint8_t zDistance,
-      uint8_t sourceX, uint8_t sourceY, uint8_t sourceZ, uint16_t dataFlitCount,
+  NocPacket::NocPacket (NocCoordinate xDistance, NocCoordinate yDistance, NocCoordinate zDistance,
+      NocCoordinate sourceX, NocCoordinate sourceY, NocCoordinate sourceZ, uint16_t dataFlitCount,
       uint32_t dataPacketSize) : Packet (dataPacketSize)
   {
     NocHeader nocHeader (xDistance, yDistance, zDistance, sourceX, sourceY, sourceZ, dataFlitCount);
-    AddHeader (nocHeader);
     NocPacketTag tag;
     tag.SetPacketType (HEAD);
-    AddPacketTag (tag);
+    tag.SetDataFlitCount (dataFlitCount);
+    AddNocHeaderAndTag (&nocHeader, tag);
   }
 
-  NocPacket::NocPacket (std::vector<uint8_t> distance, std::vector<uint8_t> source, uint16_t dataFlitCount,
-       uint32_t dataPacketSize): Packet (dataPacketSize)
+  NocPacket::NocPacket (const std::vector<NocCoordinate> &distance, const std::vector<NocCoordinate> &source,
+       uint16_t dataFlitCount, uint32_t dataPacketSize): Packet (dataPacketSize)
    {
      NocHeader nocHeader (distance, source, dataFlitCount);
-     AddHeader (nocHeader);
      NocPacketTag tag;
      tag.SetPacketType (HEAD);
-     AddPacketTag (tag);
+     tag.SetDataFlitCount (dataFlitCount);
+     AddNocHeaderAndTag (&nocHeader, tag);
    }
 
+  NocPacket::NocPacket (const NocCoordinate *distance, const NocCoordinate *source, uint32_t dimensions,
+      uint16_t dataFlitCount, uint32_t dataPacketSize) : Packet (dataPacketSize)
+  {
+    NocHeader nocHeader (distance, source, dimensions, dataFlitCount);
+    NocPacketTag tag;
+    tag.SetPacketType (HEAD);
+    tag.SetDataFlitCount (dataFlitCount);
+    AddNocHeaderAndTag (&nocHeader, tag);
+  }
+
   NocPacket::NocPacket (uint32_t headPacketUid, uint32_t dataPacketSize, bool isTailPacket) :
     Packet (dataPacketSize)
   {
@@ -73,7 +83,7 @@ namespace ns3
         tag.SetPacketType (DATA);
       }
     tag.SetPacketHeadUid (headPacketUid);
-    AddPacketTag (tag);
+    AddNocHeaderAndTag (0, tag);
   }
 
   NocPacket::~NocPacket ()
@@ -81,4 +91,14 @@ namespace ns3
     ;
   }
 
+  void
+  NocPacket::AddNocHeaderAndTag (const NocHeader *header, const NocPacketTag &tag)
+  {
+    if (header != 0)
+      {
+        AddHeader (*header);
+      }
+    AddPacketTag (tag);
+  }
+
 } // namespace ns3
@@ -23,10 +23,13 @@
 
 #include "ns3/packet.h"
 #include "ns3/log.h"
+#include "noc-header.h"
 
 namespace ns3
 {
 
+  class NocPacketTag;
+
   class NocPacket : public Packet
   {
   public:
@@ -45,8 +48,8 @@ namespace ns3
      * \param dataFlitCount the number of data flits (packets) that the message having this header will have
      * \param dataPacketSize the size of the head packet (without including the size of the header)
      */
-    NocPacket (uint8_t xDistance, uint8_t yDistance, uint8_t sourceX,
-            uint8_t sourceY, uint16_t dataFlitCount, uint32_t dataPacketSize);
+    NocPacket (NocCoordinate xDistance, NocCoordinate yDistance, NocCoordinate sourceX,
+            NocCoordinate sourceY, uint16_t dataFlitCount, uint32_t dataPacketSize);
 
     /**
      * Constructor - creates a head packet
@@ -60,8 +63,8 @@ namespace ns3
      * \param dataFlitCount the number of data flits (packets) that the message having this header will have
      * \param dataPacketSize the size of the head packet (without including the size of the header)
      */
-    NocPacket (uint8_t xDistance, uint8_t yDistance, uint8_t zDistance, uint8_t sourceX,
-        uint8_t sourceY, uint8_t sourceZ, uint16_t dataFlitCount, uint32_t dataPacketSize);
+    NocPacket (NocCoordinate xDistance, NocCoordinate yDistance, NocCoordinate zDistance, NocCoordinate sourceX,
+        NocCoordinate sourceY, NocCoordinate sourceZ, uint16_t dataFlitCount, uint32_t dataPacketSize);
 
     /**
      * Constructor - creates a head packet
@@ -71,8 +74,20 @@ namespace ns3
      * \param dataFlitCount the number of data flits (packets) that the message having this header will have
      * \param dataPacketSize the size of the head packet (without including the size of the header)
      */
-    NocPacket (std::vector <uint8_t> distance, std::vector<uint8_t> source, uint16_t dataFlitCount,
-        uint32_t dataPacketSize);
+    NocPacket (const std::vector<NocCoordinate> &distance, const std::vector<NocCoordinate> &source,
+        uint16_t dataFlitCount, uint32_t dataPacketSize);
+
+    /**
+     * Constructor - creates a head packet (without allocating memory for the header fields)
+     *
+     * \param distance the offsets to the destination
+     * \param source the coordinates of the source node
+     * \param dimensions how many offsets and coordinates are given
+     * \param dataFlitCount the number of data flits (packets) that the message having this header will have
+     * \param dataPacketSize the size of the head packet (without including the size of the header)
+     */
+    NocPacket (const NocCoordinate *distance, const NocCoordinate *source, uint32_t dimensions,
+        uint16_t dataFlitCount, uint32_t dataPacketSize);
 
     /**
      * Constructor - creates a data packet
@@ -87,6 +102,15 @@ namespace ns3
 
   private:
 
+    /**
+     * Adds the header (if any) and the tag to this packet.
+     *
+     * \param header the header (NULL for data packets)
+     * \param tag the tag
+     */
+    void
+    AddNocHeaderAndTag (const NocHeader *header, const NocPacketTag &tag);
+
   };
 
 } // namespace ns3
@@ -128,14 +128,23 @@ namespace ns3
   {
     NS_LOG_DEBUG ("Searching for a net device for node " << GetNocNode ()->GetId () << " and direction " << routingDirection);
     Ptr<NocNetDevice> netDevice = 0;
-    for (unsigned int i = 0; i < GetNDevices (); ++i)
+    Ptr<NocTopology> topology = m_context != 0 ? m_context->GetTopology () : 0;
+    if (topology != 0)
       {
-        Ptr<NocNetDevice> tmpNetDevice = GetDevice (i)->GetObject<NocNetDevice> ();
-        if (tmpNetDevice->GetRoutingDirection () == routingDirection
-            && tmpNetDevice->GetRoutingDimension () == routingDimension)
+        // the topology indexes the net devices by node, direction and dimension
+        netDevice = topology->GetNetDevice (GetNocNode ()->GetId (), routingDirection, routingDimension);
+      }
+    else
+      {
+        for (unsigned int i = 0; i < GetNDevices (); ++i)
           {
-            netDevice = tmpNetDevice;
-            break;
+            Ptr<NocNetDevice> tmpNetDevice = GetDevice (i)->GetObject<NocNetDevice> ();
+            if (tmpNetDevice->GetRoutingDirection () == routingDirection
+                && tmpNetDevice->GetRoutingDimension () == routingDimension)
+              {
+                netDevice = tmpNetDevice;
+                break;
+              }
           }
       }
     if (netDevice)
@@ -171,6 +180,12 @@ namespace ns3
     return outputDevices;
   }
 
+  bool
+  FourWayRouter::HasFixedOutputNetDevices () const
+  {
+    return true;
+  }
+
   uint32_t
   FourWayRouter::GetNumberOfInputPorts ()
   {
@@ -195,8 +210,8 @@ namespace ns3
   {
     NS_LOG_FUNCTION_NOARGS ();
 
-    // TODO change this if virtual channels are added
-    return 0;
+    // zero, unless virtual channels are enabled (see NocRouter::EnableVirtualChannels)
+    return m_numberOfVirtualChannels;
   }
 
 } // namespace ns3
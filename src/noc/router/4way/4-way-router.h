@@ -61,6 +61,14 @@ namespace ns3
     std::vector<Ptr<NocNetDevice> >
     GetOutputNetDevices (Ptr<Packet> packet, Ptr<NocNetDevice> sender);
 
+    /**
+     * A four-way router has one net device for every routing direction and dimension.
+     *
+     * \return true
+     */
+    virtual bool
+    HasFixedOutputNetDevices () const;
+
     virtual void
     SetNocNode (Ptr<NocNode> nocNode);
 
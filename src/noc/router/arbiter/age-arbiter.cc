@@ -0,0 +1,71 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "age-arbiter.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("AgeArbiter");
+
+namespace ns3
+{
+
+  NS_OBJECT_ENSURE_REGISTERED (AgeArbiter);
+
+  TypeId
+  AgeArbiter::GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::AgeArbiter")
+        .SetParent<NocArbiter> ()
+        .AddConstructor<AgeArbiter> ();
+    return tid;
+  }
+
+  AgeArbiter::AgeArbiter ()
+  {
+    ;
+  }
+
+  AgeArbiter::~AgeArbiter ()
+  {
+    ;
+  }
+
+  int
+  AgeArbiter::Arbitrate (const std::vector<bool> &requests, const std::vector<Time> &requestTimes)
+  {
+    NS_ASSERT (requests.size () == m_size);
+    NS_ASSERT (requestTimes.size () == m_size);
+
+    int granted = -1;
+    for (uint32_t i = 0; i < m_size; i++)
+      {
+        if (requests[i] && (granted == -1 || requestTimes[i] < requestTimes[granted]))
+          {
+            granted = i;
+          }
+      }
+    NS_LOG_LOGIC ("Granted requester " << granted);
+    return granted;
+  }
+
+} // namespace ns3
@@ -0,0 +1,56 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef AGEARBITER_H_
+#define AGEARBITER_H_
+
+#include "noc-arbiter.h"
+
+namespace ns3
+{
+
+  /**
+   * \brief Age-based arbiter
+   *
+   * \detail The oldest request (the one which is waiting since the earliest time) is granted.
+   *         Ties are broken in favor of the requester with the smallest index.
+   */
+  class AgeArbiter : public NocArbiter
+  {
+  public:
+
+    static TypeId
+    GetTypeId ();
+
+    AgeArbiter ();
+
+    virtual
+    ~AgeArbiter ();
+
+    virtual int
+    Arbitrate (const std::vector<bool> &requests, const std::vector<Time> &requestTimes);
+  };
+
+} // namespace ns3
+
+#endif /* AGEARBITER_H_ */
@@ -0,0 +1,72 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef ISLIPARBITER_H_
+#define ISLIPARBITER_H_
+
+#include "noc-arbiter.h"
+
+namespace ns3
+{
+
+  /**
+   * \brief iSLIP arbiter
+   *
+   * \detail A round-robin arbiter whose priority pointer moves (past the granted requester) only when the
+   *         allocator accepts the grant. In a separable allocator, this desynchronizes the pointers of the arbiters
+   *         and avoids that several inputs keep requesting the same output (N. McKeown, The iSLIP scheduling algorithm
+   *         for input-queued switches).
+   */
+  class IslipArbiter : public NocArbiter
+  {
+  public:
+
+    static TypeId
+    GetTypeId ();
+
+    IslipArbiter ();
+
+    virtual
+    ~IslipArbiter ();
+
+    virtual void
+    SetSize (uint32_t size);
+
+    virtual int
+    Arbitrate (const std::vector<bool> &requests, const std::vector<Time> &requestTimes);
+
+    virtual void
+    Accept (uint32_t requester);
+
+  private:
+
+    /**
+     * the requester with the highest priority
+     */
+    uint32_t m_pointer;
+
+  };
+
+} // namespace ns3
+
+#endif /* ISLIPARBITER_H_ */
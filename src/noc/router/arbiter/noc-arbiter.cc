@@ -0,0 +1,71 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-arbiter.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("NocArbiter");
+
+namespace ns3
+{
+
+  NS_OBJECT_ENSURE_REGISTERED (NocArbiter);
+
+  TypeId
+  NocArbiter::GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::NocArbiter")
+        .SetParent<Object> ();
+    return tid;
+  }
+
+  NocArbiter::NocArbiter () : m_size (0)
+  {
+    ;
+  }
+
+  NocArbiter::~NocArbiter ()
+  {
+    ;
+  }
+
+  void
+  NocArbiter::SetSize (uint32_t size)
+  {
+    NS_LOG_FUNCTION (size);
+    m_size = size;
+  }
+
+  uint32_t
+  NocArbiter::GetSize () const
+  {
+    return m_size;
+  }
+
+  void
+  NocArbiter::Accept (uint32_t requester)
+  {
+    ; // This method is meant to be overridden by the arbiters which update their priorities only for accepted grants
+  }
+
+} // namespace ns3
@@ -0,0 +1,98 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCARBITER_H_
+#define NOCARBITER_H_
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include <vector>
+
+namespace ns3
+{
+
+  /**
+   * \brief Interface for the arbiters used by the allocators of a NoC router
+   *
+   * \detail An arbiter grants one of its requesters (identified by their index, from 0 to GetSize () - 1).
+   *         Arbiters which keep a priority state (e.g. a round-robin pointer) may update it when they grant
+   *         a request, or only when the allocator reports that the grant was accepted (see Accept).
+   */
+  class NocArbiter : public Object
+  {
+  public:
+
+    static TypeId
+    GetTypeId ();
+
+    NocArbiter ();
+
+    virtual
+    ~NocArbiter ();
+
+    /**
+     * Sets how many requesters this arbiter has. The priority state of the arbiter is reset.
+     *
+     * \param size the number of requesters
+     */
+    virtual void
+    SetSize (uint32_t size);
+
+    /**
+     * \return how many requesters this arbiter has
+     */
+    uint32_t
+    GetSize () const;
+
+    /**
+     * Grants one of the active requests.
+     *
+     * \param requests whether each requester makes a request (GetSize () elements)
+     * \param requestTimes since when each request is waiting (GetSize () elements)
+     *
+     * \return the index of the granted requester, or -1 if there is no request
+     */
+    virtual int
+    Arbitrate (const std::vector<bool> &requests, const std::vector<Time> &requestTimes) = 0;
+
+    /**
+     * Reports that the grant given to the specified requester was accepted by the allocator.
+     * By default, nothing is done.
+     *
+     * \param requester the index of the requester
+     */
+    virtual void
+    Accept (uint32_t requester);
+
+  protected:
+
+    /**
+     * how many requesters this arbiter has
+     */
+    uint32_t m_size;
+
+  };
+
+} // namespace ns3
+
+#endif /* NOCARBITER_H_ */
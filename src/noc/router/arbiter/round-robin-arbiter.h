@@ -0,0 +1,67 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef ROUNDROBINARBITER_H_
+#define ROUNDROBINARBITER_H_
+
+#include "noc-arbiter.h"
+
+namespace ns3
+{
+
+  /**
+   * \brief Round-robin arbiter
+   *
+   * \detail The requester which follows the last granted requester has the highest priority.
+   *         The priority pointer moves every time a request is granted.
+   */
+  class RoundRobinArbiter : public NocArbiter
+  {
+  public:
+
+    static TypeId
+    GetTypeId ();
+
+    RoundRobinArbiter ();
+
+    virtual
+    ~RoundRobinArbiter ();
+
+    virtual void
+    SetSize (uint32_t size);
+
+    virtual int
+    Arbitrate (const std::vector<bool> &requests, const std::vector<Time> &requestTimes);
+
+  private:
+
+    /**
+     * the requester with the highest priority
+     */
+    uint32_t m_pointer;
+
+  };
+
+} // namespace ns3
+
+#endif /* ROUNDROBINARBITER_H_ */
@@ -629,8 +629,8 @@ namespace ns3
   {
     NS_LOG_FUNCTION_NOARGS ();
 
-    // TODO change this if virtual channels are added
-    return 0;
+    // zero, unless virtual channels are enabled (see NocRouter::EnableVirtualChannels)
+    return m_numberOfVirtualChannels;
   }
 
 } // namespace ns3
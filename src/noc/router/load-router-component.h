@@ -76,6 +76,18 @@ namespace ns3
     GetLoadForDirection (Ptr<Packet> packet, Ptr<NocNetDevice> sourceDevice,
         Ptr<NocNetDevice> selectedDevice) = 0;
 
+    /**
+     * Computes the load which the router publishes through the load side-band (see NocLoadSideBand),
+     * once per epoch. Unlike GetLocalLoad (...), no packet is involved. The load accumulated
+     * by IncreaseLoad () during the epoch is consumed.
+     *
+     * \param router the router having this load component
+     *
+     * \return the load of the router (a percentage)
+     */
+    virtual int
+    GetEpochLoad (Ptr<NocRouter> router) = 0;
+
     /**
      * \return the name
      */
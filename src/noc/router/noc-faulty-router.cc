@@ -35,6 +35,8 @@ namespace ns3
     NS_LOG_FUNCTION_NOARGS ();
 
     m_faulty = false;
+    m_loseFlits = false;
+    m_losing = false;
   }
 
   NocFaultyRouter::NocFaultyRouter (std::string name, Ptr<LoadRouterComponent> loadComponent) :
@@ -43,6 +45,8 @@ namespace ns3
     NS_LOG_FUNCTION_NOARGS ();
 
     m_faulty = false;
+    m_loseFlits = false;
+    m_losing = false;
   }
 
   TypeId
@@ -56,6 +60,13 @@ namespace ns3
             BooleanValue (false),
             MakeBooleanAccessor (&NocFaultyRouter::m_faulty),
             MakeBooleanChecker ())
+        .AddAttribute (
+            "LoseFlits",
+            "Whether or not a faulty router loses the flits which cross it, instead of stopping the simulation "
+            "when it is used (default is false)",
+            BooleanValue (false),
+            MakeBooleanAccessor (&NocFaultyRouter::m_loseFlits),
+            MakeBooleanChecker ())
         ;
     return tid;
   }
@@ -65,12 +76,12 @@ namespace ns3
     NS_LOG_FUNCTION_NOARGS ();
   }
 
-  Ptr<Route>
+  Route
   NocFaultyRouter::ManageFlit (const Ptr<NocNetDevice> source, const Ptr<NocNode> destination, Ptr<Packet> flit)
   {
     NS_LOG_FUNCTION_NOARGS();
 
-    Ptr<Route> route = 0;
+    Route route;
     if (!m_faulty)
       {
         route = NocRouter::ManageFlit (source, destination, flit);
@@ -401,4 +412,33 @@ namespace ns3
     return name;
   }
 
+  void
+  NocFaultyRouter::SetFaulty (bool faulty)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+    if (m_loseFlits)
+      {
+        if (faulty != m_losing)
+          {
+            for (uint32_t i = 0; i < NocRouter::GetNDevices (); ++i)
+              {
+                NocRouter::GetDevice (i)->SetLosingFlits (faulty);
+              }
+            m_losing = faulty;
+          }
+      }
+    else
+      {
+        m_faulty = faulty;
+      }
+    // the name of a faulty router can not be retrieved through GetName
+    NS_LOG_LOGIC ("The router " << NocRouter::GetName () << " has the faulty state set to " << faulty);
+  }
+
+  bool
+  NocFaultyRouter::IsFaulty () const
+  {
+    return m_faulty || m_losing;
+  }
+
 } // namespace ns3
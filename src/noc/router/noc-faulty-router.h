@@ -38,6 +38,9 @@ namespace ns3
    * A NocRouter which can be faulty.
    * The faulty property is an ns-3 attribute.
    *
+   * By default, a faulty router stops the simulation when it is used. When the LoseFlits attribute is set,
+   * a faulty router keeps working, but the links of its net devices lose the flits which cross them (see NocChannel::TransmitEnd).
+   *
    * \see NocRouter
    */
   class NocFaultyRouter : public NocRouter
@@ -154,9 +157,9 @@ namespace ns3
      *                      routing information is added as tags or headers). The flit
      *                      will be returned to reply callback.
      *
-     * \return the route, if a valid route is already known, NULL otherwise
+     * \return the route (not valid if no route is known)
      */
-    virtual Ptr<Route>
+    virtual Route
     ManageFlit(const Ptr<NocNetDevice> source, const Ptr<NocNode> destination, Ptr<Packet> flit);
 
     /**
@@ -263,6 +266,21 @@ namespace ns3
     virtual std::string
     GetName () const;
 
+    /**
+     * Marks the router as faulty or as working. This is the same as setting the Faulty attribute,
+     * without looking up the attribute.
+     *
+     * \param faulty whether or not the router is faulty
+     */
+    void
+    SetFaulty (bool faulty);
+
+    /**
+     * \return whether or not the router is faulty
+     */
+    bool
+    IsFaulty () const;
+
   protected:
 
   private:
@@ -272,6 +290,16 @@ namespace ns3
      */
     bool m_faulty;
 
+    /**
+     * whether or not a fault makes the router lose flits, instead of stopping the simulation
+     */
+    bool m_loseFlits;
+
+    /**
+     * whether or not the router is faulty and loses flits
+     */
+    bool m_losing;
+
   };
 
 } // namespace ns3
@@ -0,0 +1,259 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-load-side-band.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/noc-simulation-context.h"
+#include "ns3/noc-node.h"
+#include "ns3/noc-net-device.h"
+#include "ns3/noc-channel.h"
+#include "ns3/noc-router.h"
+#include "ns3/load-router-component.h"
+
+NS_LOG_COMPONENT_DEFINE ("NocLoadSideBand");
+
+namespace ns3
+{
+
+  NS_OBJECT_ENSURE_REGISTERED (NocLoadSideBand);
+
+  TypeId
+  NocLoadSideBand::GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::NocLoadSideBand")
+        .SetParent<Object> ()
+        .AddConstructor<NocLoadSideBand> ();
+    return tid;
+  }
+
+  NocLoadSideBand::NocLoadSideBand ()
+    : m_context (0),
+      m_period (1),
+      m_latency (0),
+      m_numberOfNodes (0),
+      m_slots (1),
+      m_visibleSlot (0),
+      m_publishedSlot (0),
+      m_running (false),
+      m_publishedEpochs (0)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+  }
+
+  NocLoadSideBand::~NocLoadSideBand ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+  }
+
+  void
+  NocLoadSideBand::DoDispose ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    Simulator::Cancel (m_publishEvent);
+    m_running = false;
+    m_context = 0;
+    m_routers.clear ();
+    m_loadComponents.clear ();
+    Object::DoDispose ();
+  }
+
+  void
+  NocLoadSideBand::SetContext (NocSimulationContext *context)
+  {
+    m_context = context;
+  }
+
+  void
+  NocLoadSideBand::Install (NodeContainer nodes, uint32_t period, uint32_t latency)
+  {
+    NS_LOG_FUNCTION (period << latency);
+    NS_ASSERT_MSG (period >= 1, "The load side-band period must be at least one clock cycle");
+
+    m_period = period;
+    m_latency = latency;
+    // the visible snapshot and the snapshots in transit must not be overwritten
+    m_slots = 1 + (latency + period - 1) / period;
+
+    uint32_t maxNodeId = 0;
+    for (uint32_t i = 0; i < nodes.GetN (); ++i)
+      {
+        maxNodeId = std::max (maxNodeId, nodes.Get (i)->GetId ());
+      }
+    m_numberOfNodes = nodes.GetN () > 0 ? maxNodeId + 1 : 0;
+    m_routers.assign (m_numberOfNodes, 0);
+    m_loadComponents.assign (m_numberOfNodes, 0);
+    m_neighborOffsets.assign (m_numberOfNodes, 0);
+    m_neighbors.clear ();
+    for (uint32_t i = 0; i < nodes.GetN (); ++i)
+      {
+        Ptr<Node> node = nodes.Get (i);
+        uint32_t nodeId = node->GetId ();
+        Ptr<NocNode> nocNode = node->GetObject<NocNode> ();
+        Ptr<NocRouter> router = nocNode != 0 ? nocNode->GetRouter () : 0;
+        if (router != 0 && router->GetLoadRouterComponent () != 0)
+          {
+            m_routers[nodeId] = router;
+            m_loadComponents[nodeId] = router->GetLoadRouterComponent ();
+          }
+
+        m_neighborOffsets[nodeId] = m_neighbors.size ();
+        for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+          {
+            uint32_t neighbor = NO_NEIGHBOR;
+            Ptr<NetDevice> device = node->GetDevice (j);
+            Ptr<Channel> channel = device->GetChannel ();
+            if (channel != 0)
+              {
+                for (uint32_t k = 0; k < channel->GetNDevices (); ++k)
+                  {
+                    Ptr<NetDevice> otherDevice = channel->GetDevice (k);
+                    if (otherDevice != device)
+                      {
+                        neighbor = otherDevice->GetNode ()->GetId ();
+                      }
+                  }
+              }
+            m_neighbors.push_back (neighbor);
+          }
+      }
+
+    m_snapshots.assign (m_slots * m_numberOfNodes, 0);
+    m_visibleSlot = 0;
+    m_publishedSlot = 0;
+    m_publishedEpochs = 0;
+    Simulator::Cancel (m_publishEvent);
+    m_running = false;
+
+    NS_LOG_INFO ("The routers publish their load every " << m_period << " clock cycles, with a latency of "
+        << m_latency << " clock cycles (" << m_slots << " snapshot slots)");
+  }
+
+  int
+  NocLoadSideBand::GetNeighborLoad (Ptr<NocNetDevice> device) const
+  {
+    NS_ASSERT (device != 0);
+
+    int load = 0;
+    uint32_t nodeId = device->GetNode ()->GetId ();
+    if (nodeId < m_numberOfNodes)
+      {
+        uint32_t index = m_neighborOffsets[nodeId] + device->GetIfIndex ();
+        NS_ASSERT (index < m_neighbors.size ());
+        if (m_neighbors[index] != NO_NEIGHBOR)
+          {
+            load = GetLoad (m_neighbors[index]);
+          }
+      }
+    NS_LOG_LOGIC ("Net device " << device->GetAddress () << " leads to a router with the load " << load);
+
+    return load;
+  }
+
+  uint32_t
+  NocLoadSideBand::GetPeriod () const
+  {
+    return m_period;
+  }
+
+  uint32_t
+  NocLoadSideBand::GetLatency () const
+  {
+    return m_latency;
+  }
+
+  uint64_t
+  NocLoadSideBand::GetPublishedEpochs () const
+  {
+    return m_publishedEpochs;
+  }
+
+  void
+  NocLoadSideBand::Start ()
+  {
+    NS_ASSERT_MSG (m_context != 0 && m_context->GetGlobalClockPicoSeconds () > 0,
+        "The load side-band requires the global clock of the NoC to be set!");
+
+    int64_t epochLength = m_period * m_context->GetGlobalClockPicoSeconds ();
+    int64_t now = Simulator::Now ().GetPicoSeconds ();
+    uint64_t epoch = now / epochLength + 1;
+    NS_LOG_LOGIC ("Resuming the load side-band with epoch " << epoch);
+    m_running = true;
+    // Simulator::Schedule (...) receives a relative time
+    m_publishEvent = Simulator::Schedule (PicoSeconds (epoch * epochLength - now), &NocLoadSideBand::Publish,
+        this, epoch);
+  }
+
+  void
+  NocLoadSideBand::Publish (uint64_t epoch)
+  {
+    NS_LOG_FUNCTION (epoch);
+
+    m_publishedSlot = (m_publishedSlot + 1) % m_slots;
+    uint8_t *snapshot = &m_snapshots[m_publishedSlot * m_numberOfNodes];
+    bool loaded = false;
+    for (uint32_t i = 0; i < m_numberOfNodes; ++i)
+      {
+        if (m_loadComponents[i] != 0)
+          {
+            int load = m_loadComponents[i]->GetEpochLoad (m_routers[i]);
+            NS_ASSERT_MSG (load >= 0 && load <= 100, "The load of a router must be a percentage number ("
+                << load << " is not)");
+            snapshot[i] = load;
+            loaded = loaded || load != 0;
+          }
+      }
+    m_publishedEpochs++;
+
+    int64_t clock = m_context->GetGlobalClockPicoSeconds ();
+    if (m_latency == 0)
+      {
+        Deliver (m_publishedSlot);
+      }
+    else
+      {
+        Simulator::Schedule (PicoSeconds (m_latency * clock), &NocLoadSideBand::Deliver, this, m_publishedSlot);
+      }
+
+    if (loaded)
+      {
+        m_publishEvent = Simulator::Schedule (PicoSeconds (m_period * clock), &NocLoadSideBand::Publish,
+            this, epoch + 1);
+      }
+    else
+      {
+        // the NoC is idle, the next link traversal resumes the side-band
+        NS_LOG_LOGIC ("No router is loaded in epoch " << epoch << ", the load side-band stops");
+        m_running = false;
+      }
+  }
+
+  void
+  NocLoadSideBand::Deliver (uint32_t slot)
+  {
+    NS_LOG_LOGIC ("The load snapshot from slot " << slot << " is visible now");
+    m_visibleSlot = slot;
+  }
+
+} // namespace ns3
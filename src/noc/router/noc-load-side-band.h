@@ -0,0 +1,257 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCLOADSIDEBAND_H_
+#define NOCLOADSIDEBAND_H_
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/node-container.h"
+#include "ns3/event-id.h"
+#include <vector>
+
+namespace ns3
+{
+
+  class NocSimulationContext;
+
+  class NocNetDevice;
+
+  class NocRouter;
+
+  class LoadRouterComponent;
+
+  /**
+   * \brief Side-band network which periodically propagates the load of the routers to their neighbors
+   *
+   * \detail By default, the load of a router travels to its neighbors with the head flits
+   *         (see NocPacketTag::GetLoad): every link traversal updates the load counter of the receiving router
+   *         and the neighbor load it keeps for the sending router. With a load side-band, the neighbor load
+   *         is no longer exchanged through the flits. Instead, once every period (an epoch), each router publishes
+   *         its load (see LoadRouterComponent::GetEpochLoad) into a flat array, indexed by node ID. A published
+   *         snapshot becomes visible to the routing protocols only after the side-band latency, and it stays
+   *         visible until the snapshot of the next epoch arrives. Therefore, the routing protocols always
+   *         work with load information which is between latency and (period + latency) clock cycles old.
+   *
+   *         The epochs are simulated only while the NoC has traffic. After an epoch in which
+   *         no router is loaded, the side-band stops until the next link traversal (see NotifyActivity).
+   *
+   *         The side-band requires the global clock to be set.
+   */
+  class NocLoadSideBand : public Object
+  {
+  public:
+
+    static TypeId
+    GetTypeId ();
+
+    NocLoadSideBand ();
+
+    virtual
+    ~NocLoadSideBand ();
+
+    /**
+     * Sets the simulation context which owns this side-band. The context is not reference counted
+     * by the side-band (the context already holds a reference to its side-band).
+     *
+     * \param context the simulation context
+     */
+    void
+    SetContext (NocSimulationContext *context);
+
+    /**
+     * Connects the routers of the given nodes through the side-band. Only the routers with a load component
+     * publish their load. This is done by the NoC topology, at install time.
+     *
+     * \param nodes the NoC nodes
+     * \param period after how many clock cycles the routers publish their load again (at least one)
+     * \param latency after how many clock cycles a published load becomes visible to the neighbors
+     */
+    void
+    Install (NodeContainer nodes, uint32_t period, uint32_t latency);
+
+    /**
+     * Tells the side-band that a flit traversed a link. If the side-band stopped because the NoC was idle,
+     * the epochs are resumed (from the next epoch boundary).
+     */
+    void
+    NotifyActivity ()
+    {
+      if (!m_running)
+        {
+          Start ();
+        }
+    }
+
+    /**
+     * Retrieves the visible load snapshot of the router which is connected to this router through a net device.
+     *
+     * \param device a net device of a router
+     *
+     * \return the load published by the neighbor router, or zero if the net device has no neighbor
+     */
+    int
+    GetNeighborLoad (Ptr<NocNetDevice> device) const;
+
+    /**
+     * \param nodeId the ID of a NoC node
+     *
+     * \return the visible load snapshot of the node's router
+     */
+    int
+    GetLoad (uint32_t nodeId) const
+    {
+      return nodeId < m_numberOfNodes ? m_snapshots[m_visibleSlot * m_numberOfNodes + nodeId] : 0;
+    }
+
+    /**
+     * \return how many clock cycles an epoch has
+     */
+    uint32_t
+    GetPeriod () const;
+
+    /**
+     * \return after how many clock cycles a published load becomes visible
+     */
+    uint32_t
+    GetLatency () const;
+
+    /**
+     * \return how many epochs were published so far
+     */
+    uint64_t
+    GetPublishedEpochs () const;
+
+  protected:
+
+    virtual void
+    DoDispose ();
+
+  private:
+
+    /**
+     * Schedules the publication of the next epoch.
+     */
+    void
+    Start ();
+
+    /**
+     * All the routers publish their load, in the next snapshot slot.
+     *
+     * \param epoch the epoch number (the epoch starts at clock cycle epoch * period)
+     */
+    void
+    Publish (uint64_t epoch);
+
+    /**
+     * Makes a published snapshot visible.
+     *
+     * \param slot the snapshot slot
+     */
+    void
+    Deliver (uint32_t slot);
+
+    /**
+     * the simulation context owning this side-band
+     */
+    NocSimulationContext *m_context;
+
+    /**
+     * the epoch length, in clock cycles
+     */
+    uint32_t m_period;
+
+    /**
+     * the side-band latency, in clock cycles
+     */
+    uint32_t m_latency;
+
+    /**
+     * the size of the node ID space (the highest node ID + 1)
+     */
+    uint32_t m_numberOfNodes;
+
+    /**
+     * the routers which publish their load, by node ID (null when a node has no load component)
+     */
+    std::vector<Ptr<NocRouter> > m_routers;
+
+    /**
+     * the load components of m_routers
+     */
+    std::vector<Ptr<LoadRouterComponent> > m_loadComponents;
+
+    /**
+     * where the neighbors of a node start in m_neighbors, by node ID
+     */
+    std::vector<uint32_t> m_neighborOffsets;
+
+    /**
+     * the node ID of the neighbor connected through every net device, indexed by
+     * m_neighborOffsets[node ID] + interface index (NO_NEIGHBOR for the unconnected net devices)
+     */
+    std::vector<uint32_t> m_neighbors;
+
+    static const uint32_t NO_NEIGHBOR = 0xffffffff;
+
+    /**
+     * the load snapshots: m_numberOfNodes loads for each of the slots, which are used circularly
+     * (more than one snapshot may be in transit when the latency is larger than the period)
+     */
+    std::vector<uint8_t> m_snapshots;
+
+    /**
+     * how many snapshot slots are used
+     */
+    uint32_t m_slots;
+
+    /**
+     * the snapshot slot which is currently visible
+     */
+    uint32_t m_visibleSlot;
+
+    /**
+     * the snapshot slot where the last epoch was published (the slots are used in round-robin order)
+     */
+    uint32_t m_publishedSlot;
+
+    /**
+     * whether or not the publication of an epoch is scheduled
+     */
+    bool m_running;
+
+    /**
+     * the publication of the next epoch
+     */
+    EventId m_publishEvent;
+
+    /**
+     * how many epochs were published
+     */
+    uint64_t m_publishedEpochs;
+
+  };
+
+} // namespace ns3
+
+#endif /* NOCLOADSIDEBAND_H_ */
@@ -23,6 +23,11 @@
 #include "ns3/noc-node.h"
 #include "ns3/integer.h"
 #include "ns3/noc-registry.h"
+#include "ns3/noc-packet-tag.h"
+#include "ns3/noc-cycle-engine.h"
+#include "ns3/noc-deadlock-detector.h"
+#include "ns3/noc-profiler.h"
+#include "ns3/simulator.h"
 
 NS_LOG_COMPONENT_DEFINE ("NocRouter");
 
@@ -37,7 +42,13 @@ namespace ns3
     m_powerCounter = 0;
     m_lastClock = 0;
     m_arrivedFlits = 0;
+    m_dynamicPower = 0;
+    m_leakagePower = 0;
+    m_powerTableFlitSize = 0;
+    m_powerTableFrequency = 0;
     m_loadComponent = 0;
+    m_numberOfVirtualChannels = 0;
+    m_switchAllocationScheduled = false;
     NS_LOG_DEBUG ("No load router component is used");
   }
 
@@ -49,7 +60,13 @@ namespace ns3
     m_powerCounter = 0;
     m_lastClock = 0;
     m_arrivedFlits = 0;
+    m_dynamicPower = 0;
+    m_leakagePower = 0;
+    m_powerTableFlitSize = 0;
+    m_powerTableFrequency = 0;
     m_loadComponent = loadComponent;
+    m_numberOfVirtualChannels = 0;
+    m_switchAllocationScheduled = false;
     NS_LOG_DEBUG ("Using the load router component " << loadComponent->GetName ());
   }
 
@@ -65,18 +82,23 @@ namespace ns3
   {
     m_nocNode = 0;
     m_routingProtocol = 0;
+    m_context = 0;
+    m_inputPorts.clear ();
+    m_virtualChannelAllocator = 0;
+    m_switchAllocator = 0;
   }
 
-  Ptr<Route>
+  Route
   NocRouter::ManageFlit (const Ptr<NocNetDevice> source, const Ptr<NocNode> destination, Ptr<Packet> flit)
   {
     NS_LOG_FUNCTION_NOARGS();
+    NOC_PROFILE (ROUTER_MANAGE_FLIT, GetInstanceTypeId ());
     NS_ASSERT (source != 0);
     NS_ASSERT (destination != 0);
 
     uint32_t sourceNodeId = source->GetNode ()->GetId ();
     uint32_t destinationNodeId = destination->GetId ();
-    Ptr<Route> route = 0;
+    Route route;
     if (sourceNodeId == destinationNodeId)
       {
         NS_LOG_WARN ("Trying to route a packet from node " << sourceNodeId
@@ -85,22 +107,15 @@ namespace ns3
     else
       {
         m_powerCounter++;
-        TimeValue timeValue;
-        NocRegistry::GetInstance ()->GetAttribute ("GlobalClock", timeValue);
-        Time globalClock = timeValue.Get ();
-        uint64_t clockNumber = Simulator::Now ().GetPicoSeconds () / globalClock.GetPicoSeconds () + 1;
+        NS_ASSERT_MSG (m_context != 0, "The router has no simulation context (was the topology installed?)");
+        uint64_t clockNumber = m_context->GetClockNumber (Simulator::Now ());
         NS_LOG_DEBUG ("clock number " << clockNumber);
         NS_LOG_DEBUG ("last clock " << m_lastClock);
         NS_LOG_DEBUG ("This router belongs to NoC node " << GetNocNode ()->GetId ());
         if (clockNumber > m_lastClock)
           {
-            // the following loop measures the power consumed by the flits from the previous clock cycle (m_lastClock)
-            for (unsigned int i = 0; i < m_flitsFromLastClock.size (); ++i)
-              {
-                MeasurePowerAndEnergy (m_flitsFromLastClock[i]);
-              }
-
-            m_flitsFromLastClock.clear ();
+            // the flits from the previous clock cycle (m_lastClock) are accounted for, by their number
+            RecordArrivedFlits ();
             m_arrivedFlits = 1;
             NS_LOG_DEBUG ("# arrived flits reset to " << m_arrivedFlits);
             m_lastClock = clockNumber;
@@ -110,13 +125,26 @@ namespace ns3
             m_arrivedFlits++;
             NS_LOG_DEBUG ("# arrived flits set to " << m_arrivedFlits);
           }
-        m_flitsFromLastClock.insert (m_flitsFromLastClock.end (), flit);
 
-        route = GetRoutingProtocol()->RequestRoute (source, destination, flit);
+        Ptr<NocRoutingProtocol> routingProtocol = GetRoutingProtocol ();
+        NOC_PROFILE (ROUTING, routingProtocol->GetInstanceTypeId ());
+        route = routingProtocol->RequestRoute (source, destination, flit);
       }
     return route;
   }
 
+  void
+  NocRouter::SetContext (Ptr<NocSimulationContext> context)
+  {
+    m_context = context;
+  }
+
+  Ptr<NocSimulationContext>
+  NocRouter::GetContext () const
+  {
+    return m_context;
+  }
+
   Ptr<LoadRouterComponent>
   NocRouter::GetLoadRouterComponent () const
   {
@@ -261,6 +289,12 @@ namespace ns3
     m_nocNode = nocNode;
   }
 
+  bool
+  NocRouter::HasFixedOutputNetDevices () const
+  {
+    return false;
+  }
+
   Ptr<NocNode>
   NocRouter::GetNocNode() const
   {
@@ -273,6 +307,248 @@ namespace ns3
    return m_name;
   }
 
+  void
+  NocRouter::EnableVirtualChannels (uint32_t virtualChannels, ObjectFactory queueFactory, ObjectFactory arbiterFactory)
+  {
+    NS_LOG_FUNCTION (virtualChannels);
+    NS_ASSERT_MSG (virtualChannels > 0, "A router must have at least one virtual channel");
+
+    m_numberOfVirtualChannels = virtualChannels;
+    m_inputPorts = m_devices;
+    for (uint32_t i = 0; i < m_devices.size (); i++)
+      {
+        m_devices[i]->EnableVirtualChannels (virtualChannels, queueFactory);
+      }
+    vector<Ptr<NocNetDevice> > injectionDevices = GetInjectionNetDevices ();
+    for (uint32_t i = 0; i < injectionDevices.size (); i++)
+      {
+        // the messages are injected one after the other
+        injectionDevices[i]->EnableVirtualChannels (1, queueFactory);
+        m_inputPorts.push_back (injectionDevices[i]);
+      }
+
+    m_virtualChannelAllocator = CreateObject<NocVirtualChannelAllocator> ();
+    m_virtualChannelAllocator->Initialize (m_inputPorts.size (), m_devices.size (), virtualChannels, arbiterFactory);
+    m_switchAllocator = CreateObject<NocSwitchAllocator> ();
+    m_switchAllocator->Initialize (m_inputPorts.size (), m_devices.size (), virtualChannels, arbiterFactory);
+  }
+
+  const vector<Ptr<NocNetDevice> > &
+  NocRouter::GetVirtualChannelInputPorts () const
+  {
+    return m_inputPorts;
+  }
+
+  void
+  NocRouter::ScheduleSwitchAllocation ()
+  {
+    if (m_switchAllocationScheduled)
+      {
+        return;
+      }
+    NS_ASSERT_MSG (m_context != 0, "The router has no simulation context (was the topology installed?)");
+    int64_t clock = m_context->GetGlobalClockPicoSeconds ();
+    NS_ASSERT_MSG (clock > 0, "Virtual channels require a global clock!");
+
+    m_switchAllocationScheduled = true;
+    NocCycleEngine *engine = m_context->GetCycleEngine ();
+    if (engine != 0)
+      {
+        engine->ScheduleSwitchAllocation (this);
+      }
+    else
+      {
+        // the switch is allocated at the next clock edge
+        int64_t now = Simulator::Now ().GetPicoSeconds ();
+        Simulator::Schedule (PicoSeconds ((now / clock + 1) * clock - now), &NocRouter::AllocateSwitch, this);
+      }
+  }
+
+  uint32_t
+  NocRouter::GetOutputPort (Ptr<NocNetDevice> device) const
+  {
+    for (uint32_t i = 0; i < m_devices.size (); i++)
+      {
+        if (m_devices[i] == device)
+          {
+            return i;
+          }
+      }
+    NS_ASSERT_MSG (false, "The net device " << device->GetAddress () << " does not belong to the router of node "
+        << GetNocNode ()->GetId ());
+    return 0;
+  }
+
+  void
+  NocRouter::AllocateSwitch ()
+  {
+    NS_LOG_FUNCTION (GetNocNode ()->GetId ());
+    NS_ASSERT_MSG (m_switchAllocator != 0, "Virtual channels are not enabled for this router");
+
+    m_switchAllocationScheduled = false;
+
+    // virtual channel allocation, for the messages which wait for a virtual channel in the next router
+    m_virtualChannelRequests.clear ();
+    for (uint32_t port = 0; port < m_inputPorts.size (); port++)
+      {
+        Ptr<NocNetDevice> device = m_inputPorts[port];
+        for (uint32_t vc = 0; vc < device->GetNumberOfVirtualChannels (); vc++)
+          {
+            Ptr<const Packet> flit = device->PeekVirtualChannel (vc);
+            if (flit == 0 || device->GetOutputVirtualChannel (vc) >= 0 || device->IsEjectedAtNextNetDevice (vc))
+              {
+                continue;
+              }
+            NocPacketTag tag;
+            flit->PeekPacketTag (tag);
+            NS_ASSERT_MSG (NocPacket::HEAD == tag.GetPacketType (), "The data flit with UID " << flit->GetUid ()
+                << " has no virtual channel allocated in the next router");
+            Ptr<NocNetDevice> output = device->GetOutputNetDevice (vc);
+            Ptr<NocNetDevice> next = device->GetNextNetDevice (vc);
+            uint32_t nextVirtualChannels = next->GetNumberOfVirtualChannels ();
+            uint32_t candidates = 0;
+            for (uint32_t i = 0; i < nextVirtualChannels; i++)
+              {
+                if (!next->IsVirtualChannelReserved (i)
+                    && m_routingProtocol->IsVirtualChannelAllowed (output, flit, i, nextVirtualChannels))
+                  {
+                    candidates |= (1u << i);
+                  }
+              }
+            if (candidates != 0)
+              {
+                NocVirtualChannelAllocator::Request request;
+                request.m_inputPort = port;
+                request.m_inputVirtualChannel = vc;
+                request.m_outputPort = GetOutputPort (output);
+                request.m_candidates = candidates;
+                request.m_requestTime = tag.GetInjectionTime ();
+                m_virtualChannelRequests.push_back (request);
+              }
+          }
+      }
+    if (!m_virtualChannelRequests.empty ())
+      {
+        m_virtualChannelAllocator->Allocate (m_virtualChannelRequests, m_virtualChannelGrants);
+        for (uint32_t i = 0; i < m_virtualChannelRequests.size (); i++)
+          {
+            if (m_virtualChannelGrants[i] >= 0)
+              {
+                const NocVirtualChannelAllocator::Request &request = m_virtualChannelRequests[i];
+                Ptr<NocNetDevice> device = m_inputPorts[request.m_inputPort];
+                device->GetNextNetDevice (request.m_inputVirtualChannel)->ReserveVirtualChannel (
+                    m_virtualChannelGrants[i], device->PeekVirtualChannel (request.m_inputVirtualChannel)->GetUid ());
+                device->SetOutputVirtualChannel (request.m_inputVirtualChannel, m_virtualChannelGrants[i]);
+              }
+          }
+      }
+
+    // switch allocation, for the flits which can leave the router during this clock cycle
+    bool buffered = false;
+    m_switchRequests.clear ();
+    NocDeadlockDetector *detector = m_context->GetDeadlockDetector ();
+    uint32_t firstVertex = detector != 0 ? detector->GetFirstVertex (GetNocNode ()->GetId ()) : 0;
+    for (uint32_t port = 0; port < m_inputPorts.size (); port++)
+      {
+        Ptr<NocNetDevice> device = m_inputPorts[port];
+        for (uint32_t vc = 0; vc < device->GetNumberOfVirtualChannels (); vc++)
+          {
+            Ptr<const Packet> flit = device->PeekVirtualChannel (vc);
+            if (flit == 0)
+              {
+                continue;
+              }
+            buffered = true;
+            bool ready = device->IsReadyToSend (vc);
+            if (detector != 0)
+              {
+                uint32_t vertex = firstVertex + port * m_numberOfVirtualChannels + vc;
+                if (ready)
+                  {
+                    detector->NotifyNotWaiting (vertex);
+                  }
+                else
+                  {
+                    UpdateDeadlockDetector (detector, vertex, device, vc, flit);
+                  }
+              }
+            if (ready)
+              {
+                NocPacketTag tag;
+                flit->PeekPacketTag (tag);
+                NocSwitchAllocator::Request request;
+                request.m_inputPort = port;
+                request.m_inputVirtualChannel = vc;
+                request.m_outputPort = GetOutputPort (device->GetOutputNetDevice (vc));
+                request.m_requestTime = tag.GetInjectionTime ();
+                m_switchRequests.push_back (request);
+              }
+          }
+      }
+    if (!m_switchRequests.empty ())
+      {
+        m_switchAllocator->Allocate (m_switchRequests, m_switchGrants);
+        for (uint32_t i = 0; i < m_switchRequests.size (); i++)
+          {
+            if (m_switchGrants[i])
+              {
+                const NocSwitchAllocator::Request &request = m_switchRequests[i];
+                m_inputPorts[request.m_inputPort]->SendFromVirtualChannel (request.m_inputVirtualChannel);
+              }
+          }
+      }
+
+    if (buffered)
+      {
+        ScheduleSwitchAllocation ();
+      }
+  }
+
+  void
+  NocRouter::UpdateDeadlockDetector (NocDeadlockDetector *detector, uint32_t vertex, Ptr<NocNetDevice> device,
+      uint32_t vc, Ptr<const Packet> flit)
+  {
+    if (device->IsEjectedAtNextNetDevice (vc))
+      {
+        // the flit only waits for the channel
+        detector->NotifyNotWaiting (vertex);
+        return;
+      }
+    Ptr<NocNetDevice> output = device->GetOutputNetDevice (vc);
+    Ptr<NocNetDevice> next = device->GetNextNetDevice (vc);
+    int outputVc = device->GetOutputVirtualChannel (vc);
+    if (outputVc >= 0)
+      {
+        if (output->HasCredit (outputVc))
+          {
+            detector->NotifyNotWaiting (vertex);
+          }
+        else
+          {
+            // the virtual channel of the next router is full
+            detector->NotifyWaiting (vertex, PeekPointer (next), 1u << outputVc);
+          }
+        return;
+      }
+
+    // the head flit waits only if all the virtual channels which it may use are reserved
+    uint32_t nextVirtualChannels = next->GetNumberOfVirtualChannels ();
+    uint32_t reserved = 0;
+    for (uint32_t i = 0; i < nextVirtualChannels; i++)
+      {
+        if (m_routingProtocol->IsVirtualChannelAllowed (output, flit, i, nextVirtualChannels))
+          {
+            if (!next->IsVirtualChannelReserved (i))
+              {
+                detector->NotifyNotWaiting (vertex);
+                return;
+              }
+            reserved |= (1u << i);
+          }
+      }
+    detector->NotifyWaiting (vertex, PeekPointer (next), reserved);
+  }
+
   int
   NocRouter::RouterInitForOrion (SIM_router_info_t *info, SIM_router_power_t *router_power, SIM_router_area_t *router_area)
   {
@@ -291,9 +567,7 @@ namespace ns3
     info->n_mc_out = PARM(mc_out_port);
     info->n_io_out = PARM(io_out_port);
     info->n_total_out = GetNumberOfOutputPorts () + PARM(cache_out_port) + PARM(mc_out_port) + PARM(io_out_port);
-    IntegerValue flitSize;
-    NocRegistry::GetInstance ()->GetAttribute ("FlitSize", flitSize);
-    info->flit_width = flitSize.Get ();
+    info->flit_width = m_context->GetFlitSize ();
 
     /* virtual channel parameters */
     info->n_v_channel = MAX(GetNumberOfVirtualChannels (), 1);
@@ -343,7 +617,7 @@ namespace ns3
               }
             NS_LOG_DEBUG ("The input buffers of this router have a total size of " << sizeOfInputBuffers << " flits");
 
-            SIM_array_init(&info->in_buf_info, 1, PARM(in_buf_rport), 1, sizeOfInputBuffers, flitSize.Get (), outdrv, info->in_buffer_model);
+            SIM_array_init(&info->in_buf_info, 1, PARM(in_buf_rport), 1, sizeOfInputBuffers, info->flit_width, outdrv, info->in_buffer_model);
     }
 
     if (PARM(cache_in_port)){
@@ -357,7 +631,7 @@ namespace ns3
                     else{
                     outdrv = share_buf = 0;
                     }
-            SIM_array_init(&info->cache_in_buf_info, 1, PARM(cache_in_buf_rport), 1, PARM(cache_in_buf_set), flitSize.Get (), outdrv, SRAM);
+            SIM_array_init(&info->cache_in_buf_info, 1, PARM(cache_in_buf_rport), 1, PARM(cache_in_buf_set), info->flit_width, outdrv, SRAM);
             }
     }
 
@@ -372,7 +646,7 @@ namespace ns3
                     else{
                     outdrv = share_buf = 0;
                     }
-            SIM_array_init(&info->mc_in_buf_info, 1, PARM(mc_in_buf_rport), 1, PARM(mc_in_buf_set), flitSize.Get (), outdrv, SRAM);
+            SIM_array_init(&info->mc_in_buf_info, 1, PARM(mc_in_buf_rport), 1, PARM(mc_in_buf_set), info->flit_width, outdrv, SRAM);
             }
     }
 
@@ -387,7 +661,7 @@ namespace ns3
                     else{
                     outdrv = share_buf = 0;
                     }
-            SIM_array_init(&info->io_in_buf_info, 1, PARM(io_in_buf_rport), 1, PARM(io_in_buf_set), flitSize.Get (), outdrv, SRAM);
+            SIM_array_init(&info->io_in_buf_info, 1, PARM(io_in_buf_rport), 1, PARM(io_in_buf_set), info->flit_width, outdrv, SRAM);
             }
     }
 
@@ -403,7 +677,7 @@ namespace ns3
             NS_LOG_DEBUG ("The output buffers of this router have a total size of " << sizeOfOutputBuffers << " flits");
 
             /* output buffer has no tri-state buffer anyway */
-            SIM_array_init(&info->out_buf_info, 1, 1, PARM(out_buf_wport), sizeOfOutputBuffers, flitSize.Get (), 0, info->out_buffer_model);
+            SIM_array_init(&info->out_buf_info, 1, 1, PARM(out_buf_wport), sizeOfOutputBuffers, info->flit_width, 0, info->out_buffer_model);
     }
 
     /* central buffer */
@@ -411,7 +685,7 @@ namespace ns3
     if (info->central_buf){
             info->pipe_depth = PARM(pipe_depth);
             /* central buffer is no FIFO */
-            SIM_array_init(&info->central_buf_info, 0, PARM(cbuf_rport), PARM(cbuf_wport), PARM(cbuf_set), PARM(cbuf_width) * flitSize.Get (), 0, SRAM);
+            SIM_array_init(&info->central_buf_info, 0, PARM(cbuf_rport), PARM(cbuf_wport), PARM(cbuf_set), PARM(cbuf_width) * info->flit_width, 0, SRAM);
             /* dirty hack */
             info->cbuf_ff_model = NEG_DFF;
     }
@@ -604,7 +878,7 @@ info->router_diagonal = PARM(router_diagonal);
   }
 
   double
-  NocRouter::ComputeRouterEnergyAndPowerWithOrion (SIM_router_info_t *info, SIM_router_power_t *router, int print_depth, char *path, int max_avg, double e_fin, int plot_flag, double freq)
+  NocRouter::ComputeRouterEnergyAndPowerWithOrion (SIM_router_info_t *info, SIM_router_power_t *router, int print_depth, char *path, int max_avg, double e_fin, int plot_flag, double freq, double *e_static)
   {
           double Eavg = 0, Eatomic, Estruct, Estatic = 0;
           double Pbuf = 0, Pxbar = 0, Pvc_arbiter = 0, Psw_arbiter = 0, Pclock = 0, Ptotal = 0;
@@ -814,10 +1088,7 @@ info->router_diagonal = PARM(router_diagonal);
           /* static power */
   //      Estatic = router->I_static * Vdd * Period * SCALE_S;
 
-          TimeValue timeValue;
-          NocRegistry::GetInstance ()->GetAttribute ("GlobalClock", timeValue);
-          Time globalClock = timeValue.Get ();
-          double period = globalClock.GetSeconds ();
+          double period = m_context->GetGlobalClock ().GetSeconds ();
           Estatic = router->I_static * Vdd * period * SCALE_S;
 
           SIM_print_stat_energy(SIM_strcat(path, "static energy"), Estatic, next_depth);
@@ -827,8 +1098,10 @@ info->router_diagonal = PARM(router_diagonal);
 
           SIM_print_stat_energy(path, Eavg, print_depth);
 
-          m_leakagePower += Estatic * freq;
-          m_dynamicPower += (Eavg - Estatic) * freq;
+          if (e_static != 0)
+            {
+              *e_static = Estatic;
+            }
 
           if (plot_flag)
             {
@@ -838,60 +1111,90 @@ info->router_diagonal = PARM(router_diagonal);
               NS_LOG_DEBUG ("SW_allocator dynamic power: " << Psw_arbiter);
               NS_LOG_DEBUG ("Clock dynamic power: " << Pclock);
 
-              NS_LOG_LOGIC ("Router static power (consumed so far): " << m_leakagePower);
-              NS_LOG_LOGIC ("Router dynamic power (consumed so far): " << m_dynamicPower);
-              NS_LOG_LOGIC ("Total router power (static + dynamic, consumed so far): " << Ptotal);
+              NS_LOG_LOGIC ("Router static power: " << Estatic * freq);
+              NS_LOG_LOGIC ("Router dynamic power: " << (Eavg - Estatic) * freq);
+              NS_LOG_LOGIC ("Total router power (static + dynamic): " << Ptotal);
             }
 
           return Eavg;
   }
 
   void
-  NocRouter::MeasurePowerAndEnergy (Ptr<Packet> flit)
+  NocRouter::BuildPowerTable ()
   {
-    NS_LOG_FUNCTION (*flit);
-
-    TimeValue timeValue;
-    NocRegistry::GetInstance ()->GetAttribute ("GlobalClock", timeValue);
-    Time globalClock = timeValue.Get ();
+    NS_LOG_FUNCTION_NOARGS ();
 
-    double freq = 1 / globalClock.GetSeconds ();
+    double freq = m_context->GetFrequency ();
     NS_LOG_DEBUG ("NoC clock frequency is " << freq << " Hz");
-    double dataWidth = flit->GetSize () * 8; // in bits
-    NS_LOG_DEBUG ("Arrived flit has size " << dataWidth);
-    NS_LOG_DEBUG ("arrived flits " << m_arrivedFlits);
-    NS_LOG_DEBUG ("# input ports " << GetNumberOfInputPorts ());
-    double load = m_arrivedFlits * 1.0 / GetNumberOfInputPorts ();
-    NS_LOG_DEBUG ("Router load is " << load);
-    NS_ASSERT_MSG (load >= 0 && load <= 1, "Router load in [0,1] interval");
+    uint32_t nInputs = GetNumberOfInputPorts ();
+    NS_LOG_DEBUG ("# input ports " << nInputs);
     char routerName[] = "NoC router";
 
+    // the router's configuration (ports, buffers, flit width) is fixed, so ORION is initialized only once
     //SIM_router_init(&GLOB(router_info), &GLOB(router_power), NULL);
     RouterInitForOrion(&GLOB(router_info), &GLOB(router_power), NULL);
-    //SIM_router_stat_energy(&GLOB(router_info), &GLOB(router_power), print_depth, name, max_flag, load, plot_flag, PARM(Freq));
-    ComputeRouterEnergyAndPowerWithOrion (&GLOB(router_info), &GLOB(router_power), 0, routerName, 0, load, 1, freq);
 
+    // the router load can only take the values k / nInputs, k = 0..nInputs
+    m_dynamicPowerPerFlit.assign (nInputs + 1, 0);
+    m_leakagePowerPerFlit.assign (nInputs + 1, 0);
+    for (uint32_t k = 0; k <= nInputs; ++k)
+      {
+        double load = k * 1.0 / nInputs;
+        double Estatic = 0;
+        //SIM_router_stat_energy(&GLOB(router_info), &GLOB(router_power), print_depth, name, max_flag, load, plot_flag, PARM(Freq));
+        double Eavg = ComputeRouterEnergyAndPowerWithOrion (&GLOB(router_info), &GLOB(router_power), 0,
+            routerName, 0, load, 1, freq, &Estatic);
+        m_leakagePowerPerFlit[k] = Estatic * freq;
+        m_dynamicPowerPerFlit[k] = (Eavg - Estatic) * freq;
+        NS_LOG_DEBUG ("Router load " << load << ": dynamic power " << m_dynamicPowerPerFlit[k]
+            << ", leakage power " << m_leakagePowerPerFlit[k]);
+      }
+
+    m_powerTableFlitSize = m_context->GetFlitSize ();
+    m_powerTableFrequency = freq;
   }
 
   void
-  NocRouter::MeasurePowerAndEnergyForLastClock ()
+  NocRouter::RecordArrivedFlits ()
   {
-    NS_LOG_FUNCTION_NOARGS ();
-
-    TimeValue timeValue;
-    NocRegistry::GetInstance ()->GetAttribute ("GlobalClock", timeValue);
-    Time globalClock = timeValue.Get ();
-    uint64_t clockNumber = Simulator::Now ().GetPicoSeconds () / globalClock.GetPicoSeconds () + 1;
-    // the following loop measures the power consumed by the flits from the previous clock cycle (m_lastClock)
-    for (unsigned int i = 0; i < m_flitsFromLastClock.size (); ++i)
+    if (m_arrivedFlits > 0)
       {
-        MeasurePowerAndEnergy (m_flitsFromLastClock[i]);
+        if (m_flitsPerArrivalCount.size () <= m_arrivedFlits)
+          {
+            m_flitsPerArrivalCount.resize (m_arrivedFlits + 1, 0);
+          }
+        m_flitsPerArrivalCount[m_arrivedFlits] += m_arrivedFlits;
       }
+  }
 
-    m_flitsFromLastClock.clear ();
+  void
+  NocRouter::MeasurePowerAndEnergyForLastClock ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+    NOC_PROFILE (POWER_MEASUREMENT, GetInstanceTypeId ());
+
+    NS_ASSERT_MSG (m_context != 0, "The router has no simulation context (was the topology installed?)");
+    uint64_t clockNumber = m_context->GetClockNumber (Simulator::Now ());
+    RecordArrivedFlits ();
     m_arrivedFlits = 0;
     NS_LOG_DEBUG ("# arrived flits reset to " << m_arrivedFlits);
     m_lastClock = clockNumber;
+
+    if (m_dynamicPowerPerFlit.empty () || m_powerTableFlitSize != m_context->GetFlitSize ()
+        || m_powerTableFrequency != m_context->GetFrequency ())
+      {
+        BuildPowerTable ();
+      }
+    NS_ASSERT_MSG (m_flitsPerArrivalCount.size () <= m_dynamicPowerPerFlit.size (),
+        "Router load in [0,1] interval");
+
+    m_dynamicPower = 0;
+    m_leakagePower = 0;
+    for (uint32_t k = 1; k < m_flitsPerArrivalCount.size (); ++k)
+      {
+        m_dynamicPower += m_flitsPerArrivalCount[k] * m_dynamicPowerPerFlit[k];
+        m_leakagePower += m_flitsPerArrivalCount[k] * m_leakagePowerPerFlit[k];
+      }
   }
 
   double
@@ -30,6 +30,10 @@
 #include "ns3/noc-switching-protocol.h"
 #include "ns3/load-router-component.h"
 #include "ns3/route.h"
+#include "ns3/noc-simulation-context.h"
+#include "ns3/noc-virtual-channel-allocator.h"
+#include "ns3/noc-switch-allocator.h"
+#include "ns3/object-factory.h"
 #include <vector>
 #include "src/noc/orion/SIM_router.h"
 #include "src/noc/orion/SIM_router_power.h"
@@ -47,6 +51,7 @@ namespace ns3
   class NocRoutingProtocol;
   class NocSwitchingProtocol;
   class LoadRouterComponent;
+  class NocDeadlockDetector;
 
   /**
    *
@@ -171,9 +176,9 @@ namespace ns3
      *                      routing information is added as tags or headers). The flit
      *                      will be returned to reply callback.
      *
-     * \return the route, if a valid route is already known, NULL otherwise
+     * \return the route (not valid if no route is known)
      */
-    virtual Ptr<Route>
+    virtual Route
     ManageFlit (const Ptr<NocNetDevice> source, const Ptr<NocNode> destination, Ptr<Packet> flit);
 
     /**
@@ -235,6 +240,16 @@ namespace ns3
     virtual vector<Ptr<NocNetDevice> >
     GetOutputNetDevices (Ptr<Packet> packet, Ptr<NocNetDevice> sender) = 0;
 
+    /**
+     * Routing tables (see NocRoutingTable) can be used only by routers which forward all the packets
+     * going in a routing direction and dimension through the same net device, no matter through which
+     * net device the packets came.
+     *
+     * \return true if the output net device depends only on the routing direction and dimension (false by default)
+     */
+    virtual bool
+    HasFixedOutputNetDevices () const;
+
     /**
      * Associate this device to this router.
      *
@@ -277,12 +292,63 @@ namespace ns3
     virtual Ptr<NocNode>
     GetNocNode () const;
 
+    /**
+     * Sets the simulation context (this is done by the NoC topology, at install time)
+     *
+     * \param context the simulation context
+     */
+    void
+    SetContext (Ptr<NocSimulationContext> context);
+
+    /**
+     * \return the simulation context
+     */
+    Ptr<NocSimulationContext>
+    GetContext () const;
+
     /**
      * \return the name of this routing protocol
      */
     virtual string
     GetName () const;
 
+    /**
+     * Gives every input port of this router (including the injection net devices) its own virtual channels.
+     * The router then allocates, once per clock cycle, the virtual channels of the next routers to the waiting
+     * messages (NocVirtualChannelAllocator) and its crossbar to the waiting flits (NocSwitchAllocator).
+     * The routing protocol may restrict the virtual channels used by a message
+     * (see NocRoutingProtocol::IsVirtualChannelAllowed). A global clock is required.
+     *
+     * This must be done after all the net devices were added to the router.
+     *
+     * \param virtualChannels how many virtual channels each input port has (the injection net devices have a single one)
+     * \param queueFactory the factory used for creating the queues of the virtual channels
+     * \param arbiterFactory the factory used for creating the arbiters of the allocators
+     */
+    void
+    EnableVirtualChannels (uint32_t virtualChannels, ObjectFactory queueFactory, ObjectFactory arbiterFactory);
+
+    /**
+     * \return the input ports of this router, in virtual channel mode: the net devices of this router,
+     *         followed by the injection net devices (empty if the virtual channels are not enabled)
+     */
+    const vector<Ptr<NocNetDevice> > &
+    GetVirtualChannelInputPorts () const;
+
+    /**
+     * Makes sure that the virtual channels and the switch are allocated at the next clock cycle
+     * (virtual channel mode only).
+     */
+    void
+    ScheduleSwitchAllocation ();
+
+    /**
+     * Allocates the virtual channels and the switch, and sends the flits which won the switch.
+     * This is done once per clock cycle, as long as flits are buffered by the router (virtual channel mode only).
+     */
+    void
+    AllocateSwitch ();
+
   private:
 
     /**
@@ -315,25 +381,35 @@ namespace ns3
      *              assume e_arb = 1
      *
      * NOTES: (1) negative print_depth means infinite print depth
+     *        (2) unlike ORION, the static energy is returned through e_static (if not NULL)
+     *            and nothing is accumulated into the router's power
      *
      */
     virtual double
-    ComputeRouterEnergyAndPowerWithOrion (SIM_router_info_t *info, SIM_router_power_t *router, int print_depth, char *path, int max_avg, double e_fin, int plot_flag, double freq);
+    ComputeRouterEnergyAndPowerWithOrion (SIM_router_info_t *info, SIM_router_power_t *router, int print_depth, char *path, int max_avg, double e_fin, int plot_flag, double freq, double *e_static);
 
     /**
-     * Uses ORION to measure this router's power and energy, consumed for sending the specified flit.
-     *
-     * \param flit the flit
+     * Uses ORION to build this router's power table: the dynamic and the leakage power
+     * consumed by one flit, for every possible router load (k flits arrived
+     * during a clock cycle, k = 0..GetNumberOfInputPorts ()).
      *
+     * ORION is initialized only once per table, since the router configuration does not change
+     * during a simulation. The table is rebuilt only if the flit size or the NoC clock change.
      */
     virtual void
-    MeasurePowerAndEnergy (Ptr<Packet> flit);
+    BuildPowerTable ();
+
+    /**
+     * Adds the flits which arrived during the last clock cycle to the router's activity counters.
+     */
+    void
+    RecordArrivedFlits ();
 
     /**
      * Power and energy are measured for the previous clock cycle.
      * This method is invoked when method GetDynamicPower (), GetLeakagePower () or GetTotalPower () are called,
      * with the purpose to measure power and energy for the last clock too.
-     * The method has effect only if there are flits for which power wasn't measured.
+     * The router's power is computed from its activity counters and its power table.
      */
     void
     MeasurePowerAndEnergyForLastClock ();
@@ -420,8 +496,65 @@ namespace ns3
      */
     map<uint32_t, Ptr<NocNetDevice> > m_headPacketsInjectionNetDevice;
 
+    /**
+     * the simulation context (global clock, speedup, flit size, topology)
+     */
+    Ptr<NocSimulationContext> m_context;
+
+    /**
+     * how many virtual channels each input port has (zero if virtual channels are not used)
+     */
+    uint32_t m_numberOfVirtualChannels;
+
   private:
 
+    /**
+     * \param device a net device of this router
+     *
+     * \return the index of the output port which sends through the net device
+     */
+    uint32_t
+    GetOutputPort (Ptr<NocNetDevice> device) const;
+
+    /**
+     * Tells the deadlock detector whether or not a virtual channel which could not send its flit waits
+     * for the virtual channels of the next router (for a credit or for a free virtual channel).
+     *
+     * \param detector the deadlock detector
+     * \param vertex the virtual channel, in the wait-for graph of the detector
+     * \param device the input port
+     * \param vc the virtual channel of the input port
+     * \param flit the flit from the head of the virtual channel
+     */
+    void
+    UpdateDeadlockDetector (NocDeadlockDetector *detector, uint32_t vertex, Ptr<NocNetDevice> device, uint32_t vc,
+        Ptr<const Packet> flit);
+
+    /**
+     * the input ports (the net devices of this router, followed by the injection net devices), in virtual channel mode
+     */
+    vector<Ptr<NocNetDevice> > m_inputPorts;
+
+    Ptr<NocVirtualChannelAllocator> m_virtualChannelAllocator;
+
+    Ptr<NocSwitchAllocator> m_switchAllocator;
+
+    /**
+     * whether the virtual channels and the switch will be allocated at the next clock cycle
+     */
+    bool m_switchAllocationScheduled;
+
+    /**
+     * the requests made to the allocators during a clock cycle (kept to reuse their memory)
+     */
+    vector<NocVirtualChannelAllocator::Request> m_virtualChannelRequests;
+
+    vector<int> m_virtualChannelGrants;
+
+    vector<NocSwitchAllocator::Request> m_switchRequests;
+
+    vector<bool> m_switchGrants;
+
     /**
      * the name of the routing protocol
      */
@@ -438,9 +571,30 @@ namespace ns3
     uint64_t m_lastClock;
 
     /**
-     * the flits from the previous clock cycle, for which power will have to be measured
+     * the router's activity counters: element k holds how many flits arrived during
+     * clock cycles in which exactly k flits arrived at the router
+     */
+    vector<uint64_t> m_flitsPerArrivalCount;
+
+    /**
+     * the dynamic power consumed by a flit, when k flits arrive during a clock cycle (indexed by k)
+     */
+    vector<double> m_dynamicPowerPerFlit;
+
+    /**
+     * the leakage power consumed by a flit, when k flits arrive during a clock cycle (indexed by k)
+     */
+    vector<double> m_leakagePowerPerFlit;
+
+    /**
+     * the flit size used for building the power table
+     */
+    uint32_t m_powerTableFlitSize;
+
+    /**
+     * the NoC clock frequency used for building the power table
      */
-    vector<Ptr<Packet> > m_flitsFromLastClock;
+    double m_powerTableFrequency;
 
     /**
      * the number of flits arrived at the router's all input ports, only during one clock cycle
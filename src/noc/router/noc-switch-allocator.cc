@@ -0,0 +1,164 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-switch-allocator.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("NocSwitchAllocator");
+
+namespace ns3
+{
+
+  NS_OBJECT_ENSURE_REGISTERED (NocSwitchAllocator);
+
+  TypeId
+  NocSwitchAllocator::GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::NocSwitchAllocator")
+        .SetParent<Object> ()
+        .AddConstructor<NocSwitchAllocator> ();
+    return tid;
+  }
+
+  NocSwitchAllocator::NocSwitchAllocator ()
+    : m_inputPorts (0), m_outputPorts (0), m_virtualChannels (0)
+  {
+    ;
+  }
+
+  NocSwitchAllocator::~NocSwitchAllocator ()
+  {
+    ;
+  }
+
+  void
+  NocSwitchAllocator::DoDispose ()
+  {
+    m_inputArbiters.clear ();
+    m_outputArbiters.clear ();
+    Object::DoDispose ();
+  }
+
+  void
+  NocSwitchAllocator::Initialize (uint32_t inputPorts, uint32_t outputPorts, uint32_t virtualChannels,
+      ObjectFactory arbiterFactory)
+  {
+    NS_LOG_FUNCTION (inputPorts << outputPorts << virtualChannels);
+    NS_ASSERT (virtualChannels > 0);
+
+    m_inputPorts = inputPorts;
+    m_outputPorts = outputPorts;
+    m_virtualChannels = virtualChannels;
+
+    m_inputArbiters.clear ();
+    for (uint32_t i = 0; i < inputPorts; i++)
+      {
+        Ptr<NocArbiter> arbiter = arbiterFactory.Create ()->GetObject<NocArbiter> ();
+        NS_ASSERT_MSG (arbiter != 0, "The arbiter factory must create NocArbiter objects");
+        arbiter->SetSize (virtualChannels);
+        m_inputArbiters.push_back (arbiter);
+      }
+    m_outputArbiters.clear ();
+    for (uint32_t i = 0; i < outputPorts; i++)
+      {
+        Ptr<NocArbiter> arbiter = arbiterFactory.Create ()->GetObject<NocArbiter> ();
+        NS_ASSERT_MSG (arbiter != 0, "The arbiter factory must create NocArbiter objects");
+        arbiter->SetSize (inputPorts);
+        m_outputArbiters.push_back (arbiter);
+      }
+    m_inputWinners.assign (inputPorts, -1);
+    m_inputRequests.assign (virtualChannels, false);
+    m_inputRequestTimes.assign (virtualChannels, Seconds (0));
+    m_inputRequestIndexes.assign (virtualChannels, 0);
+    m_outputRequests.assign (inputPorts, false);
+    m_outputRequestTimes.assign (inputPorts, Seconds (0));
+  }
+
+  void
+  NocSwitchAllocator::Allocate (const std::vector<Request> &requests, std::vector<bool> &grants)
+  {
+    NS_LOG_FUNCTION (requests.size ());
+
+    grants.assign (requests.size (), false);
+
+    // input stage: one virtual channel per input port
+    for (uint32_t inputPort = 0; inputPort < m_inputPorts; inputPort++)
+      {
+        m_inputWinners[inputPort] = -1;
+        bool requested = false;
+        for (uint32_t i = 0; i < requests.size (); i++)
+          {
+            const Request &request = requests[i];
+            if (request.m_inputPort == inputPort)
+              {
+                NS_ASSERT (request.m_inputVirtualChannel < m_virtualChannels && request.m_outputPort < m_outputPorts);
+                m_inputRequests[request.m_inputVirtualChannel] = true;
+                m_inputRequestTimes[request.m_inputVirtualChannel] = request.m_requestTime;
+                m_inputRequestIndexes[request.m_inputVirtualChannel] = i;
+                requested = true;
+              }
+          }
+        if (requested)
+          {
+            int vc = m_inputArbiters[inputPort]->Arbitrate (m_inputRequests, m_inputRequestTimes);
+            if (vc >= 0)
+              {
+                m_inputWinners[inputPort] = m_inputRequestIndexes[vc];
+              }
+            m_inputRequests.assign (m_virtualChannels, false);
+          }
+      }
+
+    // output stage: one input port per output port
+    for (uint32_t outputPort = 0; outputPort < m_outputPorts; outputPort++)
+      {
+        bool requested = false;
+        for (uint32_t inputPort = 0; inputPort < m_inputPorts; inputPort++)
+          {
+            int winner = m_inputWinners[inputPort];
+            if (winner >= 0 && requests[winner].m_outputPort == outputPort)
+              {
+                m_outputRequests[inputPort] = true;
+                m_outputRequestTimes[inputPort] = requests[winner].m_requestTime;
+                requested = true;
+              }
+          }
+        if (!requested)
+          {
+            continue;
+          }
+        int inputPort = m_outputArbiters[outputPort]->Arbitrate (m_outputRequests, m_outputRequestTimes);
+        if (inputPort >= 0)
+          {
+            uint32_t winner = m_inputWinners[inputPort];
+            grants[winner] = true;
+            m_outputArbiters[outputPort]->Accept (inputPort);
+            m_inputArbiters[inputPort]->Accept (requests[winner].m_inputVirtualChannel);
+            NS_LOG_LOGIC ("Output port " << outputPort << " was allocated to virtual channel "
+                << requests[winner].m_inputVirtualChannel << " of input port " << inputPort);
+          }
+        m_outputRequests.assign (m_inputPorts, false);
+      }
+  }
+
+} // namespace ns3
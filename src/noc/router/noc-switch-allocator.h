@@ -0,0 +1,153 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCSWITCHALLOCATOR_H_
+#define NOCSWITCHALLOCATOR_H_
+
+#include "ns3/object.h"
+#include "ns3/object-factory.h"
+#include "ns3/nstime.h"
+#include "ns3/noc-arbiter.h"
+#include <vector>
+
+namespace ns3
+{
+
+  /**
+   * \brief Separable (input first) switch allocator of a NoC router
+   *
+   * \detail During every clock cycle, each input port may send a single flit through the crossbar and each
+   *         output port may receive a single flit. First, the arbiter of every input port chooses one of the
+   *         input virtual channels which request the switch. Then, the arbiter of every output port chooses one
+   *         of the input ports whose chosen virtual channel requests that output port. Both arbiters are told
+   *         when their grant wins the switch (see NocArbiter::Accept).
+   */
+  class NocSwitchAllocator : public Object
+  {
+  public:
+
+    /**
+     * A request made by the flit from the head of an input virtual channel
+     */
+    struct Request
+    {
+      /**
+       * the input port of the flit
+       */
+      uint32_t m_inputPort;
+
+      /**
+       * the virtual channel of the input port which holds the flit
+       */
+      uint32_t m_inputVirtualChannel;
+
+      /**
+       * the output port through which the flit leaves the router
+       */
+      uint32_t m_outputPort;
+
+      /**
+       * since when the request is waiting (used by the age-based arbiters)
+       */
+      Time m_requestTime;
+    };
+
+    static TypeId
+    GetTypeId ();
+
+    NocSwitchAllocator ();
+
+    virtual
+    ~NocSwitchAllocator ();
+
+    /**
+     * Creates the arbiters of this allocator.
+     *
+     * \param inputPorts how many input ports the router has
+     * \param outputPorts how many output ports the router has
+     * \param virtualChannels how many virtual channels each input port has
+     * \param arbiterFactory the factory used for creating the arbiters
+     */
+    void
+    Initialize (uint32_t inputPorts, uint32_t outputPorts, uint32_t virtualChannels, ObjectFactory arbiterFactory);
+
+    /**
+     * Allocates the switch. At most one request of every input virtual channel is expected.
+     *
+     * \param requests the requests made during the current clock cycle
+     * \param grants whether each request was granted (one element per request)
+     */
+    void
+    Allocate (const std::vector<Request> &requests, std::vector<bool> &grants);
+
+  protected:
+
+    virtual void
+    DoDispose ();
+
+  private:
+
+    uint32_t m_inputPorts;
+
+    uint32_t m_outputPorts;
+
+    uint32_t m_virtualChannels;
+
+    /**
+     * the arbiter of each input port (over its virtual channels)
+     */
+    std::vector<Ptr<NocArbiter> > m_inputArbiters;
+
+    /**
+     * the arbiter of each output port (over the input ports)
+     */
+    std::vector<Ptr<NocArbiter> > m_outputArbiters;
+
+    /**
+     * the request (index) chosen by the arbiter of each input port, or -1
+     */
+    std::vector<int> m_inputWinners;
+
+    /**
+     * the requests seen by an input arbiter (by virtual channel)
+     */
+    std::vector<bool> m_inputRequests;
+
+    std::vector<Time> m_inputRequestTimes;
+
+    /**
+     * the index of the requests seen by an input arbiter (by virtual channel)
+     */
+    std::vector<uint32_t> m_inputRequestIndexes;
+
+    /**
+     * the requests seen by an output arbiter (by input port)
+     */
+    std::vector<bool> m_outputRequests;
+
+    std::vector<Time> m_outputRequestTimes;
+  };
+
+} // namespace ns3
+
+#endif /* NOCSWITCHALLOCATOR_H_ */
@@ -0,0 +1,130 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-virtual-channel-allocator.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("NocVirtualChannelAllocator");
+
+namespace ns3
+{
+
+  NS_OBJECT_ENSURE_REGISTERED (NocVirtualChannelAllocator);
+
+  TypeId
+  NocVirtualChannelAllocator::GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::NocVirtualChannelAllocator")
+        .SetParent<Object> ()
+        .AddConstructor<NocVirtualChannelAllocator> ();
+    return tid;
+  }
+
+  NocVirtualChannelAllocator::NocVirtualChannelAllocator ()
+    : m_inputPorts (0), m_outputPorts (0), m_virtualChannels (0)
+  {
+    ;
+  }
+
+  NocVirtualChannelAllocator::~NocVirtualChannelAllocator ()
+  {
+    ;
+  }
+
+  void
+  NocVirtualChannelAllocator::DoDispose ()
+  {
+    m_arbiters.clear ();
+    Object::DoDispose ();
+  }
+
+  void
+  NocVirtualChannelAllocator::Initialize (uint32_t inputPorts, uint32_t outputPorts, uint32_t virtualChannels,
+      ObjectFactory arbiterFactory)
+  {
+    NS_LOG_FUNCTION (inputPorts << outputPorts << virtualChannels);
+    NS_ASSERT_MSG (virtualChannels > 0 && virtualChannels <= MAX_VIRTUAL_CHANNELS,
+        "The number of virtual channels must be between 1 and " << MAX_VIRTUAL_CHANNELS);
+
+    m_inputPorts = inputPorts;
+    m_outputPorts = outputPorts;
+    m_virtualChannels = virtualChannels;
+
+    m_arbiters.clear ();
+    for (uint32_t i = 0; i < outputPorts * virtualChannels; i++)
+      {
+        Ptr<NocArbiter> arbiter = arbiterFactory.Create ()->GetObject<NocArbiter> ();
+        NS_ASSERT_MSG (arbiter != 0, "The arbiter factory must create NocArbiter objects");
+        arbiter->SetSize (inputPorts * virtualChannels);
+        m_arbiters.push_back (arbiter);
+      }
+    m_arbiterRequests.assign (inputPorts * virtualChannels, false);
+    m_arbiterRequestTimes.assign (inputPorts * virtualChannels, Seconds (0));
+    m_requestIndexes.assign (inputPorts * virtualChannels, 0);
+  }
+
+  void
+  NocVirtualChannelAllocator::Allocate (const std::vector<Request> &requests, std::vector<int> &grants)
+  {
+    NS_LOG_FUNCTION (requests.size ());
+
+    grants.assign (requests.size (), -1);
+    for (uint32_t outputPort = 0; outputPort < m_outputPorts; outputPort++)
+      {
+        for (uint32_t vc = 0; vc < m_virtualChannels; vc++)
+          {
+            bool requested = false;
+            for (uint32_t i = 0; i < requests.size (); i++)
+              {
+                const Request &request = requests[i];
+                if (grants[i] == -1 && request.m_outputPort == outputPort && (request.m_candidates & (1u << vc)))
+                  {
+                    NS_ASSERT (request.m_inputPort < m_inputPorts && request.m_inputVirtualChannel < m_virtualChannels);
+                    uint32_t requester = request.m_inputPort * m_virtualChannels + request.m_inputVirtualChannel;
+                    m_arbiterRequests[requester] = true;
+                    m_arbiterRequestTimes[requester] = request.m_requestTime;
+                    m_requestIndexes[requester] = i;
+                    requested = true;
+                  }
+              }
+            if (!requested)
+              {
+                continue;
+              }
+
+            Ptr<NocArbiter> arbiter = m_arbiters[outputPort * m_virtualChannels + vc];
+            int granted = arbiter->Arbitrate (m_arbiterRequests, m_arbiterRequestTimes);
+            if (granted >= 0)
+              {
+                arbiter->Accept (granted);
+                grants[m_requestIndexes[granted]] = vc;
+                NS_LOG_LOGIC ("Virtual channel " << vc << " of output port " << outputPort
+                    << " was allocated to virtual channel " << granted % m_virtualChannels
+                    << " of input port " << granted / m_virtualChannels);
+              }
+            m_arbiterRequests.assign (m_arbiterRequests.size (), false);
+          }
+      }
+  }
+
+} // namespace ns3
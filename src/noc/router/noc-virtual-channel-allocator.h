@@ -0,0 +1,151 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCVIRTUALCHANNELALLOCATOR_H_
+#define NOCVIRTUALCHANNELALLOCATOR_H_
+
+#include "ns3/object.h"
+#include "ns3/object-factory.h"
+#include "ns3/nstime.h"
+#include "ns3/noc-arbiter.h"
+#include <vector>
+
+namespace ns3
+{
+
+  /**
+   * \brief Virtual channel allocator of a NoC router
+   *
+   * \detail The head flit waiting in an input virtual channel requests a virtual channel of the downstream
+   *         router (the one connected to the output port chosen by the routing protocol). Each request carries
+   *         the set of downstream virtual channels which the flit may use.
+   *
+   *         Every downstream virtual channel (of every output port) has its own arbiter, over all the input
+   *         virtual channels of the router. The arbiters are visited in order and a request which already won
+   *         a virtual channel does not compete for the next ones, so a request gets at most one virtual channel.
+   */
+  class NocVirtualChannelAllocator : public Object
+  {
+  public:
+
+    /**
+     * A request made by the head flit of an input virtual channel
+     */
+    struct Request
+    {
+      /**
+       * the input port of the flit
+       */
+      uint32_t m_inputPort;
+
+      /**
+       * the virtual channel of the input port which holds the flit
+       */
+      uint32_t m_inputVirtualChannel;
+
+      /**
+       * the output port chosen by the routing protocol
+       */
+      uint32_t m_outputPort;
+
+      /**
+       * the downstream virtual channels which may be allocated (bit i set means virtual channel i)
+       */
+      uint32_t m_candidates;
+
+      /**
+       * since when the request is waiting (used by the age-based arbiters)
+       */
+      Time m_requestTime;
+    };
+
+    /**
+     * the maximum number of virtual channels (the candidates of a request are kept as a bit mask)
+     */
+    static const uint32_t MAX_VIRTUAL_CHANNELS = 32;
+
+    static TypeId
+    GetTypeId ();
+
+    NocVirtualChannelAllocator ();
+
+    virtual
+    ~NocVirtualChannelAllocator ();
+
+    /**
+     * Creates the arbiters of this allocator.
+     *
+     * \param inputPorts how many input ports the router has
+     * \param outputPorts how many output ports the router has
+     * \param virtualChannels how many virtual channels each port has
+     * \param arbiterFactory the factory used for creating the arbiters
+     */
+    void
+    Initialize (uint32_t inputPorts, uint32_t outputPorts, uint32_t virtualChannels, ObjectFactory arbiterFactory);
+
+    /**
+     * Allocates downstream virtual channels.
+     *
+     * \param requests the requests made during the current clock cycle
+     * \param grants the downstream virtual channel granted to each request, or -1 (one element per request)
+     */
+    void
+    Allocate (const std::vector<Request> &requests, std::vector<int> &grants);
+
+  protected:
+
+    virtual void
+    DoDispose ();
+
+  private:
+
+    uint32_t m_inputPorts;
+
+    uint32_t m_outputPorts;
+
+    uint32_t m_virtualChannels;
+
+    /**
+     * the arbiters (output port * number of virtual channels + downstream virtual channel)
+     */
+    std::vector<Ptr<NocArbiter> > m_arbiters;
+
+    /**
+     * the requests seen by an arbiter (input port * number of virtual channels + input virtual channel)
+     */
+    std::vector<bool> m_arbiterRequests;
+
+    /**
+     * the times of the requests seen by an arbiter
+     */
+    std::vector<Time> m_arbiterRequestTimes;
+
+    /**
+     * the index (in the requests given to Allocate) of the requests seen by an arbiter
+     */
+    std::vector<uint32_t> m_requestIndexes;
+  };
+
+} // namespace ns3
+
+#endif /* NOCVIRTUALCHANNELALLOCATOR_H_ */
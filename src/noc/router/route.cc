@@ -18,32 +18,32 @@
  * Author: Ciprian Radu <radu@informatik.uni-augsburg.de>
  */
 
-#include "ns3/log.h"
 #include "route.h"
-
-NS_LOG_COMPONENT_DEFINE ("Route");
+#include "ns3/noc-net-device.h"
 
 namespace ns3
 {
 
-  TypeId
-  Route::GetTypeId ()
+  Route::Route ()
+    : m_routedPacket (0),
+      m_sourceDevice (0),
+      m_destinationDevice (0)
   {
-    static TypeId tid = TypeId ("ns3::Route")
-        .SetParent<Object> ();
-    return tid;
+    ;
   }
 
   Route::Route (Ptr<Packet> routedPacket, Ptr<NocNetDevice> sourceDevice, Ptr<NocNetDevice> destinationDevice)
+    : m_routedPacket (PeekPointer (routedPacket)),
+      m_sourceDevice (PeekPointer (sourceDevice)),
+      m_destinationDevice (PeekPointer (destinationDevice))
   {
-    m_routedPacket = routedPacket;
-    m_sourceDevice = sourceDevice;
-    m_destinationDevice = destinationDevice;
+    ;
   }
 
-  Route::~Route ()
+  bool
+  Route::IsValid () const
   {
-    ;
+    return m_sourceDevice != 0 && m_destinationDevice != 0;
   }
 
   Ptr<Packet>
@@ -52,13 +52,13 @@ namespace ns3
     return m_routedPacket;
   }
 
-  Ptr<NocNetDevice>
+  NocNetDevice *
   Route::GetSourceDevice () const
   {
     return m_sourceDevice;
   }
 
-  Ptr<NocNetDevice>
+  NocNetDevice *
   Route::GetDestinationDevice () const
   {
     return m_destinationDevice;
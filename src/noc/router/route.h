@@ -21,58 +21,70 @@
 #ifndef ROUTE_H_
 #define ROUTE_H_
 
-#include "ns3/object.h"
-#include "ns3/noc-header.h"
 #include "ns3/packet.h"
-#include "ns3/noc-node.h"
-#include "ns3/noc-net-device.h"
 
 namespace ns3
 {
 
+  class NocNetDevice;
+
   /**
    *
    * \brief Holds the route for a packet, as it is determined by the routing protocol.
    *
+   * A route is a small value, returned by the routing protocols for every routed flit. It is not allocated
+   * on the heap and it does not hold references: neither to the net devices (they live as long as the topology),
+   * nor to the routed packet (it is held by whoever requested the route, while the route is used).
+   * A default constructed route is not valid (no route was found or no routing needs to be performed).
+   *
    */
-  class Route : public Object
+  class Route
   {
   public:
 
-    static TypeId
-    GetTypeId ();
+    /**
+     * Creates an invalid route
+     */
+    Route ();
 
+    /**
+     * \param routedPacket the routed packet (with its header updated by the routing protocol)
+     * \param sourceDevice the net device which sends the packet
+     * \param destinationDevice the net device which receives the packet
+     */
     Route (Ptr<Packet> routedPacket, Ptr<NocNetDevice> sourceDevice, Ptr<NocNetDevice> destinationDevice);
 
-    ~Route ();
+    /**
+     * \return whether or not this route leads somewhere
+     */
+    bool
+    IsValid () const;
 
     Ptr<Packet>
     GetRoutedPacket () const;
 
-    Ptr<NocNetDevice>
+    NocNetDevice *
     GetSourceDevice () const;
 
-    Ptr<NocNetDevice>
+    NocNetDevice *
     GetDestinationDevice () const;
 
-  protected:
-
   private:
 
     /**
-     * the routed packet packet
+     * the routed packet
      */
-    Ptr<Packet> m_routedPacket;
+    Packet *m_routedPacket;
 
     /**
      * the net device which sends the packet
      */
-    Ptr<NocNetDevice> m_sourceDevice;
+    NocNetDevice *m_sourceDevice;
 
     /**
      * the net device which receives the packet
      */
-    Ptr<NocNetDevice> m_destinationDevice;
+    NocNetDevice *m_destinationDevice;
 
   };
 
@@ -25,6 +25,7 @@
 #include "ns3/noc-application.h"
 #include "ns3/integer.h"
 #include "ns3/noc-registry.h"
+#include "ns3/noc-simulation-context.h"
 
 NS_LOG_COMPONENT_DEFINE ("SlbLoadRouterComponent");
 
@@ -143,4 +144,36 @@ namespace ns3
     return load;
   }
 
+  int
+  SlbLoadRouterComponent::GetEpochLoad (Ptr<NocRouter> router)
+  {
+    NS_ASSERT (router != 0);
+    int dataFlitSpeedup;
+    if (router->GetContext () != 0)
+      {
+        dataFlitSpeedup = router->GetContext ()->GetDataFlitSpeedup ();
+      }
+    else
+      {
+        IntegerValue speedup;
+        NocRegistry::GetInstance ()->GetAttribute ("DataPacketSpeedup", speedup);
+        dataFlitSpeedup = speedup.Get ();
+      }
+
+    // the same formula as GetLocalLoad (...), applied to the flits received during the epoch
+    // (no packet is seen here, so the length of the last routed message is used)
+    int dataLength = m_dataLength > 0 ? m_dataLength : 0;
+    int load = (int) ((m_load / (8.0 * (6.0 * dataFlitSpeedup + dataLength))) * 100);
+    if (load > 100)
+      {
+        load = 100;
+      }
+    m_load = 0;
+
+    NS_LOG_DEBUG ("Publishing the load " << load);
+    NS_ASSERT (load >= 0 && load <= 100);
+
+    return load;
+  }
+
 } // namespace ns3
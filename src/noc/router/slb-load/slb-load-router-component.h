@@ -65,6 +65,12 @@ namespace ns3
     GetLoadForDirection (Ptr<Packet> packet, Ptr<NocNetDevice> sourceDevice,
         Ptr<NocNetDevice> selectedDevice);
 
+    /**
+     * \see LoadRouterComponent::GetEpochLoad
+     */
+    int
+    GetEpochLoad (Ptr<NocRouter> router);
+
   protected:
 
   private:
@@ -111,4 +111,20 @@ namespace ns3
     return load;
   }
 
+  int
+  SoLoadRouterComponent::GetEpochLoad (Ptr<NocRouter> router)
+  {
+    NS_ASSERT (router != 0);
+    // the same load as GetLocalLoad (...), which does not depend on the packet
+    int load = (int) router->GetInChannelsOccupancy (0);
+    load = load * 100;
+    m_load = 0;
+
+    NS_ASSERT (load >= 0 && load <= 100);
+
+    NS_LOG_DEBUG ("Publishing the load " << load);
+
+    return load;
+  }
+
 } // namespace ns3
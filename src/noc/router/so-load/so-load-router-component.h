@@ -64,6 +64,12 @@ namespace ns3
     int
     GetLoadForDirection (Ptr<Packet> packet, Ptr<NocNetDevice> sourceDevice, Ptr<NocNetDevice> selectedDevice);
 
+    /**
+     * \see LoadRouterComponent::GetEpochLoad
+     */
+    int
+    GetEpochLoad (Ptr<NocRouter> router);
+
   protected:
 
   private:
@@ -27,6 +27,7 @@
 #include "ns3/log.h"
 #include "ns3/noc-header.h"
 #include "ns3/noc-packet-tag.h"
+#include "ns3/noc-routing-table.h"
 #include "ns3/boolean.h"
 #include "ns3/noc-value.h"
 #include "ns3/uinteger.h"
@@ -96,15 +97,27 @@ namespace ns3
     return m_routingOrder;
   }
 
-  Ptr<Route>
+  bool
+  DorRouting::GetDimensionOrder (std::vector<uint32_t> &order) const
+  {
+    order.clear ();
+    for (unsigned int i = 0; i < m_routingOrder.size (); i++)
+      {
+        order.push_back (m_routingOrder.at (i)->GetValue ());
+      }
+    return true;
+  }
+
+  Route
   DorRouting::RequestNewRoute (const Ptr<NocNetDevice> source, const Ptr<NocNode> destination, Ptr<Packet> packet)
   {
     NS_LOG_FUNCTION_NOARGS ();
-    std::stringstream ss;
-    packet->Print (ss);
+    if (m_routingTable != 0)
+      {
+        return RequestRouteFromTable (source, destination, packet);
+      }
     NS_LOG_DEBUG ("source node = " << source->GetNode ()->GetId () << ", destination node = " << destination->GetId ()
-        << ", packet " << ss.str ());
-    ss.str ("");
+        << ", packet " << *packet);
 
     NocHeader nocHeader;
     NocPacketTag tag;
@@ -115,12 +128,12 @@ namespace ns3
     uint dimension=m_routingOrder.size();
 
     std::vector<bool> isForward(dimension);
-    std::vector<uint8_t> offset(dimension);
+    std::vector<NocCoordinate> offset(dimension);
 
     for (unsigned int i = 0; i < m_routingOrder.size(); i++)
     {
         isForward.at(i) = nocHeader.HasForwardDirection(i);
-        offset.at(i) = nocHeader.GetOffset().at(i);
+        offset.at(i) = nocHeader.GetOffset(i);
         NS_LOG_DEBUG ("dimension " << (i+1) << " Offset " << (uint) offset.at(i) << " direction " << (isForward.at(i) ? "forward" : "back"));
     }
 
@@ -148,25 +161,24 @@ namespace ns3
                 NS_ASSERT_MSG (offset.at (dimension) - 1 >= 0, "A packet going Back will have the offset < 0");
                 direction.at (dimension) = NocRoutingProtocol::BACK;
               }
-            offset.at (dimension)--;
-            nocHeader.SetOffset(offset);
+            nocHeader.DecrementOffset (dimension);
             break;
           }
       }
 
     for (unsigned int i = 0; i < m_routingOrder.size (); i++)
       {
-        NS_LOG_DEBUG ("dimension " << (i+1) << " new offset " << (int) nocHeader.GetOffset().at(i));
+        NS_LOG_DEBUG ("dimension " << (i+1) << " new offset " << (int) nocHeader.GetOffset (i));
       }
 
     packet->AddHeader (nocHeader);
 
-    packet->Print (ss);
     NS_LOG_DEBUG ("source node = " << source->GetNode ()->GetId () << ", destination node = " << destination->GetId ()
-        << ", packet " << ss.str ());
-    ss.str ("");
+        << ", packet " << *packet);
 
-    Ptr<Route> route = 0;
+    Route route;
+    Ptr<NocNetDevice> sourceDevice;
+    Ptr<NocNetDevice> destinationDevice;
 
     std::vector <bool> routeDimension(m_routingOrder.size(), true);
 
@@ -175,18 +187,18 @@ namespace ns3
         switch (direction.at (i))
           {
             case NocRoutingProtocol::FORWARD:
-              m_sourceNetDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, FORWARD, i);
-              NS_ASSERT (m_sourceNetDevice != 0);
-              m_destinationNetDevice = destination->GetRouter ()->GetInputNetDevice (m_sourceNetDevice, BACK, i);
-              NS_ASSERT (m_destinationNetDevice != 0);
-              route = CreateObject<Route> (packet, m_sourceNetDevice, m_destinationNetDevice);
+              sourceDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, FORWARD, i);
+              NS_ASSERT (sourceDevice != 0);
+              destinationDevice = destination->GetRouter ()->GetInputNetDevice (sourceDevice, BACK, i);
+              NS_ASSERT (destinationDevice != 0);
+              route = Route (packet, sourceDevice, destinationDevice);
               break;
             case NocRoutingProtocol::BACK:
-              m_sourceNetDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, BACK, i);
-              NS_ASSERT (m_sourceNetDevice != 0);
-              m_destinationNetDevice = destination->GetRouter ()->GetInputNetDevice (m_sourceNetDevice, FORWARD, i);
-              NS_ASSERT (m_destinationNetDevice != 0);
-              route = CreateObject<Route> (packet, m_sourceNetDevice, m_destinationNetDevice);
+              sourceDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, BACK, i);
+              NS_ASSERT (sourceDevice != 0);
+              destinationDevice = destination->GetRouter ()->GetInputNetDevice (sourceDevice, FORWARD, i);
+              NS_ASSERT (destinationDevice != 0);
+              route = Route (packet, sourceDevice, destinationDevice);
               break;
             case NocRoutingProtocol::NONE:
             default:
@@ -56,9 +56,12 @@ namespace ns3
     virtual
     ~DorRouting ();
 
-    virtual Ptr<Route>
+    virtual Route
     RequestNewRoute (const Ptr<NocNetDevice> source, const Ptr<NocNode> destination, Ptr<Packet> packet);
 
+    virtual bool
+    GetDimensionOrder (std::vector<uint32_t> &order) const;
+
     void
     SetRoute (std::vector<Ptr<NocValue> > route);
 
@@ -27,6 +27,7 @@
 #include "ns3/log.h"
 #include "ns3/noc-header.h"
 #include "ns3/noc-packet-tag.h"
+#include "ns3/noc-routing-table.h"
 #include "ns3/boolean.h"
 
 NS_LOG_COMPONENT_DEFINE ("XyRouting");
@@ -82,15 +83,25 @@ namespace ns3
     return m_routeXFirst;
   }
 
-  Ptr<Route>
+  bool
+  XyRouting::GetDimensionOrder (std::vector<uint32_t> &order) const
+  {
+    order.clear ();
+    order.push_back (m_routeXFirst ? 0 : 1);
+    order.push_back (m_routeXFirst ? 1 : 0);
+    return true;
+  }
+
+  Route
   XyRouting::RequestNewRoute (const Ptr<NocNetDevice> source, const Ptr<NocNode> destination, Ptr<Packet> packet)
   {
     NS_LOG_FUNCTION_NOARGS ();
-    std::stringstream ss;
-    packet->Print (ss);
+    if (m_routingTable != 0)
+      {
+        return RequestRouteFromTable (source, destination, packet);
+      }
     NS_LOG_DEBUG ("source node = " << source->GetNode ()->GetId () << ", destination node = " << destination->GetId ()
-        << ", packet " << ss.str ());
-    ss.str ("");
+        << ", packet " << *packet);
 
     NocHeader nocHeader;
     NocPacketTag tag;
@@ -187,29 +198,29 @@ namespace ns3
 
     packet->AddHeader (nocHeader);
 
-    packet->Print (ss);
     NS_LOG_DEBUG ("source node = " << source->GetNode ()->GetId () << ", destination node = " << destination->GetId ()
-        << ", packet " << ss.str ());
-    ss.str ("");
+        << ", packet " << *packet);
 
-    Ptr<Route> route = 0;
+    Route route;
+    Ptr<NocNetDevice> sourceDevice;
+    Ptr<NocNetDevice> destinationDevice;
 
     bool routeX = true;
     bool routeY = true;
     switch (xDirection) {
 		case NocRoutingProtocol::FORWARD:
-		  m_sourceNetDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, FORWARD, 0);
-		  NS_ASSERT (m_sourceNetDevice != 0);
-		  m_destinationNetDevice = destination->GetRouter ()->GetInputNetDevice (m_sourceNetDevice, BACK, 0);
-		  NS_ASSERT (m_destinationNetDevice != 0);
-		  route = CreateObject<Route> (packet, m_sourceNetDevice, m_destinationNetDevice);
+		  sourceDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, FORWARD, 0);
+		  NS_ASSERT (sourceDevice != 0);
+		  destinationDevice = destination->GetRouter ()->GetInputNetDevice (sourceDevice, BACK, 0);
+		  NS_ASSERT (destinationDevice != 0);
+		  route = Route (packet, sourceDevice, destinationDevice);
 		  break;
 		case NocRoutingProtocol::BACK:
-		  m_sourceNetDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, BACK, 0);
-		  NS_ASSERT (m_sourceNetDevice != 0);
-		  m_destinationNetDevice = destination->GetRouter ()->GetInputNetDevice (m_sourceNetDevice, FORWARD, 0);
-		  NS_ASSERT (m_destinationNetDevice != 0);
-		  route = CreateObject<Route> (packet, m_sourceNetDevice, m_destinationNetDevice);
+		  sourceDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, BACK, 0);
+		  NS_ASSERT (sourceDevice != 0);
+		  destinationDevice = destination->GetRouter ()->GetInputNetDevice (sourceDevice, FORWARD, 0);
+		  NS_ASSERT (destinationDevice != 0);
+		  route = Route (packet, sourceDevice, destinationDevice);
 		  break;
 		case NocRoutingProtocol::NONE:
 		  routeX = false;
@@ -220,19 +231,19 @@ namespace ns3
 
     switch (yDirection) {
 		case NocRoutingProtocol::FORWARD:
-		  m_sourceNetDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, FORWARD, 1);
-		  NS_ASSERT (m_sourceNetDevice != 0);
-		  m_destinationNetDevice = destination->GetRouter ()->GetInputNetDevice (m_sourceNetDevice, NocRoutingProtocol::BACK, 1);
-		  NS_ASSERT (m_destinationNetDevice != 0);
-		  route = CreateObject<Route> (packet, m_sourceNetDevice, m_destinationNetDevice);
+		  sourceDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, FORWARD, 1);
+		  NS_ASSERT (sourceDevice != 0);
+		  destinationDevice = destination->GetRouter ()->GetInputNetDevice (sourceDevice, NocRoutingProtocol::BACK, 1);
+		  NS_ASSERT (destinationDevice != 0);
+		  route = Route (packet, sourceDevice, destinationDevice);
 		  break;
 		case NocRoutingProtocol::BACK:
-		  m_sourceNetDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source,
+		  sourceDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source,
 			  NocRoutingProtocol::BACK, 1);
-		  NS_ASSERT (m_sourceNetDevice != 0);
-		  m_destinationNetDevice = destination->GetRouter ()->GetInputNetDevice (m_sourceNetDevice, NocRoutingProtocol::FORWARD, 1);
-		  NS_ASSERT (m_destinationNetDevice != 0);
-		  route = CreateObject<Route> (packet, m_sourceNetDevice, m_destinationNetDevice);
+		  NS_ASSERT (sourceDevice != 0);
+		  destinationDevice = destination->GetRouter ()->GetInputNetDevice (sourceDevice, NocRoutingProtocol::FORWARD, 1);
+		  NS_ASSERT (destinationDevice != 0);
+		  route = Route (packet, sourceDevice, destinationDevice);
 		  break;
 		case NocRoutingProtocol::NONE:
 		  routeY = false;
@@ -58,9 +58,12 @@ namespace ns3
     virtual
     ~XyRouting();
 
-    virtual Ptr<Route>
+    virtual Route
     RequestNewRoute (const Ptr<NocNetDevice> source, const Ptr<NocNode> destination, Ptr<Packet> packet);
 
+    virtual bool
+    GetDimensionOrder (std::vector<uint32_t> &order) const;
+
     void
     SetRouteXFirst (bool routeXFirst);
 
@@ -27,6 +27,7 @@
 #include "ns3/log.h"
 #include "ns3/noc-header.h"
 #include "ns3/noc-packet-tag.h"
+#include "ns3/noc-routing-table.h"
 #include "ns3/boolean.h"
 
 NS_LOG_COMPONENT_DEFINE ("XyzRouting");
@@ -140,15 +141,45 @@ namespace ns3
    }
 
 
-  Ptr<Route>
+  bool
+  XyzRouting::GetDimensionOrder (std::vector<uint32_t> &order) const
+  {
+    // the same decisions as in RequestNewRoute
+    order.clear ();
+    if (m_routeXFirst)
+      {
+        order.push_back (0);
+        order.push_back (m_routeYSecond ? 1 : 2);
+        order.push_back (m_routeYSecond ? 2 : 1);
+      }
+    else
+      {
+        if (m_routeYFirst)
+          {
+            order.push_back (1);
+            order.push_back (m_routeXSecond ? 0 : 2);
+            order.push_back (m_routeXSecond ? 2 : 0);
+          }
+        else
+          {
+            order.push_back (2);
+            order.push_back (m_routeXSecond ? 0 : 1);
+            order.push_back (m_routeXSecond ? 1 : 0);
+          }
+      }
+    return true;
+  }
+
+  Route
   XyzRouting::RequestNewRoute (const Ptr<NocNetDevice> source, const Ptr<NocNode> destination, Ptr<Packet> packet)
   {
     NS_LOG_FUNCTION_NOARGS ();
-    std::stringstream ss;
-    packet->Print (ss);
+    if (m_routingTable != 0)
+      {
+        return RequestRouteFromTable (source, destination, packet);
+      }
     NS_LOG_DEBUG ("source node = " << source->GetNode ()->GetId () << ", destination node = " << destination->GetId ()
-        << ", packet " << ss.str ());
-    ss.str ("");
+        << ", packet " << *packet);
 
     NocHeader nocHeader;
     NocPacketTag tag;
@@ -464,12 +495,12 @@ namespace ns3
 
     packet->AddHeader (nocHeader);
 
-    packet->Print (ss);
     NS_LOG_DEBUG ("source node = " << source->GetNode ()->GetId () << ", destination node = " << destination->GetId ()
-        << ", packet " << ss.str ());
-    ss.str ("");
+        << ", packet " << *packet);
 
-    Ptr<Route> route = 0;
+    Route route;
+    Ptr<NocNetDevice> sourceDevice;
+    Ptr<NocNetDevice> destinationDevice;
 
     bool routeX = true;
     bool routeY = true;
@@ -477,18 +508,18 @@ namespace ns3
 
     switch (xDirection) {
                 case NocRoutingProtocol::FORWARD:
-                  m_sourceNetDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, FORWARD, 0);
-                  NS_ASSERT (m_sourceNetDevice != 0);
-                  m_destinationNetDevice = destination->GetRouter ()->GetInputNetDevice (m_sourceNetDevice, BACK, 0);
-                  NS_ASSERT (m_destinationNetDevice != 0);
-                  route = CreateObject<Route> (packet, m_sourceNetDevice, m_destinationNetDevice);
+                  sourceDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, FORWARD, 0);
+                  NS_ASSERT (sourceDevice != 0);
+                  destinationDevice = destination->GetRouter ()->GetInputNetDevice (sourceDevice, BACK, 0);
+                  NS_ASSERT (destinationDevice != 0);
+                  route = Route (packet, sourceDevice, destinationDevice);
                   break;
                 case NocRoutingProtocol::BACK:
-                  m_sourceNetDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, BACK, 0);
-                  NS_ASSERT (m_sourceNetDevice != 0);
-                  m_destinationNetDevice = destination->GetRouter ()->GetInputNetDevice (m_sourceNetDevice, FORWARD, 0);
-                  NS_ASSERT (m_destinationNetDevice != 0);
-                  route = CreateObject<Route> (packet, m_sourceNetDevice, m_destinationNetDevice);
+                  sourceDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, BACK, 0);
+                  NS_ASSERT (sourceDevice != 0);
+                  destinationDevice = destination->GetRouter ()->GetInputNetDevice (sourceDevice, FORWARD, 0);
+                  NS_ASSERT (destinationDevice != 0);
+                  route = Route (packet, sourceDevice, destinationDevice);
                   break;
                 case NocRoutingProtocol::NONE:
                   routeX = false;
@@ -499,19 +530,19 @@ namespace ns3
 
     switch (yDirection) {
                 case NocRoutingProtocol::FORWARD:
-                  m_sourceNetDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, FORWARD, 1);
-                  NS_ASSERT (m_sourceNetDevice != 0);
-                  m_destinationNetDevice = destination->GetRouter ()->GetInputNetDevice (m_sourceNetDevice, NocRoutingProtocol::BACK, 1);
-                  NS_ASSERT (m_destinationNetDevice != 0);
-                  route = CreateObject<Route> (packet, m_sourceNetDevice, m_destinationNetDevice);
+                  sourceDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, FORWARD, 1);
+                  NS_ASSERT (sourceDevice != 0);
+                  destinationDevice = destination->GetRouter ()->GetInputNetDevice (sourceDevice, NocRoutingProtocol::BACK, 1);
+                  NS_ASSERT (destinationDevice != 0);
+                  route = Route (packet, sourceDevice, destinationDevice);
                   break;
                 case NocRoutingProtocol::BACK:
-                  m_sourceNetDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source,
+                  sourceDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source,
                           NocRoutingProtocol::BACK, 1);
-                  NS_ASSERT (m_sourceNetDevice != 0);
-                  m_destinationNetDevice = destination->GetRouter ()->GetInputNetDevice (m_sourceNetDevice, NocRoutingProtocol::FORWARD, 1);
-                  NS_ASSERT (m_destinationNetDevice != 0);
-                  route = CreateObject<Route> (packet, m_sourceNetDevice, m_destinationNetDevice);
+                  NS_ASSERT (sourceDevice != 0);
+                  destinationDevice = destination->GetRouter ()->GetInputNetDevice (sourceDevice, NocRoutingProtocol::FORWARD, 1);
+                  NS_ASSERT (destinationDevice != 0);
+                  route = Route (packet, sourceDevice, destinationDevice);
                   break;
                 case NocRoutingProtocol::NONE:
                   routeY = false;
@@ -521,18 +552,18 @@ namespace ns3
       }
     switch (zDirection) {
                   case NocRoutingProtocol::FORWARD:
-                    m_sourceNetDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, FORWARD, 2);
-                    NS_ASSERT (m_sourceNetDevice != 0);
-                    m_destinationNetDevice = destination->GetRouter ()->GetInputNetDevice (m_sourceNetDevice, BACK, 2);
-                    NS_ASSERT (m_destinationNetDevice != 0);
-                    route = CreateObject<Route> (packet, m_sourceNetDevice, m_destinationNetDevice);
+                    sourceDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, FORWARD, 2);
+                    NS_ASSERT (sourceDevice != 0);
+                    destinationDevice = destination->GetRouter ()->GetInputNetDevice (sourceDevice, BACK, 2);
+                    NS_ASSERT (destinationDevice != 0);
+                    route = Route (packet, sourceDevice, destinationDevice);
                     break;
                   case NocRoutingProtocol::BACK:
-                    m_sourceNetDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, BACK, 2);
-                    NS_ASSERT (m_sourceNetDevice != 0);
-                    m_destinationNetDevice = destination->GetRouter ()->GetInputNetDevice (m_sourceNetDevice, FORWARD, 2);
-                    NS_ASSERT (m_destinationNetDevice != 0);
-                    route = CreateObject<Route> (packet, m_sourceNetDevice, m_destinationNetDevice);
+                    sourceDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->GetOutputNetDevice (source, BACK, 2);
+                    NS_ASSERT (sourceDevice != 0);
+                    destinationDevice = destination->GetRouter ()->GetInputNetDevice (sourceDevice, FORWARD, 2);
+                    NS_ASSERT (destinationDevice != 0);
+                    route = Route (packet, sourceDevice, destinationDevice);
                     break;
                   case NocRoutingProtocol::NONE:
                     routeZ = false;
@@ -23,6 +23,11 @@
 #include "ns3/noc-node.h"
 #include "ns3/noc-header.h"
 #include "ns3/noc-packet-tag.h"
+#include "ns3/noc-routing-table.h"
+#include "ns3/noc-topology.h"
+#include "ns3/noc-router.h"
+#include "ns3/noc-load-side-band.h"
+#include "ns3/boolean.h"
 
 NS_LOG_COMPONENT_DEFINE ("NocRoutingProtocol");
 
@@ -51,13 +56,22 @@ namespace ns3
     m_name = name;
     m_dataPacketsToBeRouted = 0;
     m_dataPacketsRouted = 0;
+    m_datelineVirtualChannels = false;
   }
 
   TypeId
   NocRoutingProtocol::GetTypeId ()
   {
     static TypeId tid = TypeId ("ns3::NocRoutingProtocol")
-        .SetParent<Object> ();
+        .SetParent<Object> ()
+        .AddAttribute ("DatelineVirtualChannels",
+                       "Whether the virtual channels are split into two classes, to avoid the deadlocks caused by "
+                       "the wrap-around links of a torus. A message uses the lower half of the virtual channels "
+                       "until it crosses the wrap-around link of a dimension and the upper half afterwards. "
+                       "By default, false (any virtual channel may be used).",
+                       BooleanValue (false),
+                       MakeBooleanAccessor (&NocRoutingProtocol::m_datelineVirtualChannels),
+                       MakeBooleanChecker ());
     return tid;
   }
 
@@ -66,13 +80,117 @@ namespace ns3
     ;
   }
 
+  bool
+  NocRoutingProtocol::IsVirtualChannelAllowed (Ptr<NocNetDevice> outputDevice, Ptr<const Packet> headPacket,
+      uint32_t virtualChannel, uint32_t numberOfVirtualChannels)
+  {
+    if (!m_datelineVirtualChannels || numberOfVirtualChannels < 2)
+      {
+        return true;
+      }
+
+    int dimension = outputDevice->GetRoutingDimension ();
+    NS_ASSERT_MSG (dimension >= 0, "The net device " << outputDevice->GetAddress () << " has no routing dimension");
+    NocHeader header;
+    headPacket->PeekHeader (header);
+    NS_ASSERT_MSG (!header.IsEmpty (), "The packet with UID " << headPacket->GetUid () << " is not a head packet");
+    // the offset was already decremented for the hop made through the output net device
+    uint32_t remainingHops = header.GetOffset (dimension) + 1;
+    NS_ASSERT (outputDevice->GetContext () != 0);
+    Ptr<NocTopology> topology = outputDevice->GetContext ()->GetTopology ();
+    uint32_t size = topology->GetDimensionSize (dimension);
+    uint32_t coordinate = topology->GetNodeCoordinates (outputDevice->GetNode ()->GetId ())[dimension];
+
+    bool crossesDateline;
+    if (outputDevice->GetRoutingDirection () == FORWARD)
+      {
+        crossesDateline = coordinate + remainingHops >= size;
+      }
+    else
+      {
+        crossesDateline = coordinate < remainingHops;
+      }
+    bool lowerClass = virtualChannel < numberOfVirtualChannels / 2;
+    return crossesDateline == lowerClass;
+  }
+
+  void
+  NocRoutingProtocol::DoDispose ()
+  {
+    m_routingTable = 0;
+    m_packetSourceNetDevices.clear ();
+    m_packetDestinationNetDevices.clear ();
+    Object::DoDispose ();
+  }
+
+  bool
+  NocRoutingProtocol::GetDimensionOrder (std::vector<uint32_t> &order) const
+  {
+    return false;
+  }
+
+  void
+  NocRoutingProtocol::SetRoutingTable (Ptr<NocRoutingTable> routingTable)
+  {
+    m_routingTable = routingTable;
+  }
+
+  Ptr<NocRoutingTable>
+  NocRoutingProtocol::GetRoutingTable () const
+  {
+    return m_routingTable;
+  }
+
+  Route
+  NocRoutingProtocol::RequestRouteFromTable (const Ptr<NocNetDevice> source, const Ptr<NocNode> destination,
+      Ptr<Packet> packet)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+    NS_ASSERT (m_routingTable != 0);
+
+    NocRoutingTable::Entry entry;
+    if (!m_routingTable->Lookup (source->GetNode ()->GetId (), destination->GetId (), entry))
+      {
+        NS_LOG_WARN ("No routing needs to be performed!");
+        return Route ();
+      }
+
+    NocHeader nocHeader;
+    packet->RemoveHeader (nocHeader);
+    NS_ASSERT_MSG (nocHeader.HasForwardDirection (entry.m_dimension) == (entry.m_direction == FORWARD),
+        "The header of packet " << packet->GetUid () << " and the routing table disagree on the direction of dimension "
+        << entry.m_dimension);
+    nocHeader.DecrementOffset (entry.m_dimension);
+    packet->AddHeader (nocHeader);
+
+    NS_ASSERT (entry.m_outputDevice != 0);
+    NS_ASSERT (entry.m_destinationDevice != 0);
+    NS_LOG_DEBUG ("The routing table forwards the packet in dimension " << entry.m_dimension
+        << (entry.m_direction == FORWARD ? " forward" : " back"));
+
+    return Route (packet, entry.m_outputDevice, entry.m_destinationDevice);
+  }
+
+  int
+  NocRoutingProtocol::GetNeighborLoad (Ptr<NocRouter> router, Ptr<NocNetDevice> device) const
+  {
+    NS_ASSERT (router != 0);
+    Ptr<NocSimulationContext> context = router->GetContext ();
+    NocLoadSideBand *sideBand = context != 0 ? context->GetLoadSideBand () : 0;
+    if (sideBand != 0)
+      {
+        return sideBand->GetNeighborLoad (device);
+      }
+    return router->GetNeighborLoad (device);
+  }
+
   std::string
   NocRoutingProtocol::GetName () const
   {
    return m_name;
   }
 
-  Ptr<Route>
+  Route
   NocRoutingProtocol::RequestRoute (const Ptr<NocNetDevice> source,
       const Ptr<NocNode> destination, Ptr<Packet> packet)
   {
@@ -104,34 +222,40 @@ namespace ns3
 //        m_dataPacketsRouted = 0;
 //        NS_LOG_DEBUG ("After this head packet is routed, " << m_dataPacketsToBeRouted
 //            << " data packets are still expected to be routed");
-        Ptr<Route> route = RequestNewRoute(source, destination, packet);
-        m_packetSourceNetDevices.erase (packet->GetUid ());
-        m_packetSourceNetDevices
-          .insert(std::pair<uint32_t, Ptr<NocNetDevice> > (packet->GetUid (), m_sourceNetDevice));
-        NS_ASSERT (m_packetSourceNetDevices[packet->GetUid ()] != 0);
-        m_packetDestinationNetDevices.erase (packet->GetUid ());
-        m_packetDestinationNetDevices
-          .insert(std::pair<uint32_t, Ptr<NocNetDevice> > (packet->GetUid (), m_destinationNetDevice));
-        NS_ASSERT (m_packetDestinationNetDevices[packet->GetUid ()] != 0);
+        Route route = RequestNewRoute(source, destination, packet);
+        NS_ASSERT_MSG (route.IsValid (), "No route was found for the head packet " << packet->GetUid ());
+        // the data packets follow the route of their head packet
+        if (tag.GetDataFlitCount () > 0)
+          {
+            m_packetSourceNetDevices[packet->GetUid ()] = route.GetSourceDevice ();
+            m_packetDestinationNetDevices[packet->GetUid ()] = route.GetDestinationDevice ();
+          }
         return route;
       }
     else
       {
         // data (body) packet
         NocPacketTag tag;
-        packet->PeekPacketTag(tag);
+        packet->PeekPacketTag (tag);
         NS_LOG_DEBUG ("A route was requested for the data packet " << *packet << " (head packet UID "
             << (int) tag.GetPacketHeadUid () << " ; current net device is "
             << source->GetAddress ()  << " ; current node is " << source->GetNode ()->GetId ()
             << " ; destination node is " << destination->GetId () << ")");
-        Ptr<NocNetDevice> sourceDevice = m_packetSourceNetDevices[tag.GetPacketHeadUid ()];
-        Ptr<NocNetDevice> destinationDevice = m_packetDestinationNetDevices[tag.GetPacketHeadUid ()];
-        NS_ASSERT (sourceDevice != 0);
-        NS_ASSERT (destinationDevice != 0);
+        std::map<uint32_t, NocNetDevice *>::iterator sourceDevice = m_packetSourceNetDevices.find (tag.GetPacketHeadUid ());
+        std::map<uint32_t, NocNetDevice *>::iterator destinationDevice = m_packetDestinationNetDevices.find (tag.GetPacketHeadUid ());
+        NS_ASSERT_MSG (sourceDevice != m_packetSourceNetDevices.end (), "No route is known for the head packet " << tag.GetPacketHeadUid ());
+        NS_ASSERT (destinationDevice != m_packetDestinationNetDevices.end ());
+        Route route (packet, sourceDevice->second, destinationDevice->second);
+        if (NocPacket::TAIL == tag.GetPacketType ())
+          {
+            // the route of a message is forgotten after its last packet passed
+            m_packetSourceNetDevices.erase (sourceDevice);
+            m_packetDestinationNetDevices.erase (destinationDevice);
+          }
 //        m_dataPacketsRouted++;
 //        NS_LOG_DEBUG (m_dataPacketsRouted << " were routed. Still expecting "
 //            << (m_dataPacketsToBeRouted - m_dataPacketsRouted) << " data packets");
-        return CreateObject<Route> (packet, sourceDevice, destinationDevice);
+        return route;
       }
   }
 
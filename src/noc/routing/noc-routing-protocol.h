@@ -32,6 +32,7 @@
 #include "ns3/noc-net-device.h"
 #include "ns3/route.h"
 #include <map>
+#include <vector>
 
 namespace ns3
 {
@@ -39,6 +40,8 @@ namespace ns3
   class NocNode;
   class NocNetDevice;
   class Route;
+  class NocRoutingTable;
+  class NocRouter;
 
   /**
    *
@@ -70,15 +73,18 @@ namespace ns3
 
     /**
      * Request routing information, all packets must go through this request.
+     * Routing a packet allocates nothing, and the head packets of different messages may be routed
+     * in any order: the only state kept by the protocol is the route of every message
+     * (which is used by its data packets).
      *
      *
-     * \return the Route or NULL if no route was found
+     * \return the Route (not valid if no route was found)
      * \param source        source NoC net device
      * \param destination   destination NoC node
      * \param packet        the packet to be resolved (needed the whole packet, because
      *                      routing information is added as tags or headers)
      */
-    virtual Ptr<Route>
+    virtual Route
     RequestRoute (const Ptr<NocNetDevice> source, const Ptr<NocNode> destination, Ptr<Packet> packet);
 
     /**
@@ -87,32 +93,98 @@ namespace ns3
     std::string
     GetName () const;
 
+    /**
+     * Deterministic, dimension order routing protocols can be replaced by a routing table (see NocRoutingTable).
+     * Such protocols must override this method.
+     *
+     * \param order in what order the dimensions are routed (set only if true is returned)
+     *
+     * \return true if this protocol routes the dimensions in a fixed order (false by default)
+     */
+    virtual bool
+    GetDimensionOrder (std::vector<uint32_t> &order) const;
+
+    /**
+     * Sets the routing table which is used to route the head packets (instead of computing every route).
+     * The table must be built for the dimension order of this protocol.
+     *
+     * \param routingTable the routing table (NULL disables the table lookups)
+     */
+    void
+    SetRoutingTable (Ptr<NocRoutingTable> routingTable);
+
+    /**
+     * \return the routing table used by this protocol (NULL if the routes are computed)
+     */
+    Ptr<NocRoutingTable>
+    GetRoutingTable () const;
+
+    /**
+     * Restricts the virtual channels of the next router which a message may use (virtual channel classes).
+     * This is how a routing protocol keeps the routes deadlock free, when virtual channels are used.
+     *
+     * By default, any virtual channel is allowed, unless the DatelineVirtualChannels attribute is set
+     * (see the dateline scheme from W. J. Dally and B. Towles, Principles and Practices of Interconnection Networks).
+     * Adaptive routing protocols may override this method with their own classes.
+     *
+     * \param outputDevice the net device through which the message leaves the current router
+     * \param headPacket the (routed) head packet of the message
+     * \param virtualChannel a virtual channel of the next router
+     * \param numberOfVirtualChannels how many virtual channels the next router has
+     *
+     * \return whether the message may use the virtual channel
+     */
+    virtual bool
+    IsVirtualChannelAllowed (Ptr<NocNetDevice> outputDevice, Ptr<const Packet> headPacket, uint32_t virtualChannel,
+        uint32_t numberOfVirtualChannels);
+
   protected:
 
+    virtual void
+    DoDispose ();
+
     /**
      * Whenever we encounter a new head packet we call this method. Otherwise, for data packets,
      * we use the same route that we used for the previous head packet.
      *
-     * \return the Route or NULL if no route was found
+     * \return the Route (not valid if no route was found)
      * \param source        source NoC net device
      * \param destination   destination NoC node
      * \param packet        the packet to be resolved (needed the whole packet, because
      *                      routing information is added as tags or headers)
      */
-    virtual Ptr<Route>
+    virtual Route
     RequestNewRoute (const Ptr<NocNetDevice> source, const Ptr<NocNode> destination, Ptr<Packet> packet) = 0;
 
     /**
-     * the net device which is the source of the transmission
-     * (as determined by the specific implementation of the routing protocol)
+     * Routes a head packet with a lookup in the routing table. The offsets from the header of the packet
+     * are updated just like when the route is computed.
+     *
+     * \return the Route (not valid if no routing needs to be performed)
+     * \param source        source NoC net device
+     * \param destination   destination NoC node
+     * \param packet        the head packet
      */
-    Ptr<NocNetDevice> m_sourceNetDevice;
+    Route
+    RequestRouteFromTable (const Ptr<NocNetDevice> source, const Ptr<NocNode> destination, Ptr<Packet> packet);
 
     /**
-     * the net device which is the destination of the transmission
-     * (as determined by the specific implementation of the routing protocol)
+     * Retrieves the load of the neighbor router which is reached through a net device. The load is read
+     * from the load side-band of the NoC (see NocLoadSideBand) or, if there is no side-band, it is the load
+     * which the router received with the head flits (see NocRouter::GetNeighborLoad).
+     *
+     * \param router the router which owns the net device
+     * \param device the net device
+     *
+     * \return the load of the neighbor router
      */
-    Ptr<NocNetDevice> m_destinationNetDevice;
+    int
+    GetNeighborLoad (Ptr<NocRouter> router, Ptr<NocNetDevice> device) const;
+
+    /**
+     * the routing table (if the routes are not computed)
+     */
+    Ptr<NocRoutingTable> m_routingTable;
 
     /**
      * the number of data packets routed since the last head packet was routed
@@ -130,9 +202,21 @@ namespace ns3
      */
     std::string m_name;
 
-    std::map<uint32_t, Ptr<NocNetDevice> > m_packetSourceNetDevices;
+    /**
+     * whether the virtual channels are split in two classes, by the dateline of each torus dimension
+     */
+    bool m_datelineVirtualChannels;
+
+    /**
+     * the net device which sends the packets of a message, by the UID of its head packet
+     * (a message is kept from its head packet until its tail packet is routed)
+     */
+    std::map<uint32_t, NocNetDevice *> m_packetSourceNetDevices;
 
-    std::map<uint32_t, Ptr<NocNetDevice> > m_packetDestinationNetDevices;
+    /**
+     * the net device which receives the packets of a message, by the UID of its head packet
+     */
+    std::map<uint32_t, NocNetDevice *> m_packetDestinationNetDevices;
   };
 
 } // namespace ns3
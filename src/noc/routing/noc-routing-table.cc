@@ -0,0 +1,175 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-routing-table.h"
+#include "ns3/log.h"
+#include "ns3/noc-topology.h"
+#include "ns3/noc-routing-protocol.h"
+#include "ns3/noc-header.h"
+
+NS_LOG_COMPONENT_DEFINE ("NocRoutingTable");
+
+namespace ns3
+{
+
+  NS_OBJECT_ENSURE_REGISTERED (NocRoutingTable);
+
+  TypeId
+  NocRoutingTable::GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::NocRoutingTable")
+        .SetParent<Object> ()
+        .AddConstructor<NocRoutingTable> ();
+    return tid;
+  }
+
+  NocRoutingTable::NocRoutingTable ()
+    : m_dimensions (0)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+  }
+
+  NocRoutingTable::~NocRoutingTable ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+  }
+
+  void
+  NocRoutingTable::DoDispose ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    m_devices.clear ();
+    Object::DoDispose ();
+  }
+
+  void
+  NocRoutingTable::Build (Ptr<NocTopology> topology, const std::vector<uint32_t> &dimensionOrder)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+    NS_ASSERT (topology != 0);
+
+    m_dimensions = topology->GetNumberOfDimensions ();
+    m_dimensionOrder = dimensionOrder;
+    m_dimensionSizes.resize (m_dimensions);
+    uint32_t numberOfNodes = 1;
+    for (uint32_t k = 0; k < m_dimensions; ++k)
+      {
+        m_dimensionSizes[k] = topology->GetDimensionSize (k);
+        numberOfNodes *= m_dimensionSizes[k];
+      }
+    for (uint32_t i = 0; i < m_dimensionOrder.size (); ++i)
+      {
+        NS_ASSERT_MSG (m_dimensionOrder[i] < m_dimensions, "Cannot route dimension " << m_dimensionOrder[i]
+            << " in a topology with " << m_dimensions << " dimensions");
+      }
+
+    m_coordinates.resize (numberOfNodes * m_dimensions);
+    for (uint32_t id = 0; id < numberOfNodes; ++id)
+      {
+        const uint32_t *coordinates = topology->GetNodeCoordinates (id);
+        for (uint32_t k = 0; k < m_dimensions; ++k)
+          {
+            m_coordinates[id * m_dimensions + k] = coordinates[k];
+          }
+      }
+
+    // the topology knows in which direction a packet goes, in every dimension (e.g. a torus uses the shortest way)
+    // the direction depends only on the difference between the two coordinates
+    m_directionOffsets.resize (m_dimensions);
+    m_directions.clear ();
+    for (uint32_t k = 0; k < m_dimensions; ++k)
+      {
+        uint32_t size = m_dimensionSizes[k];
+        m_directionOffsets[k] = m_directions.size ();
+        m_directions.resize (m_directions.size () + 2 * size - 1, NocRoutingProtocol::NONE);
+        for (uint32_t d = 0; d < 2 * size - 1; ++d)
+          {
+            // the difference is d - (size - 1)
+            uint32_t a = d < size - 1 ? size - 1 - d : 0;
+            uint32_t b = a + d - (size - 1);
+            NocCoordinate relative = topology->GetRelativeCoordinate (k, a, b);
+            if ((relative & NocHeader::OFFSET_BIT_MASK) != 0)
+              {
+                m_directions[m_directionOffsets[k] + d] =
+                    (relative & NocHeader::DIRECTION_BIT_MASK) ? NocRoutingProtocol::BACK : NocRoutingProtocol::FORWARD;
+              }
+          }
+      }
+
+    m_devices.clear ();
+    m_devices.resize (numberOfNodes * m_dimensions * 2);
+    for (uint32_t id = 0; id < numberOfNodes; ++id)
+      {
+        for (uint32_t k = 0; k < m_dimensions; ++k)
+          {
+            m_devices[(id * m_dimensions + k) * 2] = topology->GetNetDevice (id, NocRoutingProtocol::FORWARD, k);
+            m_devices[(id * m_dimensions + k) * 2 + 1] = topology->GetNetDevice (id, NocRoutingProtocol::BACK, k);
+          }
+      }
+
+    NS_LOG_INFO ("Built a routing table for " << numberOfNodes << " nodes and " << m_dimensions
+        << " dimensions (" << GetMemoryUsage () << " bytes)");
+  }
+
+  const std::vector<uint32_t> &
+  NocRoutingTable::GetDimensionOrder () const
+  {
+    return m_dimensionOrder;
+  }
+
+  bool
+  NocRoutingTable::Lookup (uint32_t routerNodeId, uint32_t destinationNodeId, Entry &entry) const
+  {
+    NS_ASSERT_MSG ((routerNodeId + 1) * m_dimensions <= m_coordinates.size ()
+        && (destinationNodeId + 1) * m_dimensions <= m_coordinates.size (),
+        "The routing table has no entry for router " << routerNodeId << " and destination " << destinationNodeId);
+    const uint32_t *router = &m_coordinates[routerNodeId * m_dimensions];
+    const uint32_t *destination = &m_coordinates[destinationNodeId * m_dimensions];
+    for (uint32_t i = 0; i < m_dimensionOrder.size (); ++i)
+      {
+        uint32_t k = m_dimensionOrder[i];
+        if (router[k] != destination[k])
+          {
+            int direction = m_directions[m_directionOffsets[k] + destination[k] + m_dimensionSizes[k] - 1 - router[k]];
+            NS_ASSERT (direction != NocRoutingProtocol::NONE);
+            entry.m_direction = direction;
+            entry.m_dimension = k;
+            uint32_t back = direction == NocRoutingProtocol::BACK ? 1 : 0;
+            entry.m_outputDevice = PeekPointer (m_devices[(routerNodeId * m_dimensions + k) * 2 + back]);
+            entry.m_destinationDevice = PeekPointer (m_devices[(destinationNodeId * m_dimensions + k) * 2 + 1 - back]);
+            return true;
+          }
+      }
+    return false;
+  }
+
+  uint64_t
+  NocRoutingTable::GetMemoryUsage () const
+  {
+    return m_dimensionOrder.size () * sizeof (uint32_t) + m_dimensionSizes.size () * sizeof (uint32_t)
+        + m_directionOffsets.size () * sizeof (uint32_t) + m_directions.size () * sizeof (uint8_t)
+        + m_coordinates.size () * sizeof (uint32_t) + m_devices.size () * sizeof (Ptr<NocNetDevice>);
+  }
+
+} // namespace ns3
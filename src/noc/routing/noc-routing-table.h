@@ -0,0 +1,172 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCROUTINGTABLE_H_
+#define NOCROUTINGTABLE_H_
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include <vector>
+
+namespace ns3
+{
+
+  class NocTopology;
+
+  class NocNetDevice;
+
+  /**
+   * \brief Compiled routing table for deterministic, dimension order routing
+   *
+   * \detail A routing table maps a (router, destination node) pair to the routing direction and dimension
+   *         of the next hop, and to the net devices used for it. It is built once, when the topology is installed,
+   *         from the dimension order of a routing protocol (see NocRoutingProtocol::GetDimensionOrder).
+   *
+   *         The table is not kept as a (router, destination) matrix. Dimension order routing forwards a packet
+   *         in the first dimension (in routing order) in which the router and the destination have different
+   *         coordinates, and the routing direction depends only on the difference between these two coordinates
+   *         (see NocTopology::GetRelativeCoordinate). Therefore, the table keeps one small direction vector for
+   *         each dimension (2n - 1 elements for a dimension with n nodes),
+   *         the coordinates of the nodes and the output net device of every node, for each direction and dimension.
+   *         A lookup takes at most one direction load for every dimension and two net device loads.
+   */
+  class NocRoutingTable : public Object
+  {
+  public:
+
+    /**
+     * The routing decision taken for a head packet
+     */
+    struct Entry
+    {
+      /**
+       * the routing direction (see NocRoutingProtocol::RoutingDirection)
+       */
+      int m_direction;
+
+      /**
+       * the routing dimension
+       */
+      uint32_t m_dimension;
+
+      /**
+       * the net device through which the router forwards the packet
+       */
+      NocNetDevice *m_outputDevice;
+
+      /**
+       * the net device of the destination node, for the opposite direction of the same dimension
+       * (the address of this net device is used as the destination address of the packet)
+       */
+      NocNetDevice *m_destinationDevice;
+    };
+
+    static TypeId
+    GetTypeId ();
+
+    NocRoutingTable ();
+
+    virtual
+    ~NocRoutingTable ();
+
+    /**
+     * Builds the routing table for the specified (installed) topology.
+     *
+     * \param topology the NoC topology
+     * \param dimensionOrder in what order the dimensions are routed
+     */
+    void
+    Build (Ptr<NocTopology> topology, const std::vector<uint32_t> &dimensionOrder);
+
+    /**
+     * \return the dimension order for which this table was built
+     */
+    const std::vector<uint32_t> &
+    GetDimensionOrder () const;
+
+    /**
+     * Looks up the routing decision for a head packet.
+     *
+     * \param routerNodeId the ID of the node where the packet is routed
+     * \param destinationNodeId the ID of the destination node of the packet
+     * \param entry the routing decision (set only if true is returned)
+     *
+     * \return false if the packet is already at its destination (no routing needs to be performed)
+     */
+    bool
+    Lookup (uint32_t routerNodeId, uint32_t destinationNodeId, Entry &entry) const;
+
+    /**
+     * \return the memory used by this table, in bytes
+     */
+    uint64_t
+    GetMemoryUsage () const;
+
+  protected:
+
+    virtual void
+    DoDispose ();
+
+  private:
+
+    /**
+     * how many dimensions the topology has
+     */
+    uint32_t m_dimensions;
+
+    /**
+     * in what order the dimensions are routed
+     */
+    std::vector<uint32_t> m_dimensionOrder;
+
+    /**
+     * the number of nodes from every dimension
+     */
+    std::vector<uint32_t> m_dimensionSizes;
+
+    /**
+     * where the directions of every dimension start, in m_directions
+     */
+    std::vector<uint32_t> m_directionOffsets;
+
+    /**
+     * the directions: for dimension k, element (b - a + size of k - 1) is the direction used to go
+     * from coordinate a to coordinate b (it depends only on the difference between the coordinates)
+     */
+    std::vector<uint8_t> m_directions;
+
+    /**
+     * the coordinates of the nodes (node ID * number of dimensions + dimension)
+     */
+    std::vector<uint32_t> m_coordinates;
+
+    /**
+     * the net devices, by node ID, dimension and direction ((node ID * number of dimensions + dimension) * 2 + (direction == BACK))
+     */
+    std::vector<Ptr<NocNetDevice> > m_devices;
+
+  };
+
+} // namespace ns3
+
+#endif /* NOCROUTINGTABLE_H_ */
@@ -23,6 +23,7 @@
 #include "ns3/noc-header.h"
 #include "ns3/noc-packet-tag.h"
 #include "ns3/noc-channel.h"
+#include "ns3/noc-simulation-context.h"
 #include "ns3/random-variable.h"
 #include "ns3/integer.h"
 #include <vector>
@@ -94,7 +95,7 @@ namespace ns3
     m_loadThreshold = loadThreshold;
   }
 
-  Ptr<Route>
+  Route
   SlbRouting::RequestNewRoute (const Ptr<NocNetDevice> source, const Ptr<NocNode> destination, Ptr<Packet> packet)
   {
     NS_LOG_FUNCTION_NOARGS ();
@@ -112,44 +113,42 @@ namespace ns3
     Ptr<NocNetDevice> selectedDevice = DoSelectionFunction(devices, source, destination, packet);
     UpdateHeader (packet, selectedDevice, source);
 
-    m_sourceNetDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->
+    Ptr<NocNetDevice> sourceDevice = source->GetNode ()->GetObject<NocNode> ()->GetRouter ()->
         GetOutputNetDevice(source, selectedDevice->GetRoutingDirection (), selectedDevice->GetRoutingDimension ());
-    NS_ASSERT(m_sourceNetDevice != 0);
-    m_destinationNetDevice = destination->GetRouter ()-> GetInputNetDevice (m_sourceNetDevice,
+    NS_ASSERT(sourceDevice != 0);
+    Ptr<NocNetDevice> destinationDevice = destination->GetRouter ()-> GetInputNetDevice (sourceDevice,
         NocRoutingProtocol::GetOpositeRoutingDirection (selectedDevice->GetRoutingDirection ()),
         selectedDevice->GetRoutingDimension ());
 
     // ensure that we find the opposite net device at the destination node
-    if (m_destinationNetDevice == 0)
+    if (destinationDevice == 0)
       {
-        m_destinationNetDevice = destination->GetRouter ()-> GetInputNetDevice (m_sourceNetDevice,
+        destinationDevice = destination->GetRouter ()-> GetInputNetDevice (sourceDevice,
             NocRoutingProtocol::GetOpositeRoutingDirection (NocRoutingProtocol::FORWARD), 1);
-        if (m_destinationNetDevice == 0)
+        if (destinationDevice == 0)
           {
-            m_destinationNetDevice = destination->GetRouter ()-> GetInputNetDevice (m_sourceNetDevice,
+            destinationDevice = destination->GetRouter ()-> GetInputNetDevice (sourceDevice,
                 NocRoutingProtocol::GetOpositeRoutingDirection (NocRoutingProtocol::FORWARD), 0);
-            if (m_destinationNetDevice == 0)
+            if (destinationDevice == 0)
               {
-                m_destinationNetDevice = destination->GetRouter ()-> GetInputNetDevice (m_sourceNetDevice,
+                destinationDevice = destination->GetRouter ()-> GetInputNetDevice (sourceDevice,
                     NocRoutingProtocol::GetOpositeRoutingDirection (NocRoutingProtocol::BACK), 1);
-                if (m_destinationNetDevice == 0)
+                if (destinationDevice == 0)
                   {
-                    m_destinationNetDevice = destination->GetRouter ()-> GetInputNetDevice (m_sourceNetDevice,
+                    destinationDevice = destination->GetRouter ()-> GetInputNetDevice (sourceDevice,
                         NocRoutingProtocol::GetOpositeRoutingDirection (NocRoutingProtocol::BACK), 0);
                   }
               }
           }
       }
 
-    NS_ASSERT(m_destinationNetDevice != 0);
-    NS_LOG_DEBUG ("Found source net device " << m_sourceNetDevice->GetAddress ()
+    NS_ASSERT(destinationDevice != 0);
+    NS_LOG_DEBUG ("Found source net device " << sourceDevice->GetAddress ()
         << " (packet UID " << packet->GetUid () << ")");
-    NS_LOG_DEBUG ("Found destination net device " << m_destinationNetDevice->GetAddress ()
+    NS_LOG_DEBUG ("Found destination net device " << destinationDevice->GetAddress ()
         << " (packet UID " << packet->GetUid () << ")");
 
-    Ptr<Route> route = CreateObject<Route> (packet, m_sourceNetDevice, m_destinationNetDevice);
-
-    return route;
+    return Route (packet, sourceDevice, destinationDevice);
   }
 
   std::vector<Ptr<NocNetDevice> >
@@ -240,7 +239,7 @@ namespace ns3
 
     // loaded directions are bad
     Ptr<NocRouter> router = device->GetNode ()->GetObject<NocNode> ()->GetRouter ();
-    if (router->GetNeighborLoad (device) > m_loadThreshold)
+    if (GetNeighborLoad (router, device) > m_loadThreshold)
       {
         value += m_loadWeight;
         NS_LOG_DEBUG ("Net device " << device->GetAddress ()
@@ -385,7 +384,8 @@ namespace ns3
 
     Ptr<NocRouter> router = source->GetNode ()->GetObject<NocNode> ()->GetRouter ();
     Ptr<LoadRouterComponent> loadComponent = router->GetLoadRouterComponent ();
-    if (loadComponent != 0)
+    // with a load side-band, the load does not travel with the head flits
+    if (loadComponent != 0 && (router->GetContext () == 0 || router->GetContext ()->GetLoadSideBand () == 0))
       {
         int load = loadComponent->GetLoadForDirection (packet, source, device);
         NS_ASSERT_MSG (load >= 0 && load <= 100, "The load of a router must be a percentage number ("
@@ -50,7 +50,7 @@ namespace ns3
     virtual
     ~SoRouting ();
 
-    virtual Ptr<Route>
+    virtual Route
     RequestNewRoute (const Ptr<NocNetDevice> source, const Ptr<NocNode> destination, Ptr<Packet> packet);
 
   private:
@@ -0,0 +1,495 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-convergence-controller.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/data-output-interface.h"
+#include <math.h>
+#include <limits>
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("NocConvergenceController");
+
+namespace ns3
+{
+
+  NS_OBJECT_ENSURE_REGISTERED (NocConvergenceController);
+
+  /**
+   * the 97.5% quantiles of the Student t distribution, by degrees of freedom (1 .. 30)
+   */
+  static const double STUDENT_T_975[] =
+    { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+      2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+      2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+
+  static double
+  GetStudentT975 (uint32_t degreesOfFreedom)
+  {
+    NS_ASSERT (degreesOfFreedom > 0);
+    if (degreesOfFreedom <= 30)
+      {
+        return STUDENT_T_975[degreesOfFreedom - 1];
+      }
+    if (degreesOfFreedom <= 60)
+      {
+        return 2.000;
+      }
+    if (degreesOfFreedom <= 120)
+      {
+        return 1.980;
+      }
+    return 1.960;
+  }
+
+  std::string
+  NocConvergenceController::StatusToString (Status status)
+  {
+    switch (status)
+      {
+      case RUNNING:
+        return "running";
+      case CONVERGED:
+        return "converged";
+      case SATURATED:
+        return "saturated";
+      case DEADLOCKED:
+        return "deadlocked";
+      default:
+        return "unknown";
+      }
+  }
+
+  TypeId
+  NocConvergenceController::GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::NocConvergenceController")
+        .SetParent<DataCalculator> ()
+        .AddConstructor<NocConvergenceController> ()
+        .AddAttribute ("BatchCycles",
+            "How many clock cycles a batch has (default is 200)",
+            UintegerValue (200),
+            MakeUintegerAccessor (&NocConvergenceController::m_batchCycles),
+            MakeUintegerChecker<uint64_t> (1))
+        .AddAttribute ("TargetRelativeWidth",
+            "The simulation converged when the half width of the 95% confidence interval of the average packet latency "
+            "is at most this fraction of the average (default is 0.05)",
+            DoubleValue (0.05),
+            MakeDoubleAccessor (&NocConvergenceController::m_targetRelativeWidth),
+            MakeDoubleChecker<double> (0))
+        .AddAttribute ("MinBatches",
+            "The minimum number of batches needed to detect the end of the warmup and the convergence (default is 10)",
+            UintegerValue (10),
+            MakeUintegerAccessor (&NocConvergenceController::m_minBatches),
+            MakeUintegerChecker<uint32_t> (2))
+        .AddAttribute ("MaxBatches",
+            "When this many batches are measured, adjacent batches are merged (default is 64)",
+            UintegerValue (64),
+            MakeUintegerAccessor (&NocConvergenceController::m_maxBatches),
+            MakeUintegerChecker<uint32_t> (4))
+        .AddAttribute ("DeadlockBatches",
+            "The network is deadlocked if no flit is received for this many batches, while packets are in flight (default is 10)",
+            UintegerValue (10),
+            MakeUintegerAccessor (&NocConvergenceController::m_deadlockBatches),
+            MakeUintegerChecker<uint32_t> (1))
+        .AddAttribute ("SaturationFactor",
+            "The network is saturated if the average latency of the last quarter of the batches is this many times "
+            "bigger than the one of the second quarter (default is 2)",
+            DoubleValue (2),
+            MakeDoubleAccessor (&NocConvergenceController::m_saturationFactor),
+            MakeDoubleChecker<double> (1))
+        .AddAttribute ("StopSimulation",
+            "Whether or not the simulation is stopped when it converged, or when the network is saturated "
+            "or deadlocked (default is true)",
+            BooleanValue (true),
+            MakeBooleanAccessor (&NocConvergenceController::m_stopSimulation),
+            MakeBooleanChecker ())
+        ;
+    return tid;
+  }
+
+  NocConvergenceController::NocConvergenceController ()
+  {
+    m_batchCycles = 200;
+    m_targetRelativeWidth = 0.05;
+    m_minBatches = 10;
+    m_maxBatches = 64;
+    m_deadlockBatches = 10;
+    m_saturationFactor = 2;
+    m_stopSimulation = true;
+    m_collector = 0;
+    m_clock = 0;
+    m_status = RUNNING;
+    m_warmupEnded = false;
+    m_warmupCycles = 0;
+    m_cycles = 0;
+    m_currentBatch.m_latencySum = 0;
+    m_currentBatch.m_packets = 0;
+    m_intervalsPerBatch = 1;
+    m_intervals = 0;
+    m_receivedFlits = 0;
+    m_flitsReceived = false;
+    m_idleIntervals = 0;
+    m_latencyMean = 0;
+    m_latencyHalfWidth = std::numeric_limits<double>::infinity ();
+  }
+
+  NocConvergenceController::~NocConvergenceController ()
+  {
+    ;
+  }
+
+  void
+  NocConvergenceController::DoDispose ()
+  {
+    Simulator::Cancel (m_intervalEvent);
+    m_collector = 0;
+    m_warmupBatches.clear ();
+    m_batches.clear ();
+    DataCalculator::DoDispose ();
+  }
+
+  void
+  NocConvergenceController::Install (Ptr<NocStatsCollector> collector)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+    NS_ASSERT (collector != 0);
+    NS_ASSERT_MSG (collector->GetGlobalClock () > 0, "The statistics collector must be installed first");
+
+    m_collector = collector;
+    m_clock = collector->GetGlobalClock ();
+    m_collector->TraceConnectWithoutContext ("PacketLatency",
+        MakeCallback (&NocConvergenceController::PacketLatency, this));
+    m_intervalEvent = Simulator::Schedule (PicoSeconds (m_batchCycles * m_clock),
+        &NocConvergenceController::EndInterval, this);
+  }
+
+  void
+  NocConvergenceController::PacketLatency (double latency)
+  {
+    m_currentBatch.m_latencySum += latency;
+    m_currentBatch.m_packets++;
+  }
+
+  uint64_t
+  NocConvergenceController::GetCurrentCycle () const
+  {
+    return Simulator::Now ().GetPicoSeconds () / m_clock;
+  }
+
+  void
+  NocConvergenceController::EndInterval ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    if (!m_enabled || m_status != RUNNING)
+      {
+        return;
+      }
+
+    uint64_t receivedFlits = m_collector->GetReceivedFlits ();
+    if (receivedFlits == m_receivedFlits)
+      {
+        m_idleIntervals++;
+        // an idle network (e.g. a bursty or finished traffic source) is not deadlocked
+        if (m_flitsReceived && m_idleIntervals >= m_deadlockBatches && m_collector->GetInFlightPackets () > 0)
+          {
+            NS_LOG_INFO ("No flit was received during the last " << m_idleIntervals * m_batchCycles
+                << " cycles, while " << m_collector->GetInFlightPackets () << " packets are in flight");
+            Stop (DEADLOCKED);
+            return;
+          }
+      }
+    else
+      {
+        m_idleIntervals = 0;
+        m_flitsReceived = true;
+      }
+    m_receivedFlits = receivedFlits;
+
+    if (!m_warmupEnded)
+      {
+        m_intervals++;
+        if (m_intervals == m_intervalsPerBatch)
+          {
+            if (m_currentBatch.m_packets > 0)
+              {
+                m_warmupBatches.push_back (m_currentBatch);
+              }
+            m_currentBatch.m_latencySum = 0;
+            m_currentBatch.m_packets = 0;
+            m_intervals = 0;
+
+            if (DetectWarmupEnd ())
+              {
+                m_warmupEnded = true;
+                m_warmupCycles = GetCurrentCycle ();
+                NS_LOG_INFO ("The warmup ended at cycle " << m_warmupCycles);
+                m_warmupBatches.clear ();
+                m_collector->SetWarmupCycles (m_warmupCycles);
+                m_receivedFlits = 0;
+                // the measurement starts with batches of BatchCycles cycles
+                m_intervalsPerBatch = 1;
+              }
+            else if (IsSaturated (GetBatchMeans (m_warmupBatches)))
+              {
+                Stop (SATURATED);
+                return;
+              }
+            else if (m_warmupBatches.size () >= std::max (m_maxBatches, 4 * m_minBatches))
+              {
+                // the MSER rule needs at least 2 MinBatches batches, so that many are kept after merging
+                MergeBatches (m_warmupBatches);
+              }
+          }
+      }
+    else
+      {
+        m_intervals++;
+        if (m_intervals == m_intervalsPerBatch)
+          {
+            if (m_currentBatch.m_packets > 0)
+              {
+                m_batches.push_back (m_currentBatch);
+              }
+            m_currentBatch.m_latencySum = 0;
+            m_currentBatch.m_packets = 0;
+            m_intervals = 0;
+
+            if (m_batches.size () >= m_maxBatches)
+              {
+                // fewer but longer (less correlated) batches
+                MergeBatches (m_batches);
+              }
+
+            UpdateConfidenceInterval ();
+            if (m_batches.size () >= m_minBatches && m_latencyMean > 0
+                && m_latencyHalfWidth <= m_targetRelativeWidth * m_latencyMean)
+              {
+                Stop (CONVERGED);
+                return;
+              }
+
+            if (IsSaturated (GetBatchMeans (m_batches)))
+              {
+                Stop (SATURATED);
+                return;
+              }
+          }
+      }
+
+    m_intervalEvent = Simulator::Schedule (PicoSeconds (m_batchCycles * m_clock),
+        &NocConvergenceController::EndInterval, this);
+  }
+
+  void
+  NocConvergenceController::MergeBatches (std::vector<Batch> &batches)
+  {
+    NS_ASSERT (m_intervals == 0);
+
+    if (batches.size () % 2 == 1)
+      {
+        // the odd batch is carried over: it becomes the first half of the next batch
+        m_currentBatch = batches.back ();
+        m_intervals = m_intervalsPerBatch;
+        batches.pop_back ();
+      }
+    for (uint32_t i = 0; i < batches.size () / 2; i++)
+      {
+        batches[i].m_latencySum = batches[2 * i].m_latencySum + batches[2 * i + 1].m_latencySum;
+        batches[i].m_packets = batches[2 * i].m_packets + batches[2 * i + 1].m_packets;
+      }
+    batches.resize (batches.size () / 2);
+    m_intervalsPerBatch *= 2;
+    NS_LOG_LOGIC ("A batch has " << m_intervalsPerBatch * m_batchCycles << " cycles from now on");
+  }
+
+  std::vector<double>
+  NocConvergenceController::GetBatchMeans (const std::vector<Batch> &batches) const
+  {
+    std::vector<double> means;
+    means.reserve (batches.size ());
+    for (uint32_t i = 0; i < batches.size (); i++)
+      {
+        means.push_back (batches[i].m_latencySum / batches[i].m_packets);
+      }
+    return means;
+  }
+
+  bool
+  NocConvergenceController::DetectWarmupEnd () const
+  {
+    uint32_t n = m_warmupBatches.size ();
+    if (n < 2 * m_minBatches)
+      {
+        return false;
+      }
+    std::vector<double> means = GetBatchMeans (m_warmupBatches);
+
+    // suffix sums, to evaluate every truncation point in linear time
+    std::vector<double> sums (n + 1, 0);
+    std::vector<double> squareSums (n + 1, 0);
+    for (int32_t i = n - 1; i >= 0; i--)
+      {
+        sums[i] = sums[i + 1] + means[i];
+        squareSums[i] = squareSums[i + 1] + means[i] * means[i];
+      }
+
+    // at least MinBatches batches are kept
+    uint32_t bestTruncation = 0;
+    double bestMser = std::numeric_limits<double>::infinity ();
+    for (uint32_t d = 0; d + m_minBatches <= n; d++)
+      {
+        double remaining = n - d;
+        double mean = sums[d] / remaining;
+        double mser = (squareSums[d] - remaining * mean * mean) / (remaining * remaining);
+        if (mser < bestMser)
+          {
+            bestMser = mser;
+            bestTruncation = d;
+          }
+      }
+    NS_LOG_LOGIC ("MSER truncation point is batch " << bestTruncation << " of " << n);
+
+    // a truncation point from the second half means that the batch means are still drifting
+    return bestTruncation <= n / 2;
+  }
+
+  bool
+  NocConvergenceController::IsSaturated (const std::vector<double> &means) const
+  {
+    uint32_t n = means.size ();
+    if (n < 2 * m_minBatches)
+      {
+        return false;
+      }
+    double secondQuarter = 0;
+    for (uint32_t i = n / 4; i < n / 2; i++)
+      {
+        secondQuarter += means[i];
+      }
+    secondQuarter /= n / 2 - n / 4;
+    double lastQuarter = 0;
+    for (uint32_t i = n - n / 4; i < n; i++)
+      {
+        lastQuarter += means[i];
+      }
+    lastQuarter /= n / 4;
+    return lastQuarter > m_saturationFactor * secondQuarter;
+  }
+
+  void
+  NocConvergenceController::UpdateConfidenceInterval ()
+  {
+    uint32_t n = m_batches.size ();
+    if (n == 0)
+      {
+        return;
+      }
+    double sum = 0;
+    double squareSum = 0;
+    for (uint32_t i = 0; i < n; i++)
+      {
+        double mean = m_batches[i].m_latencySum / m_batches[i].m_packets;
+        sum += mean;
+        squareSum += mean * mean;
+      }
+    m_latencyMean = sum / n;
+    if (n < 2)
+      {
+        return;
+      }
+    double variance = (squareSum - n * m_latencyMean * m_latencyMean) / (n - 1);
+    m_latencyHalfWidth = GetStudentT975 (n - 1) * sqrt (variance > 0 ? variance : 0) / sqrt (n);
+    NS_LOG_LOGIC ("Average packet latency is " << m_latencyMean << " +/- " << m_latencyHalfWidth
+        << " cycles (" << n << " batches)");
+  }
+
+  void
+  NocConvergenceController::Stop (Status status)
+  {
+    NS_LOG_FUNCTION (StatusToString (status));
+
+    m_status = status;
+    m_cycles = GetCurrentCycle ();
+    Simulator::Cancel (m_intervalEvent);
+    NS_LOG_INFO ("The simulation " << StatusToString (status) << " after " << m_cycles << " cycles");
+    if (m_stopSimulation)
+      {
+        Simulator::Stop ();
+      }
+  }
+
+  NocConvergenceController::Status
+  NocConvergenceController::GetStatus () const
+  {
+    return m_status;
+  }
+
+  uint64_t
+  NocConvergenceController::GetWarmupCycles () const
+  {
+    return m_warmupCycles;
+  }
+
+  uint64_t
+  NocConvergenceController::GetCycles () const
+  {
+    if (m_status != RUNNING || m_clock == 0)
+      {
+        return m_cycles;
+      }
+    return GetCurrentCycle ();
+  }
+
+  double
+  NocConvergenceController::GetLatencyMean () const
+  {
+    return m_latencyMean;
+  }
+
+  double
+  NocConvergenceController::GetLatencyHalfWidth () const
+  {
+    return m_latencyHalfWidth;
+  }
+
+  void
+  NocConvergenceController::Output (DataOutputCallback &callback) const
+  {
+    callback.OutputSingleton (m_context, m_key + "-status", StatusToString (m_status));
+    callback.OutputSingleton (m_context, m_key + "-cycles", (double) GetCycles ());
+    callback.OutputSingleton (m_context, m_key + "-warmup-cycles", (double) m_warmupCycles);
+    callback.OutputSingleton (m_context, m_key + "-batches", (uint32_t) m_batches.size ());
+    callback.OutputSingleton (m_context, m_key + "-latency-average", m_latencyMean);
+    if (m_batches.size () >= 2)
+      {
+        callback.OutputSingleton (m_context, m_key + "-latency-half-width", m_latencyHalfWidth);
+      }
+  }
+
+} // namespace ns3
@@ -0,0 +1,299 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCCONVERGENCECONTROLLER_H_
+#define NOCCONVERGENCECONTROLLER_H_
+
+#include "ns3/data-calculator.h"
+#include "ns3/event-id.h"
+#include "noc-stats-collector.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+  /**
+   * \brief Detects the end of the warmup and stops the simulation when the average packet latency is known
+   *        precisely enough
+   *
+   * \detail The packet latencies measured by a NocStatsCollector are grouped in batches of BatchCycles clock cycles.
+   *
+   *         The end of the warmup is detected with the MSER rule (Marginal Standard Error Rule), applied to the batch
+   *         means: the warmup ends when truncating the first d batches minimizes the standard error of the remaining
+   *         ones, for a d from the first half of the batches. The measurement starts from that moment
+   *         (the NocStatsCollector is restarted, so only the packets injected after the warmup are measured).
+   *         The warmup batches are merged like the measurement batches (see below), when there are
+   *         MaxBatches of them, but at least 4 MinBatches.
+   *
+   *         The measurement uses the batch means method. The simulation is stopped when the half width
+   *         of the 95% confidence interval of the average packet latency, relative to the average, is at most
+   *         TargetRelativeWidth. When MaxBatches batches are measured, adjacent batches are merged
+   *         (and the next batches are twice as long), so the batches get less correlated as the run goes on.
+   *         An odd last batch is not merged; it becomes the first half of the next batch.
+   *
+   *         The simulation is also stopped when the network is saturated (the batch means keep growing:
+   *         the last quarter of the batches has an average latency SaturationFactor times bigger than the second quarter)
+   *         or deadlocked (no flit is received for DeadlockBatches batches, after flits were received,
+   *         while packets are still in flight).
+   */
+  class NocConvergenceController : public DataCalculator
+  {
+  public:
+
+    enum Status
+      {
+        /**
+         * the simulation did not converge yet
+         */
+        RUNNING,
+
+        /**
+         * the average packet latency is known with the required precision
+         */
+        CONVERGED,
+
+        /**
+         * the latency keeps growing (the injection rate is bigger than what the network accepts)
+         */
+        SATURATED,
+
+        /**
+         * no flit reaches its destination anymore
+         */
+        DEADLOCKED
+      };
+
+    static std::string
+    StatusToString (Status status);
+
+    static TypeId
+    GetTypeId ();
+
+    NocConvergenceController ();
+
+    virtual
+    ~NocConvergenceController ();
+
+    /**
+     * Starts controlling the simulation, using the statistics measured by a collector.
+     * The collector must be installed and it should have no warmup cycles (the warmup is detected by this controller).
+     *
+     * \param collector the statistics collector
+     */
+    void
+    Install (Ptr<NocStatsCollector> collector);
+
+    /**
+     * \return the status of the simulation
+     */
+    Status
+    GetStatus () const;
+
+    /**
+     * \return the clock cycle when the warmup ended (0 if the end of the warmup was not detected yet)
+     */
+    uint64_t
+    GetWarmupCycles () const;
+
+    /**
+     * \return how many clock cycles were simulated (until the simulation was stopped by the controller,
+     *         otherwise until now)
+     */
+    uint64_t
+    GetCycles () const;
+
+    /**
+     * \return the average packet latency measured after the warmup (the mean of the batch means)
+     */
+    double
+    GetLatencyMean () const;
+
+    /**
+     * \return the half width of the 95% confidence interval of the average packet latency (infinite if it is not known yet)
+     */
+    double
+    GetLatencyHalfWidth () const;
+
+    virtual void
+    Output (DataOutputCallback &callback) const;
+
+  protected:
+
+    virtual void
+    DoDispose ();
+
+  private:
+
+    /**
+     * A batch of packet latencies
+     */
+    struct Batch
+    {
+      double m_latencySum;
+
+      uint64_t m_packets;
+    };
+
+    /**
+     * The trace sink for the latencies measured by the collector
+     *
+     * \param latency the latency of a packet, in clock cycles
+     */
+    void
+    PacketLatency (double latency);
+
+    /**
+     * Invoked every BatchCycles clock cycles
+     */
+    void
+    EndInterval ();
+
+    /**
+     * Merges adjacent batches, so that the next batches are twice as long. When the number of batches
+     * is odd, the last batch is not dropped: it becomes the first half of the current batch.
+     *
+     * \param batches the batches to merge (m_warmupBatches or m_batches)
+     */
+    void
+    MergeBatches (std::vector<Batch> &batches);
+
+    /**
+     * \param batches batches of packet latencies
+     *
+     * \return the means of the batches
+     */
+    std::vector<double>
+    GetBatchMeans (const std::vector<Batch> &batches) const;
+
+    /**
+     * Applies the MSER rule to the batch means collected during the warmup
+     *
+     * \return whether or not the warmup ended
+     */
+    bool
+    DetectWarmupEnd () const;
+
+    /**
+     * \param means batch means, in the order in which they were measured
+     *
+     * \return whether or not the batch means show that the network is saturated
+     */
+    bool
+    IsSaturated (const std::vector<double> &means) const;
+
+    /**
+     * Computes the confidence interval of the average packet latency, from the measured batches
+     */
+    void
+    UpdateConfidenceInterval ();
+
+    /**
+     * Stops the simulation
+     *
+     * \param status why the simulation is stopped
+     */
+    void
+    Stop (Status status);
+
+    /**
+     * \return the current clock cycle
+     */
+    uint64_t
+    GetCurrentCycle () const;
+
+    uint64_t m_batchCycles;
+
+    double m_targetRelativeWidth;
+
+    uint32_t m_minBatches;
+
+    uint32_t m_maxBatches;
+
+    uint32_t m_deadlockBatches;
+
+    double m_saturationFactor;
+
+    bool m_stopSimulation;
+
+    Ptr<NocStatsCollector> m_collector;
+
+    /**
+     * the global clock, in picoseconds
+     */
+    int64_t m_clock;
+
+    Status m_status;
+
+    bool m_warmupEnded;
+
+    uint64_t m_warmupCycles;
+
+    uint64_t m_cycles;
+
+    /**
+     * the batches measured during the warmup (the batches without packets are skipped)
+     */
+    std::vector<Batch> m_warmupBatches;
+
+    /**
+     * the batches measured after the warmup (the batches without packets are skipped)
+     */
+    std::vector<Batch> m_batches;
+
+    Batch m_currentBatch;
+
+    /**
+     * how many intervals of BatchCycles cycles a measurement batch has
+     */
+    uint32_t m_intervalsPerBatch;
+
+    /**
+     * how many intervals the current measurement batch has so far
+     */
+    uint32_t m_intervals;
+
+    /**
+     * the number of flits received by the collector, at the end of the last interval
+     */
+    uint64_t m_receivedFlits;
+
+    bool m_flitsReceived;
+
+    /**
+     * how many consecutive intervals had no received flits
+     */
+    uint32_t m_idleIntervals;
+
+    double m_latencyMean;
+
+    double m_latencyHalfWidth;
+
+    EventId m_intervalEvent;
+
+  };
+
+} // namespace ns3
+
+#endif /* NOCCONVERGENCECONTROLLER_H_ */
@@ -0,0 +1,439 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-deadlock-detector.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/data-output-interface.h"
+#include "ns3/noc-topology.h"
+#include "ns3/noc-simulation-context.h"
+#include "ns3/noc-node.h"
+#include "ns3/noc-router.h"
+#include "ns3/noc-net-device.h"
+#include "ns3/noc-packet-tag.h"
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE ("NocDeadlockDetector");
+
+namespace ns3
+{
+
+  NS_OBJECT_ENSURE_REGISTERED (NocDeadlockDetector);
+
+  std::string
+  NocDeadlockDetector::StatusToString (Status status)
+  {
+    switch (status)
+      {
+      case RUNNING:
+        return "running";
+      case DEADLOCKED:
+        return "deadlocked";
+      default:
+        return "unknown";
+      }
+  }
+
+  TypeId
+  NocDeadlockDetector::GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::NocDeadlockDetector")
+        .SetParent<DataCalculator> ()
+        .AddConstructor<NocDeadlockDetector> ()
+        .AddAttribute ("ConfirmationCycles",
+            "For how many clock cycles the virtual channels of a knot must keep waiting for each other, "
+            "before the deadlock is reported (default is 100)",
+            UintegerValue (100),
+            MakeUintegerAccessor (&NocDeadlockDetector::m_confirmationCycles),
+            MakeUintegerChecker<uint64_t> (1))
+        .AddAttribute ("StopSimulation",
+            "Whether or not the simulation is stopped when a deadlock is detected (default is true)",
+            BooleanValue (true),
+            MakeBooleanAccessor (&NocDeadlockDetector::m_stopSimulation),
+            MakeBooleanChecker ())
+        .AddTraceSource ("Deadlock",
+            "A deadlock was detected (the report of the deadlocked virtual channels is given)",
+            MakeTraceSourceAccessor (&NocDeadlockDetector::m_deadlockTrace))
+        ;
+    return tid;
+  }
+
+  NocDeadlockDetector::NocDeadlockDetector ()
+  {
+    m_confirmationCycles = 100;
+    m_stopSimulation = true;
+    m_simulationContext = 0;
+    m_waitingQueues = 0;
+    m_visitStamp = 0;
+    m_knotCycle = 0;
+    m_searches = 0;
+    m_status = RUNNING;
+    m_deadlockCycle = 0;
+  }
+
+  NocDeadlockDetector::~NocDeadlockDetector ()
+  {
+    ;
+  }
+
+  void
+  NocDeadlockDetector::DoDispose ()
+  {
+    Simulator::Cancel (m_confirmEvent);
+    m_simulationContext = 0;
+    m_deviceVertices.clear ();
+    m_vertexDevices.clear ();
+    m_successorDevices.clear ();
+    DataCalculator::DoDispose ();
+  }
+
+  void
+  NocDeadlockDetector::Install (Ptr<NocTopology> topology, NodeContainer nodes)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+    NS_ASSERT (topology != 0);
+
+    m_simulationContext = PeekPointer (topology->GetContext ());
+    NS_ASSERT_MSG (m_simulationContext->GetGlobalClockPicoSeconds () > 0,
+        "The deadlock detector requires the global clock of the NoC to be set!");
+
+    uint32_t maxNodeId = 0;
+    for (uint32_t i = 0; i < nodes.GetN (); ++i)
+      {
+        maxNodeId = std::max (maxNodeId, nodes.Get (i)->GetId ());
+      }
+    m_firstVertices.assign (maxNodeId + 1, 0);
+    m_deviceVertices.clear ();
+    m_vertexDevices.clear ();
+    m_vertexVirtualChannels.clear ();
+    m_vertexNodes.clear ();
+    for (uint32_t i = 0; i < nodes.GetN (); ++i)
+      {
+        uint32_t nodeId = nodes.Get (i)->GetId ();
+        Ptr<NocRouter> router = nodes.Get (i)->GetObject<NocNode> ()->GetRouter ();
+        m_firstVertices[nodeId] = m_vertexDevices.size ();
+        if (router == 0)
+          {
+            continue;
+          }
+        const std::vector<Ptr<NocNetDevice> > &ports = router->GetVirtualChannelInputPorts ();
+        if (ports.empty ())
+          {
+            // no virtual channels: each net device has a single input queue
+            for (uint32_t j = 0; j < nodes.Get (i)->GetNDevices (); ++j)
+              {
+                Ptr<NocNetDevice> device = nodes.Get (i)->GetDevice (j)->GetObject<NocNetDevice> ();
+                if (device == 0 || device->GetInQueue () == 0)
+                  {
+                    continue;
+                  }
+                m_deviceVertices[PeekPointer (device)] = m_vertexDevices.size ();
+                m_vertexDevices.push_back (PeekPointer (device));
+                m_vertexVirtualChannels.push_back (0);
+                m_vertexNodes.push_back (nodeId);
+              }
+            continue;
+          }
+        uint32_t virtualChannels = 0;
+        for (uint32_t port = 0; port < ports.size (); ++port)
+          {
+            virtualChannels = std::max (virtualChannels, ports[port]->GetNumberOfVirtualChannels ());
+          }
+        for (uint32_t port = 0; port < ports.size (); ++port)
+          {
+            m_deviceVertices[PeekPointer (ports[port])] = m_vertexDevices.size ();
+            for (uint32_t vc = 0; vc < virtualChannels; ++vc)
+              {
+                m_vertexDevices.push_back (vc < ports[port]->GetNumberOfVirtualChannels () ? PeekPointer (ports[port]) : 0);
+                m_vertexVirtualChannels.push_back (vc);
+                m_vertexNodes.push_back (nodeId);
+              }
+          }
+      }
+    if (m_vertexDevices.empty ())
+      {
+        NS_LOG_WARN ("The routers have no input buffers, so no deadlock can be detected");
+      }
+
+    uint32_t vertices = m_vertexDevices.size ();
+    m_waiting.assign (vertices, false);
+    m_waitingQueues = 0;
+    m_waitingSince.assign (vertices, 0);
+    m_successorDevices.assign (vertices, 0);
+    m_successorVertices.assign (vertices, 0);
+    m_successorMasks.assign (vertices, 0);
+    m_visitStamps.assign (vertices, 0);
+    m_visitStamp = 0;
+    m_status = RUNNING;
+    m_deadlockCycle = 0;
+    m_report.clear ();
+
+    topology->GetContext ()->SetDeadlockDetector (this);
+    NS_LOG_INFO ("Watching " << vertices << " virtual channels and input queues for deadlocks");
+  }
+
+  void
+  NocDeadlockDetector::NotifyWaiting (uint32_t vertex, NocNetDevice *next, uint32_t virtualChannels)
+  {
+    NS_ASSERT (vertex < m_waiting.size ());
+    if (m_waiting[vertex] && m_successorDevices[vertex] == next && m_successorMasks[vertex] == virtualChannels)
+      {
+        return;
+      }
+
+    m_waiting[vertex] = true;
+    m_waitingSince[vertex] = GetCurrentCycle ();
+    m_successorDevices[vertex] = next;
+    m_successorVertices[vertex] = GetDeviceVertex (next);
+    m_successorMasks[vertex] = virtualChannels;
+    NS_LOG_LOGIC ("Virtual channel " << vertex << " waits for the virtual channels " << virtualChannels
+        << " of the net device " << next->GetAddress ());
+
+    if (m_status == DEADLOCKED || m_confirmEvent.IsRunning ())
+      {
+        // a knot is already being confirmed (a rejected knot triggers a full search)
+        return;
+      }
+    if (FindKnot (vertex))
+      {
+        ScheduleConfirmation ();
+      }
+  }
+
+  void
+  NocDeadlockDetector::NotifyQueueWaiting (const NocNetDevice *device, NocNetDevice *holder)
+  {
+    NS_ASSERT (device != holder);
+    if (m_deviceVertices.find (holder) == m_deviceVertices.end ())
+      {
+        // the flit on the link was not buffered (its net device has no input queue), so it does not wait
+        NotifyQueueNotWaiting (device);
+        return;
+      }
+    uint32_t vertex = GetDeviceVertex (device);
+    if (!m_waiting[vertex])
+      {
+        m_waitingQueues++;
+      }
+    NotifyWaiting (vertex, holder, 1);
+  }
+
+  void
+  NocDeadlockDetector::DoNotifyQueueNotWaiting (const NocNetDevice *device)
+  {
+    uint32_t vertex = GetDeviceVertex (device);
+    if (m_waiting[vertex])
+      {
+        NS_ASSERT (m_waitingQueues > 0);
+        m_waitingQueues--;
+        m_waiting[vertex] = false;
+      }
+  }
+
+  uint32_t
+  NocDeadlockDetector::GetDeviceVertex (const NocNetDevice *device) const
+  {
+    std::map<const NocNetDevice *, uint32_t>::const_iterator it = m_deviceVertices.find (device);
+    NS_ASSERT_MSG (it != m_deviceVertices.end (), "The net device " << device->GetAddress ()
+        << " is not watched by the deadlock detector");
+    return it->second;
+  }
+
+  bool
+  NocDeadlockDetector::FindKnot (uint32_t vertex)
+  {
+    m_searches++;
+    m_visitStamp++;
+    m_knot.clear ();
+    m_stack.clear ();
+    m_visitStamps[vertex] = m_visitStamp;
+    m_stack.push_back (vertex);
+    while (!m_stack.empty ())
+      {
+        uint32_t current = m_stack.back ();
+        m_stack.pop_back ();
+        m_knot.push_back (current);
+        if (!m_waiting[current])
+          {
+            return false;
+          }
+        uint32_t mask = m_successorMasks[current];
+        for (uint32_t vc = 0; mask != 0; ++vc, mask >>= 1)
+          {
+            if ((mask & 1) == 0)
+              {
+                continue;
+              }
+            uint32_t successor = m_successorVertices[current] + vc;
+            NS_ASSERT (successor < m_waiting.size ());
+            if (m_visitStamps[successor] == m_visitStamp)
+              {
+                continue;
+              }
+            m_visitStamps[successor] = m_visitStamp;
+            m_stack.push_back (successor);
+          }
+      }
+    return true;
+  }
+
+  void
+  NocDeadlockDetector::ScheduleConfirmation ()
+  {
+    m_knotCycle = GetCurrentCycle ();
+    NS_LOG_INFO ("Found a knot of " << m_knot.size () << " waiting virtual channels at clock cycle " << m_knotCycle
+        << " (confirming it in " << m_confirmationCycles << " clock cycles)");
+    m_confirmEvent = Simulator::Schedule (PicoSeconds (m_confirmationCycles
+        * m_simulationContext->GetGlobalClockPicoSeconds ()), &NocDeadlockDetector::Confirm, this);
+  }
+
+  void
+  NocDeadlockDetector::Confirm ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    bool confirmed = true;
+    for (uint32_t i = 0; i < m_knot.size () && confirmed; ++i)
+      {
+        confirmed = m_waiting[m_knot[i]] && m_waitingSince[m_knot[i]] <= m_knotCycle;
+      }
+    if (!confirmed)
+      {
+        NS_LOG_INFO ("The knot found at clock cycle " << m_knotCycle << " was resolved");
+        // the knots which formed in the meantime were not searched for
+        for (uint32_t vertex = 0; vertex < m_waiting.size (); ++vertex)
+          {
+            if (m_waiting[vertex] && FindKnot (vertex))
+              {
+                ScheduleConfirmation ();
+                return;
+              }
+          }
+        return;
+      }
+
+    m_status = DEADLOCKED;
+    m_deadlockCycle = GetCurrentCycle ();
+    std::ostringstream oss;
+    oss << "Deadlock of " << m_knot.size () << " input buffers, waiting since clock cycle " << m_knotCycle
+        << " at the latest:";
+    for (uint32_t i = 0; i < m_knot.size (); ++i)
+      {
+        oss << std::endl << "  " << DescribeVertex (m_knot[i]);
+      }
+    m_report = oss.str ();
+    NS_LOG_WARN (m_report);
+    m_deadlockTrace (m_report);
+    if (m_stopSimulation)
+      {
+        Simulator::Stop ();
+      }
+  }
+
+  std::string
+  NocDeadlockDetector::DescribeVertex (uint32_t vertex) const
+  {
+    std::ostringstream oss;
+    NocNetDevice *device = m_vertexDevices[vertex];
+    uint32_t vc = m_vertexVirtualChannels[vertex];
+    oss << "router " << m_vertexNodes[vertex] << ", port " << device->GetAddress ()
+        << " (direction " << device->GetRoutingDirection () << ", dimension " << device->GetRoutingDimension ()
+        << "), ";
+    Ptr<const Packet> flit;
+    if (device->GetNumberOfVirtualChannels () == 0)
+      {
+        oss << "input queue";
+        flit = device->GetInQueue ()->Peek ();
+      }
+    else
+      {
+        oss << "VC " << vc;
+        flit = device->PeekVirtualChannel (vc);
+      }
+    if (flit != 0)
+      {
+        NocPacketTag tag;
+        flit->PeekPacketTag (tag);
+        oss << ", flit " << flit->GetUid () << " (" << (NocPacket::HEAD == tag.GetPacketType () ? "head"
+            : (NocPacket::TAIL == tag.GetPacketType () ? "tail" : "data")) << ")";
+      }
+    NocNetDevice *next = m_successorDevices[vertex];
+    oss << " waits for router " << next->GetNode ()->GetId () << ", port " << next->GetAddress ();
+    if (next->GetNumberOfVirtualChannels () == 0)
+      {
+        oss << ", input queue";
+        return oss.str ();
+      }
+    oss << ", VC";
+    uint32_t mask = m_successorMasks[vertex];
+    for (uint32_t i = 0; mask != 0; ++i, mask >>= 1)
+      {
+        if ((mask & 1) != 0)
+          {
+            oss << " " << i;
+          }
+      }
+    return oss.str ();
+  }
+
+  uint64_t
+  NocDeadlockDetector::GetCurrentCycle () const
+  {
+    return m_simulationContext->GetClockNumber (Simulator::Now ());
+  }
+
+  NocDeadlockDetector::Status
+  NocDeadlockDetector::GetStatus () const
+  {
+    return m_status;
+  }
+
+  uint64_t
+  NocDeadlockDetector::GetDeadlockCycle () const
+  {
+    return m_deadlockCycle;
+  }
+
+  std::string
+  NocDeadlockDetector::GetReport () const
+  {
+    return m_report;
+  }
+
+  void
+  NocDeadlockDetector::Output (DataOutputCallback &callback) const
+  {
+    callback.OutputSingleton (m_context, m_key + "-status", StatusToString (m_status));
+    callback.OutputSingleton (m_context, m_key + "-searches", (double) m_searches);
+    if (m_status == DEADLOCKED)
+      {
+        callback.OutputSingleton (m_context, m_key + "-cycle", (double) m_deadlockCycle);
+        callback.OutputSingleton (m_context, m_key + "-virtual-channels", (uint32_t) m_knot.size ());
+        callback.OutputSingleton (m_context, m_key + "-report", m_report);
+      }
+  }
+
+} // namespace ns3
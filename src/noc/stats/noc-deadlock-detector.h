@@ -0,0 +1,351 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCDEADLOCKDETECTOR_H_
+#define NOCDEADLOCKDETECTOR_H_
+
+#include "ns3/data-calculator.h"
+#include "ns3/event-id.h"
+#include "ns3/node-container.h"
+#include "ns3/traced-callback.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace ns3
+{
+
+  class NocTopology;
+
+  class NocSimulationContext;
+
+  class NocNetDevice;
+
+  /**
+   * \brief Watchdog which detects the deadlocks of the input buffers of the routers and stops the simulation
+   *
+   * \detail The detector keeps the wait-for graph of the virtual channels of all the routers. A virtual channel
+   *         waits when the flit from its head cannot advance because of a resource held by another virtual channel:
+   *         - the message has a virtual channel in the next router, but there is no credit for it
+   *           (the downstream virtual channel is full), or
+   *         - the head flit needs a virtual channel in the next router, and all the virtual channels it may use
+   *           (see NocRoutingProtocol::IsVirtualChannelAllowed) are reserved by other messages.
+   *         The routers report these situations once per clock cycle, while allocating their switch
+   *         (see NocRouter::AllocateSwitch). The graph is only updated when the state of a virtual channel changes.
+   *
+   *         Since a head flit may wait for any of several virtual channels, a deadlock is a knot of the graph:
+   *         a set of waiting virtual channels which only wait for each other. The search is incremental:
+   *         it is done only when a virtual channel starts waiting (or waits for something else), and it only visits
+   *         the virtual channels reachable from it. A knot is confirmed if none of its virtual channels advanced during
+   *         ConfirmationCycles clock cycles (credits may still be in transit when the knot is found).
+   *
+   *         When a deadlock is confirmed, a report with the routers, the ports, the virtual channels and the flits of
+   *         the knot is built, the Deadlock trace source is fired and the simulation is stopped.
+   *
+   *         The routers without virtual channels (see the VirtualChannels attribute of NocTopology) have a single
+   *         input queue per net device, which is a vertex of the graph too. The head flit of such a queue waits when
+   *         NocChannel::TransmitStart refuses it, because the link to the next router carries a flit of another
+   *         input queue; the net device retries it later (see NocNetDevice::ProcessBufferedPackets). The queue
+   *         waits for the input queue which occupies the link. A queue whose own flit is on the link does not wait.
+   */
+  class NocDeadlockDetector : public DataCalculator
+  {
+  public:
+
+    enum Status
+      {
+        /**
+         * no deadlock was detected
+         */
+        RUNNING,
+
+        /**
+         * a deadlock was detected (and the simulation was stopped)
+         */
+        DEADLOCKED
+      };
+
+    static std::string
+    StatusToString (Status status);
+
+    static TypeId
+    GetTypeId ();
+
+    NocDeadlockDetector ();
+
+    virtual
+    ~NocDeadlockDetector ();
+
+    /**
+     * Starts watching the virtual channels (or the input queues) of the routers of the given nodes. The topology
+     * must be installed (its routers must already have their virtual channels).
+     *
+     * \param topology the NoC topology
+     * \param nodes the nodes of the topology
+     */
+    void
+    Install (Ptr<NocTopology> topology, NodeContainer nodes);
+
+    /**
+     * The virtual channels of a router are numbered consecutively, by input port: the virtual channel vc of
+     * input port p (see NocRouter::GetVirtualChannelInputPorts) is GetFirstVertex (nodeId) + p * V + vc,
+     * where V is the number of virtual channels of the router. A router without virtual channels has one vertex
+     * for the input queue of each of its net devices.
+     *
+     * \param nodeId the ID of a NoC node
+     *
+     * \return the number of the first virtual channel of the node's router, in the wait-for graph
+     */
+    uint32_t
+    GetFirstVertex (uint32_t nodeId) const
+    {
+      return m_firstVertices[nodeId];
+    }
+
+    /**
+     * Reports that a virtual channel waits for one or more virtual channels of the next router.
+     *
+     * \param vertex the waiting virtual channel
+     * \param next the net device of the next router
+     * \param virtualChannels the virtual channels of the next net device which are waited for (bit mask)
+     */
+    void
+    NotifyWaiting (uint32_t vertex, NocNetDevice *next, uint32_t virtualChannels);
+
+    /**
+     * Reports that a virtual channel does not wait for other virtual channels.
+     *
+     * \param vertex the virtual channel
+     */
+    void
+    NotifyNotWaiting (uint32_t vertex)
+    {
+      m_waiting[vertex] = false;
+    }
+
+    /**
+     * Reports that the head flit of the input queue of a net device without virtual channels cannot be sent,
+     * because the link to the next router carries a flit from the input queue of another net device.
+     *
+     * \param device the net device with the waiting input queue
+     * \param holder the net device whose flit occupies the link
+     */
+    void
+    NotifyQueueWaiting (const NocNetDevice *device, NocNetDevice *holder);
+
+    /**
+     * Reports that the input queue of a net device without virtual channels does not wait.
+     * This is called for every sent flit, so it does nothing while no input queue waits.
+     *
+     * \param device the net device
+     */
+    void
+    NotifyQueueNotWaiting (const NocNetDevice *device)
+    {
+      if (m_waitingQueues > 0)
+        {
+          DoNotifyQueueNotWaiting (device);
+        }
+    }
+
+    /**
+     * \return whether or not a deadlock was detected
+     */
+    Status
+    GetStatus () const;
+
+    /**
+     * \return the clock cycle when the deadlock was confirmed (0 if there is no deadlock)
+     */
+    uint64_t
+    GetDeadlockCycle () const;
+
+    /**
+     * \return the description of the deadlocked virtual channels (empty if there is no deadlock)
+     */
+    std::string
+    GetReport () const;
+
+    virtual void
+    Output (DataOutputCallback &callback) const;
+
+  protected:
+
+    virtual void
+    DoDispose ();
+
+  private:
+
+    void
+    DoNotifyQueueNotWaiting (const NocNetDevice *device);
+
+    /**
+     * \param device a net device
+     *
+     * \return the first vertex of the net device (its input queue, if it has no virtual channels)
+     */
+    uint32_t
+    GetDeviceVertex (const NocNetDevice *device) const;
+
+    /**
+     * Searches for a knot, starting from a waiting virtual channel. The visited virtual channels are kept in m_knot.
+     * The search stops (with no knot) at the first reachable virtual channel which does not wait.
+     *
+     * \param vertex the virtual channel where the search starts
+     *
+     * \return whether or not a knot was found
+     */
+    bool
+    FindKnot (uint32_t vertex);
+
+    /**
+     * Schedules the confirmation of the knot from m_knot.
+     */
+    void
+    ScheduleConfirmation ();
+
+    /**
+     * Invoked ConfirmationCycles clock cycles after a knot was found. If the knot still exists, the simulation
+     * is stopped. Otherwise, all the waiting virtual channels are searched for other knots.
+     */
+    void
+    Confirm ();
+
+    /**
+     * \param vertex a virtual channel
+     *
+     * \return the description of the virtual channel and of the flit from its head
+     */
+    std::string
+    DescribeVertex (uint32_t vertex) const;
+
+    /**
+     * \return the current clock cycle
+     */
+    uint64_t
+    GetCurrentCycle () const;
+
+    uint64_t m_confirmationCycles;
+
+    bool m_stopSimulation;
+
+    /**
+     * the simulation context of the watched topology
+     */
+    NocSimulationContext *m_simulationContext;
+
+    /**
+     * the first virtual channel of each router, by node ID
+     */
+    std::vector<uint32_t> m_firstVertices;
+
+    /**
+     * the first vertex of every watched net device
+     */
+    std::map<const NocNetDevice *, uint32_t> m_deviceVertices;
+
+    /**
+     * the net device of each virtual channel (null for the unused numbers)
+     */
+    std::vector<NocNetDevice *> m_vertexDevices;
+
+    /**
+     * the virtual channel number of each virtual channel, in its net device
+     */
+    std::vector<uint32_t> m_vertexVirtualChannels;
+
+    /**
+     * the node ID of the router of each virtual channel
+     */
+    std::vector<uint32_t> m_vertexNodes;
+
+    /**
+     * whether or not each virtual channel waits
+     */
+    std::vector<bool> m_waiting;
+
+    /**
+     * how many input queues (of net devices without virtual channels) wait
+     */
+    uint32_t m_waitingQueues;
+
+    /**
+     * the clock cycle from which each virtual channel waits for its current successors
+     */
+    std::vector<uint64_t> m_waitingSince;
+
+    /**
+     * the net device waited for by each virtual channel
+     */
+    std::vector<NocNetDevice *> m_successorDevices;
+
+    /**
+     * the first virtual channel of the net device waited for by each virtual channel
+     */
+    std::vector<uint32_t> m_successorVertices;
+
+    /**
+     * the virtual channels waited for by each virtual channel (bit mask)
+     */
+    std::vector<uint32_t> m_successorMasks;
+
+    /**
+     * the visit stamps of the knot searches, by virtual channel
+     */
+    std::vector<uint32_t> m_visitStamps;
+
+    uint32_t m_visitStamp;
+
+    /**
+     * the virtual channels visited by the last knot search
+     */
+    std::vector<uint32_t> m_knot;
+
+    std::vector<uint32_t> m_stack;
+
+    /**
+     * the clock cycle when the knot being confirmed was found
+     */
+    uint64_t m_knotCycle;
+
+    /**
+     * how many knot searches were made
+     */
+    uint64_t m_searches;
+
+    EventId m_confirmEvent;
+
+    Status m_status;
+
+    uint64_t m_deadlockCycle;
+
+    std::string m_report;
+
+    TracedCallback<std::string> m_deadlockTrace;
+
+  };
+
+} // namespace ns3
+
+#endif /* NOCDEADLOCKDETECTOR_H_ */
@@ -0,0 +1,223 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-latency-histogram.h"
+#include "ns3/log.h"
+#include <math.h>
+
+NS_LOG_COMPONENT_DEFINE ("NocLatencyHistogram");
+
+namespace ns3
+{
+
+  NocLatencyHistogram::NocLatencyHistogram ()
+  {
+    Reset ();
+  }
+
+  NocLatencyHistogram::~NocLatencyHistogram ()
+  {
+    ;
+  }
+
+  uint32_t
+  NocLatencyHistogram::GetBucket (uint64_t value)
+  {
+    if (value < SUB_BUCKETS)
+      {
+        return value;
+      }
+    // SUB_BUCKETS is a power of two: 2^subBits
+    uint32_t subBits = 0;
+    while ((1u << subBits) < SUB_BUCKETS)
+      {
+        subBits++;
+      }
+    uint32_t exponent = 0;
+    for (uint64_t v = value; v > 1; v >>= 1)
+      {
+        exponent++;
+      }
+    uint32_t shift = exponent - subBits;
+    uint32_t subBucket = (value >> shift) & (SUB_BUCKETS - 1);
+    return SUB_BUCKETS + shift * SUB_BUCKETS + subBucket;
+  }
+
+  uint64_t
+  NocLatencyHistogram::GetBucketLowerBound (uint32_t bucket)
+  {
+    if (bucket < SUB_BUCKETS)
+      {
+        return bucket;
+      }
+    uint32_t shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+    uint64_t subBucket = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+    return (SUB_BUCKETS + subBucket) << shift;
+  }
+
+  uint64_t
+  NocLatencyHistogram::GetBucketWidth (uint32_t bucket)
+  {
+    if (bucket < SUB_BUCKETS)
+      {
+        return 1;
+      }
+    return ((uint64_t) 1) << ((bucket - SUB_BUCKETS) / SUB_BUCKETS);
+  }
+
+  void
+  NocLatencyHistogram::Update (double value)
+  {
+    if (value < 0)
+      {
+        value = 0;
+      }
+    uint32_t bucket = GetBucket ((uint64_t) value);
+    if (bucket >= m_buckets.size ())
+      {
+        m_buckets.resize (bucket + 1, 0);
+      }
+    m_buckets[bucket]++;
+
+    if (m_count == 0 || value < m_min)
+      {
+        m_min = value;
+      }
+    if (m_count == 0 || value > m_max)
+      {
+        m_max = value;
+      }
+    m_count++;
+    m_sum += value;
+    m_sqrSum += value * value;
+  }
+
+  void
+  NocLatencyHistogram::Reset ()
+  {
+    m_buckets.clear ();
+    m_count = 0;
+    m_sum = 0;
+    m_sqrSum = 0;
+    m_min = 0;
+    m_max = 0;
+  }
+
+  double
+  NocLatencyHistogram::GetPercentile (double percent) const
+  {
+    NS_ASSERT_MSG (percent >= 0 && percent <= 100, "A percentile must be in [0, 100] (" << percent << " is not)");
+    if (m_count == 0)
+      {
+        return NaN;
+      }
+    uint64_t rank = (uint64_t) ceil (percent / 100 * m_count);
+    if (rank == 0)
+      {
+        rank = 1;
+      }
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < m_buckets.size (); i++)
+      {
+        seen += m_buckets[i];
+        if (seen >= rank)
+          {
+            // the middle of the bucket, without going outside the observed values
+            double value = GetBucketLowerBound (i) + (GetBucketWidth (i) - 1) / 2.0;
+            if (value < m_min)
+              {
+                value = m_min;
+              }
+            if (value > m_max)
+              {
+                value = m_max;
+              }
+            return value;
+          }
+      }
+    return m_max;
+  }
+
+  uint32_t
+  NocLatencyHistogram::GetNumberOfBuckets () const
+  {
+    return m_buckets.size ();
+  }
+
+  long
+  NocLatencyHistogram::getCount () const
+  {
+    return m_count;
+  }
+
+  double
+  NocLatencyHistogram::getSum () const
+  {
+    return m_sum;
+  }
+
+  double
+  NocLatencyHistogram::getSqrSum () const
+  {
+    return m_sqrSum;
+  }
+
+  double
+  NocLatencyHistogram::getMin () const
+  {
+    return m_count > 0 ? m_min : NaN;
+  }
+
+  double
+  NocLatencyHistogram::getMax () const
+  {
+    return m_count > 0 ? m_max : NaN;
+  }
+
+  double
+  NocLatencyHistogram::getMean () const
+  {
+    return m_count > 0 ? m_sum / m_count : NaN;
+  }
+
+  double
+  NocLatencyHistogram::getStddev () const
+  {
+    double variance = getVariance ();
+    return isNaN (variance) ? NaN : sqrt (variance);
+  }
+
+  double
+  NocLatencyHistogram::getVariance () const
+  {
+    if (m_count == 0)
+      {
+        return NaN;
+      }
+    double mean = m_sum / m_count;
+    double variance = m_sqrSum / m_count - mean * mean;
+    // rounding errors may give a tiny negative variance
+    return variance > 0 ? variance : 0;
+  }
+
+} // namespace ns3
@@ -0,0 +1,158 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCLATENCYHISTOGRAM_H_
+#define NOCLATENCYHISTOGRAM_H_
+
+#include "ns3/data-calculator.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+  /**
+   * \brief Streaming histogram of latencies (measured in clock cycles)
+   *
+   * \detail The values are counted in logarithmic buckets: each power of two is split into
+   *         SUB_BUCKETS linear buckets, so the memory needed does not depend on the number of values
+   *         and the percentiles are estimated with a relative error of at most 1 / SUB_BUCKETS.
+   *         Values smaller than SUB_BUCKETS have their own buckets (they are exact).
+   *         The count, the minimum, the maximum and the sums (hence the mean and the standard deviation)
+   *         are exact.
+   */
+  class NocLatencyHistogram : public StatisticalSummary
+  {
+  public:
+
+    /**
+     * how many buckets each power of two is split into
+     */
+    static const uint32_t SUB_BUCKETS = 8;
+
+    NocLatencyHistogram ();
+
+    virtual
+    ~NocLatencyHistogram ();
+
+    /**
+     * Adds a value to the histogram
+     *
+     * \param value the value (negative values are counted as zero)
+     */
+    void
+    Update (double value);
+
+    /**
+     * Removes all the values
+     */
+    void
+    Reset ();
+
+    /**
+     * Estimates a percentile, from the bucket which holds it
+     *
+     * \param percent the percentage of values smaller than or equal to the returned value, in [0, 100]
+     *
+     * \return the percentile (NaN if the histogram is empty)
+     */
+    double
+    GetPercentile (double percent) const;
+
+    /**
+     * \return how many buckets are currently allocated
+     */
+    uint32_t
+    GetNumberOfBuckets () const;
+
+    // inherited from StatisticalSummary
+
+    virtual long
+    getCount () const;
+
+    virtual double
+    getSum () const;
+
+    virtual double
+    getSqrSum () const;
+
+    virtual double
+    getMin () const;
+
+    virtual double
+    getMax () const;
+
+    virtual double
+    getMean () const;
+
+    virtual double
+    getStddev () const;
+
+    virtual double
+    getVariance () const;
+
+  private:
+
+    /**
+     * \param value a non negative integer value
+     *
+     * \return the index of the bucket which counts the value
+     */
+    static uint32_t
+    GetBucket (uint64_t value);
+
+    /**
+     * \param bucket the index of a bucket
+     *
+     * \return the smallest value counted by the bucket
+     */
+    static uint64_t
+    GetBucketLowerBound (uint32_t bucket);
+
+    /**
+     * \param bucket the index of a bucket
+     *
+     * \return how many integer values the bucket counts
+     */
+    static uint64_t
+    GetBucketWidth (uint32_t bucket);
+
+    /**
+     * the buckets (allocated up to the bucket of the biggest value)
+     */
+    std::vector<uint64_t> m_buckets;
+
+    uint64_t m_count;
+
+    double m_sum;
+
+    double m_sqrSum;
+
+    double m_min;
+
+    double m_max;
+  };
+
+} // namespace ns3
+
+#endif /* NOCLATENCYHISTOGRAM_H_ */
@@ -0,0 +1,326 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-stats-collector.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/simulator.h"
+#include "ns3/data-output-interface.h"
+#include "ns3/noc-topology.h"
+#include "ns3/noc-packet-tag.h"
+#include "ns3/noc-header.h"
+#include <sstream>
+#include <cstdlib>
+
+NS_LOG_COMPONENT_DEFINE ("NocStatsCollector");
+
+namespace ns3
+{
+
+  NS_OBJECT_ENSURE_REGISTERED (NocStatsCollector);
+
+  TypeId
+  NocStatsCollector::GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::NocStatsCollector")
+        .SetParent<DataCalculator> ()
+        .AddConstructor<NocStatsCollector> ()
+        .AddAttribute ("WarmupCycles",
+            "The packets injected during the warmup cycles are not measured (default is 0)",
+            UintegerValue (0),
+            MakeUintegerAccessor (&NocStatsCollector::m_warmupCycles),
+            MakeUintegerChecker<uint64_t> ())
+        .AddAttribute ("OutputFlows",
+            "Whether or not the statistics of each flow (source node - destination node) are output, "
+            "besides the network-wide ones (default is false)",
+            BooleanValue (false),
+            MakeBooleanAccessor (&NocStatsCollector::m_outputFlows),
+            MakeBooleanChecker ())
+        .AddTraceSource ("PacketLatency",
+            "A packet was measured (its tail flit reached the destination); the latency is given in clock cycles",
+            MakeTraceSourceAccessor (&NocStatsCollector::m_packetLatencyTrace))
+        ;
+    return tid;
+  }
+
+  NocStatsCollector::NocStatsCollector ()
+  {
+    m_receivedFlits = 0;
+    m_lastReceiveTime = PicoSeconds (0);
+    m_warmupCycles = 0;
+    m_outputFlows = false;
+    m_topology = 0;
+    m_clock = 0;
+  }
+
+  NocStatsCollector::~NocStatsCollector ()
+  {
+    ;
+  }
+
+  void
+  NocStatsCollector::DoDispose ()
+  {
+    m_inFlightPackets.clear ();
+    m_flowLatency.clear ();
+    m_topology = 0;
+    DataCalculator::DoDispose ();
+  }
+
+  void
+  NocStatsCollector::Install (Ptr<NocTopology> topology)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+    NS_ASSERT (topology != 0);
+    NS_ASSERT_MSG (topology->GetContext () != 0, "The NoC topology must be installed first");
+
+    m_topology = topology;
+    m_clock = topology->GetContext ()->GetGlobalClockPicoSeconds ();
+    NS_ASSERT_MSG (m_clock > 0, "The statistics are measured in clock cycles, so a global clock is required");
+    m_dimensionSizes.clear ();
+    for (uint32_t i = 0; i < topology->GetNumberOfDimensions (); i++)
+      {
+        m_dimensionSizes.push_back (topology->GetDimensionSize (i));
+      }
+
+    Config::Connect ("/NodeList/*/DeviceList/*/$ns3::NocNetDevice/Receive",
+        MakeCallback (&NocStatsCollector::ReceiveCallback, this));
+  }
+
+  void
+  NocStatsCollector::ReceiveCallback (std::string path, Ptr<const Packet> flit)
+  {
+    // the path looks like /NodeList/<node ID>/DeviceList/<device ID>/$ns3::NocNetDevice/Receive
+    std::string::size_type position = path.find ("/NodeList/");
+    NS_ASSERT_MSG (position != std::string::npos, "Unexpected trace source path " << path);
+    uint32_t destination = atoi (path.c_str () + position + 10);
+    FlitReceived (destination, flit);
+  }
+
+  uint32_t
+  NocStatsCollector::GetSourceNodeId (const NocHeader &header) const
+  {
+    // the node IDs are assigned in row-major order
+    uint32_t id = 0;
+    uint32_t stride = 1;
+    for (uint32_t i = 0; i < m_dimensionSizes.size () && i < header.GetDimensions (); i++)
+      {
+        id += header.GetSource (i) * stride;
+        stride *= m_dimensionSizes[i];
+      }
+    return id;
+  }
+
+  void
+  NocStatsCollector::FlitReceived (uint32_t destination, Ptr<const Packet> flit)
+  {
+    NS_LOG_FUNCTION (destination << flit->GetUid ());
+    if (!m_enabled)
+      {
+        return;
+      }
+    NS_ASSERT_MSG (m_clock > 0, "The statistics collector is not installed");
+
+    Time now = Simulator::Now ();
+    Time warmupEnd = PicoSeconds (m_warmupCycles * m_clock);
+    if (now >= warmupEnd)
+      {
+        m_receivedFlits++;
+        m_lastReceiveTime = now;
+      }
+
+    NocPacketTag tag;
+    flit->PeekPacketTag (tag);
+    if (NocPacket::HEAD == tag.GetPacketType ())
+      {
+        if (tag.GetInjectionTime () < warmupEnd)
+          {
+            NS_LOG_LOGIC ("The packet with the head UID " << flit->GetUid () << " was injected during the warmup");
+            return;
+          }
+        NocHeader header;
+        flit->PeekHeader (header);
+        InFlightPacket packet;
+        packet.m_injectionTime = tag.GetInjectionTime ();
+        packet.m_source = GetSourceNodeId (header);
+        if (tag.GetDataFlitCount () > 0)
+          {
+            m_inFlightPackets[flit->GetUid ()] = packet;
+            return;
+          }
+        // a single flit packet
+        double latency = (now - packet.m_injectionTime).GetPicoSeconds () * 1.0 / m_clock;
+        m_latency.Update (latency);
+        m_flowLatency[std::make_pair (packet.m_source, destination)].Update (latency);
+        m_packetLatencyTrace (latency);
+      }
+    else if (NocPacket::TAIL == tag.GetPacketType ())
+      {
+        std::map<uint32_t, InFlightPacket>::iterator it = m_inFlightPackets.find (tag.GetPacketHeadUid ());
+        if (it == m_inFlightPackets.end ())
+          {
+            NS_LOG_LOGIC ("The packet with the head UID " << tag.GetPacketHeadUid () << " is not measured");
+            return;
+          }
+        double latency = (now - it->second.m_injectionTime).GetPicoSeconds () * 1.0 / m_clock;
+        NS_LOG_LOGIC ("The packet with the head UID " << tag.GetPacketHeadUid () << " has a latency of "
+            << latency << " cycles");
+        m_latency.Update (latency);
+        m_flowLatency[std::make_pair (it->second.m_source, destination)].Update (latency);
+        m_inFlightPackets.erase (it);
+        m_packetLatencyTrace (latency);
+      }
+  }
+
+  const NocLatencyHistogram &
+  NocStatsCollector::GetLatency () const
+  {
+    return m_latency;
+  }
+
+  const NocLatencyHistogram *
+  NocStatsCollector::GetFlowLatency (uint32_t source, uint32_t destination) const
+  {
+    std::map<std::pair<uint32_t, uint32_t>, NocLatencyHistogram>::const_iterator it =
+        m_flowLatency.find (std::make_pair (source, destination));
+    if (it == m_flowLatency.end ())
+      {
+        return 0;
+      }
+    return &it->second;
+  }
+
+  uint64_t
+  NocStatsCollector::GetReceivedFlits () const
+  {
+    return m_receivedFlits;
+  }
+
+  void
+  NocStatsCollector::SetWarmupCycles (uint64_t warmupCycles)
+  {
+    NS_LOG_FUNCTION (warmupCycles);
+
+    m_warmupCycles = warmupCycles;
+    m_latency.Reset ();
+    m_flowLatency.clear ();
+    m_receivedFlits = 0;
+    m_lastReceiveTime = PicoSeconds (0);
+    Time warmupEnd = PicoSeconds (m_warmupCycles * m_clock);
+    std::map<uint32_t, InFlightPacket>::iterator it = m_inFlightPackets.begin ();
+    while (it != m_inFlightPackets.end ())
+      {
+        if (it->second.m_injectionTime < warmupEnd)
+          {
+            m_inFlightPackets.erase (it++);
+          }
+        else
+          {
+            ++it;
+          }
+      }
+  }
+
+  uint64_t
+  NocStatsCollector::GetWarmupCycles () const
+  {
+    return m_warmupCycles;
+  }
+
+  int64_t
+  NocStatsCollector::GetGlobalClock () const
+  {
+    return m_clock;
+  }
+
+  uint64_t
+  NocStatsCollector::GetReceivedPackets () const
+  {
+    return m_latency.getCount ();
+  }
+
+  uint32_t
+  NocStatsCollector::GetInFlightPackets () const
+  {
+    return m_inFlightPackets.size ();
+  }
+
+  double
+  NocStatsCollector::GetThroughput () const
+  {
+    uint32_t nodes = 1;
+    for (uint32_t i = 0; i < m_dimensionSizes.size (); i++)
+      {
+        nodes *= m_dimensionSizes[i];
+      }
+    if (m_clock <= 0 || m_receivedFlits == 0)
+      {
+        return 0;
+      }
+    double cycles = (m_lastReceiveTime.GetPicoSeconds () - (int64_t) m_warmupCycles * m_clock) * 1.0 / m_clock + 1;
+    return m_receivedFlits / (nodes * cycles);
+  }
+
+  void
+  NocStatsCollector::OutputHistogram (DataOutputCallback &callback, std::string variable,
+      const NocLatencyHistogram &histogram) const
+  {
+    // count, total, min, max, sqrsum and stddev
+    callback.OutputStatistic (m_context, variable, &histogram);
+    if (histogram.getCount () == 0)
+      {
+        callback.OutputSingleton (m_context, variable + "-average", 0.0);
+        return;
+      }
+    callback.OutputSingleton (m_context, variable + "-average", histogram.getMean ());
+    callback.OutputSingleton (m_context, variable + "-p50", histogram.GetPercentile (50));
+    callback.OutputSingleton (m_context, variable + "-p90", histogram.GetPercentile (90));
+    callback.OutputSingleton (m_context, variable + "-p95", histogram.GetPercentile (95));
+    callback.OutputSingleton (m_context, variable + "-p99", histogram.GetPercentile (99));
+    callback.OutputSingleton (m_context, variable + "-p999", histogram.GetPercentile (99.9));
+  }
+
+  void
+  NocStatsCollector::Output (DataOutputCallback &callback) const
+  {
+    OutputHistogram (callback, m_key, m_latency);
+    callback.OutputSingleton (m_context, m_key + "-flits-received", (double) m_receivedFlits);
+    callback.OutputSingleton (m_context, m_key + "-throughput", GetThroughput ());
+    callback.OutputSingleton (m_context, m_key + "-in-flight", GetInFlightPackets ());
+
+    if (m_outputFlows)
+      {
+        std::map<std::pair<uint32_t, uint32_t>, NocLatencyHistogram>::const_iterator it;
+        for (it = m_flowLatency.begin (); it != m_flowLatency.end (); it++)
+          {
+            std::stringstream ss;
+            ss << m_key << "-" << it->first.first << "-" << it->first.second;
+            OutputHistogram (callback, ss.str (), it->second);
+          }
+      }
+  }
+
+} // namespace ns3
@@ -0,0 +1,236 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCSTATSCOLLECTOR_H_
+#define NOCSTATSCOLLECTOR_H_
+
+#include "ns3/data-calculator.h"
+#include "ns3/packet.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+#include "ns3/noc-header.h"
+#include "noc-latency-histogram.h"
+#include <map>
+#include <string>
+
+namespace ns3
+{
+
+  class NocTopology;
+
+  /**
+   * \brief Collects the packet latency and the accepted throughput of a NoC, while the simulation runs
+   *
+   * \detail The collector listens to the flits which reach their destination. The injection time of a head flit
+   *         is kept only until the tail flit of its packet arrives, so the memory needed is given by the packets
+   *         in flight, not by the length of the simulation. The latency of a packet is measured from the injection
+   *         of its head flit until the receipt of its tail flit, in clock cycles. It is counted in a network-wide
+   *         histogram and in the histogram of the packet's flow (source node - destination node).
+   *
+   *         Only the packets injected after the warmup cycles are measured (the throughput counts the flits
+   *         received after the warmup cycles).
+   *
+   *         The collector is a DataCalculator, so it can be added to a DataCollector. The network-wide
+   *         statistics are output as key-count, key-average, key-min, key-max, key-stddev, key-p50, key-p90,
+   *         key-p99 and so on. Per flow statistics are output only if the OutputFlows attribute is set.
+   */
+  class NocStatsCollector : public DataCalculator
+  {
+  public:
+
+    static TypeId
+    GetTypeId ();
+
+    NocStatsCollector ();
+
+    virtual
+    ~NocStatsCollector ();
+
+    /**
+     * Starts listening to the flits received by all the nodes of the topology.
+     * The topology must be installed.
+     *
+     * \param topology the NoC topology
+     */
+    void
+    Install (Ptr<NocTopology> topology);
+
+    /**
+     * Accounts for a flit which reached its destination. This is invoked for every received flit,
+     * once the collector is installed.
+     *
+     * \param destination the ID of the node which received the flit
+     * \param flit the received flit
+     */
+    void
+    FlitReceived (uint32_t destination, Ptr<const Packet> flit);
+
+    /**
+     * \return the network-wide packet latency histogram
+     */
+    const NocLatencyHistogram &
+    GetLatency () const;
+
+    /**
+     * \param source the ID of the source node
+     * \param destination the ID of the destination node
+     *
+     * \return the packet latency histogram of the flow (NULL if no packet of this flow was measured)
+     */
+    const NocLatencyHistogram *
+    GetFlowLatency (uint32_t source, uint32_t destination) const;
+
+    /**
+     * \return how many flits were received after the warmup cycles
+     */
+    uint64_t
+    GetReceivedFlits () const;
+
+    /**
+     * Ends the warmup at another clock cycle. Everything measured so far is discarded
+     * (the packets in flight which were injected before the new warmup end are not measured anymore).
+     *
+     * \param warmupCycles the number of warmup cycles
+     */
+    void
+    SetWarmupCycles (uint64_t warmupCycles);
+
+    /**
+     * \return the number of warmup cycles
+     */
+    uint64_t
+    GetWarmupCycles () const;
+
+    /**
+     * \return the global clock, in picoseconds (0 if the collector is not installed)
+     */
+    int64_t
+    GetGlobalClock () const;
+
+    /**
+     * \return how many packets were measured
+     */
+    uint64_t
+    GetReceivedPackets () const;
+
+    /**
+     * \return how many packets have their head flit received, but not their tail flit
+     */
+    uint32_t
+    GetInFlightPackets () const;
+
+    /**
+     * \return the accepted throughput, in flits / node / clock cycle
+     *         (measured from the end of the warmup until the last received flit)
+     */
+    double
+    GetThroughput () const;
+
+    virtual void
+    Output (DataOutputCallback &callback) const;
+
+  protected:
+
+    virtual void
+    DoDispose ();
+
+  private:
+
+    /**
+     * The trace sink for the Receive trace source of the net devices
+     *
+     * \param path the path of the trace source (it contains the ID of the node)
+     * \param flit the received flit
+     */
+    void
+    ReceiveCallback (std::string path, Ptr<const Packet> flit);
+
+    /**
+     * Outputs the statistics of a latency histogram
+     *
+     * \param callback the data output callback
+     * \param variable the prefix of the output variables
+     * \param histogram the histogram
+     */
+    void
+    OutputHistogram (DataOutputCallback &callback, std::string variable, const NocLatencyHistogram &histogram) const;
+
+    /**
+     * \param header the header of a head flit
+     *
+     * \return the ID of the node which injected the flit
+     */
+    uint32_t
+    GetSourceNodeId (const NocHeader &header) const;
+
+    /**
+     * A packet whose head flit was received
+     */
+    struct InFlightPacket
+    {
+      Time m_injectionTime;
+
+      uint32_t m_source;
+    };
+
+    /**
+     * the packets in flight, by the UID of their head flit
+     */
+    std::map<uint32_t, InFlightPacket> m_inFlightPackets;
+
+    /**
+     * the latency histograms of the flows, by (source, destination)
+     */
+    std::map<std::pair<uint32_t, uint32_t>, NocLatencyHistogram> m_flowLatency;
+
+    NocLatencyHistogram m_latency;
+
+    uint64_t m_receivedFlits;
+
+    Time m_lastReceiveTime;
+
+    uint64_t m_warmupCycles;
+
+    bool m_outputFlows;
+
+    Ptr<NocTopology> m_topology;
+
+    /**
+     * the global clock, in picoseconds
+     */
+    int64_t m_clock;
+
+    /**
+     * how many nodes the topology has in each dimension
+     */
+    std::vector<uint32_t> m_dimensionSizes;
+
+    /**
+     * fired for every measured packet, with its latency (in clock cycles)
+     */
+    TracedCallback<double> m_packetLatencyTrace;
+  };
+
+} // namespace ns3
+
+#endif /* NOCSTATSCOLLECTOR_H_ */
@@ -59,7 +59,7 @@ namespace ns3
     packet->PeekPacketTag (tag);
     if (NocPacket::HEAD == tag.GetPacketType ())
       {
-        packet->PeekHeader(header);
+        packet->PeekHeader (header);
       }
     if (!header.IsEmpty())
       {
@@ -35,6 +35,7 @@
 #include "ns3/noc-packet-tag.h"
 #include "ns3/uinteger.h"
 #include "ns3/file-utils.h"
+#include "ns3/noc-header.h"
 
 NS_LOG_COMPONENT_DEFINE ("NocMesh2D");
 
@@ -53,7 +54,7 @@ namespace ns3
             "how many nodes the 2D mesh will have on one horizontal line",
             UintegerValue (4),
             MakeUintegerAccessor (&NocMesh2D::m_hSize),
-            MakeUintegerChecker<uint8_t> (1, 127));
+            MakeUintegerChecker<uint32_t> (1, NocHeader::OFFSET_BIT_MASK + 1));
 
     return tid;
   }
@@ -84,14 +85,7 @@ namespace ns3
         Ptr<NocNode> nocNode = nodes.Get (i)->GetObject<NocNode> ();
         if (nocNode->GetRouter () == 0)
           {
-            Ptr<NocRouter> router = m_routerFactory.Create ()->GetObject<NocRouter> ();
-            router->SetNocNode (nocNode);
-            nocNode->SetRouter (router);
-            Ptr<NocRoutingProtocol> routingProtocol = m_routingProtocolFactory.Create ()->GetObject<NocRoutingProtocol> ();
-            router->SetRoutingProtocol (routingProtocol);
-            Ptr<NocSwitchingProtocol> switchingProtocol =
-                m_switchingProtocolFactory.Create ()->GetObject<NocSwitchingProtocol> ();
-            router->SetSwitchingProtocol (switchingProtocol);
+            InstallRouter (nocNode);
           }
       }
 
@@ -101,31 +95,13 @@ namespace ns3
         Ptr<NocNode> nocNode = nodes.Get (i)->GetObject<NocNode> ();
         if (channel != 0)
           {
-            netDevice = CreateObject<NocNetDevice> ();
-            netDevice->SetAddress (Mac48Address::Allocate ());
-            netDevice->SetChannel (channel);
-            netDevice->SetRoutingDirection (NocRoutingProtocol::BACK, 0); // WEST
-            m_devices.Add (netDevice);
-            // attach input buffering (we don't use output buffering for the moment)
-            Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-            netDevice->SetInQueue (inQueue);
-            nocNode->AddDevice (netDevice);
-            nocNode->GetRouter ()->AddDevice (netDevice);
+            netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::BACK, 0); // WEST
           }
 
         if (i == 0 || (i > 0 && (i + 1) % m_hSize != 0))
           {
             channel = m_channelFactory.Create ()->GetObject<NocChannel> ();
-            netDevice = CreateObject<NocNetDevice> ();
-            netDevice->SetAddress (Mac48Address::Allocate ());
-            netDevice->SetChannel (channel);
-            netDevice->SetRoutingDirection (NocRoutingProtocol::FORWARD, 0); // EAST
-            m_devices.Add (netDevice);
-            // attach input buffering (we don't use output buffering for the moment)
-            Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-            netDevice->SetInQueue (inQueue);
-            nocNode->AddDevice (netDevice);
-            nocNode->GetRouter ()->AddDevice (netDevice);
+            netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::FORWARD, 0); // EAST
           }
         else
           {
@@ -144,30 +120,12 @@ namespace ns3
             if (columnChannels[j] != 0)
               {
                 channel = columnChannels[j];
-                netDevice = CreateObject<NocNetDevice> ();
-                netDevice->SetAddress (Mac48Address::Allocate ());
-                netDevice->SetChannel (channel);
-                netDevice->SetRoutingDirection (NocRoutingProtocol::BACK, 1); // SOUTH
-                m_devices.Add (netDevice);
-                // attach input buffering (we don't use output buffering for the moment)
-                Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                netDevice->SetInQueue (inQueue);
-                nocNode->AddDevice (netDevice);
-                nocNode->GetRouter ()->AddDevice (netDevice);
+                netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::BACK, 1); // SOUTH
               }
             if (i < nodes.GetN () - m_hSize)
               {
                 channel = m_channelFactory.Create ()->GetObject<NocChannel> ();
-                netDevice = CreateObject<NocNetDevice> ();
-                netDevice->SetAddress (Mac48Address::Allocate ());
-                netDevice->SetChannel (channel);
-                netDevice->SetRoutingDirection (NocRoutingProtocol::FORWARD, 1); // NORTH
-                m_devices.Add (netDevice);
-                // attach input buffering (we don't use output buffering for the moment)
-                Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                netDevice->SetInQueue (inQueue);
-                nocNode->AddDevice (netDevice);
-                nocNode->GetRouter ()->AddDevice (netDevice);
+                netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::FORWARD, 1); // NORTH
                 columnChannels[j] = channel;
               }
             else
@@ -187,24 +145,38 @@ namespace ns3
       }
     NS_LOG_DEBUG ("Done with printing the 2D mesh topology.");
 
+    CompleteInstall ();
+
     return m_devices;
   }
 
-  vector<uint8_t>
+  vector<uint32_t>
+  NocMesh2D::GetDimensionSizes () const
+  {
+    NS_ASSERT (m_hSize > 0);
+    vector<uint32_t> sizes;
+    sizes.push_back (m_hSize);
+    sizes.push_back (m_nodes.GetN () / m_hSize);
+    return sizes;
+  }
+
+  vector<NocCoordinate>
   NocMesh2D::GetDestinationRelativeDimensionalPosition (uint32_t sourceNodeId, uint32_t destinationNodeId)
   {
     NS_LOG_FUNCTION (sourceNodeId << destinationNodeId);
 
-    vector<uint8_t> relativePositions;
+    vector<NocCoordinate> relativePositions;
 
-    uint8_t sourceX = sourceNodeId % m_hSize;
-    uint8_t sourceY = sourceNodeId / m_hSize;
+    const uint32_t *sourceCoordinates = GetNodeCoordinates (sourceNodeId);
+    const uint32_t *destinationCoordinates = GetNodeCoordinates (destinationNodeId);
+    NocCoordinate sourceX = sourceCoordinates[0];
+    NocCoordinate sourceY = sourceCoordinates[1];
 
-    uint8_t destinationX = destinationNodeId % m_hSize;
-    uint8_t destinationY = destinationNodeId / m_hSize;
+    NocCoordinate destinationX = destinationCoordinates[0];
+    NocCoordinate destinationY = destinationCoordinates[1];
 
-    uint8_t relativeX = 0;
-    uint8_t relativeY = 0;
+    NocCoordinate relativeX = 0;
+    NocCoordinate relativeY = 0;
 
     if (destinationX < sourceX)
       {
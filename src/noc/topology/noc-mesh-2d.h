@@ -50,22 +50,27 @@ namespace ns3
     NetDeviceContainer
     Install (NodeContainer nodes);
 
-    vector<uint8_t>
+    vector<NocCoordinate>
     GetDestinationRelativeDimensionalPosition (uint32_t sourceNodeId, uint32_t destinationNodeId);
 
     void
     SaveTopology (NodeContainer nodes, string directoryPath);
 
+  protected:
+
+    virtual vector<uint32_t>
+    GetDimensionSizes () const;
+
   private:
 
     /**
      * how many nodes the 2D mesh will have on one horizontal line
      */
-    uint8_t m_hSize;
+    uint32_t m_hSize;
     /**
      * how many nodes the 2D mesh will have on one vertical line
      */
-    uint8_t m_vSize;
+    uint32_t m_vSize;
 
   };
 
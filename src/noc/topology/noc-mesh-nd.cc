@@ -115,26 +115,26 @@ namespace ns3
         Ptr<NocNode> nocNode = nodes.Get (i)->GetObject<NocNode> ();
         if (nocNode->GetRouter () == 0)
           {
-            Ptr<NocRouter> router = m_routerFactory.Create ()->GetObject<NocRouter> ();
-            router->SetNocNode (nocNode);
-            nocNode->SetRouter (router);
-            Ptr<NocRoutingProtocol> routingProtocol = m_routingProtocolFactory.Create ()->GetObject<NocRoutingProtocol> ();
-            router->SetRoutingProtocol (routingProtocol);
-            Ptr<NocSwitchingProtocol> switchingProtocol =
-                m_switchingProtocolFactory.Create ()->GetObject<NocSwitchingProtocol> ();
-            router->SetSwitchingProtocol (switchingProtocol);
+            InstallRouter (nocNode);
           }
       }
 
+    // the node ID strides of all the dimensions (and the number of nodes), computed only once
+    std::vector<uint32_t> strides (m_size.size () + 1);
+    for (unsigned int k = 0; k <= m_size.size (); k++)
+      {
+        strides[k] = GetNumberOfNodes (k);
+      }
+
     // create the channels (and net devices)
     for (unsigned int k = 0; k < m_size.size (); k++)
       {
         channel = 0;
-        std::vector<Ptr<NocChannel> > channels (GetNumberOfNodes (k));
+        std::vector<Ptr<NocChannel> > channels (strides[k]);
 
-        for (unsigned int i = 0; i < nodes.GetN (); i = i + GetNumberOfNodes (k))
+        for (unsigned int i = 0; i < nodes.GetN (); i = i + strides[k])
           {
-            for (unsigned int j = 0; j < GetNumberOfNodes (k); j++)
+            for (unsigned int j = 0; j < strides[k]; j++)
               {
 
                 Ptr<NocNode> nocNode = nodes.Get (i + j)->GetObject<NocNode> ();
@@ -142,30 +142,12 @@ namespace ns3
                 if (channels[j] != 0)
                   {
                     channel = channels[j];
-                    netDevice = CreateObject<NocNetDevice> ();
-                    netDevice->SetAddress (Mac48Address::Allocate ());
-                    netDevice->SetChannel (channel);
-                    netDevice->SetRoutingDirection (NocRoutingProtocol::BACK, k);
-                    m_devices.Add (netDevice);
-                    // attach input buffering (we don't use output buffering for the moment)
-                    Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                    netDevice->SetInQueue (inQueue);
-                    nocNode->AddDevice (netDevice);
-                    nocNode->GetRouter ()->AddDevice (netDevice);
+                    netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::BACK, k);
                   }
-                if (((i + j) % GetNumberOfNodes (k+1)) < (GetNumberOfNodes (k+1) - GetNumberOfNodes (k)))
+                if (((i + j) % strides[k + 1]) < (strides[k + 1] - strides[k]))
                   {
                     channel = m_channelFactory.Create ()->GetObject<NocChannel> ();
-                    netDevice = CreateObject<NocNetDevice> ();
-                    netDevice->SetAddress (Mac48Address::Allocate ());
-                    netDevice->SetChannel (channel);
-                    netDevice->SetRoutingDirection (NocRoutingProtocol::FORWARD, k);
-                    m_devices.Add (netDevice);
-                    // attach input buffering (we don't use output buffering for the moment)
-                    Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                    netDevice->SetInQueue (inQueue);
-                    nocNode->AddDevice (netDevice);
-                    nocNode->GetRouter ()->AddDevice (netDevice);
+                    netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::FORWARD, k);
                     channels[j] = channel;
                   }
                 else
@@ -184,53 +166,47 @@ namespace ns3
             << device->GetAddress () << " connected to channel " << device->GetChannel ()->GetId ());
       } NS_LOG_DEBUG ("Done with printing the "<<m_size.size() <<"D mesh topology.");
 
+    CompleteInstall ();
+
     return m_devices;
   }
 
-  vector<uint8_t>
-  NocMeshND::GetDestinationRelativeDimensionalPosition (uint32_t sourceNodeId, uint32_t destinationNodeId)
+  vector<uint32_t>
+  NocMeshND::GetDimensionSizes () const
   {
-    NS_LOG_FUNCTION (sourceNodeId << destinationNodeId);
-
-    vector<uint8_t> relativePositions = vector<uint8_t> (m_size.size());
-    vector<uint32_t> source = vector<uint32_t> (m_size.size());
-
-    for (unsigned int k = 0; k < m_size.size(); k++)
+    vector<uint32_t> sizes;
+    for (unsigned int i = 0; i < m_size.size (); i++)
       {
-        source.at (k) = (sourceNodeId / GetNumberOfNodes (k)) % m_size.at (k)->GetValue ();
-        NS_LOG_DEBUG ("dimension "<<(k+1)<<" source " << source.at(k));
+        sizes.push_back (m_size.at (i)->GetValue ());
       }
+    return sizes;
+  }
 
-    vector<uint32_t> destination = vector<uint32_t> (m_size.size());
-    //uint32_t g=0;
-    for (unsigned int k = 0; k < m_size.size(); k++)
-      {
-        //g=GetNumberOfNodes (k);
-        destination.at (k) = (destinationNodeId / GetNumberOfNodes (k)) % m_size.at (k)->GetValue ();
-        NS_LOG_DEBUG ("dimension "<<(k+1)<<" destination " << destination.at(k));
-      }
+  vector<NocCoordinate>
+  NocMeshND::GetDestinationRelativeDimensionalPosition (uint32_t sourceNodeId, uint32_t destinationNodeId)
+  {
+    NS_LOG_FUNCTION (sourceNodeId << destinationNodeId);
 
-    vector<uint8_t> relative = vector<uint8_t> (m_size.size(), 0);
+    const uint32_t *source = GetNodeCoordinates (sourceNodeId);
+    const uint32_t *destination = GetNodeCoordinates (destinationNodeId);
+    vector<NocCoordinate> relative (GetNumberOfDimensions (), 0);
 
-    for (unsigned int k = 0; k < m_size.size(); k++)
+    for (uint32_t k = 0; k < GetNumberOfDimensions (); k++)
       {
-        if (destination.at (k) < source.at (k))
-          {
-            relative.at(k) = NocHeader::DIRECTION_BIT_MASK;
-          }
-        relative.at (k) = relative.at (k) | std::abs ((int) (destination.at (k) - source.at (k)));
-        if ((relative.at (k) & NocHeader::DIRECTION_BIT_MASK) == NocHeader::DIRECTION_BIT_MASK)
+        NS_LOG_DEBUG ("dimension " << (k+1) << " source " << source[k] << " destination " << destination[k]);
+        if (destination[k] < source[k])
           {
-            NS_LOG_DEBUG ("dimension " << (k+1) << " relative " << " -" << (int) (relative.at(k) & NocHeader::OFFSET_BIT_MASK));
+            relative[k] = NocHeader::DIRECTION_BIT_MASK | (source[k] - destination[k]);
+            NS_LOG_DEBUG ("dimension " << (k+1) << " relative " << " -" << (int) (relative[k] & NocHeader::OFFSET_BIT_MASK));
           }
         else
           {
-            NS_LOG_DEBUG ("dimension " << (k+1) << " relative " << (int) (relative.at(k) & NocHeader::OFFSET_BIT_MASK));
+            relative[k] = destination[k] - source[k];
+            NS_LOG_DEBUG ("dimension " << (k+1) << " relative " << (int) relative[k]);
           }
-        relativePositions.at (k) = relative.at (k);
       }
 
-    return relativePositions;
+    return relative;
   }
 
   void
@@ -32,6 +32,12 @@
 #include "ns3/wormhole-switching.h"
 #include "ns3/vct-switching.h"
 #include "ns3/noc-packet-tag.h"
+#include "ns3/noc-cycle-engine.h"
+#include "ns3/noc-load-side-band.h"
+#include "ns3/noc-routing-table.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/node-list.h"
 
 using namespace std;
 
@@ -46,17 +52,61 @@ namespace ns3
   NocTopology::GetTypeId ()
   {
     static TypeId tid = TypeId("ns3::NocTopology")
-        .SetParent<Object> ();
+        .SetParent<Object> ()
+        .AddAttribute ("CycleDriven",
+                       "Whether the NoC is simulated clock cycle by clock cycle (by a NocCycleEngine), instead of "
+                       "scheduling a separate event for every flit. A global clock must be set. By default, false.",
+                       BooleanValue (false),
+                       MakeBooleanAccessor (&NocTopology::m_cycleDriven),
+                       MakeBooleanChecker ())
+        .AddAttribute ("RoutingTables",
+                       "Whether the dimension order routing protocols (XY, XYZ, DOR) route the head packets by looking up "
+                       "a routing table which is built when the topology is installed. Only four-way routers are supported. "
+                       "By default, true.",
+                       BooleanValue (true),
+                       MakeBooleanAccessor (&NocTopology::m_routingTables),
+                       MakeBooleanChecker ())
+        .AddAttribute ("VirtualChannels",
+                       "How many virtual channels each input port of a router has. With more than one virtual channel, "
+                       "the routers allocate the virtual channels and their switch once per clock cycle "
+                       "(a global clock must be set). By default, 1 (each input port has a single queue).",
+                       UintegerValue (1),
+                       MakeUintegerAccessor (&NocTopology::m_virtualChannels),
+                       MakeUintegerChecker<uint32_t> (1, NocVirtualChannelAllocator::MAX_VIRTUAL_CHANNELS))
+        .AddAttribute ("LoadSideBandPeriod",
+                       "After how many clock cycles the routers publish their load to their neighbors, through a "
+                       "side-band (see NocLoadSideBand). The load aware routing protocols (SO, SLB) then use these "
+                       "snapshots. A global clock must be set. By default, 0 (no side-band, the load travels with the head flits).",
+                       UintegerValue (0),
+                       MakeUintegerAccessor (&NocTopology::m_loadSideBandPeriod),
+                       MakeUintegerChecker<uint32_t> ())
+        .AddAttribute ("LoadSideBandLatency",
+                       "After how many clock cycles a load published through the side-band becomes visible to the "
+                       "neighbors. By default, 1.",
+                       UintegerValue (1),
+                       MakeUintegerAccessor (&NocTopology::m_loadSideBandLatency),
+                       MakeUintegerChecker<uint32_t> ());
     return tid;
   }
 
   NocTopology::NocTopology ()
+    : m_cycleDriven (false),
+      m_routingTables (true),
+      m_virtualChannels (1),
+      m_loadSideBandPeriod (0),
+      m_loadSideBandLatency (1),
+      m_firstAddressValue (0),
+      m_indexedRoutingDimensions (0)
   {
     NS_LOG_FUNCTION_NOARGS ();
 
     m_channelFactory.SetTypeId ("ns3::NocChannel");
     m_inQueueFactory.SetTypeId ("ns3::DropTailQueue");
     m_outQueueFactory.SetTypeId ("ns3::DropTailQueue");
+    m_arbiterFactory.SetTypeId ("ns3::RoundRobinArbiter");
+
+    m_context = CreateObject<NocSimulationContext> ();
+    m_context->SetTopology (this);
   }
 
   NocTopology::~NocTopology ()
@@ -64,6 +114,123 @@ namespace ns3
     NS_LOG_FUNCTION_NOARGS ();
   }
 
+  void
+  NocTopology::DoDispose ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    if (m_context != 0)
+      {
+        m_context->Dispose ();
+        m_context = 0;
+      }
+    Object::DoDispose ();
+  }
+
+  Ptr<NocSimulationContext>
+  NocTopology::GetContext () const
+  {
+    return m_context;
+  }
+
+  Ptr<NocRouter>
+  NocTopology::InstallRouter (Ptr<NocNode> nocNode)
+  {
+    Ptr<NocRouter> router = m_routerFactory.Create ()->GetObject<NocRouter> ();
+    router->SetNocNode (nocNode);
+    nocNode->SetRouter (router);
+    Ptr<NocRoutingProtocol> routingProtocol = m_routingProtocolFactory.Create ()->GetObject<NocRoutingProtocol> ();
+    router->SetRoutingProtocol (routingProtocol);
+    Ptr<NocSwitchingProtocol> switchingProtocol =
+        m_switchingProtocolFactory.Create ()->GetObject<NocSwitchingProtocol> ();
+    router->SetSwitchingProtocol (switchingProtocol);
+    return router;
+  }
+
+  Ptr<NocNetDevice>
+  NocTopology::InstallNetDevice (Ptr<NocNode> nocNode, Ptr<NocChannel> channel, int routingDirection,
+      uint32_t routingDimension)
+  {
+    Ptr<NocNetDevice> netDevice = CreateObject<NocNetDevice> ();
+    netDevice->SetAddress (Mac48Address::Allocate ());
+    netDevice->SetChannel (channel);
+    netDevice->SetRoutingDirection (routingDirection, routingDimension);
+    m_devices.Add (netDevice);
+    // attach input buffering (we don't use output buffering for the moment)
+    Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
+    netDevice->SetInQueue (inQueue);
+    nocNode->AddDevice (netDevice);
+    nocNode->GetRouter ()->AddDevice (netDevice);
+    return netDevice;
+  }
+
+  void
+  NocTopology::CompleteInstall ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    BuildIndex ();
+    BuildRoutingTables ();
+
+    if (m_cycleDriven)
+      {
+        NS_LOG_INFO ("The NoC is cycle driven");
+        m_context->SetCycleEngine (CreateObject<NocCycleEngine> ());
+      }
+    else
+      {
+        m_context->SetCycleEngine (0);
+      }
+
+    if (m_loadSideBandPeriod > 0)
+      {
+        NS_LOG_INFO ("The routers publish their load every " << m_loadSideBandPeriod << " clock cycles");
+        Ptr<NocLoadSideBand> sideBand = CreateObject<NocLoadSideBand> ();
+        m_context->SetLoadSideBand (sideBand);
+        sideBand->Install (m_nodes, m_loadSideBandPeriod, m_loadSideBandLatency);
+      }
+    else
+      {
+        m_context->SetLoadSideBand (0);
+      }
+
+    for (uint32_t i = 0; i < m_nodes.GetN (); ++i)
+      {
+        Ptr<NocNode> nocNode = m_nodes.Get (i)->GetObject<NocNode> ();
+        Ptr<NocRouter> router = nocNode->GetRouter ();
+        if (router != 0)
+          {
+            router->SetContext (m_context);
+            // the injection and the receive net devices of a router are not connected to channels
+            vector<Ptr<NocNetDevice> > injectionDevices = router->GetInjectionNetDevices ();
+            for (uint32_t j = 0; j < injectionDevices.size (); ++j)
+              {
+                injectionDevices[j]->SetContext (m_context);
+              }
+            if (router->GetReceiveNetDevice () != 0)
+              {
+                router->GetReceiveNetDevice ()->SetContext (m_context);
+              }
+            if (m_virtualChannels > 1)
+              {
+                router->EnableVirtualChannels (m_virtualChannels, m_inQueueFactory, m_arbiterFactory);
+              }
+          }
+      }
+    for (uint32_t i = 0; i < m_devices.GetN (); ++i)
+      {
+        Ptr<NocNetDevice> device = m_devices.Get (i)->GetObject<NocNetDevice> ();
+        device->SetContext (m_context);
+        Ptr<Channel> channel = device->GetChannel ();
+        if (channel != 0)
+          {
+            channel->GetObject<NocChannel> ()->SetContext (m_context);
+          }
+        // the virtual channels of all the routers are known now
+        device->InitializeCredits ();
+      }
+  }
+
   void
   NocTopology::SetChannelAttribute (std::string n1, const AttributeValue &v1)
   {
@@ -98,6 +265,17 @@ namespace ns3
     m_outQueueFactory.Set (n4, v4);
   }
 
+  void
+  NocTopology::SetArbiter (std::string type, std::string n1, const AttributeValue &v1, std::string n2,
+      const AttributeValue &v2)
+  {
+    NS_LOG_FUNCTION (type);
+
+    m_arbiterFactory.SetTypeId (type);
+    m_arbiterFactory.Set (n1, v1);
+    m_arbiterFactory.Set (n2, v2);
+  }
+
   void
   NocTopology::SetRouter (string type)
   {
@@ -304,18 +482,26 @@ namespace ns3
     NS_LOG_FUNCTION_NOARGS ();
 
     Packet::EnablePrinting ();
+
+    // the trace sources are connected directly (with the same context which Config::Connect would give),
+    // because resolving a /NodeList/<node ID> path takes time proportional to the number of nodes
+    Ptr<NocNetDevice> device = NodeList::GetNode (nodeid)->GetDevice (deviceid)->GetObject<NocNetDevice> ();
+    if (device == 0)
+      {
+        return;
+      }
     std::ostringstream oss;
 
     oss << "/NodeList/" << nodeid << "/DeviceList/" << deviceid << "/$ns3::NocNetDevice/Send";
-    Config::Connect (oss.str (), MakeBoundCallback (&NocTopology::AsciiTxEvent, stream));
+    device->TraceConnect ("Send", oss.str (), MakeBoundCallback (&NocTopology::AsciiTxEvent, stream));
     oss.str ("");
 
     oss << "/NodeList/" << nodeid << "/DeviceList/" << deviceid << "/$ns3::NocNetDevice/Receive";
-    Config::Connect (oss.str (), MakeBoundCallback (&NocTopology::AsciiRxEvent, stream));
+    device->TraceConnect ("Receive", oss.str (), MakeBoundCallback (&NocTopology::AsciiRxEvent, stream));
     oss.str ("");
 
     oss << "/NodeList/" << nodeid << "/DeviceList/" << deviceid << "/$ns3::NocNetDevice/Drop";
-    Config::Connect (oss.str (), MakeBoundCallback (&NocTopology::AsciiDropEvent, stream));
+    device->TraceConnect ("Drop", oss.str (), MakeBoundCallback (&NocTopology::AsciiDropEvent, stream));
     oss.str ("");
   }
 
@@ -356,19 +542,225 @@ namespace ns3
     EnableAscii (stream, NodeContainer::GetGlobal ());
   }
 
+  void
+  NocTopology::EnableBinary (Ptr<NocBinaryTraceWriter> writer, uint32_t nodeid, uint32_t deviceid)
+  {
+    NS_LOG_FUNCTION (nodeid << deviceid);
+    NS_ASSERT_MSG (writer->IsOpen (), "The binary trace file must be opened before the tracing is enabled");
+
+    Ptr<NocNetDevice> device = NodeList::GetNode (nodeid)->GetDevice (deviceid)->GetObject<NocNetDevice> ();
+    if (device != 0)
+      {
+        writer->Connect (device);
+      }
+  }
+
+  void
+  NocTopology::EnableBinary (Ptr<NocBinaryTraceWriter> writer, NetDeviceContainer d)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    for (NetDeviceContainer::Iterator i = d.Begin (); i != d.End (); ++i)
+      {
+        Ptr<NetDevice> dev = *i;
+        EnableBinary (writer, dev->GetNode ()->GetId (), dev->GetIfIndex ());
+      }
+  }
+
+  void
+  NocTopology::EnableBinary (Ptr<NocBinaryTraceWriter> writer, NodeContainer n)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    NetDeviceContainer devs;
+    for (NodeContainer::Iterator i = n.Begin (); i != n.End (); ++i)
+      {
+        Ptr<Node> node = *i;
+        for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+          {
+            devs.Add (node->GetDevice (j));
+          }
+      }
+    EnableBinary (writer, devs);
+  }
+
+  void
+  NocTopology::EnableBinaryAll (Ptr<NocBinaryTraceWriter> writer)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    EnableBinary (writer, NodeContainer::GetGlobal ());
+  }
+
+  vector<uint32_t>
+  NocTopology::GetDimensionSizes () const
+  {
+    return vector<uint32_t> (1, m_nodes.GetN ());
+  }
+
+  uint64_t
+  NocTopology::GetAddressValue (Mac48Address address)
+  {
+    uint8_t buffer[6];
+    address.CopyTo (buffer);
+    uint64_t value = 0;
+    for (int i = 0; i < 6; ++i)
+      {
+        value = (value << 8) | buffer[i];
+      }
+    return value;
+  }
+
+  void
+  NocTopology::BuildIndex ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    // net devices, by address
+    m_devicesByAddress.clear ();
+    m_sparseDevicesByAddress.clear ();
+    m_firstAddressValue = 0;
+    if (m_devices.GetN () > 0)
+      {
+        uint64_t firstAddressValue = GetAddressValue (Mac48Address::ConvertFrom (m_devices.Get (0)->GetAddress ()));
+        uint64_t lastAddressValue = firstAddressValue;
+        for (uint32_t i = 1; i < m_devices.GetN (); ++i)
+          {
+            uint64_t value = GetAddressValue (Mac48Address::ConvertFrom (m_devices.Get (i)->GetAddress ()));
+            firstAddressValue = std::min (firstAddressValue, value);
+            lastAddressValue = std::max (lastAddressValue, value);
+          }
+        m_firstAddressValue = firstAddressValue;
+        // the routers allocate addresses for their internal net devices too, so some gaps are expected
+        bool dense = lastAddressValue - firstAddressValue < 4 * (uint64_t) m_devices.GetN () + 64;
+        if (dense)
+          {
+            m_devicesByAddress.resize (lastAddressValue - firstAddressValue + 1);
+          }
+        for (uint32_t i = 0; i < m_devices.GetN (); ++i)
+          {
+            Ptr<NocNetDevice> device = m_devices.Get (i)->GetObject<NocNetDevice> ();
+            uint64_t value = GetAddressValue (Mac48Address::ConvertFrom (device->GetAddress ()));
+            if (dense)
+              {
+                m_devicesByAddress[value - m_firstAddressValue] = device;
+              }
+            else
+              {
+                m_sparseDevicesByAddress[value] = device;
+              }
+          }
+        NS_LOG_DEBUG ("Indexed " << m_devices.GetN () << " net devices by address ("
+            << (dense ? "dense" : "sparse") << " index)");
+      }
+
+    // node coordinates
+    uint32_t maxNodeId = 0;
+    for (uint32_t i = 0; i < m_nodes.GetN (); ++i)
+      {
+        maxNodeId = std::max (maxNodeId, m_nodes.Get (i)->GetId ());
+      }
+    m_dimensionSizes = GetDimensionSizes ();
+    uint32_t dimensions = m_dimensionSizes.size ();
+    for (uint32_t k = 0; k < dimensions; ++k)
+      {
+        // the offsets carried by the headers must be able to cross the whole dimension
+        NS_ASSERT_MSG (m_dimensionSizes[k] <= (uint32_t) NocHeader::OFFSET_BIT_MASK + 1, "Dimension " << k
+            << " has " << m_dimensionSizes[k] << " nodes, but the NoC headers allow at most "
+            << (uint32_t) NocHeader::OFFSET_BIT_MASK + 1 << " (configure with --enable-noc-wide-coordinates)");
+      }
+    m_dimensionStrides.resize (dimensions);
+    uint32_t stride = 1;
+    for (uint32_t k = 0; k < dimensions; ++k)
+      {
+        NS_ASSERT (m_dimensionSizes[k] > 0);
+        m_dimensionStrides[k] = stride;
+        stride *= m_dimensionSizes[k];
+      }
+    m_nodeCoordinates.assign ((maxNodeId + 1) * dimensions, 0);
+    m_nodesById.assign (maxNodeId + 1, 0);
+    for (uint32_t i = 0; i < m_nodes.GetN (); ++i)
+      {
+        uint32_t nodeId = m_nodes.Get (i)->GetId ();
+        m_nodesById[nodeId] = m_nodes.Get (i)->GetObject<NocNode> ();
+        for (uint32_t k = 0; k < dimensions; ++k)
+          {
+            m_nodeCoordinates[nodeId * dimensions + k] = nodeId / m_dimensionStrides[k] % m_dimensionSizes[k];
+          }
+      }
+
+    // relative positions, by dimension and coordinate difference
+    // (computed by the topology for two nodes which differ only in that dimension)
+    m_relativeCoordinateOffsets.resize (dimensions);
+    m_relativeCoordinates.clear ();
+    if (m_nodes.GetN () >= stride)
+      {
+        for (uint32_t k = 0; k < dimensions; ++k)
+          {
+            uint32_t size = m_dimensionSizes[k];
+            m_relativeCoordinateOffsets[k] = m_relativeCoordinates.size ();
+            m_relativeCoordinates.resize (m_relativeCoordinates.size () + 2 * size - 1, 0);
+            for (uint32_t d = 0; d < 2 * size - 1; ++d)
+              {
+                // the difference is d - (size - 1)
+                uint32_t source = d < size - 1 ? size - 1 - d : 0;
+                uint32_t destination = source + d - (size - 1);
+                if (source != destination)
+                  {
+                    m_relativeCoordinates[m_relativeCoordinateOffsets[k] + d] = GetDestinationRelativeDimensionalPosition (
+                        source * m_dimensionStrides[k], destination * m_dimensionStrides[k]).at (k);
+                  }
+              }
+          }
+      }
+
+    // net devices, by node, routing direction and routing dimension
+    m_indexedRoutingDimensions = dimensions;
+    for (uint32_t i = 0; i < m_devices.GetN (); ++i)
+      {
+        Ptr<NocNetDevice> device = m_devices.Get (i)->GetObject<NocNetDevice> ();
+        m_indexedRoutingDimensions = std::max (m_indexedRoutingDimensions, (uint32_t) device->GetRoutingDimension () + 1);
+      }
+    m_devicesByDirection.clear ();
+    m_devicesByDirection.resize ((maxNodeId + 1) * m_indexedRoutingDimensions * 2);
+    for (uint32_t i = 0; i < m_devices.GetN (); ++i)
+      {
+        Ptr<NocNetDevice> device = m_devices.Get (i)->GetObject<NocNetDevice> ();
+        int direction = device->GetRoutingDirection ();
+        if (direction == NocRoutingProtocol::FORWARD || direction == NocRoutingProtocol::BACK)
+          {
+            uint32_t slot = (device->GetNode ()->GetId () * m_indexedRoutingDimensions
+                + device->GetRoutingDimension ()) * 2 + (direction == NocRoutingProtocol::BACK ? 1 : 0);
+            NS_ASSERT (slot < m_devicesByDirection.size ());
+            // keep the first net device (the same net device which a linear search would find)
+            if (m_devicesByDirection[slot] == 0)
+              {
+                m_devicesByDirection[slot] = device;
+              }
+          }
+      }
+  }
+
   Ptr<NocNetDevice>
   NocTopology::FindNetDeviceByAddress (Mac48Address address)
   {
     NS_LOG_FUNCTION_NOARGS ();
 
     Ptr<NocNetDevice> nocNetDevice = 0;
-    for (unsigned int i = 0; i < m_devices.GetN (); ++i)
+    uint64_t value = GetAddressValue (address);
+    if (!m_devicesByAddress.empty ())
       {
-        Ptr<NetDevice> netDevice = m_devices.Get (i);
-        Mac48Address macAddress = Mac48Address::ConvertFrom (netDevice->GetAddress ());
-        if (macAddress == address)
+        if (value >= m_firstAddressValue && value - m_firstAddressValue < m_devicesByAddress.size ())
           {
-            nocNetDevice = netDevice->GetObject<NocNetDevice> ();
+            nocNetDevice = m_devicesByAddress[value - m_firstAddressValue];
+          }
+      }
+    else
+      {
+        map<uint64_t, Ptr<NocNetDevice> >::const_iterator it = m_sparseDevicesByAddress.find (value);
+        if (it != m_sparseDevicesByAddress.end ())
+          {
+            nocNetDevice = it->second;
           }
       }
 
@@ -377,6 +769,154 @@ namespace ns3
     return nocNetDevice;
   }
 
+  Ptr<NocNetDevice>
+  NocTopology::GetNetDevice (uint32_t nodeId, int routingDirection, int routingDimension) const
+  {
+    Ptr<NocNetDevice> device = 0;
+    if (routingDimension >= 0 && (uint32_t) routingDimension < m_indexedRoutingDimensions
+        && (routingDirection == NocRoutingProtocol::FORWARD || routingDirection == NocRoutingProtocol::BACK))
+      {
+        uint32_t slot = (nodeId * m_indexedRoutingDimensions + routingDimension) * 2
+            + (routingDirection == NocRoutingProtocol::BACK ? 1 : 0);
+        if (slot < m_devicesByDirection.size ())
+          {
+            device = m_devicesByDirection[slot];
+          }
+      }
+    return device;
+  }
+
+  uint32_t
+  NocTopology::GetNumberOfDimensions () const
+  {
+    return m_dimensionSizes.size ();
+  }
+
+  uint32_t
+  NocTopology::GetDimensionSize (uint32_t dimension) const
+  {
+    NS_ASSERT_MSG (dimension < m_dimensionSizes.size (), "The topology has only "
+        << m_dimensionSizes.size () << " dimensions");
+    return m_dimensionSizes[dimension];
+  }
+
+  void
+  NocTopology::BuildRoutingTables ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    if (!m_routingTables)
+      {
+        return;
+      }
+    uint32_t numberOfNodes = 1;
+    for (uint32_t k = 0; k < m_dimensionSizes.size (); ++k)
+      {
+        numberOfNodes *= m_dimensionSizes[k];
+      }
+    if (numberOfNodes != m_nodes.GetN ())
+      {
+        NS_LOG_INFO ("No routing tables are used because the nodes do not fill the topology");
+        return;
+      }
+
+    // the routers which use the same dimension order share the same table
+    map<vector<uint32_t>, Ptr<NocRoutingTable> > tables;
+    uint32_t routers = 0;
+    for (uint32_t i = 0; i < m_nodes.GetN (); ++i)
+      {
+        Ptr<NocNode> nocNode = m_nodes.Get (i)->GetObject<NocNode> ();
+        Ptr<NocRouter> router = nocNode->GetRouter ();
+        if (router == 0 || !router->HasFixedOutputNetDevices () || router->GetRoutingProtocol () == 0)
+          {
+            continue;
+          }
+        Ptr<NocRoutingProtocol> routingProtocol = router->GetRoutingProtocol ();
+        vector<uint32_t> order;
+        if (!routingProtocol->GetDimensionOrder (order) || order.size () != m_dimensionSizes.size ())
+          {
+            continue;
+          }
+        Ptr<NocRoutingTable> table = tables[order];
+        if (table == 0)
+          {
+            table = CreateObject<NocRoutingTable> ();
+            table->Build (this, order);
+            tables[order] = table;
+          }
+        routingProtocol->SetRoutingTable (table);
+        routers++;
+      }
+
+    uint64_t memory = 0;
+    for (map<vector<uint32_t>, Ptr<NocRoutingTable> >::iterator it = tables.begin (); it != tables.end (); ++it)
+      {
+        memory += it->second->GetMemoryUsage ();
+      }
+    NS_LOG_INFO (routers << " routers use " << tables.size () << " routing tables (" << memory << " bytes)");
+  }
+
+  Ptr<NocNode>
+  NocTopology::GetNocNode (uint32_t nodeId) const
+  {
+    if (nodeId < m_nodesById.size ())
+      {
+        return m_nodesById[nodeId];
+      }
+    return 0;
+  }
+
+  const uint32_t *
+  NocTopology::GetNodeCoordinates (uint32_t nodeId) const
+  {
+    NS_ASSERT_MSG ((nodeId + 1) * m_dimensionSizes.size () <= m_nodeCoordinates.size (),
+        "Node " << nodeId << " does not belong to the topology (or the topology is not installed)");
+    return &m_nodeCoordinates[nodeId * m_dimensionSizes.size ()];
+  }
+
+  uint32_t
+  NocTopology::GetDimensionStride (uint32_t dimension) const
+  {
+    NS_ASSERT_MSG (dimension < m_dimensionStrides.size (), "The topology has only "
+        << m_dimensionStrides.size () << " dimensions");
+    return m_dimensionStrides[dimension];
+  }
+
+  uint32_t
+  NocTopology::GetNodeId (const uint32_t *coordinates) const
+  {
+    uint32_t nodeId = 0;
+    for (uint32_t k = 0; k < m_dimensionStrides.size (); ++k)
+      {
+        nodeId += coordinates[k] * m_dimensionStrides[k];
+      }
+    return nodeId;
+  }
+
+  NocCoordinate
+  NocTopology::GetRelativeCoordinate (uint32_t dimension, uint32_t source, uint32_t destination) const
+  {
+    NS_ASSERT_MSG (dimension < m_relativeCoordinateOffsets.size () && !m_relativeCoordinates.empty (),
+        "The relative positions are not available (the topology is not installed or it is incomplete)");
+    NS_ASSERT (source < m_dimensionSizes[dimension] && destination < m_dimensionSizes[dimension]);
+    return m_relativeCoordinates[m_relativeCoordinateOffsets[dimension] + destination + m_dimensionSizes[dimension] - 1
+        - source];
+  }
+
+  uint32_t
+  NocTopology::GetDestinationRelativePosition (uint32_t sourceNodeId, uint32_t destinationNodeId,
+      NocCoordinate *relative) const
+  {
+    const uint32_t *source = GetNodeCoordinates (sourceNodeId);
+    const uint32_t *destination = GetNodeCoordinates (destinationNodeId);
+    uint32_t dimensions = m_dimensionSizes.size ();
+    for (uint32_t k = 0; k < dimensions; ++k)
+      {
+        relative[k] = GetRelativeCoordinate (k, source[k], destination[k]);
+      }
+    return dimensions;
+  }
+
   void
   NocTopology::AsciiTxEvent (Ptr<OutputStreamWrapper> stream, std::string path, Ptr<const Packet> packet)
   {
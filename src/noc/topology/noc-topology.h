@@ -25,6 +25,7 @@
 #define NOCTOPOLOGY_H_
 
 #include "ns3/noc-channel.h"
+#include "ns3/noc-header.h"
 #include "ns3/net-device-container.h"
 #include "ns3/node-container.h"
 #include "ns3/noc-router.h"
@@ -32,6 +33,8 @@
 #include "ns3/noc-switching-protocol.h"
 #include "ns3/trace-helper.h"
 #include "ns3/object-factory.h"
+#include "ns3/noc-simulation-context.h"
+#include "ns3/noc-binary-trace-writer.h"
 
 #include "../../../../NoC-XML/src/ro/ulbsibiu/acaps/noc/xml/link/link.hxx"
 #include "../../../../NoC-XML/src/ro/ulbsibiu/acaps/noc/xml/node/node.hxx"
@@ -49,6 +52,8 @@ namespace ns3
 {
 
   class NocChannel;
+  class NocNode;
+  class NocRouter;
 
   /**
    * The topology for a Network-on-Chip.
@@ -167,6 +172,20 @@ namespace ns3
     void
     SetSwitchingProtocolAttribute (string attributeName, const AttributeValue &attributeValue);
 
+    /**
+     * Sets the type of the arbiters used by the virtual channel and switch allocators of the routers
+     * (only when the VirtualChannels attribute is greater than one). It must be a child of ns3::NocArbiter.
+     *
+     * \param type the arbiter type
+     * \param n1 the name of the attribute to set on the arbiter
+     * \param v1 the value of the attribute to set on the arbiter
+     * \param n2 the name of the attribute to set on the arbiter
+     * \param v2 the value of the attribute to set on the arbiter
+     */
+    void
+    SetArbiter (string type, string n1 = "", const AttributeValue &v1 = EmptyAttributeValue (), string n2 = "",
+        const AttributeValue &v2 = EmptyAttributeValue ());
+
     /**
      * Uses ORION to get the dynamic power consumed by this NoC.
      *
@@ -246,6 +265,48 @@ namespace ns3
     static void
     EnableAsciiAll (Ptr<OutputStreamWrapper> stream);
 
+    /**
+     * \param writer the binary trace writer (its trace file must be open)
+     * \param nodeid the id of the node to generate binary trace records for.
+     * \param deviceid the id of the device to generate binary trace records for.
+     *
+     * Enable binary tracing (of the sent and received flits) on the specified deviceid
+     * within the specified nodeid, which must be of type ns3::NocNetDevice.
+     */
+    static void
+    EnableBinary (Ptr<NocBinaryTraceWriter> writer, uint32_t nodeid, uint32_t deviceid);
+
+    /**
+     * \param writer the binary trace writer (its trace file must be open)
+     * \param d device container
+     *
+     * Enable binary tracing on each device which is of the
+     * ns3::NocNetDevice type and which is located in the input
+     * device container.
+     */
+    static void
+    EnableBinary (Ptr<NocBinaryTraceWriter> writer, NetDeviceContainer d);
+
+    /**
+     * \param writer the binary trace writer (its trace file must be open)
+     * \param n node container
+     *
+     * Enable binary tracing on each device which is of the
+     * ns3::NocNetDevice type and which is located in one
+     * of the input nodes.
+     */
+    static void
+    EnableBinary (Ptr<NocBinaryTraceWriter> writer, NodeContainer n);
+
+    /**
+     * \param writer the binary trace writer (its trace file must be open)
+     *
+     * Enable binary tracing on each device which is of the
+     * ns3::NocNetDevice type.
+     */
+    static void
+    EnableBinaryAll (Ptr<NocBinaryTraceWriter> writer);
+
     /**
      * Installs the topology on the given Network-on-Chip nodes
      *
@@ -262,10 +323,35 @@ namespace ns3
      * \param destinationNodeId the destination node
      *
      * \return an array with the destination's relative position in each dimension
+     *
+     * \see GetDestinationRelativePosition (the allocation-free version, used when flits are injected)
      */
-    virtual vector<uint8_t>
+    virtual vector<NocCoordinate>
     GetDestinationRelativeDimensionalPosition (uint32_t sourceNodeId, uint32_t destinationNodeId) = 0;
 
+    /**
+     * Same as GetDestinationRelativeDimensionalPosition, but the relative positions are looked up in the
+     * tables built when the topology was installed and they are written into a buffer given by the caller.
+     *
+     * \param sourceNodeId the source node
+     * \param destinationNodeId the destination node
+     * \param relative the buffer for the relative positions (it must have room for GetNumberOfDimensions () values)
+     *
+     * \return the number of dimensions (how many relative positions were written)
+     */
+    uint32_t
+    GetDestinationRelativePosition (uint32_t sourceNodeId, uint32_t destinationNodeId, NocCoordinate *relative) const;
+
+    /**
+     * \param dimension a topological dimension
+     * \param source the coordinate of the source node, in that dimension
+     * \param destination the coordinate of the destination node, in that dimension
+     *
+     * \return the relative position of the destination, in the specified dimension (see NocHeader)
+     */
+    NocCoordinate
+    GetRelativeCoordinate (uint32_t dimension, uint32_t source, uint32_t destination) const;
+
     /**
      * Saves this topology using the NoC-XML interface: for each NocNode and NocChannel, an XML file is built.
      * The node XMLs are put in the nodes directory, and the link XMLs are put in the links directory.
@@ -278,11 +364,135 @@ namespace ns3
     virtual void
     SaveTopology (NodeContainer nodes, string directoryPath) = 0;
 
+    /**
+     * Finds a net device of this topology, by its (MAC) address.
+     * The lookup uses the index built when the topology is installed.
+     *
+     * \param address the address of the net device
+     *
+     * \return the net device
+     */
     Ptr<NocNetDevice>
     FindNetDeviceByAddress (Mac48Address address);
 
+    /**
+     * Retrieves the net device which a node uses for the specified routing direction and dimension
+     * (if more net devices match, the first one added to the node is returned).
+     * The lookup uses the index built when the topology is installed.
+     *
+     * \param nodeId the ID of the node
+     * \param routingDirection the routing direction
+     * \param routingDimension the routing dimension
+     *
+     * \return the net device, or NULL if the node has no such net device
+     */
+    Ptr<NocNetDevice>
+    GetNetDevice (uint32_t nodeId, int routingDirection, int routingDimension) const;
+
+    /**
+     * Retrieves a node of this topology, by its ID.
+     * The lookup uses the index built when the topology is installed.
+     *
+     * \param nodeId the ID of the node
+     *
+     * \return the node, or NULL if the node does not belong to this topology
+     */
+    Ptr<NocNode>
+    GetNocNode (uint32_t nodeId) const;
+
+    /**
+     * \return the number of topological dimensions
+     */
+    uint32_t
+    GetNumberOfDimensions () const;
+
+    /**
+     * \param dimension a topological dimension
+     *
+     * \return how many nodes the topology has in the specified dimension
+     */
+    uint32_t
+    GetDimensionSize (uint32_t dimension) const;
+
+    /**
+     * Retrieves the coordinates of a node, as they were computed when the topology was installed.
+     * Coordinate i is the position of the node in the topological dimension i.
+     *
+     * \param nodeId the ID of the node
+     *
+     * \return a pointer to the GetNumberOfDimensions () coordinates of the node
+     */
+    const uint32_t *
+    GetNodeCoordinates (uint32_t nodeId) const;
+
+    /**
+     * \param dimension a topological dimension
+     *
+     * \return by how much the node ID changes when the coordinate from the specified dimension is incremented
+     *         (the product of the sizes of the previous dimensions)
+     */
+    uint32_t
+    GetDimensionStride (uint32_t dimension) const;
+
+    /**
+     * \param coordinates the GetNumberOfDimensions () coordinates of a node
+     *
+     * \return the ID of the node
+     */
+    uint32_t
+    GetNodeId (const uint32_t *coordinates) const;
+
+    /**
+     * \return the simulation context of this topology (shared by all the NoC components of the topology)
+     */
+    Ptr<NocSimulationContext>
+    GetContext () const;
+
 protected:
 
+    virtual void
+    DoDispose ();
+
+    /**
+     * Must be invoked by every topology at the end of its Install method.
+     * It hands the simulation context to all the routers, net devices and channels of this topology.
+     */
+    void
+    CompleteInstall ();
+
+    /**
+     * Creates the router of a node, together with its routing and switching protocols
+     * (with the factories of this topology).
+     *
+     * \param nocNode the node
+     *
+     * \return the router
+     */
+    Ptr<NocRouter>
+    InstallRouter (Ptr<NocNode> nocNode);
+
+    /**
+     * Creates a net device (with an input queue), attaches it to a channel and adds it to a node,
+     * to the router of that node and to the net devices of this topology.
+     *
+     * \param nocNode the node (it must already have a router)
+     * \param channel the channel
+     * \param routingDirection the routing direction of the net device
+     * \param routingDimension the routing dimension of the net device
+     *
+     * \return the net device
+     */
+    Ptr<NocNetDevice>
+    InstallNetDevice (Ptr<NocNode> nocNode, Ptr<NocChannel> channel, int routingDirection, uint32_t routingDimension);
+
+    /**
+     * \return how many nodes the topology has in each dimension (row-major order is assumed,
+     *         i.e. the node ID increases first along the first dimension).
+     *         By default, the topology is considered to have a single dimension.
+     */
+    virtual vector<uint32_t>
+    GetDimensionSizes () const;
+
     NodeContainer m_nodes;
 
     NetDeviceContainer m_devices;
@@ -299,8 +509,122 @@ protected:
 
     ObjectFactory m_switchingProtocolFactory;
 
+    ObjectFactory m_arbiterFactory;
+
   private:
 
+    /**
+     * the simulation context of this topology
+     */
+    Ptr<NocSimulationContext> m_context;
+
+    /**
+     * whether the NoC is simulated by a cycle engine or by scheduling an event for every flit
+     */
+    bool m_cycleDriven;
+
+    /**
+     * whether the dimension order routing protocols use routing tables, instead of computing every route
+     */
+    bool m_routingTables;
+
+    /**
+     * how many virtual channels each input port of a router has
+     */
+    uint32_t m_virtualChannels;
+
+    /**
+     * after how many clock cycles the routers publish their load through the load side-band
+     * (zero if the load travels with the head flits)
+     */
+    uint32_t m_loadSideBandPeriod;
+
+    /**
+     * after how many clock cycles a load published through the side-band becomes visible
+     */
+    uint32_t m_loadSideBandLatency;
+
+    /**
+     * Builds the address, coordinates and (node, direction, dimension) indexes of this topology
+     */
+    void
+    BuildIndex ();
+
+    /**
+     * Builds the routing tables (one for every dimension order) and hands them to the routing protocols
+     * which can use them
+     */
+    void
+    BuildRoutingTables ();
+
+    /**
+     * \param address a (MAC) address
+     *
+     * \return the numeric value of the address
+     */
+    static uint64_t
+    GetAddressValue (Mac48Address address);
+
+    /**
+     * the smallest address value of the net devices from this topology
+     */
+    uint64_t m_firstAddressValue;
+
+    /**
+     * the net devices of this topology, indexed by their address value (relative to m_firstAddressValue).
+     * Addresses are allocated consecutively, so this index is dense.
+     */
+    vector<Ptr<NocNetDevice> > m_devicesByAddress;
+
+    /**
+     * the net devices indexed by their address value, used only when the addresses are too sparse
+     * to be kept in m_devicesByAddress
+     */
+    map<uint64_t, Ptr<NocNetDevice> > m_sparseDevicesByAddress;
+
+    /**
+     * the size of the topology, for each dimension
+     */
+    vector<uint32_t> m_dimensionSizes;
+
+    /**
+     * the coordinates of all the nodes (node ID * number of dimensions + dimension)
+     */
+    vector<uint32_t> m_nodeCoordinates;
+
+    /**
+     * the node ID stride of each dimension
+     */
+    vector<uint32_t> m_dimensionStrides;
+
+    /**
+     * the relative positions, for every dimension and every difference between two coordinates:
+     * for dimension k, the element m_relativeCoordinateOffsets[k] + (destination - source + size of k - 1)
+     * (the relative positions depend only on this difference, even for the wraparound links of a torus)
+     */
+    vector<NocCoordinate> m_relativeCoordinates;
+
+    /**
+     * where the relative positions of every dimension start, in m_relativeCoordinates
+     */
+    vector<uint32_t> m_relativeCoordinateOffsets;
+
+    /**
+     * the nodes of this topology, indexed by their ID
+     */
+    vector<Ptr<NocNode> > m_nodesById;
+
+    /**
+     * how many routing dimensions are kept in m_devicesByDirection, for each node
+     */
+    uint32_t m_indexedRoutingDimensions;
+
+    /**
+     * the net devices, indexed by node ID, routing dimension and routing direction
+     * ((node ID * m_indexedRoutingDimensions + dimension) * 2 + (direction == BACK))
+     */
+    vector<Ptr<NocNetDevice> > m_devicesByDirection;
+
     /*
      * \internal
      */
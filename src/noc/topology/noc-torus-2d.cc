@@ -34,6 +34,7 @@
 #include "ns3/noc-packet-tag.h"
 #include "ns3/uinteger.h"
 #include "ns3/file-utils.h"
+#include "ns3/noc-header.h"
 
 NS_LOG_COMPONENT_DEFINE ("NocTorus2D");
 
@@ -51,11 +52,11 @@ namespace ns3
                 .AddAttribute("hSize",
                                 "how many nodes the 2D torus will have on one horizontal line",
                                 UintegerValue(4), MakeUintegerAccessor(&NocTorus2D::m_hSize),
-                                MakeUintegerChecker<uint32_t> (1, 127))
+                                MakeUintegerChecker<uint32_t> (1, NocHeader::OFFSET_BIT_MASK + 1))
                 .AddAttribute("vSize",
                                 "how many nodes the 2D torus will have on one vertical line",
                                 UintegerValue(4), MakeUintegerAccessor(&NocTorus2D::m_vSize),
-                                MakeUintegerChecker<uint32_t> (1, 127));
+                                MakeUintegerChecker<uint32_t> (1, NocHeader::OFFSET_BIT_MASK + 1));
     return tid;
   }
 
@@ -86,14 +87,7 @@ namespace ns3
         Ptr<NocNode> nocNode = nodes.Get (i)->GetObject<NocNode> ();
         if (nocNode->GetRouter () == 0)
           {
-            Ptr<NocRouter> router = m_routerFactory.Create ()->GetObject<NocRouter> ();
-            router->SetNocNode (nocNode);
-            nocNode->SetRouter (router);
-            Ptr<NocRoutingProtocol> routingProtocol = m_routingProtocolFactory.Create ()->GetObject<NocRoutingProtocol> ();
-            router->SetRoutingProtocol (routingProtocol);
-            Ptr<NocSwitchingProtocol> switchingProtocol =
-                m_switchingProtocolFactory.Create ()->GetObject<NocSwitchingProtocol> ();
-            router->SetSwitchingProtocol (switchingProtocol);
+            InstallRouter (nocNode);
           }
       }
 
@@ -103,31 +97,13 @@ namespace ns3
         Ptr<NocNode> nocNode = nodes.Get (i)->GetObject<NocNode> ();
         if (channel != 0)
           {
-            netDevice = CreateObject<NocNetDevice> ();
-            netDevice->SetAddress (Mac48Address::Allocate ());
-            netDevice->SetChannel (channel);
-            netDevice->SetRoutingDirection (NocRoutingProtocol::BACK, 0); // WEST
-            m_devices.Add (netDevice);
-            // attach input buffering (we don't use output buffering for the moment)
-            Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-            netDevice->SetInQueue (inQueue);
-            nocNode->AddDevice (netDevice);
-            nocNode->GetRouter ()->AddDevice (netDevice);
+            netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::BACK, 0); // WEST
           }
 
         if (i == 0 || (i > 0 && (i + 1) % m_hSize != 0))
           {
             channel = m_channelFactory.Create ()->GetObject<NocChannel> ();
-            netDevice = CreateObject<NocNetDevice> ();
-            netDevice->SetAddress (Mac48Address::Allocate ());
-            netDevice->SetChannel (channel);
-            netDevice->SetRoutingDirection (NocRoutingProtocol::FORWARD, 0); // EAST
-            m_devices.Add (netDevice);
-            // attach input buffering (we don't use output buffering for the moment)
-            Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-            netDevice->SetInQueue (inQueue);
-            nocNode->AddDevice (netDevice);
-            nocNode->GetRouter ()->AddDevice (netDevice);
+            netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::FORWARD, 0); // EAST
           }
         else
           {
@@ -136,29 +112,11 @@ namespace ns3
         if (i == 0 || (i > 0 && i % m_hSize == 0))
           {
             channel_torus = m_channelFactory.Create ()->GetObject<NocChannel> ();
-            netDevice = CreateObject<NocNetDevice> ();
-            netDevice->SetAddress (Mac48Address::Allocate ());
-            netDevice->SetChannel (channel_torus);
-            netDevice->SetRoutingDirection (NocRoutingProtocol::BACK, 0); // WEST
-            m_devices.Add (netDevice);
-            // attach input buffering (we don't use output buffering for the moment)
-            Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-            netDevice->SetInQueue (inQueue);
-            nocNode->AddDevice (netDevice);
-            nocNode->GetRouter ()->AddDevice (netDevice);
+            netDevice = InstallNetDevice (nocNode, channel_torus, NocRoutingProtocol::BACK, 0); // WEST
           }
         if ((i + 1) % m_hSize == 0)
           {
-            netDevice = CreateObject<NocNetDevice> ();
-            netDevice->SetAddress (Mac48Address::Allocate ());
-            netDevice->SetChannel (channel_torus);
-            netDevice->SetRoutingDirection (NocRoutingProtocol::FORWARD, 0); // EAST
-            m_devices.Add (netDevice);
-            // attach input buffering (we don't use output buffering for the moment)
-            Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-            netDevice->SetInQueue (inQueue);
-            nocNode->AddDevice (netDevice);
-            nocNode->GetRouter ()->AddDevice (netDevice);
+            netDevice = InstallNetDevice (nocNode, channel_torus, NocRoutingProtocol::FORWARD, 0); // EAST
           }
       }
 
@@ -174,30 +132,12 @@ namespace ns3
             if (columnChannels[j] != 0)
               {
                 channel = columnChannels[j];
-                netDevice = CreateObject<NocNetDevice> ();
-                netDevice->SetAddress (Mac48Address::Allocate ());
-                netDevice->SetChannel (channel);
-                netDevice->SetRoutingDirection (NocRoutingProtocol::BACK, 1); // SOUTH
-                m_devices.Add (netDevice);
-                // attach input buffering (we don't use output buffering for the moment)
-                Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                netDevice->SetInQueue (inQueue);
-                nocNode->AddDevice (netDevice);
-                nocNode->GetRouter ()->AddDevice (netDevice);
+                netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::BACK, 1); // SOUTH
               }
             if (i < nodes.GetN () - m_hSize)
               {
                 channel = m_channelFactory.Create ()->GetObject<NocChannel> ();
-                netDevice = CreateObject<NocNetDevice> ();
-                netDevice->SetAddress (Mac48Address::Allocate ());
-                netDevice->SetChannel (channel);
-                netDevice->SetRoutingDirection (NocRoutingProtocol::FORWARD, 1); // NORTH
-                m_devices.Add (netDevice);
-                // attach input buffering (we don't use output buffering for the moment)
-                Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                netDevice->SetInQueue (inQueue);
-                nocNode->AddDevice (netDevice);
-                nocNode->GetRouter ()->AddDevice (netDevice);
+                netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::FORWARD, 1); // NORTH
                 columnChannels[j] = channel;
               }
             else
@@ -207,31 +147,13 @@ namespace ns3
             if (i < m_hSize)
               {
                 channel = m_channelFactory.Create ()->GetObject<NocChannel> ();
-                netDevice = CreateObject<NocNetDevice> ();
-                netDevice->SetAddress (Mac48Address::Allocate ());
-                netDevice->SetChannel (channel);
-                netDevice->SetRoutingDirection (NocRoutingProtocol::BACK, 1); // SOUTH
-                m_devices.Add (netDevice);
-                // attach input buffering (we don't use output buffering for the moment)
-                Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                netDevice->SetInQueue (inQueue);
-                nocNode->AddDevice (netDevice);
-                nocNode->GetRouter ()->AddDevice (netDevice);
+                netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::BACK, 1); // SOUTH
                 columnChannels_torus[j] = channel;
               }
             if (i >= nodes.GetN () - m_hSize)
               {
                 channel = columnChannels_torus[j];
-                netDevice = CreateObject<NocNetDevice> ();
-                netDevice->SetAddress (Mac48Address::Allocate ());
-                netDevice->SetChannel (channel);
-                netDevice->SetRoutingDirection (NocRoutingProtocol::FORWARD, 1); // NORTH
-                m_devices.Add (netDevice);
-                // attach input buffering (we don't use output buffering for the moment)
-                Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                netDevice->SetInQueue (inQueue);
-                nocNode->AddDevice (netDevice);
-                nocNode->GetRouter ()->AddDevice (netDevice);
+                netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::FORWARD, 1); // NORTH
               }
           }
       }
@@ -246,24 +168,38 @@ namespace ns3
       }
       NS_LOG_DEBUG ("Done with printing the 2D torus topology.");
 
+    CompleteInstall ();
+
     return m_devices;
   }
 
-  vector<uint8_t>
+  vector<uint32_t>
+  NocTorus2D::GetDimensionSizes () const
+  {
+    NS_ASSERT (m_hSize > 0);
+    vector<uint32_t> sizes;
+    sizes.push_back (m_hSize);
+    sizes.push_back (m_nodes.GetN () / m_hSize);
+    return sizes;
+  }
+
+  vector<NocCoordinate>
   NocTorus2D::GetDestinationRelativeDimensionalPosition (uint32_t sourceNodeId, uint32_t destinationNodeId)
   {
     NS_LOG_FUNCTION (sourceNodeId << destinationNodeId);
 
-    vector<uint8_t> relativePositions;
+    vector<NocCoordinate> relativePositions;
 
-    uint8_t sourceX = sourceNodeId % m_hSize;
-    uint8_t sourceY = sourceNodeId / m_hSize;
+    const uint32_t *sourceCoordinates = GetNodeCoordinates (sourceNodeId);
+    const uint32_t *destinationCoordinates = GetNodeCoordinates (destinationNodeId);
+    NocCoordinate sourceX = sourceCoordinates[0];
+    NocCoordinate sourceY = sourceCoordinates[1];
 
-    uint8_t destinationX = destinationNodeId % m_hSize;
-    uint8_t destinationY = destinationNodeId / m_hSize;
+    NocCoordinate destinationX = destinationCoordinates[0];
+    NocCoordinate destinationY = destinationCoordinates[1];
 
-    uint8_t relativeX = 0;
-    uint8_t relativeY = 0;
+    NocCoordinate relativeX = 0;
+    NocCoordinate relativeY = 0;
 
     int xOffset = ((int) (destinationX - sourceX)) >= 0 ? (destinationX - sourceX) % m_hSize : (m_hSize + destinationX
         - sourceX) % m_hSize;
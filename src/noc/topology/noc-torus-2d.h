@@ -52,12 +52,17 @@ namespace ns3
     NetDeviceContainer
     Install (NodeContainer nodes);
 
-    vector<uint8_t>
+    vector<NocCoordinate>
     GetDestinationRelativeDimensionalPosition (uint32_t sourceNodeId, uint32_t destinationNodeId);
 
     void
     SaveTopology (NodeContainer nodes, string directoryPath);
 
+  protected:
+
+    virtual vector<uint32_t>
+    GetDimensionSizes () const;
+
   private:
 
     /**
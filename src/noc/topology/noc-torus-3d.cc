@@ -33,6 +33,7 @@
 #include "ns3/noc-packet-tag.h"
 #include "ns3/uinteger.h"
 #include "ns3/file-utils.h"
+#include "ns3/noc-header.h"
 
 NS_LOG_COMPONENT_DEFINE ("NocTorus3D");
 
@@ -50,11 +51,11 @@ namespace ns3
         .AddAttribute ("hSize",
                 "how many nodes the 3D torus will have on one horizontal line",
                 UintegerValue (4), MakeUintegerAccessor (&NocTorus3D::m_hSize),
-                MakeUintegerChecker<uint32_t> (1, 127))
+                MakeUintegerChecker<uint32_t> (1, NocHeader::OFFSET_BIT_MASK + 1))
         .AddAttribute ("vSize",
                 "how many nodes the 3D torus will have on one vertical line",
                 UintegerValue (4), MakeUintegerAccessor (&NocTorus3D::m_vSize),
-                MakeUintegerChecker<uint32_t> (1, 127));
+                MakeUintegerChecker<uint32_t> (1, NocHeader::OFFSET_BIT_MASK + 1));
     return tid;
   }
 
@@ -89,14 +90,7 @@ namespace ns3
         Ptr<NocNode> nocNode = nodes.Get (i)->GetObject<NocNode> ();
         if (nocNode->GetRouter () == 0)
           {
-            Ptr<NocRouter> router = m_routerFactory.Create ()->GetObject<NocRouter> ();
-            router->SetNocNode (nocNode);
-            nocNode->SetRouter (router);
-            Ptr<NocRoutingProtocol> routingProtocol = m_routingProtocolFactory.Create ()->GetObject<NocRoutingProtocol> ();
-            router->SetRoutingProtocol (routingProtocol);
-            Ptr<NocSwitchingProtocol> switchingProtocol =
-                m_switchingProtocolFactory.Create ()->GetObject<NocSwitchingProtocol> ();
-            router->SetSwitchingProtocol (switchingProtocol);
+            InstallRouter (nocNode);
           }
       }
 
@@ -106,31 +100,13 @@ namespace ns3
         Ptr<NocNode> nocNode = nodes.Get (i)->GetObject<NocNode> ();
         if (channel != 0)
           {
-            netDevice = CreateObject<NocNetDevice> ();
-            netDevice->SetAddress (Mac48Address::Allocate ());
-            netDevice->SetChannel (channel);
-            netDevice->SetRoutingDirection (NocRoutingProtocol::BACK, 0); // WEST
-            m_devices.Add (netDevice);
-            // attach input buffering (we don't use output buffering for the moment)
-            Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-            netDevice->SetInQueue (inQueue);
-            nocNode->AddDevice (netDevice);
-            nocNode->GetRouter ()->AddDevice (netDevice);
+            netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::BACK, 0); // WEST
           }
 
         if (i == 0 || (i > 0 && (i + 1) % m_hSize != 0))
           {
             channel = m_channelFactory.Create ()->GetObject<NocChannel> ();
-            netDevice = CreateObject<NocNetDevice> ();
-            netDevice->SetAddress (Mac48Address::Allocate ());
-            netDevice->SetChannel (channel);
-            netDevice->SetRoutingDirection (NocRoutingProtocol::FORWARD, 0); // EAST
-            m_devices.Add (netDevice);
-            // attach input buffering (we don't use output buffering for the moment)
-            Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-            netDevice->SetInQueue (inQueue);
-            nocNode->AddDevice (netDevice);
-            nocNode->GetRouter ()->AddDevice (netDevice);
+            netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::FORWARD, 0); // EAST
           }
         else
           {
@@ -139,29 +115,11 @@ namespace ns3
         if (i == 0 || (i > 0 && i % m_hSize == 0))
           {
             channel_torus = m_channelFactory.Create ()->GetObject<NocChannel> ();
-            netDevice = CreateObject<NocNetDevice> ();
-            netDevice->SetAddress (Mac48Address::Allocate ());
-            netDevice->SetChannel (channel_torus);
-            netDevice->SetRoutingDirection (NocRoutingProtocol::BACK, 0); // WEST
-            m_devices.Add (netDevice);
-            // attach input buffering (we don't use output buffering for the moment)
-            Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-            netDevice->SetInQueue (inQueue);
-            nocNode->AddDevice (netDevice);
-            nocNode->GetRouter ()->AddDevice (netDevice);
+            netDevice = InstallNetDevice (nocNode, channel_torus, NocRoutingProtocol::BACK, 0); // WEST
           }
         if ((i + 1) % m_hSize == 0)
           {
-            netDevice = CreateObject<NocNetDevice> ();
-            netDevice->SetAddress (Mac48Address::Allocate ());
-            netDevice->SetChannel (channel_torus);
-            netDevice->SetRoutingDirection (NocRoutingProtocol::FORWARD, 0); // EAST
-            m_devices.Add (netDevice);
-            // attach input buffering (we don't use output buffering for the moment)
-            Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-            netDevice->SetInQueue (inQueue);
-            nocNode->AddDevice (netDevice);
-            nocNode->GetRouter ()->AddDevice (netDevice);
+            netDevice = InstallNetDevice (nocNode, channel_torus, NocRoutingProtocol::FORWARD, 0); // EAST
           }
       }
 
@@ -177,30 +135,12 @@ namespace ns3
             if (columnChannels[j] != 0)
               {
                 channel = columnChannels[j];
-                netDevice = CreateObject<NocNetDevice> ();
-                netDevice->SetAddress (Mac48Address::Allocate ());
-                netDevice->SetChannel (channel);
-                netDevice->SetRoutingDirection (NocRoutingProtocol::BACK, 1); // SOUTH
-                m_devices.Add (netDevice);
-                // attach input buffering (we don't use output buffering for the moment)
-                Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                netDevice->SetInQueue (inQueue);
-                nocNode->AddDevice (netDevice);
-                nocNode->GetRouter ()->AddDevice (netDevice);
+                netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::BACK, 1); // SOUTH
               }
             if ((i % numberOfNodesXY) < (numberOfNodesXY - m_hSize))
               {
                 channel = m_channelFactory.Create ()->GetObject<NocChannel> ();
-                netDevice = CreateObject<NocNetDevice> ();
-                netDevice->SetAddress (Mac48Address::Allocate ());
-                netDevice->SetChannel (channel);
-                netDevice->SetRoutingDirection (NocRoutingProtocol::FORWARD, 1); // NORTH
-                m_devices.Add (netDevice);
-                // attach input buffering (we don't use output buffering for the moment)
-                Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                netDevice->SetInQueue (inQueue);
-                nocNode->AddDevice (netDevice);
-                nocNode->GetRouter ()->AddDevice (netDevice);
+                netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::FORWARD, 1); // NORTH
                 columnChannels[j] = channel;
               }
             else
@@ -210,31 +150,13 @@ namespace ns3
             if (i % numberOfNodesXY < m_hSize)
               {
                 channel = m_channelFactory.Create ()->GetObject<NocChannel> ();
-                netDevice = CreateObject<NocNetDevice> ();
-                netDevice->SetAddress (Mac48Address::Allocate ());
-                netDevice->SetChannel (channel);
-                netDevice->SetRoutingDirection (NocRoutingProtocol::BACK, 1); // SOUTH
-                m_devices.Add (netDevice);
-                // attach input buffering (we don't use output buffering for the moment)
-                Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                netDevice->SetInQueue (inQueue);
-                nocNode->AddDevice (netDevice);
-                nocNode->GetRouter ()->AddDevice (netDevice);
+                netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::BACK, 1); // SOUTH
                 columnChannels_torus[j] = channel;
               }
             if ((i % numberOfNodesXY) >= (numberOfNodesXY - m_hSize))
               {
                 channel = columnChannels_torus[j];
-                netDevice = CreateObject<NocNetDevice> ();
-                netDevice->SetAddress (Mac48Address::Allocate ());
-                netDevice->SetChannel (channel);
-                netDevice->SetRoutingDirection (NocRoutingProtocol::FORWARD, 1); // NORTH
-                m_devices.Add (netDevice);
-                // attach input buffering (we don't use output buffering for the moment)
-                Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                netDevice->SetInQueue (inQueue);
-                nocNode->AddDevice (netDevice);
-                nocNode->GetRouter ()->AddDevice (netDevice);
+                netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::FORWARD, 1); // NORTH
               }
           }
       }
@@ -252,30 +174,12 @@ namespace ns3
             if (channel3D[j] != 0)
               {
                 channel = channel3D[j];
-                netDevice = CreateObject<NocNetDevice> ();
-                netDevice->SetAddress (Mac48Address::Allocate ());
-                netDevice->SetChannel (channel);
-                netDevice->SetRoutingDirection (NocRoutingProtocol::BACK, 2); // DOWN
-                m_devices.Add (netDevice);
-                // attach input buffering (we don't use output buffering for the moment)
-                Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                netDevice->SetInQueue (inQueue);
-                nocNode->AddDevice (netDevice);
-                nocNode->GetRouter ()->AddDevice (netDevice);
+                netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::BACK, 2); // DOWN
               }
             if (i < nodes.GetN () - (numberOfNodesXY))
               {
                 channel = m_channelFactory.Create ()->GetObject<NocChannel> ();
-                netDevice = CreateObject<NocNetDevice> ();
-                netDevice->SetAddress (Mac48Address::Allocate ());
-                netDevice->SetChannel (channel);
-                netDevice->SetRoutingDirection (NocRoutingProtocol::FORWARD, 2); // UP
-                m_devices.Add (netDevice);
-                // attach input buffering (we don't use output buffering for the moment)
-                Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                netDevice->SetInQueue (inQueue);
-                nocNode->AddDevice (netDevice);
-                nocNode->GetRouter ()->AddDevice (netDevice);
+                netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::FORWARD, 2); // UP
                 channel3D[j] = channel;
               }
             else
@@ -285,31 +189,13 @@ namespace ns3
             if (i < numberOfNodesXY)
               {
                 channel = m_channelFactory.Create ()->GetObject<NocChannel> ();
-                netDevice = CreateObject<NocNetDevice> ();
-                netDevice->SetAddress (Mac48Address::Allocate ());
-                netDevice->SetChannel (channel);
-                netDevice->SetRoutingDirection (NocRoutingProtocol::BACK, 2); // DOWN
-                m_devices.Add (netDevice);
-                // attach input buffering (we don't use output buffering for the moment)
-                Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                netDevice->SetInQueue (inQueue);
-                nocNode->AddDevice (netDevice);
-                nocNode->GetRouter ()->AddDevice (netDevice);
+                netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::BACK, 2); // DOWN
                 channel3D_torus[j] = channel;
               }
             if (i >= nodes.GetN () - (numberOfNodesXY))
               {
                 channel = channel3D_torus[j];
-                netDevice = CreateObject<NocNetDevice> ();
-                netDevice->SetAddress (Mac48Address::Allocate ());
-                netDevice->SetChannel (channel);
-                netDevice->SetRoutingDirection (NocRoutingProtocol::FORWARD, 2); // UP
-                m_devices.Add (netDevice);
-                // attach input buffering (we don't use output buffering for the moment)
-                Ptr<Queue> inQueue = m_inQueueFactory.Create<Queue> ();
-                netDevice->SetInQueue (inQueue);
-                nocNode->AddDevice (netDevice);
-                nocNode->GetRouter ()->AddDevice (netDevice);
+                netDevice = InstallNetDevice (nocNode, channel, NocRoutingProtocol::FORWARD, 2); // UP
               }
           }
       }
@@ -322,33 +208,48 @@ namespace ns3
       }
     NS_LOG_DEBUG ("Done with printing the 3D torus topology.");
 
+    CompleteInstall ();
+
     return m_devices;
   }
 
-  vector<uint8_t>
+  vector<uint32_t>
+  NocTorus3D::GetDimensionSizes () const
+  {
+    NS_ASSERT (m_hSize > 0 && m_vSize > 0);
+    vector<uint32_t> sizes;
+    sizes.push_back (m_hSize);
+    sizes.push_back (m_vSize);
+    sizes.push_back (m_nodes.GetN () / m_hSize / m_vSize);
+    return sizes;
+  }
+
+  vector<NocCoordinate>
   NocTorus3D::GetDestinationRelativeDimensionalPosition (uint32_t sourceNodeId, uint32_t destinationNodeId)
   {
     NS_LOG_FUNCTION (sourceNodeId << destinationNodeId);
 
-    vector<uint8_t> relativePositions;
+    vector<NocCoordinate> relativePositions;
 
-    uint32_t sourceX = sourceNodeId % m_hSize;
-    uint32_t sourceY = sourceNodeId % (m_hSize * m_vSize) / m_hSize;
-    uint32_t sourceZ = sourceNodeId / m_hSize / m_vSize;
+    const uint32_t *sourceCoordinates = GetNodeCoordinates (sourceNodeId);
+    const uint32_t *destinationCoordinates = GetNodeCoordinates (destinationNodeId);
+    uint32_t sourceX = sourceCoordinates[0];
+    uint32_t sourceY = sourceCoordinates[1];
+    uint32_t sourceZ = sourceCoordinates[2];
     NS_LOG_DEBUG ("source X = " << sourceX);
     NS_LOG_DEBUG ("source Y = " << sourceY);
     NS_LOG_DEBUG ("source Z = " << sourceZ);
 
-    uint8_t destinationX = destinationNodeId % m_hSize;
-    uint8_t destinationY = destinationNodeId % (m_hSize * m_vSize) / m_hSize;
-    uint8_t destinationZ = destinationNodeId / m_hSize / m_vSize;
+    NocCoordinate destinationX = destinationCoordinates[0];
+    NocCoordinate destinationY = destinationCoordinates[1];
+    NocCoordinate destinationZ = destinationCoordinates[2];
     NS_LOG_DEBUG ("destination X = " <<(int) destinationX);
     NS_LOG_DEBUG ("destination Y = " <<(int) destinationY);
     NS_LOG_DEBUG ("destination Z = " <<(int) destinationZ);
 
-    uint8_t relativeX = 0;
-    uint8_t relativeY = 0;
-    uint8_t relativeZ = 0;
+    NocCoordinate relativeX = 0;
+    NocCoordinate relativeY = 0;
+    NocCoordinate relativeZ = 0;
 
     int xOffset = ((int) (destinationX - sourceX)) >= 0 ? (destinationX - sourceX) % m_hSize : (m_hSize + destinationX
         - sourceX) % m_hSize;
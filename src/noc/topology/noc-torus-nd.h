@@ -54,7 +54,7 @@ namespace ns3
     NetDeviceContainer
     Install (NodeContainer nodes);
 
-    vector<uint8_t>
+    vector<NocCoordinate>
     GetDestinationRelativeDimensionalPosition (uint32_t sourceNodeId, uint32_t destinationNodeId);
 
     uint32_t
@@ -63,6 +63,11 @@ namespace ns3
     void
     SaveTopology (NodeContainer nodes, string directoryPath);
 
+  protected:
+
+    virtual vector<uint32_t>
+    GetDimensionSizes () const;
+
   private:
 
     /**
@@ -23,6 +23,7 @@
 
 // Implementation for ns3 NocValue base class.
 #include "noc-value.h"
+#include "ns3/noc-header.h"
 
 using namespace std;
 
@@ -39,7 +40,7 @@ NS_OBJECT_ENSURE_REGISTERED (NocValue);
         .SetParent<Object> ()
         .AddAttribute ("Value", "What value does it have",
               UintegerValue (0), MakeUintegerAccessor (&NocValue::m_value),
-              MakeUintegerChecker<uint32_t> (1, 127))
+              MakeUintegerChecker<uint32_t> (1, NocHeader::OFFSET_BIT_MASK + 1))
     ;
     return tid;
   }
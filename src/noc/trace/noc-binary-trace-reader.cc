@@ -0,0 +1,221 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-binary-trace-reader.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+NS_LOG_COMPONENT_DEFINE ("NocBinaryTraceReader");
+
+namespace ns3
+{
+
+  NocBinaryTraceReader::NocBinaryTraceReader ()
+  {
+    m_map = 0;
+    m_mapSize = 0;
+    m_records = 0;
+    m_cachedBlock = -1;
+    memset (&m_header, 0, sizeof (m_header));
+  }
+
+  NocBinaryTraceReader::~NocBinaryTraceReader ()
+  {
+    Close ();
+  }
+
+  bool
+  NocBinaryTraceReader::Open (std::string fileName)
+  {
+    NS_LOG_FUNCTION (fileName);
+
+    Close ();
+    int fd = open (fileName.c_str (), O_RDONLY);
+    if (fd < 0)
+      {
+        NS_LOG_ERROR ("Could not open the trace file " << fileName);
+        return false;
+      }
+    struct stat status;
+    if (fstat (fd, &status) != 0 || (uint64_t) status.st_size < sizeof (NocTraceFileHeader))
+      {
+        NS_LOG_ERROR (fileName << " is not a binary NoC trace (it is too small)");
+        close (fd);
+        return false;
+      }
+    void *map = mmap (0, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping remains valid after the file is closed
+    close (fd);
+    if (map == MAP_FAILED)
+      {
+        NS_LOG_ERROR ("Could not map the trace file " << fileName << " into memory");
+        return false;
+      }
+    m_map = (uint8_t *) map;
+    m_mapSize = status.st_size;
+
+    memcpy (&m_header, m_map, sizeof (m_header));
+    if (memcmp (m_header.m_magic, NOC_TRACE_MAGIC, sizeof (m_header.m_magic)) != 0
+        || m_header.m_version != NOC_TRACE_VERSION || m_header.m_recordSize != sizeof (NocTraceRecord))
+      {
+        NS_LOG_ERROR (fileName << " is not a binary NoC trace (or it has an unsupported version)");
+        Close ();
+        return false;
+      }
+    if (m_header.m_byteOrder != NOC_TRACE_BYTE_ORDER)
+      {
+        NS_LOG_ERROR (fileName << " was written by a host with a different byte order");
+        Close ();
+        return false;
+      }
+
+    uint64_t offset = sizeof (NocTraceFileHeader);
+    while (offset + sizeof (NocTraceBlockHeader) <= m_mapSize)
+      {
+        NocTraceBlockHeader blockHeader;
+        memcpy (&blockHeader, m_map + offset, sizeof (blockHeader));
+        offset += sizeof (blockHeader);
+        if (offset + blockHeader.m_bytes > m_mapSize || (!IsCompressed ()
+            && blockHeader.m_bytes != blockHeader.m_records * sizeof (NocTraceRecord)))
+          {
+            NS_LOG_WARN ("Ignoring the incomplete block from the end of " << fileName);
+            break;
+          }
+        Block block;
+        block.m_firstRecord = m_records;
+        block.m_records = blockHeader.m_records;
+        block.m_bytes = blockHeader.m_bytes;
+        block.m_data = m_map + offset;
+        m_blocks.push_back (block);
+        m_records += blockHeader.m_records;
+        offset += blockHeader.m_bytes;
+      }
+    NS_LOG_INFO (fileName << " has " << m_records << " records, in " << m_blocks.size () << " blocks");
+
+    return true;
+  }
+
+  void
+  NocBinaryTraceReader::Close ()
+  {
+    if (m_map != 0)
+      {
+        munmap (m_map, m_mapSize);
+        m_map = 0;
+      }
+    m_mapSize = 0;
+    m_records = 0;
+    m_blocks.clear ();
+    m_cache.clear ();
+    m_cachedBlock = -1;
+  }
+
+  bool
+  NocBinaryTraceReader::IsOpen () const
+  {
+    return m_map != 0;
+  }
+
+  int64_t
+  NocBinaryTraceReader::GetGlobalClock () const
+  {
+    return m_header.m_clock;
+  }
+
+  bool
+  NocBinaryTraceReader::IsCompressed () const
+  {
+    return (m_header.m_flags & NOC_TRACE_COMPRESSED) != 0;
+  }
+
+  uint64_t
+  NocBinaryTraceReader::GetNRecords () const
+  {
+    return m_records;
+  }
+
+  uint32_t
+  NocBinaryTraceReader::FindBlock (uint64_t index) const
+  {
+    // binary search for the last block which starts at or before the record
+    uint32_t low = 0;
+    uint32_t high = m_blocks.size ();
+    while (high - low > 1)
+      {
+        uint32_t middle = low + (high - low) / 2;
+        if (m_blocks[middle].m_firstRecord <= index)
+          {
+            low = middle;
+          }
+        else
+          {
+            high = middle;
+          }
+      }
+    return low;
+  }
+
+  const NocTraceRecord *
+  NocBinaryTraceReader::GetRecord (uint64_t index)
+  {
+    NS_ASSERT_MSG (index < m_records, "The trace has only " << m_records << " records (requested record " << index << ")");
+
+    uint32_t blockIndex;
+    if (m_cachedBlock >= 0 && index >= m_blocks[m_cachedBlock].m_firstRecord
+        && index < m_blocks[m_cachedBlock].m_firstRecord + m_blocks[m_cachedBlock].m_records)
+      {
+        blockIndex = m_cachedBlock;
+      }
+    else
+      {
+        blockIndex = FindBlock (index);
+      }
+    const Block &block = m_blocks[blockIndex];
+
+    if (!IsCompressed ())
+      {
+        // the records are 8 bytes aligned inside the file, so they can be used in place
+        m_cachedBlock = blockIndex;
+        return ((const NocTraceRecord *) block.m_data) + (index - block.m_firstRecord);
+      }
+
+    if (m_cachedBlock != (int64_t) blockIndex)
+      {
+        m_cache.resize (block.m_records);
+        if (!NocTraceDecodeBlock (block.m_data, block.m_bytes, block.m_records, &m_cache[0]))
+          {
+            NS_LOG_ERROR ("Block " << blockIndex << " of the trace is corrupted");
+            m_cachedBlock = -1;
+            return 0;
+          }
+        m_cachedBlock = blockIndex;
+      }
+    return &m_cache[index - block.m_firstRecord];
+  }
+
+} // namespace ns3
@@ -0,0 +1,165 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCBINARYTRACEREADER_H_
+#define NOCBINARYTRACEREADER_H_
+
+#include "noc-trace-format.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+  /**
+   * \brief Reads a binary NoC trace (written by a NocBinaryTraceWriter)
+   *
+   * \detail The trace file is memory mapped, so opening a trace does not read it: only its block headers
+   *         are visited, to index the blocks. The records of an uncompressed trace are accessed in place.
+   *         The records of a compressed trace are decompressed one block at a time (the last decompressed
+   *         block is kept), so reading the records in order is cheap.
+   *
+   *         The reader does not depend on the simulator, so it can be used by standalone analysis tools.
+   */
+  class NocBinaryTraceReader
+  {
+  public:
+
+    NocBinaryTraceReader ();
+
+    ~NocBinaryTraceReader ();
+
+    /**
+     * Opens (and maps into memory) a trace file. A block which was not completely written
+     * (the simulation was interrupted) is ignored.
+     *
+     * \param fileName the name of the trace file
+     *
+     * \return false, if the file could not be opened or it is not a binary NoC trace
+     */
+    bool
+    Open (std::string fileName);
+
+    /**
+     * Unmaps the trace file
+     */
+    void
+    Close ();
+
+    /**
+     * \return whether or not a trace file is open
+     */
+    bool
+    IsOpen () const;
+
+    /**
+     * \return the global clock of the traced simulation, in picoseconds
+     */
+    int64_t
+    GetGlobalClock () const;
+
+    /**
+     * \return whether or not the trace is compressed
+     */
+    bool
+    IsCompressed () const;
+
+    /**
+     * \return how many records the trace has
+     */
+    uint64_t
+    GetNRecords () const;
+
+    /**
+     * \param index the index of the record (smaller than GetNRecords ())
+     *
+     * \return the record (the pointer is valid until the next call),
+     *         or 0 if the compressed block of the record is corrupted
+     */
+    const NocTraceRecord *
+    GetRecord (uint64_t index);
+
+  private:
+
+    NocBinaryTraceReader (const NocBinaryTraceReader &);
+
+    NocBinaryTraceReader &
+    operator= (const NocBinaryTraceReader &);
+
+    /**
+     * \param index the index of a record
+     *
+     * \return the index of the block which holds the record
+     */
+    uint32_t
+    FindBlock (uint64_t index) const;
+
+    /**
+     * A block of records, from the mapped file
+     */
+    struct Block
+    {
+      /**
+       * the index of the first record of the block
+       */
+      uint64_t m_firstRecord;
+
+      uint32_t m_records;
+
+      uint32_t m_bytes;
+
+      /**
+       * the (encoded) records, inside the mapped file
+       */
+      const uint8_t *m_data;
+    };
+
+    std::vector<Block> m_blocks;
+
+    /**
+     * the mapped file
+     */
+    uint8_t *m_map;
+
+    uint64_t m_mapSize;
+
+    NocTraceFileHeader m_header;
+
+    uint64_t m_records;
+
+    /**
+     * the records of the last decompressed block
+     */
+    std::vector<NocTraceRecord> m_cache;
+
+    /**
+     * the index of the last decompressed block (-1 if there is none)
+     */
+    int64_t m_cachedBlock;
+
+  };
+
+} // namespace ns3
+
+#endif /* NOCBINARYTRACEREADER_H_ */
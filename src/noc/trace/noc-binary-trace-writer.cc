@@ -0,0 +1,255 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-binary-trace-writer.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/noc-packet-tag.h"
+#include "ns3/pointer.h"
+#include <string.h>
+
+NS_LOG_COMPONENT_DEFINE ("NocBinaryTraceWriter");
+
+namespace ns3
+{
+
+  NS_OBJECT_ENSURE_REGISTERED (NocBinaryTraceWriter);
+
+  TypeId
+  NocBinaryTraceWriter::GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::NocBinaryTraceWriter")
+        .SetParent<Object> ()
+        .AddConstructor<NocBinaryTraceWriter> ()
+        .AddAttribute ("BlockRecords",
+            "How many records are buffered before they are written into the file, as a block (default is 4096)",
+            UintegerValue (4096),
+            MakeUintegerAccessor (&NocBinaryTraceWriter::m_blockRecords),
+            MakeUintegerChecker<uint32_t> (1))
+        .AddAttribute ("Compression",
+            "Whether or not the blocks of records are compressed (default is false). "
+            "It must be set before the trace file is opened.",
+            BooleanValue (false),
+            MakeBooleanAccessor (&NocBinaryTraceWriter::m_compression),
+            MakeBooleanChecker ())
+        ;
+    return tid;
+  }
+
+  NocBinaryTraceWriter::NocBinaryTraceWriter ()
+  {
+    m_clock = 0;
+    m_records = 0;
+  }
+
+  NocBinaryTraceWriter::~NocBinaryTraceWriter ()
+  {
+    ;
+  }
+
+  void
+  NocBinaryTraceWriter::DoDispose ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+    Close ();
+    Object::DoDispose ();
+  }
+
+  bool
+  NocBinaryTraceWriter::Open (std::string fileName, int64_t globalClock)
+  {
+    NS_LOG_FUNCTION (fileName << globalClock);
+    NS_ASSERT_MSG (globalClock > 0, "The flit events are recorded in clock cycles, so a global clock is required");
+
+    Close ();
+    m_file.open (fileName.c_str (), std::ios_base::binary | std::ios_base::out | std::ios_base::trunc);
+    if (!m_file.is_open ())
+      {
+        NS_LOG_ERROR ("Could not create the trace file " << fileName);
+        return false;
+      }
+    m_clock = globalClock;
+    m_records = 0;
+    m_buffer.clear ();
+    m_buffer.reserve (m_blockRecords);
+
+    NocTraceFileHeader header;
+    memcpy (header.m_magic, NOC_TRACE_MAGIC, sizeof (header.m_magic));
+    header.m_version = NOC_TRACE_VERSION;
+    header.m_byteOrder = NOC_TRACE_BYTE_ORDER;
+    header.m_recordSize = sizeof (NocTraceRecord);
+    header.m_flags = m_compression ? NOC_TRACE_COMPRESSED : 0;
+    header.m_clock = m_clock;
+    m_file.write ((const char *) &header, sizeof (header));
+    return true;
+  }
+
+  void
+  NocBinaryTraceWriter::Close ()
+  {
+    if (m_file.is_open ())
+      {
+        Flush ();
+        m_file.close ();
+        NS_LOG_INFO ("Closed a binary trace with " << m_records << " records");
+      }
+  }
+
+  bool
+  NocBinaryTraceWriter::IsOpen () const
+  {
+    return m_file.is_open ();
+  }
+
+  void
+  NocBinaryTraceWriter::Connect (Ptr<NetDevice> device)
+  {
+    NS_LOG_FUNCTION (device);
+
+    Ptr<TracedPort> port = Create<TracedPort> ();
+    port->m_writer = this;
+    port->m_node = device->GetNode ()->GetId ();
+    port->m_port = (uint16_t) device->GetIfIndex ();
+    device->TraceConnectWithoutContext ("Send", MakeBoundCallback (&NocBinaryTraceWriter::TxEvent, port));
+    device->TraceConnectWithoutContext ("Receive", MakeBoundCallback (&NocBinaryTraceWriter::RxEvent, port));
+    device->TraceConnectWithoutContext ("Drop", MakeBoundCallback (&NocBinaryTraceWriter::DropEvent, port));
+
+    PointerValue queue;
+    if (device->GetAttributeFailSafe ("InQueue", queue))
+      {
+        ConnectQueue (queue.Get<Queue> (), port);
+      }
+    if (device->GetAttributeFailSafe ("OutQueue", queue))
+      {
+        ConnectQueue (queue.Get<Queue> (), port);
+      }
+  }
+
+  void
+  NocBinaryTraceWriter::ConnectQueue (Ptr<Queue> queue, Ptr<TracedPort> port)
+  {
+    if (queue != 0)
+      {
+        queue->TraceConnectWithoutContext ("Enqueue", MakeBoundCallback (&NocBinaryTraceWriter::EnqueueEvent, port));
+        queue->TraceConnectWithoutContext ("Dequeue", MakeBoundCallback (&NocBinaryTraceWriter::DequeueEvent, port));
+        queue->TraceConnectWithoutContext ("Drop", MakeBoundCallback (&NocBinaryTraceWriter::DropEvent, port));
+      }
+  }
+
+  void
+  NocBinaryTraceWriter::TxEvent (Ptr<TracedPort> port, Ptr<const Packet> flit)
+  {
+    port->m_writer->Write (NocTraceRecord::TX, port->m_node, port->m_port, flit);
+  }
+
+  void
+  NocBinaryTraceWriter::RxEvent (Ptr<TracedPort> port, Ptr<const Packet> flit)
+  {
+    port->m_writer->Write (NocTraceRecord::RX, port->m_node, port->m_port, flit);
+  }
+
+  void
+  NocBinaryTraceWriter::EnqueueEvent (Ptr<TracedPort> port, Ptr<const Packet> flit)
+  {
+    port->m_writer->Write (NocTraceRecord::ENQUEUE, port->m_node, port->m_port, flit);
+  }
+
+  void
+  NocBinaryTraceWriter::DequeueEvent (Ptr<TracedPort> port, Ptr<const Packet> flit)
+  {
+    port->m_writer->Write (NocTraceRecord::DEQUEUE, port->m_node, port->m_port, flit);
+  }
+
+  void
+  NocBinaryTraceWriter::DropEvent (Ptr<TracedPort> port, Ptr<const Packet> flit)
+  {
+    port->m_writer->Write (NocTraceRecord::DROP, port->m_node, port->m_port, flit);
+  }
+
+  void
+  NocBinaryTraceWriter::Write (NocTraceRecord::EventType event, uint32_t node, uint16_t port, Ptr<const Packet> flit)
+  {
+    if (!m_file.is_open ())
+      {
+        return;
+      }
+
+    NocPacketTag tag;
+    flit->PeekPacketTag (tag);
+
+    NocTraceRecord record;
+    record.m_cycle = Simulator::Now ().GetPicoSeconds () / m_clock;
+    record.m_flitUid = flit->GetUid ();
+    record.m_headUid = NocPacket::HEAD == tag.GetPacketType () ? flit->GetUid () : tag.GetPacketHeadUid ();
+    record.m_node = node;
+    record.m_flitSize = flit->GetSize ();
+    record.m_port = port;
+    record.m_event = event;
+    record.m_flitType = tag.GetPacketType ();
+    record.m_reserved = 0;
+    m_buffer.push_back (record);
+    m_records++;
+
+    if (m_buffer.size () >= m_blockRecords)
+      {
+        Flush ();
+      }
+  }
+
+  uint64_t
+  NocBinaryTraceWriter::GetNRecords () const
+  {
+    return m_records;
+  }
+
+  void
+  NocBinaryTraceWriter::Flush ()
+  {
+    if (m_buffer.empty ())
+      {
+        return;
+      }
+
+    NocTraceBlockHeader header;
+    header.m_records = m_buffer.size ();
+    if (m_compression)
+      {
+        NocTraceEncodeBlock (&m_buffer[0], m_buffer.size (), m_block);
+        header.m_bytes = m_block.size ();
+        m_file.write ((const char *) &header, sizeof (header));
+        m_file.write ((const char *) &m_block[0], m_block.size ());
+      }
+    else
+      {
+        header.m_bytes = m_buffer.size () * sizeof (NocTraceRecord);
+        m_file.write ((const char *) &header, sizeof (header));
+        m_file.write ((const char *) &m_buffer[0], header.m_bytes);
+      }
+    NS_LOG_LOGIC ("Wrote a block of " << header.m_records << " records (" << header.m_bytes << " bytes)");
+    m_buffer.clear ();
+  }
+
+} // namespace ns3
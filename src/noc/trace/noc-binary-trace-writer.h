@@ -0,0 +1,189 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCBINARYTRACEWRITER_H_
+#define NOCBINARYTRACEWRITER_H_
+
+#include "ns3/object.h"
+#include "ns3/packet.h"
+#include "ns3/net-device.h"
+#include "ns3/queue.h"
+#include "ns3/simple-ref-count.h"
+#include "noc-trace-format.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+  /**
+   * \brief Writes flit events into a binary trace file
+   *
+   * \detail Each event is a fixed size NocTraceRecord (clock cycle, event type, node, port, flit type,
+   *         head flit UID and flit UID). The records are buffered and written in blocks of BlockRecords
+   *         records. If Compression is set, each block is compressed (see NocTraceEncodeBlock).
+   *
+   *         A binary trace is much smaller and much faster to write than an ASCII trace. It can be read
+   *         with a NocBinaryTraceReader and converted to the ASCII format with the noc-trace-converter program.
+   */
+  class NocBinaryTraceWriter : public Object
+  {
+  public:
+
+    static TypeId
+    GetTypeId ();
+
+    NocBinaryTraceWriter ();
+
+    virtual
+    ~NocBinaryTraceWriter ();
+
+    /**
+     * Creates the trace file (an existing file is overwritten)
+     *
+     * \param fileName the name of the trace file
+     * \param globalClock the global clock, in picoseconds (the events are recorded in clock cycles)
+     *
+     * \return false, if the file could not be created
+     */
+    bool
+    Open (std::string fileName, int64_t globalClock);
+
+    /**
+     * Writes the buffered records and closes the trace file.
+     * The file is closed anyway when the writer is disposed.
+     */
+    void
+    Close ();
+
+    /**
+     * \return whether or not the trace file is open
+     */
+    bool
+    IsOpen () const;
+
+    /**
+     * Starts tracing the flits sent, received and dropped by a net device,
+     * and the flits which go through its input and output queues
+     *
+     * \param device the net device (a NocNetDevice)
+     */
+    void
+    Connect (Ptr<NetDevice> device);
+
+    /**
+     * Records a flit event (at the current simulation time)
+     *
+     * \param event the type of the event (a NocTraceRecord::EventType)
+     * \param node the ID of the node
+     * \param port the index of the net device, inside the node
+     * \param flit the flit
+     */
+    void
+    Write (NocTraceRecord::EventType event, uint32_t node, uint16_t port, Ptr<const Packet> flit);
+
+    /**
+     * \return how many records were written (including the buffered ones)
+     */
+    uint64_t
+    GetNRecords () const;
+
+  protected:
+
+    virtual void
+    DoDispose ();
+
+  private:
+
+    /**
+     * The place (node and port) of a traced net device
+     */
+    class TracedPort : public SimpleRefCount<TracedPort>
+    {
+    public:
+      Ptr<NocBinaryTraceWriter> m_writer;
+
+      uint32_t m_node;
+
+      uint16_t m_port;
+    };
+
+    static void
+    TxEvent (Ptr<TracedPort> port, Ptr<const Packet> flit);
+
+    static void
+    RxEvent (Ptr<TracedPort> port, Ptr<const Packet> flit);
+
+    static void
+    EnqueueEvent (Ptr<TracedPort> port, Ptr<const Packet> flit);
+
+    static void
+    DequeueEvent (Ptr<TracedPort> port, Ptr<const Packet> flit);
+
+    static void
+    DropEvent (Ptr<TracedPort> port, Ptr<const Packet> flit);
+
+    /**
+     * Starts tracing the flits which go through a queue of a traced net device
+     *
+     * \param queue the queue (may be 0)
+     * \param port the traced net device
+     */
+    static void
+    ConnectQueue (Ptr<Queue> queue, Ptr<TracedPort> port);
+
+    /**
+     * Writes the buffered records into the file, as a block
+     */
+    void
+    Flush ();
+
+    std::ofstream m_file;
+
+    /**
+     * the records which are not written yet
+     */
+    std::vector<NocTraceRecord> m_buffer;
+
+    /**
+     * the compressed block (it is kept here, so that its memory is reused)
+     */
+    std::vector<uint8_t> m_block;
+
+    uint32_t m_blockRecords;
+
+    bool m_compression;
+
+    /**
+     * the global clock, in picoseconds
+     */
+    int64_t m_clock;
+
+    uint64_t m_records;
+
+  };
+
+} // namespace ns3
+
+#endif /* NOCBINARYTRACEWRITER_H_ */
@@ -0,0 +1,133 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-trace-format.h"
+
+namespace ns3
+{
+
+  const char NOC_TRACE_MAGIC[8] = {'N', 'O', 'C', 'T', 'R', 'A', 'C', 'E'};
+
+  // a record must have the same size everywhere (the reader relies on it)
+  typedef char NocTraceRecordSizeCheck[sizeof (NocTraceRecord) == 32 ? 1 : -1];
+
+  static void
+  PutVarint (std::vector<uint8_t> &block, uint64_t value)
+  {
+    while (value >= 0x80)
+      {
+        block.push_back ((uint8_t) (value | 0x80));
+        value >>= 7;
+      }
+    block.push_back ((uint8_t) value);
+  }
+
+  static bool
+  GetVarint (const uint8_t *&current, const uint8_t *end, uint64_t &value)
+  {
+    value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+      {
+        if (current == end)
+          {
+            return false;
+          }
+        uint8_t byte = *current++;
+        value |= ((uint64_t) (byte & 0x7f)) << shift;
+        if ((byte & 0x80) == 0)
+          {
+            return true;
+          }
+      }
+    return false;
+  }
+
+  // zigzag encoding, so that small negative differences are small numbers too
+  static uint64_t
+  ZigZag (int64_t value)
+  {
+    return (((uint64_t) value) << 1) ^ (uint64_t) (value >> 63);
+  }
+
+  static int64_t
+  UnZigZag (uint64_t value)
+  {
+    return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+  }
+
+  void
+  NocTraceEncodeBlock (const NocTraceRecord *records, uint32_t count, std::vector<uint8_t> &block)
+  {
+    block.clear ();
+    block.reserve (count * 8);
+    uint64_t cycle = 0;
+    uint32_t flitUid = 0;
+    for (uint32_t i = 0; i < count; i++)
+      {
+        const NocTraceRecord &record = records[i];
+        PutVarint (block, ZigZag ((int64_t) (record.m_cycle - cycle)));
+        PutVarint (block, ZigZag ((int64_t) record.m_flitUid - (int64_t) flitUid));
+        PutVarint (block, ZigZag ((int64_t) record.m_flitUid - (int64_t) record.m_headUid));
+        PutVarint (block, record.m_node);
+        PutVarint (block, record.m_flitSize);
+        PutVarint (block, record.m_port);
+        block.push_back (record.m_event);
+        block.push_back (record.m_flitType);
+        cycle = record.m_cycle;
+        flitUid = record.m_flitUid;
+      }
+  }
+
+  bool
+  NocTraceDecodeBlock (const uint8_t *block, uint32_t bytes, uint32_t count, NocTraceRecord *records)
+  {
+    const uint8_t *current = block;
+    const uint8_t *end = block + bytes;
+    uint64_t cycle = 0;
+    uint32_t flitUid = 0;
+    for (uint32_t i = 0; i < count; i++)
+      {
+        NocTraceRecord &record = records[i];
+        uint64_t cycleDelta, flitUidDelta, headUidDelta, node, flitSize, port;
+        if (!GetVarint (current, end, cycleDelta) || !GetVarint (current, end, flitUidDelta)
+            || !GetVarint (current, end, headUidDelta) || !GetVarint (current, end, node)
+            || !GetVarint (current, end, flitSize) || !GetVarint (current, end, port) || end - current < 2)
+          {
+            return false;
+          }
+        record.m_cycle = cycle + UnZigZag (cycleDelta);
+        record.m_flitUid = (uint32_t) (flitUid + UnZigZag (flitUidDelta));
+        record.m_headUid = (uint32_t) (record.m_flitUid - UnZigZag (headUidDelta));
+        record.m_node = (uint32_t) node;
+        record.m_flitSize = (uint32_t) flitSize;
+        record.m_port = (uint16_t) port;
+        record.m_event = *current++;
+        record.m_flitType = *current++;
+        record.m_reserved = 0;
+        cycle = record.m_cycle;
+        flitUid = record.m_flitUid;
+      }
+    return current == end;
+  }
+
+} // namespace ns3
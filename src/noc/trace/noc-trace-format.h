@@ -0,0 +1,190 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCTRACEFORMAT_H_
+#define NOCTRACEFORMAT_H_
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+  /**
+   * \brief A flit event, as it is stored in a binary NoC trace
+   *
+   * \detail All the records have the same size (32 bytes), so a record can be found directly by its index.
+   *         The fields are stored in the byte order of the host which wrote the trace.
+   */
+  struct NocTraceRecord
+  {
+    /**
+     * the types of events (the same characters are used in the ASCII traces)
+     */
+    enum EventType
+      {
+        TX = 't',
+        RX = 'r',
+        ENQUEUE = '+',
+        DEQUEUE = '-',
+        DROP = 'd'
+      };
+
+    /**
+     * the clock cycle of the event
+     */
+    uint64_t m_cycle;
+
+    /**
+     * the UID of the head flit of the packet
+     */
+    uint32_t m_headUid;
+
+    /**
+     * the UID of the flit
+     */
+    uint32_t m_flitUid;
+
+    /**
+     * the ID of the node
+     */
+    uint32_t m_node;
+
+    /**
+     * the size of the flit, in bytes
+     */
+    uint32_t m_flitSize;
+
+    /**
+     * the index of the net device (port) of the node
+     */
+    uint16_t m_port;
+
+    /**
+     * the type of the event (see EventType)
+     */
+    uint8_t m_event;
+
+    /**
+     * the type of the flit (a NocPacket::Type)
+     */
+    uint8_t m_flitType;
+
+    /**
+     * always zero
+     */
+    uint32_t m_reserved;
+  };
+
+  /**
+   * \brief The header of a binary NoC trace file
+   *
+   * \detail The header is followed by blocks of records. Each block starts with a NocTraceBlockHeader.
+   *         The records of a block are stored as they are, or (if the trace is compressed) encoded with
+   *         NocTraceEncodeBlock.
+   */
+  struct NocTraceFileHeader
+  {
+    /**
+     * NOC_TRACE_MAGIC
+     */
+    char m_magic[8];
+
+    /**
+     * NOC_TRACE_VERSION
+     */
+    uint32_t m_version;
+
+    /**
+     * NOC_TRACE_BYTE_ORDER, as written by the host
+     */
+    uint32_t m_byteOrder;
+
+    /**
+     * sizeof (NocTraceRecord)
+     */
+    uint32_t m_recordSize;
+
+    /**
+     * NOC_TRACE_COMPRESSED, if the blocks are compressed
+     */
+    uint32_t m_flags;
+
+    /**
+     * the global clock, in picoseconds
+     */
+    int64_t m_clock;
+  };
+
+  /**
+   * \brief The header of a block of records, from a binary NoC trace file
+   */
+  struct NocTraceBlockHeader
+  {
+    /**
+     * how many records the block has
+     */
+    uint32_t m_records;
+
+    /**
+     * the size of the block (without this header), in bytes
+     */
+    uint32_t m_bytes;
+  };
+
+  extern const char NOC_TRACE_MAGIC[8];
+
+  const uint32_t NOC_TRACE_VERSION = 1;
+
+  const uint32_t NOC_TRACE_BYTE_ORDER = 0x01020304;
+
+  const uint32_t NOC_TRACE_COMPRESSED = 1;
+
+  /**
+   * Compresses a block of records. Each field is stored as a variable length integer; the cycle and the UIDs
+   * are stored as differences from the previous record. The encoding starts from scratch for every block,
+   * so the blocks can be decoded independently.
+   *
+   * \param records the records
+   * \param count how many records are encoded
+   * \param block where the encoded block is put (the previous content is discarded)
+   */
+  void
+  NocTraceEncodeBlock (const NocTraceRecord *records, uint32_t count, std::vector<uint8_t> &block);
+
+  /**
+   * Decompresses a block of records (encoded with NocTraceEncodeBlock)
+   *
+   * \param block the encoded block
+   * \param bytes the size of the encoded block
+   * \param count how many records the block has
+   * \param records where the decoded records are put (it must have room for count records)
+   *
+   * \return false, if the block is malformed
+   */
+  bool
+  NocTraceDecodeBlock (const uint8_t *block, uint32_t bytes, uint32_t count, NocTraceRecord *records);
+
+} // namespace ns3
+
+#endif /* NOCTRACEFORMAT_H_ */
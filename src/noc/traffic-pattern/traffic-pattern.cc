@@ -171,4 +171,10 @@ namespace ns3
     return m_uniformVariable.GetInteger (min, max);
   }
 
+  void
+  TrafficPattern::ResetRandomStream ()
+  {
+    m_uniformVariable = UniformVariable ();
+  }
+
 } // Namespace ns3
@@ -130,6 +130,13 @@ public:
   uint32_t
   GetUniformRandomNumber (uint32_t min, uint32_t max);
 
+  /**
+   * Replaces the random stream with a new one (created from the current seed of the package).
+   * This is used after the random number generators were reseeded.
+   */
+  void
+  ResetRandomStream ();
+
 private:
 
   UniformVariable m_uniformVariable;
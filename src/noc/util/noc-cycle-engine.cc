@@ -0,0 +1,311 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-cycle-engine.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/noc-simulation-context.h"
+#include "ns3/noc-channel.h"
+#include "ns3/noc-net-device.h"
+#include "ns3/noc-router.h"
+
+NS_LOG_COMPONENT_DEFINE ("NocCycleEngine");
+
+namespace ns3
+{
+
+  NS_OBJECT_ENSURE_REGISTERED (NocCycleEngine);
+
+  TypeId
+  NocCycleEngine::GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::NocCycleEngine")
+        .SetParent<Object> ()
+        .AddConstructor<NocCycleEngine> ();
+    return tid;
+  }
+
+  NocCycleEngine::NocCycleEngine ()
+    : m_context (0),
+      m_currentCycle (0),
+      m_ticking (false),
+      m_processedCycles (0)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    // typically, a flit spends only a few clock cycles on a link
+    m_buckets.resize (16);
+    for (uint32_t i = 0; i < m_buckets.size (); ++i)
+      {
+        m_buckets[i].m_cycle = 0;
+        m_buckets[i].m_scheduled = false;
+      }
+  }
+
+  NocCycleEngine::~NocCycleEngine ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+  }
+
+  void
+  NocCycleEngine::DoDispose ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    m_buckets.clear ();
+    m_context = 0;
+    Object::DoDispose ();
+  }
+
+  void
+  NocCycleEngine::SetContext (NocSimulationContext *context)
+  {
+    m_context = context;
+  }
+
+  uint64_t
+  NocCycleEngine::GetProcessedCycles () const
+  {
+    return m_processedCycles;
+  }
+
+  bool
+  NocCycleEngine::CycleBucket::IsEmpty () const
+  {
+    return m_linkChannels.empty () && m_bufferDevices.empty () && m_allocationRouters.empty () && m_injections.empty ();
+  }
+
+  void
+  NocCycleEngine::CycleBucket::Clear ()
+  {
+    m_linkChannels.clear ();
+    m_linkSenders.clear ();
+    m_linkReceivers.clear ();
+    m_linkTo.clear ();
+    m_linkFrom.clear ();
+    m_bufferDevices.clear ();
+    m_bufferHeaders.clear ();
+    m_allocationRouters.clear ();
+    m_injections.clear ();
+    m_injectionCookies.clear ();
+  }
+
+  uint64_t
+  NocCycleEngine::GetCycle (Time delay) const
+  {
+    NS_ASSERT_MSG (m_context != 0, "The cycle engine does not belong to a simulation context!");
+    int64_t clock = m_context->GetGlobalClockPicoSeconds ();
+    NS_ASSERT_MSG (clock > 0, "The cycle-driven NoC engine requires a global clock!");
+    int64_t time = (Simulator::Now () + delay).GetPicoSeconds ();
+    NS_ASSERT (time >= 0);
+    return (time + clock - 1) / clock;
+  }
+
+  uint32_t
+  NocCycleEngine::PrepareBucket (uint64_t cycle)
+  {
+    uint32_t index = cycle & (m_buckets.size () - 1);
+    while ((m_buckets[index].m_scheduled || !m_buckets[index].IsEmpty ()) && m_buckets[index].m_cycle != cycle)
+      {
+        // the ring is too small for the clock cycles which currently have work to do
+        Grow ();
+        index = cycle & (m_buckets.size () - 1);
+      }
+    CycleBucket &bucket = m_buckets[index];
+    bucket.m_cycle = cycle;
+    if (!bucket.m_scheduled && !(m_ticking && cycle == m_currentCycle))
+      {
+        Time tickTime = PicoSeconds (cycle * m_context->GetGlobalClockPicoSeconds ());
+        NS_LOG_LOGIC ("Schedule event (clock cycle " << cycle << ") to occur at time " << tickTime);
+        // Simulator::Schedule (...) receives a relative time
+        Simulator::Schedule (tickTime - Simulator::Now (), &NocCycleEngine::Tick, this, cycle);
+        bucket.m_scheduled = true;
+      }
+    return index;
+  }
+
+  void
+  NocCycleEngine::Grow ()
+  {
+    NS_LOG_FUNCTION (m_buckets.size ());
+
+    std::vector<CycleBucket> buckets (2 * m_buckets.size ());
+    uint64_t mask = buckets.size () - 1;
+    for (uint32_t i = 0; i < buckets.size (); ++i)
+      {
+        buckets[i].m_cycle = 0;
+        buckets[i].m_scheduled = false;
+      }
+    for (uint32_t i = 0; i < m_buckets.size (); ++i)
+      {
+        CycleBucket &from = m_buckets[i];
+        if (!from.m_scheduled && from.IsEmpty ())
+          {
+            // an unused bucket (its clock cycle is not meaningful) must not replace a used one
+            continue;
+          }
+        CycleBucket &to = buckets[from.m_cycle & mask];
+        NS_ASSERT (!to.m_scheduled && to.IsEmpty ());
+        to.m_cycle = from.m_cycle;
+        to.m_scheduled = from.m_scheduled;
+        to.m_linkChannels.swap (from.m_linkChannels);
+        to.m_linkSenders.swap (from.m_linkSenders);
+        to.m_linkReceivers.swap (from.m_linkReceivers);
+        to.m_linkTo.swap (from.m_linkTo);
+        to.m_linkFrom.swap (from.m_linkFrom);
+        to.m_bufferDevices.swap (from.m_bufferDevices);
+        to.m_bufferHeaders.swap (from.m_bufferHeaders);
+        to.m_allocationRouters.swap (from.m_allocationRouters);
+        to.m_injections.swap (from.m_injections);
+        to.m_injectionCookies.swap (from.m_injectionCookies);
+      }
+    m_buckets.swap (buckets);
+  }
+
+  void
+  NocCycleEngine::ScheduleTransmitEnd (Time delay, NocChannel *channel, NocNetDevice *sender, Mac48Address to,
+      NocNetDevice *receiver, Mac48Address from)
+  {
+    uint64_t cycle = GetCycle (delay);
+    NS_LOG_DEBUG ("Link traversal through channel " << channel->GetId () << " ends at clock cycle " << cycle);
+    CycleBucket &bucket = m_buckets[PrepareBucket (cycle)];
+    bucket.m_linkChannels.push_back (channel);
+    bucket.m_linkSenders.push_back (sender);
+    bucket.m_linkReceivers.push_back (receiver);
+    bucket.m_linkTo.push_back (to);
+    bucket.m_linkFrom.push_back (from);
+  }
+
+  Time
+  NocCycleEngine::ScheduleBufferedPackets (NocNetDevice *device, const NocHeader &originalHeader)
+  {
+    NS_ASSERT_MSG (m_context != 0, "The cycle engine does not belong to a simulation context!");
+    int64_t clock = m_context->GetGlobalClockPicoSeconds ();
+    NS_ASSERT_MSG (clock > 0, "The cycle-driven NoC engine requires a global clock!");
+    uint64_t cycle = Simulator::Now ().GetPicoSeconds () / clock + 1;
+    NS_LOG_DEBUG ("Net device " << device->GetAddress () << " will process its buffered packets at clock cycle " << cycle);
+    CycleBucket &bucket = m_buckets[PrepareBucket (cycle)];
+    bucket.m_bufferDevices.push_back (device);
+    bucket.m_bufferHeaders.push_back (originalHeader);
+    return PicoSeconds (cycle * clock);
+  }
+
+  void
+  NocCycleEngine::ScheduleSwitchAllocation (NocRouter *router)
+  {
+    NS_ASSERT_MSG (m_context != 0, "The cycle engine does not belong to a simulation context!");
+    int64_t clock = m_context->GetGlobalClockPicoSeconds ();
+    NS_ASSERT_MSG (clock > 0, "The cycle-driven NoC engine requires a global clock!");
+    uint64_t cycle = Simulator::Now ().GetPicoSeconds () / clock + 1;
+    NS_LOG_DEBUG ("The router of node " << router->GetNocNode ()->GetId () << " will allocate its switch at clock cycle " << cycle);
+    m_buckets[PrepareBucket (cycle)].m_allocationRouters.push_back (router);
+  }
+
+  void
+  NocCycleEngine::ScheduleInjection (Time delay, Callback<void, uint64_t> injection, uint64_t cookie)
+  {
+    uint64_t cycle = GetCycle (delay);
+    NS_LOG_DEBUG ("Flit injection at clock cycle " << cycle);
+    CycleBucket &bucket = m_buckets[PrepareBucket (cycle)];
+    bucket.m_injections.push_back (injection);
+    bucket.m_injectionCookies.push_back (cookie);
+  }
+
+  void
+  NocCycleEngine::Tick (uint64_t cycle)
+  {
+    NS_LOG_FUNCTION (cycle);
+
+    m_ticking = true;
+    m_currentCycle = cycle;
+    m_processedCycles++;
+
+    // the activities may add more work for this cycle, and they may even grow the ring of buckets,
+    // so the bucket is looked up again after each activity
+    uint64_t mask = m_buckets.size () - 1;
+    uint32_t links = 0;
+    uint32_t buffers = 0;
+    uint32_t allocations = 0;
+    uint32_t injections = 0;
+    bool progress;
+    do
+      {
+        progress = false;
+        // link traversal: the flits reach the input buffers of the next routers
+        while (links < m_buckets[cycle & mask].m_linkChannels.size ())
+          {
+            CycleBucket &bucket = m_buckets[cycle & mask];
+            NocChannel *channel = bucket.m_linkChannels[links];
+            Ptr<NocNetDevice> sender = bucket.m_linkSenders[links];
+            Ptr<NocNetDevice> receiver = bucket.m_linkReceivers[links];
+            Mac48Address to = bucket.m_linkTo[links];
+            Mac48Address from = bucket.m_linkFrom[links];
+            links++;
+            channel->TransmitEnd (sender, to, receiver, from);
+            mask = m_buckets.size () - 1;
+            progress = true;
+          }
+        // routing, switching and link allocation for the buffered flits
+        while (buffers < m_buckets[cycle & mask].m_bufferDevices.size ())
+          {
+            CycleBucket &bucket = m_buckets[cycle & mask];
+            NocNetDevice *device = bucket.m_bufferDevices[buffers];
+            NocHeader originalHeader = bucket.m_bufferHeaders[buffers];
+            buffers++;
+            device->ProcessBufferedPackets (originalHeader, 0);
+            mask = m_buckets.size () - 1;
+            progress = true;
+          }
+        // virtual channel and switch allocation, for the routers which use virtual channels
+        while (allocations < m_buckets[cycle & mask].m_allocationRouters.size ())
+          {
+            NocRouter *router = m_buckets[cycle & mask].m_allocationRouters[allocations];
+            allocations++;
+            router->AllocateSwitch ();
+            mask = m_buckets.size () - 1;
+            progress = true;
+          }
+        // injection of new flits
+        while (injections < m_buckets[cycle & mask].m_injections.size ())
+          {
+            CycleBucket &bucket = m_buckets[cycle & mask];
+            Callback<void, uint64_t> injection = bucket.m_injections[injections];
+            uint64_t cookie = bucket.m_injectionCookies[injections];
+            injections++;
+            injection (cookie);
+            mask = m_buckets.size () - 1;
+            progress = true;
+          }
+      }
+    while (progress);
+
+    NS_LOG_DEBUG ("Clock cycle " << cycle << ": " << links << " link traversals, "
+        << buffers << " buffer wake-ups, " << allocations << " switch allocations, " << injections << " injections");
+
+    CycleBucket &bucket = m_buckets[cycle & mask];
+    bucket.Clear ();
+    bucket.m_scheduled = false;
+    m_ticking = false;
+  }
+
+} // namespace ns3
@@ -0,0 +1,246 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCCYCLEENGINE_H_
+#define NOCCYCLEENGINE_H_
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/callback.h"
+#include "ns3/mac48-address.h"
+#include "ns3/noc-header.h"
+#include <vector>
+
+namespace ns3
+{
+
+  class NocChannel;
+
+  class NocNetDevice;
+
+  class NocRouter;
+
+  class NocSimulationContext;
+
+  /**
+   * \brief Cycle-driven engine for a synchronous Network-on-Chip
+   *
+   * \detail By default, every link traversal, every buffered flit and every flit injection
+   *         is a separate simulator event. When a NocTopology is configured to be cycle driven,
+   *         these activities are instead registered with the cycle engine of the topology's simulation context.
+   *         The engine keeps the activities of every global clock cycle in structure-of-arrays buckets and
+   *         schedules a single simulator event per clock cycle (only for the cycles which have work to do).
+   *         At each clock tick, it first completes all the link traversals (which deliver flits to the
+   *         input buffers of the routers), then it lets the net devices process their buffered flits (routing,
+   *         switching, flow control and link allocation are done by the existing NoC classes; routers with
+   *         virtual channels allocate their switch instead) and finally
+   *         it injects the new flits. Activities added for the current clock cycle (e.g. through links with no delay)
+   *         are processed in the same pass.
+   *
+   *         The engine requires the global clock to be set. Times which are not multiples of the global clock
+   *         are rounded up to the next clock edge.
+   */
+  class NocCycleEngine : public Object
+  {
+  public:
+
+    static TypeId
+    GetTypeId ();
+
+    NocCycleEngine ();
+
+    virtual
+    ~NocCycleEngine ();
+
+    /**
+     * Sets the simulation context which owns this engine. The context is not reference counted
+     * by the engine (the context already holds a reference to its engine).
+     *
+     * \param context the simulation context
+     */
+    void
+    SetContext (NocSimulationContext *context);
+
+    /**
+     * Schedules the end of a link traversal (see NocChannel::TransmitEnd).
+     *
+     * \param delay after how much time the traversal ends (rounded up to the next clock edge)
+     * \param channel the channel
+     * \param sender the NoC net device that sent the flit
+     * \param to the address where the flit is to be sent
+     * \param receiver the NoC net device that must receive the flit
+     * \param from the address from where the flit is sent
+     */
+    void
+    ScheduleTransmitEnd (Time delay, NocChannel *channel, NocNetDevice *sender, Mac48Address to,
+        NocNetDevice *receiver, Mac48Address from);
+
+    /**
+     * Schedules the processing of the flits buffered by a net device, at the next clock cycle
+     * (see NocNetDevice::ProcessBufferedPackets).
+     *
+     * \param device the net device
+     * \param originalHeader the header to be traced for the sent flit
+     *
+     * \return the moment of time when the buffered flits will be processed
+     */
+    Time
+    ScheduleBufferedPackets (NocNetDevice *device, const NocHeader &originalHeader);
+
+    /**
+     * Schedules the virtual channel and switch allocation of a router, at the next clock cycle
+     * (see NocRouter::AllocateSwitch).
+     *
+     * \param router the router
+     */
+    void
+    ScheduleSwitchAllocation (NocRouter *router);
+
+    /**
+     * Schedules a flit injection.
+     *
+     * \param delay after how much time the flit is injected (rounded up to the next clock edge)
+     * \param injection the callback which injects the flit
+     * \param cookie the value passed to the callback (it allows the caller to ignore cancelled injections)
+     */
+    void
+    ScheduleInjection (Time delay, Callback<void, uint64_t> injection, uint64_t cookie);
+
+    /**
+     * \return the number of clock cycles simulated so far by this engine
+     */
+    uint64_t
+    GetProcessedCycles () const;
+
+  protected:
+
+    virtual void
+    DoDispose ();
+
+  private:
+
+    /**
+     * All the activities which must be done in a clock cycle.
+     * The vectors are only cleared after the cycle is simulated, so they keep their capacity.
+     */
+    struct CycleBucket
+    {
+      /**
+       * the clock cycle of this bucket
+       */
+      uint64_t m_cycle;
+
+      /**
+       * whether or not a simulator event was scheduled for this bucket
+       */
+      bool m_scheduled;
+
+      // link traversals
+      std::vector<NocChannel *> m_linkChannels;
+      std::vector<NocNetDevice *> m_linkSenders;
+      std::vector<NocNetDevice *> m_linkReceivers;
+      std::vector<Mac48Address> m_linkTo;
+      std::vector<Mac48Address> m_linkFrom;
+
+      // buffered flits
+      std::vector<NocNetDevice *> m_bufferDevices;
+      std::vector<NocHeader> m_bufferHeaders;
+
+      // switch allocations
+      std::vector<NocRouter *> m_allocationRouters;
+
+      // flit injections
+      std::vector<Callback<void, uint64_t> > m_injections;
+      std::vector<uint64_t> m_injectionCookies;
+
+      bool
+      IsEmpty () const;
+
+      void
+      Clear ();
+    };
+
+    /**
+     * Computes the clock cycle which starts at or after the given moment of time.
+     *
+     * \param delay a delay, relative to the current simulation time
+     *
+     * \return the clock cycle
+     */
+    uint64_t
+    GetCycle (Time delay) const;
+
+    /**
+     * Retrieves the bucket of a clock cycle, making sure that a simulator event exists for that cycle.
+     *
+     * \param cycle the clock cycle
+     *
+     * \return the bucket's index
+     */
+    uint32_t
+    PrepareBucket (uint64_t cycle);
+
+    /**
+     * Doubles the number of buckets.
+     */
+    void
+    Grow ();
+
+    /**
+     * Simulates one clock cycle.
+     *
+     * \param cycle the clock cycle
+     */
+    void
+    Tick (uint64_t cycle);
+
+    /**
+     * the simulation context which owns this engine
+     */
+    NocSimulationContext *m_context;
+
+    /**
+     * a ring of buckets, indexed by clock cycle (its size is a power of 2)
+     */
+    std::vector<CycleBucket> m_buckets;
+
+    /**
+     * the clock cycle being simulated
+     */
+    uint64_t m_currentCycle;
+
+    /**
+     * whether or not a clock cycle is currently being simulated
+     */
+    bool m_ticking;
+
+    /**
+     * how many clock cycles were simulated
+     */
+    uint64_t m_processedCycles;
+
+  };
+
+} // namespace ns3
+
+#endif /* NOCCYCLEENGINE_H_ */
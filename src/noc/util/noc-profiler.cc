@@ -0,0 +1,179 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-profiler.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include <iostream>
+#include <iomanip>
+
+NS_LOG_COMPONENT_DEFINE ("NocProfiler");
+
+namespace ns3
+{
+
+  std::string
+  NocProfiler::StageToString (Stage stage)
+  {
+    switch (stage)
+      {
+      case INJECTION:
+        return "injection";
+      case NODE_SEND:
+        return "node send";
+      case ROUTER_MANAGE_FLIT:
+        return "router manage flit";
+      case ROUTING:
+        return "routing";
+      case SWITCHING:
+        return "switching";
+      case CHANNEL_TRANSMIT:
+        return "channel transmit";
+      case CHANNEL_PROPAGATE:
+        return "channel propagate";
+      case POWER_MEASUREMENT:
+        return "power measurement";
+      case TRACE_CALLBACKS:
+        return "trace callbacks";
+      default:
+        return "unknown";
+      }
+  }
+
+  NocProfiler *
+  NocProfiler::GetInstance ()
+  {
+    static NocProfiler profiler;
+    return &profiler;
+  }
+
+  NocProfiler::NocProfiler ()
+  {
+    m_reportScheduled = false;
+    Reset ();
+  }
+
+  double
+  NocProfiler::GetSeconds ()
+  {
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+  }
+
+  void
+  NocProfiler::Add (Stage stage, TypeId owner, uint64_t ticks)
+  {
+    if (!m_reportScheduled)
+      {
+        Simulator::ScheduleDestroy (&NocProfiler::ReportAtDestroy);
+        m_reportScheduled = true;
+      }
+    uint16_t uid = owner.GetUid ();
+    if (uid >= m_counters.size ())
+      {
+        Counter counter;
+        counter.m_events = 0;
+        counter.m_ticks = 0;
+        m_counters.resize (uid + 1, std::vector<Counter> (STAGES, counter));
+        m_names.resize (uid + 1);
+      }
+    if (m_names[uid].empty ())
+      {
+        m_names[uid] = owner.GetName ();
+      }
+    Counter &counter = m_counters[uid][stage];
+    counter.m_events++;
+    counter.m_ticks += ticks;
+  }
+
+  double
+  NocProfiler::GetTicksPerSecond () const
+  {
+#if defined (__i386__) || defined (__x86_64__)
+    double seconds = GetSeconds () - m_startSeconds;
+    return seconds > 0 ? (GetTicks () - m_startTicks) / seconds : 1e9;
+#else
+    return 1e9;
+#endif
+  }
+
+  void
+  NocProfiler::Report (std::ostream &os) const
+  {
+    double ticksPerSecond = GetTicksPerSecond ();
+    os << "NoC profile (" << std::fixed << std::setprecision (0) << ticksPerSecond << " ticks per second; "
+        << "the time of a stage includes the stages nested in it)" << std::endl;
+    for (int stage = 0; stage < STAGES; stage++)
+      {
+        uint64_t events = 0;
+        uint64_t ticks = 0;
+        for (uint32_t uid = 0; uid < m_counters.size (); uid++)
+          {
+            events += m_counters[uid][stage].m_events;
+            ticks += m_counters[uid][stage].m_ticks;
+          }
+        if (events == 0)
+          {
+            continue;
+          }
+        os << std::setw (20) << std::left << StageToString ((Stage) stage) << std::right
+            << std::setw (14) << events << " events" << std::setprecision (6)
+            << std::setw (14) << ticks / ticksPerSecond << " s"
+            << std::setprecision (1) << std::setw (10) << ticks / ticksPerSecond / events * 1e9 << " ns/event"
+            << std::endl;
+        for (uint32_t uid = 0; uid < m_counters.size (); uid++)
+          {
+            const Counter &counter = m_counters[uid][stage];
+            if (counter.m_events == 0)
+              {
+                continue;
+              }
+            os << "  " << std::setw (32) << std::left << m_names[uid] << std::right
+                << std::setw (14) << counter.m_events << " events" << std::setprecision (6)
+                << std::setw (14) << counter.m_ticks / ticksPerSecond << " s"
+                << std::setprecision (1) << std::setw (10) << counter.m_ticks / ticksPerSecond / counter.m_events * 1e9
+                << " ns/event" << std::endl;
+          }
+      }
+  }
+
+  void
+  NocProfiler::Reset ()
+  {
+    m_counters.clear ();
+    m_names.clear ();
+    m_startTicks = GetTicks ();
+    m_startSeconds = GetSeconds ();
+  }
+
+  void
+  NocProfiler::ReportAtDestroy ()
+  {
+    NocProfiler *profiler = GetInstance ();
+    profiler->Report (std::cerr);
+    profiler->Reset ();
+    profiler->m_reportScheduled = false;
+  }
+
+} // namespace ns3
@@ -0,0 +1,214 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCPROFILER_H_
+#define NOCPROFILER_H_
+
+#include "ns3/type-id.h"
+#include <stdint.h>
+#include <time.h>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+  /**
+   * \brief Counts the events and measures the time spent by the hot paths of the NoC module, per stage
+   *
+   * \detail The stages are the flit injection, NocNode::Send, NocRouter::ManageFlit, the routing (RequestRoute),
+   *         the switching (ApplyFlowControl), the transmission and the propagation through a NocChannel,
+   *         the power measurements and the trace callbacks. The events and the time of every stage are kept
+   *         per class of the component which does the work (the router class for ManageFlit,
+   *         the routing protocol for the routing and so on).
+   *
+   *         The time is measured with the time stamp counter of the processor (on x86) or with the monotonic clock.
+   *         The time of a stage includes the time of the stages nested in it (for example, the time of ManageFlit
+   *         includes the routing).
+   *
+   *         The profiler is compiled in only if ns-3 is configured with --enable-noc-profiler
+   *         (which defines NS3_NOC_PROFILER). Otherwise, NOC_PROFILE expands to nothing, so the profiler
+   *         has no overhead. When it is enabled, the report is printed (to the standard error) when the simulator
+   *         is destroyed.
+   */
+  class NocProfiler
+  {
+  public:
+
+    enum Stage
+      {
+        INJECTION,
+        NODE_SEND,
+        ROUTER_MANAGE_FLIT,
+        ROUTING,
+        SWITCHING,
+        CHANNEL_TRANSMIT,
+        CHANNEL_PROPAGATE,
+        POWER_MEASUREMENT,
+        TRACE_CALLBACKS,
+        STAGES
+      };
+
+    static std::string
+    StageToString (Stage stage);
+
+    /**
+     * \return the profiler (it is created when it is used for the first time)
+     */
+    static NocProfiler *
+    GetInstance ();
+
+    /**
+     * \return the current time, in ticks of the time stamp counter (on x86) or in nanoseconds
+     */
+    static uint64_t
+    GetTicks ()
+    {
+#if defined (__i386__) || defined (__x86_64__)
+      uint32_t low;
+      uint32_t high;
+      __asm__ __volatile__ ("rdtsc" : "=a" (low), "=d" (high));
+      return ((uint64_t) high << 32) | low;
+#else
+      struct timespec now;
+      clock_gettime (CLOCK_MONOTONIC, &now);
+      return (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+#endif
+    }
+
+    /**
+     * Accounts for an event of a stage.
+     *
+     * \param stage the stage
+     * \param owner the class of the component which did the work
+     * \param ticks how long the work took
+     */
+    void
+    Add (Stage stage, TypeId owner, uint64_t ticks);
+
+    /**
+     * Prints the events and the time of every stage, in total and per class.
+     *
+     * \param os the output stream
+     */
+    void
+    Report (std::ostream &os) const;
+
+    /**
+     * Discards everything measured so far
+     */
+    void
+    Reset ();
+
+  private:
+
+    NocProfiler ();
+
+    /**
+     * Prints the report and resets the profiler (when the simulator is destroyed)
+     */
+    static void
+    ReportAtDestroy ();
+
+    /**
+     * \return the number of ticks per second (measured since the profiler was created or reset)
+     */
+    double
+    GetTicksPerSecond () const;
+
+    /**
+     * \return the monotonic time, in seconds
+     */
+    static double
+    GetSeconds ();
+
+    struct Counter
+    {
+      uint64_t m_events;
+
+      uint64_t m_ticks;
+    };
+
+    /**
+     * the counters of every class (by TypeId UID) and stage
+     */
+    std::vector<std::vector<Counter> > m_counters;
+
+    /**
+     * the names of the classes (by TypeId UID)
+     */
+    std::vector<std::string> m_names;
+
+    uint64_t m_startTicks;
+
+    double m_startSeconds;
+
+    /**
+     * whether or not the report is scheduled for when the simulator is destroyed
+     */
+    bool m_reportScheduled;
+
+  };
+
+  /**
+   * Measures a stage, from its construction to its destruction (use NOC_PROFILE)
+   */
+  class NocProfilerScope
+  {
+  public:
+
+    NocProfilerScope (NocProfiler::Stage stage, TypeId owner) :
+      m_stage (stage), m_owner (owner), m_start (NocProfiler::GetTicks ())
+    {
+      ;
+    }
+
+    ~NocProfilerScope ()
+    {
+      NocProfiler::GetInstance ()->Add (m_stage, m_owner, NocProfiler::GetTicks () - m_start);
+    }
+
+  private:
+
+    NocProfiler::Stage m_stage;
+
+    TypeId m_owner;
+
+    uint64_t m_start;
+
+  };
+
+} // namespace ns3
+
+#ifdef NS3_NOC_PROFILER
+/**
+ * Profiles the rest of the enclosing block as the given stage (see NocProfiler::Stage), done by a component
+ * of the given class (TypeId). It expands to nothing if the NoC profiler is not enabled.
+ */
+#define NOC_PROFILE(stage, owner) ns3::NocProfilerScope nocProfilerScope (ns3::NocProfiler::stage, owner)
+#else
+#define NOC_PROFILE(stage, owner)
+#endif
+
+#endif /* NOCPROFILER_H_ */
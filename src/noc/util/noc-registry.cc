@@ -26,6 +26,7 @@
 #include "ns3/integer.h"
 #include "ns3/pointer.h"
 #include "ns3/object-factory.h"
+#include "noc-simulation-context.h"
 
 NS_LOG_COMPONENT_DEFINE ("NocRegistry");
 
@@ -39,14 +40,27 @@ namespace ns3
     ;
   }
 
-  Ptr<NocRegistry>
-  NocRegistry::GetInstance ()
+  NocRegistry::~NocRegistry ()
+  {
+    // the topology may own simulation contexts, which unregister themselves when they are destroyed
+    m_contexts.clear ();
+    m_nocTopology = 0;
+  }
+
+  static Ptr<NocRegistry>
+  CreateNocRegistry ()
   {
     ObjectFactory factory;
-    factory.SetTypeId (GetTypeId ());
+    factory.SetTypeId (NocRegistry::GetTypeId ());
+    return factory.Create ()->GetObject<NocRegistry> ();
+  }
 
+  Ptr<NocRegistry>
+  NocRegistry::GetInstance ()
+  {
 //    static Ptr<NocRegistry> instance = CreateObject<NocRegistry> ();
-    static Ptr<NocRegistry> instance = factory.Create ()->GetObject<NocRegistry> ();
+    // the factory is used only once (this method is called for every head flit, by the NocHeader constructors)
+    static Ptr<NocRegistry> instance = CreateNocRegistry ();
     return instance;
   }
 
@@ -61,19 +75,19 @@ namespace ns3
                 "FlitSize",
                 "the flit size, in bits",
                 IntegerValue (8 * 3), // in bits; 3 bytes by default
-                MakeIntegerAccessor (&NocRegistry::m_flitSize),
+                MakeIntegerAccessor (&NocRegistry::SetFlitSize, &NocRegistry::GetFlitSize),
                 MakeIntegerChecker<uint32_t> (8 * 1)) // in bits; at least 1 byte
             .AddAttribute (
                 "DataPacketSpeedup",
                 "How many times a data flit is routed faster than a head flit",
                 IntegerValue (1),
-                MakeIntegerAccessor (&NocRegistry::m_dataFlitSpeedup),
+                MakeIntegerAccessor (&NocRegistry::SetDataFlitSpeedup, &NocRegistry::GetDataFlitSpeedup),
                 MakeIntegerChecker<int> (1))
             .AddAttribute (
                 "GlobalClock",
                 "The global clock used by a synchronous NoC",
                 TimeValue (PicoSeconds (0)),
-                MakeTimeAccessor (&NocRegistry::m_globalClock),
+                MakeTimeAccessor (&NocRegistry::SetGlobalClock, &NocRegistry::GetGlobalClock),
                 MakeTimeChecker ())
             .AddAttribute (
                 "NoCTopology",
@@ -85,11 +99,85 @@ namespace ns3
                 "NoCDimensions",
                 "The Network-on-Chip topology number of dimensions",
                 IntegerValue (2),
-                MakeIntegerAccessor(&NocRegistry::m_nocTopologyDimension),
+                MakeIntegerAccessor (&NocRegistry::SetNocDimensions, &NocRegistry::GetNocDimensions),
                 MakeIntegerChecker<uint32_t> (1, 127))
             ;
     return tid;
   }
 
+  void
+  NocRegistry::RegisterContext (NocSimulationContext *context)
+  {
+    NS_ASSERT (context != 0);
+    m_contexts.push_back (context);
+  }
+
+  void
+  NocRegistry::UnregisterContext (NocSimulationContext *context)
+  {
+    m_contexts.remove (context);
+  }
+
+  uint32_t
+  NocRegistry::GetFlitSize () const
+  {
+    return m_flitSize;
+  }
+
+  void
+  NocRegistry::SetFlitSize (uint32_t flitSize)
+  {
+    m_flitSize = flitSize;
+    NotifyContexts ();
+  }
+
+  int
+  NocRegistry::GetDataFlitSpeedup () const
+  {
+    return m_dataFlitSpeedup;
+  }
+
+  void
+  NocRegistry::SetDataFlitSpeedup (int dataFlitSpeedup)
+  {
+    m_dataFlitSpeedup = dataFlitSpeedup;
+    NotifyContexts ();
+  }
+
+  Time
+  NocRegistry::GetGlobalClock () const
+  {
+    return m_globalClock;
+  }
+
+  void
+  NocRegistry::SetGlobalClock (Time globalClock)
+  {
+    m_globalClock = globalClock;
+    NotifyContexts ();
+  }
+
+  uint32_t
+  NocRegistry::GetNocDimensions () const
+  {
+    return m_nocTopologyDimension;
+  }
+
+  void
+  NocRegistry::SetNocDimensions (uint32_t nocTopologyDimension)
+  {
+    m_nocTopologyDimension = nocTopologyDimension;
+    NotifyContexts ();
+  }
+
+  void
+  NocRegistry::NotifyContexts ()
+  {
+    for (std::list<NocSimulationContext *>::iterator it = m_contexts.begin (); it != m_contexts.end (); ++it)
+      {
+        (*it)->Update ();
+      }
+  }
+
 } // namespace ns3
 
@@ -28,12 +28,15 @@
 #include "ns3/ptr.h"
 #include "ns3/nstime.h"
 #include "ns3/noc-topology.h"
+#include <list>
 
 namespace ns3
 {
 
   class NocTopology;
 
+  class NocSimulationContext;
+
   /**
    * \brief Registry for globally accessible values
    * \detail This class follows the Singleton design pattern.
@@ -51,6 +54,49 @@ namespace ns3
     static Ptr<NocRegistry>
     GetInstance ();
 
+    virtual
+    ~NocRegistry ();
+
+    /**
+     * Registers a simulation context. The context is updated each time a registry value changes.
+     *
+     * \param context the simulation context
+     */
+    void
+    RegisterContext (NocSimulationContext *context);
+
+    /**
+     * Unregisters a simulation context (the context will no longer be notified about changes).
+     *
+     * \param context the simulation context
+     */
+    void
+    UnregisterContext (NocSimulationContext *context);
+
+    /**
+     * \return the flit size, in bits
+     */
+    uint32_t
+    GetFlitSize () const;
+
+    /**
+     * \return the speedup used for routing a data packet, as compared to a head packet
+     */
+    int
+    GetDataFlitSpeedup () const;
+
+    /**
+     * \return the global clock of the synchronous NoC
+     */
+    Time
+    GetGlobalClock () const;
+
+    /**
+     * \return the NoC topology number of dimensions
+     */
+    uint32_t
+    GetNocDimensions () const;
+
   private:
 
     /**
@@ -64,6 +110,24 @@ namespace ns3
 
     NocRegistry& operator= (const NocRegistry&);      // Prevent assignment
 
+    void
+    SetFlitSize (uint32_t flitSize);
+
+    void
+    SetDataFlitSpeedup (int dataFlitSpeedup);
+
+    void
+    SetGlobalClock (Time globalClock);
+
+    void
+    SetNocDimensions (uint32_t nocTopologyDimension);
+
+    /**
+     * Updates all the registered simulation contexts
+     */
+    void
+    NotifyContexts ();
+
     /**
      * the flit size, in bits
      */
@@ -90,6 +154,11 @@ namespace ns3
      */
     uint32_t m_nocTopologyDimension;
 
+    /**
+     * the simulation contexts which cache the values of this registry
+     */
+    std::list<NocSimulationContext *> m_contexts;
+
   };
 
 } // namespace ns3
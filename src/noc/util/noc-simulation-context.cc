@@ -0,0 +1,180 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-simulation-context.h"
+#include "ns3/log.h"
+#include "ns3/noc-registry.h"
+#include "ns3/noc-topology.h"
+#include "ns3/noc-cycle-engine.h"
+#include "ns3/noc-load-side-band.h"
+#include "ns3/noc-deadlock-detector.h"
+
+NS_LOG_COMPONENT_DEFINE ("NocSimulationContext");
+
+namespace ns3
+{
+
+  NS_OBJECT_ENSURE_REGISTERED (NocSimulationContext);
+
+  TypeId
+  NocSimulationContext::GetTypeId ()
+  {
+    static TypeId tid = TypeId ("ns3::NocSimulationContext")
+        .SetParent<Object> ()
+        .AddConstructor<NocSimulationContext> ();
+    return tid;
+  }
+
+  NocSimulationContext::NocSimulationContext ()
+    : m_topology (0),
+      m_globalClockPicoSeconds (0),
+      m_frequency (0),
+      m_dataFlitSpeedup (1),
+      m_flitSize (0),
+      m_nocDimensions (0),
+      m_registry (0),
+      m_cycleEngineRaw (0),
+      m_loadSideBandRaw (0),
+      m_deadlockDetectorRaw (0)
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    // the registry is kept as a raw pointer because the context may be destroyed while
+    // the registry singleton itself is destroyed (the registry may hold the topology)
+    m_registry = PeekPointer (NocRegistry::GetInstance ());
+    m_registry->RegisterContext (this);
+    Update ();
+  }
+
+  NocSimulationContext::~NocSimulationContext ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    if (m_registry != 0)
+      {
+        m_registry->UnregisterContext (this);
+        m_registry = 0;
+      }
+  }
+
+  void
+  NocSimulationContext::DoDispose ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    if (m_registry != 0)
+      {
+        m_registry->UnregisterContext (this);
+        m_registry = 0;
+      }
+    m_topology = 0;
+    if (m_cycleEngine != 0)
+      {
+        m_cycleEngine->Dispose ();
+      }
+    m_cycleEngine = 0;
+    m_cycleEngineRaw = 0;
+    if (m_loadSideBand != 0)
+      {
+        m_loadSideBand->Dispose ();
+      }
+    m_loadSideBand = 0;
+    m_loadSideBandRaw = 0;
+    // the deadlock detector belongs to the statistics of the simulation, so it is not disposed here
+    m_deadlockDetector = 0;
+    m_deadlockDetectorRaw = 0;
+    Object::DoDispose ();
+  }
+
+  void
+  NocSimulationContext::Update ()
+  {
+    NS_LOG_FUNCTION_NOARGS ();
+
+    NS_ASSERT (m_registry != 0);
+    NocRegistry *registry = m_registry;
+    m_globalClock = registry->GetGlobalClock ();
+    m_globalClockPicoSeconds = m_globalClock.GetPicoSeconds ();
+    m_frequency = m_globalClockPicoSeconds > 0 ? 1 / m_globalClock.GetSeconds () : 0;
+    m_dataFlitSpeedup = registry->GetDataFlitSpeedup ();
+    m_flitSize = registry->GetFlitSize ();
+    m_nocDimensions = registry->GetNocDimensions ();
+
+    NS_LOG_DEBUG ("Simulation context updated: clock " << m_globalClockPicoSeconds << " ps, speedup "
+        << m_dataFlitSpeedup << ", flit size " << m_flitSize << " bits, " << m_nocDimensions << " dimensions");
+  }
+
+  void
+  NocSimulationContext::SetTopology (NocTopology *topology)
+  {
+    NS_LOG_FUNCTION (topology);
+    m_topology = topology;
+  }
+
+  void
+  NocSimulationContext::SetCycleEngine (Ptr<NocCycleEngine> engine)
+  {
+    NS_LOG_FUNCTION (engine);
+    if (m_cycleEngine != 0)
+      {
+        m_cycleEngine->SetContext (0);
+      }
+    m_cycleEngine = engine;
+    m_cycleEngineRaw = PeekPointer (engine);
+    if (m_cycleEngine != 0)
+      {
+        m_cycleEngine->SetContext (this);
+      }
+  }
+
+  void
+  NocSimulationContext::SetLoadSideBand (Ptr<NocLoadSideBand> sideBand)
+  {
+    NS_LOG_FUNCTION (sideBand);
+    if (m_loadSideBand != 0)
+      {
+        m_loadSideBand->SetContext (0);
+      }
+    m_loadSideBand = sideBand;
+    m_loadSideBandRaw = PeekPointer (sideBand);
+    if (m_loadSideBand != 0)
+      {
+        m_loadSideBand->SetContext (this);
+      }
+  }
+
+  void
+  NocSimulationContext::SetDeadlockDetector (Ptr<NocDeadlockDetector> detector)
+  {
+    NS_LOG_FUNCTION (detector);
+    m_deadlockDetector = detector;
+    m_deadlockDetectorRaw = PeekPointer (detector);
+  }
+
+  Ptr<NocTopology>
+  NocSimulationContext::GetTopology () const
+  {
+    return m_topology;
+  }
+
+} // namespace ns3
@@ -0,0 +1,293 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCSIMULATIONCONTEXT_H_
+#define NOCSIMULATIONCONTEXT_H_
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/assert.h"
+
+namespace ns3
+{
+
+  class NocTopology;
+
+  class NocRegistry;
+
+  class NocCycleEngine;
+
+  class NocLoadSideBand;
+
+  class NocDeadlockDetector;
+
+  /**
+   * \brief Strongly typed, cached view of the global NoC simulation parameters
+   *
+   * \detail The values kept by the NocRegistry are accessed through the attribute system,
+   *         which is too expensive to be used for every flit. A simulation context is owned by a
+   *         NocTopology and it is handed to the routers, channels and net devices at install time
+   *         (applications retrieve it from the topology when they start).
+   *         The context registers itself with the NocRegistry, which pushes every change
+   *         of a registry value to it. Therefore, the cached values are always up to date.
+   */
+  class NocSimulationContext : public Object
+  {
+  public:
+
+    static TypeId
+    GetTypeId ();
+
+    NocSimulationContext ();
+
+    virtual
+    ~NocSimulationContext ();
+
+    /**
+     * Reloads all the cached values from the NocRegistry.
+     * This is automatically invoked by the registry each time one of its values changes.
+     */
+    void
+    Update ();
+
+    /**
+     * Sets the topology which owns this context. The topology is not referenced counted
+     * by the context (the topology already holds a reference to its context).
+     *
+     * \param topology the NoC topology
+     */
+    void
+    SetTopology (NocTopology *topology);
+
+    /**
+     * \return the NoC topology which owns this context
+     */
+    Ptr<NocTopology>
+    GetTopology () const;
+
+    /**
+     * \return the global clock period of the synchronous NoC
+     */
+    Time
+    GetGlobalClock () const
+    {
+      return m_globalClock;
+    }
+
+    /**
+     * \return the global clock period, in picoseconds
+     */
+    int64_t
+    GetGlobalClockPicoSeconds () const
+    {
+      return m_globalClockPicoSeconds;
+    }
+
+    /**
+     * \return the NoC frequency, in Hz
+     */
+    double
+    GetFrequency () const
+    {
+      return m_frequency;
+    }
+
+    /**
+     * \return how many times a data flit is routed faster than a head flit
+     */
+    int
+    GetDataFlitSpeedup () const
+    {
+      return m_dataFlitSpeedup;
+    }
+
+    /**
+     * \return the flit size, in bits
+     */
+    uint32_t
+    GetFlitSize () const
+    {
+      return m_flitSize;
+    }
+
+    /**
+     * \return the number of dimensions of the NoC topology
+     */
+    uint32_t
+    GetNocDimensions () const
+    {
+      return m_nocDimensions;
+    }
+
+    /**
+     * Sets the cycle engine which drives the NoC (this is done by the NoC topology, at install time).
+     * Without a cycle engine, the NoC is simulated by scheduling a separate event for every flit.
+     *
+     * \param engine the cycle engine (may be null)
+     */
+    void
+    SetCycleEngine (Ptr<NocCycleEngine> engine);
+
+    /**
+     * \return the cycle engine which drives the NoC, or null if the NoC is event driven
+     */
+    NocCycleEngine *
+    GetCycleEngine () const
+    {
+      return m_cycleEngineRaw;
+    }
+
+    /**
+     * Sets the side-band which propagates the load of the routers (this is done by the NoC topology,
+     * at install time). Without a side-band, the load travels with the head flits.
+     *
+     * \param sideBand the load side-band (may be null)
+     */
+    void
+    SetLoadSideBand (Ptr<NocLoadSideBand> sideBand);
+
+    /**
+     * \return the load side-band, or null if the load travels with the head flits
+     */
+    NocLoadSideBand *
+    GetLoadSideBand () const
+    {
+      return m_loadSideBandRaw;
+    }
+
+    /**
+     * Sets the detector which watches the virtual channels of the routers for deadlocks
+     * (this is done by NocDeadlockDetector::Install).
+     *
+     * \param detector the deadlock detector (may be null)
+     */
+    void
+    SetDeadlockDetector (Ptr<NocDeadlockDetector> detector);
+
+    /**
+     * \return the deadlock detector, or null if deadlocks are not detected
+     */
+    NocDeadlockDetector *
+    GetDeadlockDetector () const
+    {
+      return m_deadlockDetectorRaw;
+    }
+
+    /**
+     * Computes the number of the clock cycle which contains the given moment in time.
+     * Clock cycles are numbered starting from 1.
+     *
+     * \param time the moment in time
+     *
+     * \return the clock cycle number
+     */
+    uint64_t
+    GetClockNumber (Time time) const
+    {
+      NS_ASSERT_MSG (m_globalClockPicoSeconds > 0, "The global clock of the NoC is not set!");
+      return time.GetPicoSeconds () / m_globalClockPicoSeconds + 1;
+    }
+
+  protected:
+
+    virtual void
+    DoDispose ();
+
+  private:
+
+    /**
+     * the NoC topology owning this context
+     */
+    NocTopology *m_topology;
+
+    /**
+     * the global clock period
+     */
+    Time m_globalClock;
+
+    /**
+     * the global clock period, in picoseconds
+     */
+    int64_t m_globalClockPicoSeconds;
+
+    /**
+     * the NoC frequency, in Hz (zero when the global clock is not set)
+     */
+    double m_frequency;
+
+    /**
+     * the speedup used for routing a data packet, as compared to a head packet
+     */
+    int m_dataFlitSpeedup;
+
+    /**
+     * the flit size, in bits
+     */
+    uint32_t m_flitSize;
+
+    /**
+     * the NoC topology number of dimensions
+     */
+    uint32_t m_nocDimensions;
+
+    /**
+     * the registry with which this context is registered (null after disposal)
+     */
+    NocRegistry *m_registry;
+
+    /**
+     * the cycle engine (null for an event driven NoC)
+     */
+    Ptr<NocCycleEngine> m_cycleEngine;
+
+    /**
+     * m_cycleEngine, kept as a raw pointer for fast access
+     */
+    NocCycleEngine *m_cycleEngineRaw;
+
+    /**
+     * the load side-band (null when the load travels with the head flits)
+     */
+    Ptr<NocLoadSideBand> m_loadSideBand;
+
+    /**
+     * m_loadSideBand, kept as a raw pointer for fast access
+     */
+    NocLoadSideBand *m_loadSideBandRaw;
+
+    /**
+     * the deadlock detector (null when deadlocks are not detected)
+     */
+    Ptr<NocDeadlockDetector> m_deadlockDetector;
+
+    /**
+     * m_deadlockDetector, kept as a raw pointer for fast access
+     */
+    NocDeadlockDetector *m_deadlockDetectorRaw;
+
+  };
+
+} // namespace ns3
+
+#endif /* NOCSIMULATIONCONTEXT_H_ */
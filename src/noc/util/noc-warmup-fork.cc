@@ -0,0 +1,197 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#include "noc-warmup-fork.h"
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+#include "ns3/simulator.h"
+#include "ns3/rng-stream.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+NS_LOG_COMPONENT_DEFINE ("NocWarmupFork");
+
+namespace ns3
+{
+
+  NocWarmupFork::NocWarmupFork (uint32_t runs, uint32_t parallelRuns)
+  {
+    m_runs = runs;
+    m_parallelRuns = parallelRuns;
+    if (m_parallelRuns == 0)
+      {
+        long processors = sysconf (_SC_NPROCESSORS_ONLN);
+        m_parallelRuns = processors > 0 ? processors : 1;
+      }
+    m_child = false;
+    m_run = 0;
+    m_runningChildren = 0;
+    m_failedRuns = 0;
+    m_lock = -1;
+  }
+
+  NocWarmupFork::~NocWarmupFork ()
+  {
+    UnlockOutput ();
+  }
+
+  bool
+  NocWarmupFork::Fork (Time warmupEnd)
+  {
+    NS_LOG_FUNCTION (warmupEnd);
+    NS_ASSERT_MSG (!m_child, "A measurement run can not fork other runs");
+    NS_ASSERT_MSG (warmupEnd >= Simulator::Now (), "The warmup already ended");
+
+    Simulator::Stop (warmupEnd - Simulator::Now ());
+    Simulator::Run ();
+    NS_LOG_INFO ("The warmup ended at " << Simulator::Now () << "; forking " << m_runs << " measurement runs");
+
+    for (uint32_t run = 0; run < m_runs; run++)
+      {
+        while (m_runningChildren >= m_parallelRuns)
+          {
+            WaitChild ();
+          }
+        // otherwise, the buffered output would be written by every child
+        fflush (0);
+        pid_t pid = fork ();
+        if (pid < 0)
+          {
+            NS_FATAL_ERROR ("Could not fork measurement run " << run << ": " << strerror (errno));
+          }
+        if (pid == 0)
+          {
+            m_child = true;
+            m_run = run;
+            return true;
+          }
+        NS_LOG_LOGIC ("Measurement run " << run << " is done by process " << pid);
+        m_runningChildren++;
+      }
+    while (m_runningChildren > 0)
+      {
+        WaitChild ();
+      }
+    NS_LOG_INFO (m_runs - m_failedRuns << " of the " << m_runs << " measurement runs exited successfully");
+
+    return false;
+  }
+
+  void
+  NocWarmupFork::WaitChild ()
+  {
+    int status;
+    pid_t pid;
+    do
+      {
+        pid = wait (&status);
+      }
+    while (pid < 0 && errno == EINTR);
+    if (pid < 0)
+      {
+        NS_FATAL_ERROR ("Could not wait for a measurement run: " << strerror (errno));
+      }
+    if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+      {
+        NS_LOG_WARN ("Process " << pid << " (a measurement run) failed");
+        m_failedRuns++;
+      }
+    m_runningChildren--;
+  }
+
+  bool
+  NocWarmupFork::IsChild () const
+  {
+    return m_child;
+  }
+
+  uint32_t
+  NocWarmupFork::GetRun () const
+  {
+    return m_run;
+  }
+
+  uint32_t
+  NocWarmupFork::GetFailedRuns () const
+  {
+    return m_failedRuns;
+  }
+
+  void
+  NocWarmupFork::Reseed (uint32_t seed)
+  {
+    NS_LOG_FUNCTION (seed);
+    NS_ASSERT_MSG (seed != 0, "The seed must not be zero");
+
+    bool valid = RngStream::SetPackageSeed (seed);
+    if (!valid)
+      {
+        NS_FATAL_ERROR ("Invalid seed " << seed);
+      }
+    srand (seed);
+  }
+
+  void
+  NocWarmupFork::LockOutput (std::string fileName)
+  {
+    NS_LOG_FUNCTION (fileName);
+
+    if (m_lock >= 0)
+      {
+        return;
+      }
+    std::string lockFile = fileName + ".lock";
+    m_lock = open (lockFile.c_str (), O_RDWR | O_CREAT, 0644);
+    if (m_lock < 0)
+      {
+        NS_FATAL_ERROR ("Could not create the lock file " << lockFile << ": " << strerror (errno));
+      }
+    while (flock (m_lock, LOCK_EX) != 0)
+      {
+        // retry only when interrupted by a signal
+        if (errno != EINTR)
+          {
+            NS_FATAL_ERROR ("Could not lock " << lockFile << ": " << strerror (errno));
+          }
+      }
+  }
+
+  void
+  NocWarmupFork::UnlockOutput ()
+  {
+    if (m_lock >= 0)
+      {
+        flock (m_lock, LOCK_UN);
+        close (m_lock);
+        m_lock = -1;
+      }
+  }
+
+} // namespace ns3
@@ -0,0 +1,152 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 - 2011
+ *               Advanced Computer Architecture and Processing Systems (ACAPS),
+ *               Lucian Blaga University of Sibiu, Romania
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Ciprian Radu <ciprian.radu@ulbsibiu.ro>
+ *         http://webspace.ulbsibiu.ro/ciprian.radu/
+ */
+
+#ifndef NOCWARMUPFORK_H_
+#define NOCWARMUPFORK_H_
+
+#include "ns3/nstime.h"
+#include <stdint.h>
+#include <string>
+
+namespace ns3
+{
+
+  /**
+   * \brief Simulates the warmup once and then forks a process for each measurement run
+   *
+   * \detail The simulation is run until the end of the warmup, in the current process. Then a child process is forked
+   *         for every measurement run. The children start from the warmed up state (their memory is a copy-on-write
+   *         copy of the parent's memory), so the warmup is not simulated again by every run. Each child may change
+   *         the parameters used after the warmup (the random streams, the injection rate and so on) and then continues
+   *         the simulation. The parent only waits for its children.
+   *
+   *         At most ParallelRuns children run at the same time. The children of a sweep usually write their results
+   *         into the same output (database) file; LockOutput makes them do it one at a time.
+   *
+   *         Nothing may be open for writing (files, databases) when the processes are forked,
+   *         otherwise the children would share it.
+   */
+  class NocWarmupFork
+  {
+  public:
+
+    /**
+     * \param runs how many measurement runs (child processes) are forked
+     * \param parallelRuns how many children may run at the same time (0 means the number of processors)
+     */
+    NocWarmupFork (uint32_t runs, uint32_t parallelRuns);
+
+    ~NocWarmupFork ();
+
+    /**
+     * Simulates until the end of the warmup and then forks the measurement runs.
+     * It returns in every child (immediately after the fork) and in the parent (after all the children exited).
+     *
+     * \param warmupEnd the simulation time when the warmup ends
+     *
+     * \return true in a child process, false in the parent process
+     */
+    bool
+    Fork (Time warmupEnd);
+
+    /**
+     * \return whether or not this is a child (measurement run) process
+     */
+    bool
+    IsChild () const;
+
+    /**
+     * \return the index of the measurement run done by this (child) process, in [0, runs)
+     */
+    uint32_t
+    GetRun () const;
+
+    /**
+     * \return how many children did not exit successfully (valid in the parent, after Fork)
+     */
+    uint32_t
+    GetFailedRuns () const;
+
+    /**
+     * Reseeds the random number generators, so that the random streams which are created from now on
+     * are different from the ones of the parent (and of the other children, if they use other seeds).
+     * The streams which already exist must be replaced by the user.
+     *
+     * \param seed the new seed (must not be zero)
+     */
+    static void
+    Reseed (uint32_t seed);
+
+    /**
+     * Waits until no other process holds the lock of an output file and then takes it.
+     * The lock is released by UnlockOutput or when the process exits.
+     *
+     * \param fileName the output file (the lock file is fileName.lock)
+     */
+    void
+    LockOutput (std::string fileName);
+
+    /**
+     * Releases the output lock
+     */
+    void
+    UnlockOutput ();
+
+  private:
+
+    NocWarmupFork (const NocWarmupFork &);
+
+    NocWarmupFork &
+    operator= (const NocWarmupFork &);
+
+    /**
+     * Waits for a child to exit
+     */
+    void
+    WaitChild ();
+
+    uint32_t m_runs;
+
+    uint32_t m_parallelRuns;
+
+    bool m_child;
+
+    uint32_t m_run;
+
+    /**
+     * how many children were forked and did not exit yet
+     */
+    uint32_t m_runningChildren;
+
+    uint32_t m_failedRuns;
+
+    /**
+     * the file descriptor of the output lock file (-1 if the lock is not held)
+     */
+    int m_lock;
+
+  };
+
+} // namespace ns3
+
+#endif /* NOCWARMUPFORK_H_ */